@@ -86,7 +86,10 @@
 #ifdef __OPENTENBASE__
 #include "storage/nodelock.h"
 #include "access/xact.h"
+#include "access/nbtree.h"
 #include "pgxc/shardmap.h"
+#include "utils/builtins.h"
+#include "utils/fmgroids.h"
 #endif
 #ifdef _MLS_
 #include "catalog/pg_authid.h"
@@ -97,6 +100,7 @@
 
 /* GUC variable */
 bool        synchronize_seqscans = true;
+int            seqscan_prefetch_pages = 0;
 
 
 static HeapScanDesc heap_beginscan_internal(Relation relation,
@@ -110,6 +114,13 @@ static HeapScanDesc heap_beginscan_internal(Relation relation,
                         bool is_samplescan,
                         bool temp_snap);
 static void heap_parallelscan_startblock_init(HeapScanDesc scan);
+#ifdef USE_PREFETCH
+static void heap_scan_prefetch(HeapScanDesc scan, BlockNumber page);
+#endif
+#ifdef __OPENTENBASE__
+static int heap_page_filter_keys(HeapScanDesc scan, Page dp, BlockNumber page,
+                      int ntup);
+#endif
 static BlockNumber heap_parallelscan_nextpage(HeapScanDesc scan);
 static HeapTuple heap_prepare_insert(Relation relation, HeapTuple tup,
                     TransactionId xid, CommandId cid, int options);
@@ -323,6 +334,7 @@ initscan(HeapScanDesc scan, ScanKey key, bool keep_startblock)
     ItemPointerSetInvalid(&scan->rs_ctup.t_self);
     scan->rs_cbuf = InvalidBuffer;
     scan->rs_cblock = InvalidBlockNumber;
+    scan->rs_prefetch_next = InvalidBlockNumber;
 
     /* page-at-a-time fields are always invalid when not rs_inited */
 
@@ -395,6 +407,12 @@ heapgetpage(HeapScanDesc scan, BlockNumber page)
      */
     CHECK_FOR_INTERRUPTS();
 
+#ifdef USE_PREFETCH
+    /* get the next pages on their way before blocking on this one */
+    if (seqscan_prefetch_pages > 0 && !scan->rs_samplescan)
+        heap_scan_prefetch(scan, page);
+#endif
+
     /* read page using selected strategy */
     scan->rs_cbuf = ReadBufferExtended(scan->rs_rd, MAIN_FORKNUM, page,
                                        RBM_NORMAL, scan->rs_strategy);
@@ -491,10 +509,230 @@ heapgetpage(HeapScanDesc scan, BlockNumber page)
 
     LockBuffer(buffer, BUFFER_LOCK_UNLOCK);
 
+#ifdef __OPENTENBASE__
+    /*
+     * Apply the scan keys to the whole page here rather than one tuple at a
+     * time in heapgettup_pagemode; the tuples are pinned, so no lock needed.
+     */
+    if (scan->rs_pageatatime && scan->rs_nkeys > 0 && ntup > 0)
+        ntup = heap_page_filter_keys(scan, dp, page, ntup);
+#endif
+
     Assert(ntup <= MaxHeapTuplesPerPage);
     scan->rs_ntuples = ntup;
 }
 
+#ifdef __OPENTENBASE__
+/*
+ * Scan key comparisons heap_page_filter_keys evaluates inline instead of
+ * calling the comparison function.  The type codes say how the attribute
+ * and the key argument are stored: 'h' int2, 'i' int4, 'l' int8, 'o' oid,
+ * 'f' float4, 'd' float8.  date is an int4 and timestamp(tz) an int8.
+ */
+typedef struct HeapKeyKernel
+{
+    Oid            fn_oid;
+    char        lefttype;
+    char        righttype;
+    int16        strategy;        /* BT*StrategyNumber, or HEAPKEY_NE */
+} HeapKeyKernel;
+
+#define HEAPKEY_NE    (BTMaxStrategyNumber + 1)
+
+#define HEAPKEY_KERNELS(prefix, l, r) \
+    {prefix##EQ, l, r, BTEqualStrategyNumber}, \
+    {prefix##NE, l, r, HEAPKEY_NE}, \
+    {prefix##LT, l, r, BTLessStrategyNumber}, \
+    {prefix##LE, l, r, BTLessEqualStrategyNumber}, \
+    {prefix##GT, l, r, BTGreaterStrategyNumber}, \
+    {prefix##GE, l, r, BTGreaterEqualStrategyNumber}
+
+static const HeapKeyKernel heap_key_kernels[] =
+{
+    HEAPKEY_KERNELS(F_INT2, 'h', 'h'),
+    HEAPKEY_KERNELS(F_INT4, 'i', 'i'),
+    HEAPKEY_KERNELS(F_INT8, 'l', 'l'),
+    HEAPKEY_KERNELS(F_INT24, 'h', 'i'),
+    HEAPKEY_KERNELS(F_INT42, 'i', 'h'),
+    HEAPKEY_KERNELS(F_INT28, 'h', 'l'),
+    HEAPKEY_KERNELS(F_INT82, 'l', 'h'),
+    HEAPKEY_KERNELS(F_INT48, 'i', 'l'),
+    HEAPKEY_KERNELS(F_INT84, 'l', 'i'),
+    HEAPKEY_KERNELS(F_OID, 'o', 'o'),
+    HEAPKEY_KERNELS(F_FLOAT4, 'f', 'f'),
+    HEAPKEY_KERNELS(F_FLOAT8, 'd', 'd'),
+    HEAPKEY_KERNELS(F_FLOAT48, 'f', 'd'),
+    HEAPKEY_KERNELS(F_FLOAT84, 'd', 'f'),
+    HEAPKEY_KERNELS(F_DATE_, 'i', 'i'),
+    HEAPKEY_KERNELS(F_TIMESTAMP_, 'l', 'l')
+};
+
+static const HeapKeyKernel *
+heap_key_kernel_lookup(Oid fn_oid)
+{
+    int            i;
+
+    for (i = 0; i < lengthof(heap_key_kernels); i++)
+    {
+        if (heap_key_kernels[i].fn_oid == fn_oid)
+            return &heap_key_kernels[i];
+    }
+    return NULL;
+}
+
+static inline bool
+heap_key_kernel_test(const HeapKeyKernel *kernel, Datum left, Datum right)
+{
+    int            cmp;
+
+    if (kernel->lefttype == 'f' || kernel->lefttype == 'd')
+    {
+        float8        l = kernel->lefttype == 'f' ? DatumGetFloat4(left) : DatumGetFloat8(left);
+        float8        r = kernel->righttype == 'f' ? DatumGetFloat4(right) : DatumGetFloat8(right);
+
+        /* same NaN ordering as the float comparison functions */
+        cmp = float8_cmp_internal(l, r);
+    }
+    else if (kernel->lefttype == 'o')
+    {
+        Oid            l = DatumGetObjectId(left);
+        Oid            r = DatumGetObjectId(right);
+
+        cmp = (l > r) - (l < r);
+    }
+    else
+    {
+        int64        l;
+        int64        r;
+
+        l = kernel->lefttype == 'h' ? DatumGetInt16(left) :
+            kernel->lefttype == 'i' ? DatumGetInt32(left) : DatumGetInt64(left);
+        r = kernel->righttype == 'h' ? DatumGetInt16(right) :
+            kernel->righttype == 'i' ? DatumGetInt32(right) : DatumGetInt64(right);
+        cmp = (l > r) - (l < r);
+    }
+
+    switch (kernel->strategy)
+    {
+        case BTLessStrategyNumber:
+            return cmp < 0;
+        case BTLessEqualStrategyNumber:
+            return cmp <= 0;
+        case BTEqualStrategyNumber:
+            return cmp == 0;
+        case BTGreaterEqualStrategyNumber:
+            return cmp >= 0;
+        case BTGreaterStrategyNumber:
+            return cmp > 0;
+        default:
+            return cmp != 0;
+    }
+}
+
+/*
+ * heap_page_filter_keys - apply the scan keys to the visible tuples of a page
+ *
+ * Works one key at a time over rs_vistuples, compacting it to the offsets
+ * that pass, so the kernel for a key runs in a tight loop over the page and
+ * later keys only look at the survivors.  Same semantics as HeapKeyTest.
+ * Returns the new number of tuples in rs_vistuples.
+ */
+static int
+heap_page_filter_keys(HeapScanDesc scan, Page dp, BlockNumber page, int ntup)
+{
+    TupleDesc    tupdesc = RelationGetDescr(scan->rs_rd);
+    HeapTupleData loctup;
+    int            k;
+
+    loctup.t_tableOid = RelationGetRelid(scan->rs_rd);
+
+    for (k = 0; k < scan->rs_nkeys && ntup > 0; k++)
+    {
+        ScanKey        key = &scan->rs_key[k];
+        const HeapKeyKernel *kernel;
+        int            nkeep = 0;
+        int            i;
+
+        if (key->sk_flags & SK_ISNULL)
+            return 0;
+
+        kernel = heap_key_kernel_lookup(key->sk_func.fn_oid);
+
+        for (i = 0; i < ntup; i++)
+        {
+            OffsetNumber lineoff = scan->rs_vistuples[i];
+            ItemId        lpp = PageGetItemId(dp, lineoff);
+            Datum        atp;
+            bool        isnull;
+            bool        pass;
+
+            loctup.t_data = (HeapTupleHeader) PageGetItem(dp, lpp);
+            loctup.t_len = ItemIdGetLength(lpp);
+            ItemPointerSet(&(loctup.t_self), page, lineoff);
+
+            atp = heap_getattr(&loctup, key->sk_attno, tupdesc, &isnull);
+            if (isnull)
+                continue;
+
+            if (kernel)
+                pass = heap_key_kernel_test(kernel, atp, key->sk_argument);
+            else
+                pass = DatumGetBool(FunctionCall2Coll(&key->sk_func,
+                                                      key->sk_collation,
+                                                      atp, key->sk_argument));
+            if (pass)
+                scan->rs_vistuples[nkeep++] = lineoff;
+        }
+
+        ntup = nkeep;
+    }
+
+    return ntup;
+}
+#endif
+
+#ifdef USE_PREFETCH
+/*
+ * heap_scan_prefetch - issue prefetch requests ahead of a forward scan
+ *
+ * Keeps up to seqscan_prefetch_pages blocks past the page about to be read
+ * prefetched, so the kernel reads them while we process the current page.
+ * Only forward progress is followed: backward scans and wrap-around restart
+ * the window. The window stops at the end of the relation and, for extent
+ * tables, at the end of the current extent, since the next extent may belong
+ * to a shard the scan skips altogether.
+ *
+ * In a parallel scan each worker prefetches ahead of the pages it got, which
+ * mostly covers the pages handed out to the other workers next.
+ */
+static void
+heap_scan_prefetch(HeapScanDesc scan, BlockNumber page)
+{
+    BlockNumber limit = scan->rs_nblocks;
+    BlockNumber target;
+
+    if (scan->rs_cblock != InvalidBlockNumber && page <= scan->rs_cblock)
+    {
+        scan->rs_prefetch_next = InvalidBlockNumber;
+        return;
+    }
+
+    if (scan->rs_prefetch_next == InvalidBlockNumber ||
+        scan->rs_prefetch_next <= page ||
+        scan->rs_prefetch_next > page + seqscan_prefetch_pages + 1)
+        scan->rs_prefetch_next = page + 1;
+
+#ifdef _SHARDING_
+    if (RelationHasExtent(scan->rs_rd))
+        limit = Min(limit, (page / PAGES_PER_EXTENTS + 1) * PAGES_PER_EXTENTS);
+#endif
+
+    target = Min(page + seqscan_prefetch_pages + 1, limit);
+    while (scan->rs_prefetch_next < target)
+        PrefetchBuffer(scan->rs_rd, MAIN_FORKNUM, scan->rs_prefetch_next++);
+}
+#endif
+
 /* ----------------
  *        heapgettup - fetch next heap tuple
  *
@@ -1073,6 +1311,11 @@ heapgettup_pagemode(HeapScanDesc scan,
             /*
              * if current tuple qualifies, return it.
              */
+#ifdef __OPENTENBASE__
+            /* heapgetpage has already applied the scan keys */
+            scan->rs_cindex = lineindex;
+            return;
+#else
             if (key != NULL)
             {
                 bool        valid;
@@ -1090,6 +1333,7 @@ heapgettup_pagemode(HeapScanDesc scan,
                 scan->rs_cindex = lineindex;
                 return;
             }
+#endif
 
             /*
              * otherwise move to the next item on the page
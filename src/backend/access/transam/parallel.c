@@ -22,6 +22,7 @@
 #include "access/xlog.h"
 #include "catalog/namespace.h"
 #include "commands/async.h"
+#include "commands/vacuum.h"
 #include "executor/execParallel.h"
 #include "libpq/libpq.h"
 #include "libpq/pqformat.h"
@@ -133,7 +134,12 @@ static const struct
 {
     {
         "ParallelQueryMain", ParallelQueryMain
+    },
+#ifdef __OPENTENBASE__
+    {
+        "parallel_vacuum_main", parallel_vacuum_main
     }
+#endif
 };
 
 /* Private functions. */
@@ -32,6 +32,7 @@
 #include "gtm/gtm_gxid.h"
 #include "pgxc/execRemote.h"
 #include "pgxc/pause.h"
+#include "pgxc/shardmap.h"
 /* PGXC_DATANODE */
 #include "postmaster/autovacuum.h"
 #include "postmaster/clean2pc.h"
@@ -3138,6 +3139,9 @@ CommitTransaction(void)
     AtEOXact_ComboCid();
     AtEOXact_HashTables(true);
     AtEOXact_PgStat(true);
+#ifdef __OPENTENBASE__
+    AtEOXact_ShardStatistic();
+#endif
     AtEOXact_Snapshot(true, false);
     AtEOXact_ApplyLauncher(true);
     pgstat_report_xact_timestamp(0);
@@ -3577,6 +3581,9 @@ PrepareTransaction(void)
     AtEOXact_ComboCid();
     AtEOXact_HashTables(true);
     /* don't call AtEOXact_PgStat here; we fixed pgstat state above */
+#ifdef __OPENTENBASE__
+    AtEOXact_ShardStatistic();
+#endif
     AtEOXact_Snapshot(true, true);
     pgstat_report_xact_timestamp(0);
 
@@ -4168,6 +4175,9 @@ AbortTransaction(void)
         AtEOXact_ComboCid();
         AtEOXact_HashTables(false);
         AtEOXact_PgStat(false);
+#ifdef __OPENTENBASE__
+        AtEOXact_ShardStatistic();
+#endif
         AtEOXact_ApplyLauncher(false);
         pgstat_report_xact_timestamp(0);
     }
@@ -168,9 +168,12 @@ bool g_wal_check;
 /*
  * Number of WAL insertion locks to use. A higher value allows more insertions
  * to happen concurrently, but adds some CPU overhead to flushing the WAL,
- * which needs to iterate all the locks.
+ * which needs to iterate all the locks. Set at server start by the
+ * wal_insert_locks GUC.
  */
-#define NUM_XLOGINSERT_LOCKS  8
+int            num_xloginsert_locks = 8;
+
+#define NUM_XLOGINSERT_LOCKS  num_xloginsert_locks
 
 /*
  * Max distance from last checkpoint, before triggering a new xlog-based
@@ -1260,6 +1260,11 @@ acquire_sample_rows(Relation onerel, int elevel,
     TransactionId OldestXmin;
     BlockSamplerData bs;
     ReservoirStateData rstate;
+    long        randseed = random();
+#ifdef USE_PREFETCH
+    BlockSamplerData prefetch_bs;
+    int            prefetch_pages = seqscan_prefetch_pages;
+#endif
 
     Assert(targrows > 0);
 
@@ -1269,10 +1274,26 @@ acquire_sample_rows(Relation onerel, int elevel,
     OldestXmin = GetOldestXmin(onerel, PROCARRAY_FLAGS_VACUUM);
 
     /* Prepare for sampling block numbers */
-    BlockSampler_Init(&bs, totalblocks, targrows, random());
+    BlockSampler_Init(&bs, totalblocks, targrows, randseed);
     /* Prepare for sampling rows */
     reservoir_init_selection_state(&rstate, targrows);
 
+#ifdef USE_PREFETCH
+    /*
+     * A second sampler with the same seed yields the same block sequence, so
+     * running it prefetch_pages blocks ahead tells us which blocks to
+     * prefetch.
+     */
+    if (prefetch_pages > 0)
+    {
+        int            i;
+
+        BlockSampler_Init(&prefetch_bs, totalblocks, targrows, randseed);
+        for (i = 0; i < prefetch_pages && BlockSampler_HasMore(&prefetch_bs); i++)
+            PrefetchBuffer(onerel, MAIN_FORKNUM, BlockSampler_Next(&prefetch_bs));
+    }
+#endif
+
     /* Outer loop over blocks to sample */
     while (BlockSampler_HasMore(&bs))
     {
@@ -1282,6 +1303,11 @@ acquire_sample_rows(Relation onerel, int elevel,
         OffsetNumber targoffset,
                     maxoffset;
 
+#ifdef USE_PREFETCH
+        if (prefetch_pages > 0 && BlockSampler_HasMore(&prefetch_bs))
+            PrefetchBuffer(onerel, MAIN_FORKNUM, BlockSampler_Next(&prefetch_bs));
+#endif
+
         vacuum_delay_point();
 
         /*
@@ -30,6 +30,7 @@
 #include "access/heapam.h"
 #include "access/htup_details.h"
 #include "access/sysattr.h"
+#include "access/transam.h"
 #include "access/xact.h"
 #include "access/xlog.h"
 #include "catalog/pg_type.h"
@@ -59,6 +60,7 @@
 #endif
 #include "nodes/makefuncs.h"
 #include "optimizer/pgxcship.h"
+#include "parser/analyze.h"
 #include "parser/parse_relation.h"
 #include "rewrite/rewriteHandler.h"
 #include "storage/fd.h"
@@ -70,6 +72,7 @@
 #include "utils/rel.h"
 #include "utils/rls.h"
 #include "utils/snapmgr.h"
+#include "utils/syscache.h"
 #ifdef __OPENTENBASE__
 #include "utils/rel.h"
 #include "utils/ruleutils.h"
@@ -264,6 +267,7 @@ typedef struct CopyStateData
     Relation    *partrels;
     int            nparts;
     bool        insert_into;
+    bool        insert_into_binary; /* ship evaluated VALUES rows in binary */
     int        data_index;
     char       ***data_list;
     int        data_ncolumns;
@@ -414,6 +418,11 @@ static bool CopyGetInt16(CopyState cstate, int16 *val);
 #ifdef PGXC
 static RemoteCopyOptions *GetRemoteCopyOptions(CopyState cstate);
 static void append_defvals(Datum *values, CopyState cstate);
+static void RemoteCopySendBinaryHeader(CopyState cstate);
+#endif
+#ifdef __OPENTENBASE__
+static bool InsertIntoBinaryCapable(Relation rel, List *attnums);
+static void InsertIntoBuildBinaryRow(CopyState cstate, Datum *values, bool *nulls);
 #endif
 
 /*
@@ -1607,6 +1616,7 @@ BeginCopy(ParseState *pstate,
 #ifdef _SHARDING_
     cstate->shard_array = shards;
     cstate->insert_into = false;
+    cstate->insert_into_binary = false;
 #endif
 
     /* Process the source/target relation or query */
@@ -1666,6 +1676,15 @@ BeginCopy(ParseState *pstate,
             if (pstate && pstate->stmt && pstate->stmt->insert_into)
             {
                 cstate->insert_into = true;
+
+                /*
+                 * The coordinator evaluates every VALUES row anyway to route
+                 * it, so ship the evaluated datums in binary COPY format and
+                 * spare the datanodes from parsing the text again.
+                 */
+                if (g_transform_insert_to_copy_binary &&
+                    InsertIntoBinaryCapable(cstate->rel, attnums))
+                    cstate->insert_into_binary = true;
             }
 #endif
             /* Build remote query */
@@ -4199,6 +4218,20 @@ BeginCopyFrom(ParseState *pstate,
                              &in_func_oid, &typioparams[attnum - 1]);
         fmgr_info(in_func_oid, &in_functions[attnum - 1]);
 
+#ifdef __OPENTENBASE__
+        /* Send functions used to ship evaluated VALUES rows to datanodes */
+        if (cstate->insert_into_binary &&
+            list_member_int(cstate->attnumlist, attnum))
+        {
+            Oid        send_func_oid;
+            bool    isvarlena;
+
+            getTypeBinaryOutputInfo(attr[attnum - 1]->atttypid,
+                                    &send_func_oid, &isvarlena);
+            fmgr_info(send_func_oid, &cstate->out_functions[attnum - 1]);
+        }
+#endif
+
         /* Get default info if needed */
         if (!list_member_int(cstate->attnumlist, attnum))
         {
@@ -4239,7 +4272,7 @@ BeginCopyFrom(ParseState *pstate,
                          * Initialize output functions needed to convert default
                          * values into output form before appending to data row.
                          */
-                        if (cstate->binary)
+                        if (cstate->binary || cstate->insert_into_binary)
                             getTypeBinaryOutputInfo(attr[attnum - 1]->atttypid,
                                                     &out_func_oid, &isvarlena);
                         else
@@ -4363,6 +4396,11 @@ BeginCopyFrom(ParseState *pstate,
     {
         /* must rely on user to tell us... */
         cstate->file_has_oids = cstate->oids;
+#ifdef __OPENTENBASE__
+        /* No input file to read a header from, datanodes still expect one */
+        if (cstate->insert_into_binary)
+            RemoteCopySendBinaryHeader(cstate);
+#endif
     }
     else
     {
@@ -4404,32 +4442,7 @@ BeginCopyFrom(ParseState *pstate,
 #ifdef PGXC
         /* This is done at the beginning of COPY FROM from Coordinator to Datanodes */
         if (IS_PGXC_COORDINATOR)
-        {
-            RemoteCopyData *remoteCopyState = cstate->remoteCopyState;
-
-            /* Empty buffer info and send header to all the backends involved in COPY */
-            resetStringInfo(&cstate->line_buf);
-
-            enlargeStringInfo(&cstate->line_buf, 19);
-            appendBinaryStringInfo(&cstate->line_buf, BinarySignature, 11);
-            tmp = 0;
-
-            if (cstate->oids)
-                tmp |= (1 << 16);
-            tmp = htonl(tmp);
-
-            appendBinaryStringInfo(&cstate->line_buf, (char *) &tmp, 4);
-            tmp = 0;
-            tmp = htonl(tmp);
-            appendBinaryStringInfo(&cstate->line_buf, (char *) &tmp, 4);
-
-            if (DataNodeCopyInBinaryForAll(cstate->line_buf.data, 19,
-                    getLocatorNodeCount(remoteCopyState->locator),
-                    (PGXCNodeHandle **) getLocatorNodeMap(remoteCopyState->locator)))
-                ereport(ERROR,
-                            (errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
-                             errmsg("invalid COPY file header (COPY SEND)")));
-        }
+            RemoteCopySendBinaryHeader(cstate);
 #endif
     }
 
@@ -4566,7 +4579,14 @@ NextCopyFrom(CopyState cstate, ExprContext *econtext,
             resetStringInfo(&cstate->line_buf);
 
             /* send data in datarow format to remote datanode */
-            if (cstate->data_index < cstate->ndatarows)
+            if (cstate->data_index < cstate->ndatarows && cstate->insert_into_binary)
+            {
+                /* row is built from the evaluated datums below */
+                field_strings = cstate->data_list[cstate->data_index];
+                cstate->data_index++;
+                fldct = cstate->data_ncolumns;
+            }
+            else if (cstate->data_index < cstate->ndatarows)
             {
                 int index = 0;
                 uint16     n16 = 0;
@@ -4700,6 +4720,11 @@ NextCopyFrom(CopyState cstate, ExprContext *econtext,
         }
 
         Assert(fieldno == nfields);
+
+#ifdef __OPENTENBASE__
+        if (cstate->insert_into_binary)
+            InsertIntoBuildBinaryRow(cstate, values, nulls);
+#endif
     }
     else
     {
@@ -4886,7 +4911,7 @@ append_defvals(Datum *values, CopyState cstate)
         int attindex = cstate->defmap[i];
         Datum defvalue = values[attindex];
 
-        if (!cstate->binary)
+        if (!cstate->binary && !cstate->insert_into_binary)
             CopySendChar(&new_cstate, new_cstate.delim[0]);
 
         /*
@@ -4903,7 +4928,7 @@ append_defvals(Datum *values, CopyState cstate)
          * same, so new cstate will have all the fields copied from the original
          * cstate, except fe_msgbuf.
          */
-        if (cstate->binary)
+        if (cstate->binary || cstate->insert_into_binary)
         {
             bytea       *outputbytes;
 
@@ -4937,7 +4962,7 @@ append_defvals(Datum *values, CopyState cstate)
     }
 
 #ifdef __OPENTENBASE__
-    if (cstate->insert_into && cstate->data_list)
+    if (cstate->insert_into && cstate->data_list && !cstate->insert_into_binary)
     {
         /* do nothing, default values have been appended before */
     }
@@ -4951,6 +4976,134 @@ append_defvals(Datum *values, CopyState cstate)
     }
 #endif
 }
+
+/*
+ * RemoteCopySendBinaryHeader
+ * Send the binary COPY file header to all the datanodes involved in COPY.
+ */
+static void
+RemoteCopySendBinaryHeader(CopyState cstate)
+{
+    RemoteCopyData *remoteCopyState = cstate->remoteCopyState;
+    int32        tmp;
+
+    /* Empty buffer info and send header to all the backends involved in COPY */
+    resetStringInfo(&cstate->line_buf);
+
+    enlargeStringInfo(&cstate->line_buf, 19);
+    appendBinaryStringInfo(&cstate->line_buf, BinarySignature, 11);
+    tmp = 0;
+
+    if (cstate->oids)
+        tmp |= (1 << 16);
+    tmp = htonl(tmp);
+
+    appendBinaryStringInfo(&cstate->line_buf, (char *) &tmp, 4);
+    tmp = 0;
+    tmp = htonl(tmp);
+    appendBinaryStringInfo(&cstate->line_buf, (char *) &tmp, 4);
+
+    if (DataNodeCopyInBinaryForAll(cstate->line_buf.data, 19,
+            getLocatorNodeCount(remoteCopyState->locator),
+            (PGXCNodeHandle **) getLocatorNodeMap(remoteCopyState->locator)))
+        ereport(ERROR,
+                    (errcode(ERRCODE_BAD_COPY_FILE_FORMAT),
+                     errmsg("invalid COPY file header (COPY SEND)")));
+}
+#endif
+
+#ifdef __OPENTENBASE__
+/*
+ * InsertIntoBinaryCapable
+ * Check whether the rows of an insert into multi-values transformed to copy
+ * from can be shipped to datanodes in binary format. Only built-in base types
+ * qualify: their send/receive functions are identical on every node, while
+ * user-defined type OIDs embedded in binary data may differ between nodes.
+ * Besides the inserted columns, this covers the columns whose defaults the
+ * coordinator may compute and append to the row (see append_defvals).
+ */
+static bool
+InsertIntoBinaryCapable(Relation rel, List *attnums)
+{
+    TupleDesc    tupDesc = RelationGetDescr(rel);
+    int            attnum;
+
+    for (attnum = 1; attnum <= tupDesc->natts; attnum++)
+    {
+        Form_pg_attribute attr = tupDesc->attrs[attnum - 1];
+        HeapTuple    typeTuple;
+        Form_pg_type pt;
+        bool        capable;
+
+        if (attr->attisdropped)
+            continue;
+
+        /* columns not inserted only matter if they get a default */
+        if (!list_member_int(attnums, attnum) &&
+            build_column_default(rel, attnum) == NULL)
+            continue;
+
+        if (attr->atttypid >= FirstNormalObjectId)
+            return false;
+
+        typeTuple = SearchSysCache1(TYPEOID, ObjectIdGetDatum(attr->atttypid));
+        if (!HeapTupleIsValid(typeTuple))
+            elog(ERROR, "cache lookup failed for type %u", attr->atttypid);
+        pt = (Form_pg_type) GETSTRUCT(typeTuple);
+
+        capable = pt->typtype == TYPTYPE_BASE &&
+                  OidIsValid(pt->typsend) && OidIsValid(pt->typreceive);
+        ReleaseSysCache(typeTuple);
+
+        if (!capable)
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * InsertIntoBuildBinaryRow
+ * Build the binary COPY data row for the current values row of an insert into
+ * multi-values. The datums have already been evaluated for routing, so they
+ * are encoded with the type send functions instead of shipping the original
+ * literals, and datanodes load them without going through text input.
+ * Default values are appended later by append_defvals.
+ */
+static void
+InsertIntoBuildBinaryRow(CopyState cstate, Datum *values, bool *nulls)
+{
+    ListCell   *cur;
+    uint16        n16;
+
+    resetStringInfo(&cstate->line_buf);
+
+    n16 = htons(list_length(cstate->attnumlist) + cstate->num_defaults);
+    appendBinaryStringInfo(&cstate->line_buf, (char *) &n16, sizeof(n16));
+
+    foreach(cur, cstate->attnumlist)
+    {
+        int            m = lfirst_int(cur) - 1;
+        uint32        n32;
+
+        if (nulls[m])
+        {
+            n32 = htonl(-1);
+            appendBinaryStringInfo(&cstate->line_buf, (char *) &n32, sizeof(n32));
+        }
+        else
+        {
+            bytea       *outputbytes;
+            int            len;
+
+            outputbytes = SendFunctionCall(&cstate->out_functions[m], values[m]);
+            len = VARSIZE(outputbytes) - VARHDRSZ;
+            n32 = htonl(len);
+            appendBinaryStringInfo(&cstate->line_buf, (char *) &n32, sizeof(n32));
+            appendBinaryStringInfo(&cstate->line_buf, VARDATA(outputbytes), len);
+        }
+    }
+}
 #endif
 
 
@@ -6420,7 +6573,10 @@ GetRemoteCopyOptions(CopyState cstate)
     if (cstate->force_notnull)
         res->rco_force_notnull = list_copy(cstate->force_notnull);
 #ifdef __OPENTENBASE__
-    res->rco_insert_into = cstate->insert_into;
+    if (cstate->insert_into_binary)
+        res->rco_binary = true;
+    else
+        res->rco_insert_into = cstate->insert_into;
 #endif
 
     return res;
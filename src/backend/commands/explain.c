@@ -52,6 +52,7 @@
 #ifdef __OPENTENBASE__
 #include "commands/explain_dist.h"
 #include "commands/vacuum.h"
+#include "jit/jit.h"
 #endif
 
 /* Hook for plugins to get control in ExplainOneQuery() */
@@ -134,6 +135,10 @@ static void show_modifytable_info(ModifyTableState *mtstate, List *ancestors,
                       ExplainState *es);
 static void ExplainMemberNodes(List *plans, PlanState **planstates,
                    List *ancestors, ExplainState *es);
+#ifdef __OPENTENBASE__
+static void show_subplans_removed(int nremoved, List *prunequals,
+                      PlanState *planstate, ExplainState *es);
+#endif
 static void ExplainSubPlans(List *plans, List *ancestors,
                 const char *relationship, ExplainState *es);
 static void ExplainCustomChildren(CustomScanState *css,
@@ -610,6 +615,12 @@ ExplainOnePlan(PlannedStmt *plannedstmt, IntoClause *into, ExplainState *es,
     if (es->analyze)
         ExplainPrintTriggers(es, queryDesc);
 
+#ifdef __OPENTENBASE__
+    /* Print info about JITing, if any */
+    if (es->analyze)
+        ExplainPrintJIT(es, queryDesc);
+#endif
+
     /*
      * Close down the query and free resources.  Include time for this in the
      * total execution time (although it should be pretty minimal).
@@ -721,6 +732,87 @@ ExplainPrintTriggers(ExplainState *es, QueryDesc *queryDesc)
     ExplainCloseGroup("Triggers", "Triggers", false, es);
 }
 
+#ifdef __OPENTENBASE__
+/*
+ * ExplainPrintJIT -
+ *      append information about JITing to es->str
+ *
+ * Only the JIT work done by the local executor is reported; expressions
+ * compiled on remote nodes are accounted for there.
+ */
+void
+ExplainPrintJIT(ExplainState *es, QueryDesc *queryDesc)
+{
+    JitContext *jc = queryDesc->estate->es_jit;
+    instr_time    total_time;
+
+    if (!jc)
+        return;
+
+    /* calculate total time */
+    INSTR_TIME_SET_ZERO(total_time);
+    INSTR_TIME_ADD(total_time, jc->instr.generation_counter);
+    INSTR_TIME_ADD(total_time, jc->instr.optimization_counter);
+    INSTR_TIME_ADD(total_time, jc->instr.emission_counter);
+
+    ExplainOpenGroup("JIT", "JIT", true, es);
+
+    if (es->format == EXPLAIN_FORMAT_TEXT)
+    {
+        appendStringInfoString(es->str, "JIT:\n");
+        appendStringInfo(es->str, "  Functions: %zu\n",
+                         jc->instr.created_functions);
+        appendStringInfo(es->str,
+                         "  Options: %s %s, %s %s, %s %s, %s %s\n",
+                         "Inlining", jc->flags & PGJIT_INLINE ? "true" : "false",
+                         "Optimization", jc->flags & PGJIT_OPT3 ? "true" : "false",
+                         "Expressions", jc->flags & PGJIT_EXPR ? "true" : "false",
+                         "Deforming", jc->flags & PGJIT_DEFORM ? "true" : "false");
+
+        if (es->timing)
+            appendStringInfo(es->str,
+                             "  Timing: %s %.3f ms, %s %.3f ms, %s %.3f ms, %s %.3f ms\n",
+                             "Generation", 1000.0 * INSTR_TIME_GET_DOUBLE(jc->instr.generation_counter),
+                             "Optimization", 1000.0 * INSTR_TIME_GET_DOUBLE(jc->instr.optimization_counter),
+                             "Emission", 1000.0 * INSTR_TIME_GET_DOUBLE(jc->instr.emission_counter),
+                             "Total", 1000.0 * INSTR_TIME_GET_DOUBLE(total_time));
+    }
+    else
+    {
+        ExplainPropertyLong("Functions", (long) jc->instr.created_functions, es);
+
+        ExplainOpenGroup("Options", "Options", true, es);
+        ExplainPropertyBool("Inlining", jc->flags & PGJIT_INLINE, es);
+        ExplainPropertyBool("Optimization", jc->flags & PGJIT_OPT3, es);
+        ExplainPropertyBool("Expressions", jc->flags & PGJIT_EXPR, es);
+        ExplainPropertyBool("Deforming", jc->flags & PGJIT_DEFORM, es);
+        ExplainCloseGroup("Options", "Options", true, es);
+
+        if (es->timing)
+        {
+            ExplainOpenGroup("Timing", "Timing", true, es);
+
+            ExplainPropertyFloat("Generation",
+                                 1000.0 * INSTR_TIME_GET_DOUBLE(jc->instr.generation_counter),
+                                 3, es);
+            ExplainPropertyFloat("Optimization",
+                                 1000.0 * INSTR_TIME_GET_DOUBLE(jc->instr.optimization_counter),
+                                 3, es);
+            ExplainPropertyFloat("Emission",
+                                 1000.0 * INSTR_TIME_GET_DOUBLE(jc->instr.emission_counter),
+                                 3, es);
+            ExplainPropertyFloat("Total",
+                                 1000.0 * INSTR_TIME_GET_DOUBLE(total_time),
+                                 3, es);
+
+            ExplainCloseGroup("Timing", "Timing", true, es);
+        }
+    }
+
+    ExplainCloseGroup("JIT", "JIT", true, es);
+}
+#endif
+
 /*
  * ExplainQueryText -
  *      add a "Query Text" node that contains the actual text of the query
@@ -1618,6 +1710,29 @@ ExplainNode(PlanState *planstate, List *ancestors,
                     }
                 }
 
+#ifdef __OPENTENBASE__
+                /* rows with hot key values do not follow the distribution */
+                if (rsubplan->skewValues)
+                {
+                    char        skew[64];
+                    int         nvalues = list_length(rsubplan->skewValues);
+
+                    snprintf(skew, 64, "%s %d hot value%s",
+                             rsubplan->skewPolicy == SKEW_POLICY_SPREAD ?
+                             "round-robin" : "broadcast",
+                             nvalues, nvalues > 1 ? "s" : "");
+                    ExplainPropertyText("Skew Handling", skew, es);
+                }
+
+                /* broadcast or redistribution is decided at runtime */
+                if (rsubplan->adaptivePolicy == ADAPTIVE_POLICY_BUILD)
+                    ExplainPropertyText("Adaptive Broadcast",
+                                        "build side, broadcast if small", es);
+                else if (rsubplan->adaptivePolicy == ADAPTIVE_POLICY_PROBE)
+                    ExplainPropertyText("Adaptive Broadcast",
+                                        "probe side, local if build side is broadcast", es);
+#endif
+
                 /* add info about output sort order */
                 if (es->verbose)
                     show_simple_sort_keys((RemoteSubplanState *)planstate,
@@ -1827,9 +1942,19 @@ ExplainNode(PlanState *planstate, List *ancestors,
                                    ancestors, es);
 #ifdef __OPENTENBASE__
             show_upper_qual(plan->qual, "Filter", planstate, ancestors, es);
+            show_subplans_removed(((MergeAppendState *) planstate)->ms_nremoved,
+                                  ((MergeAppend *) plan)->partprunequals,
+                                  planstate, es);
 #endif
 
             break;
+#ifdef __OPENTENBASE__
+        case T_Append:
+            show_subplans_removed(((AppendState *) planstate)->as_nremoved,
+                                  ((Append *) plan)->partprunequals,
+                                  planstate, es);
+            break;
+#endif
         case T_Result:
             show_upper_qual((List *) ((Result *) plan)->resconstantqual,
                             "One-Time Filter", planstate, ancestors, es);
@@ -2720,6 +2845,27 @@ show_hash_info(HashState *hashstate, ExplainState *es)
 							 hinstrument->nbuckets, hinstrument->nbatch,
                              spacePeakKb);
         }
+#ifdef __OPENTENBASE__
+		/* outer tuples the runtime join filter kept out of the batch files */
+		if (hinstrument->bloom_checked > 0)
+		{
+			if (es->format != EXPLAIN_FORMAT_TEXT)
+			{
+				ExplainPropertyFloat("Bloom Filter Rows Checked",
+									 hinstrument->bloom_checked, 0, es);
+				ExplainPropertyFloat("Bloom Filter Rows Removed",
+									 hinstrument->bloom_removed, 0, es);
+			}
+			else
+			{
+				appendStringInfoSpaces(es->str, es->indent * 2);
+				appendStringInfo(es->str,
+								 "Bloom Filter: Rows Checked: %.0f  Rows Removed: %.0f\n",
+								 hinstrument->bloom_checked,
+								 hinstrument->bloom_removed);
+			}
+		}
+#endif
     }
 }
 
@@ -3329,9 +3475,34 @@ ExplainMemberNodes(List *plans, PlanState **planstates,
     int            j;
 
     for (j = 0; j < nplans; j++)
+    {
+#ifdef __OPENTENBASE__
+        /* pruned or missing children have no planstate */
+        if (planstates[j] == NULL)
+            continue;
+#endif
         ExplainNode(planstates[j], ancestors,
                     "Member", NULL, es);
+    }
+}
+
+#ifdef __OPENTENBASE__
+/*
+ * Show how many children of an Append or MergeAppend were pruned at executor
+ * startup, and how many executions of the others run-time pruning skipped per
+ * loop.  Children of dropped partitions are not counted.
+ */
+static void
+show_subplans_removed(int nremoved, List *prunequals, PlanState *planstate,
+                      ExplainState *es)
+{
+    if (nremoved > 0)
+        ExplainPropertyInteger("Subplans Removed", nremoved, es);
+
+    if (prunequals != NIL)
+        show_instrumentation_count("Subplans Pruned", 1, planstate, es);
 }
+#endif
 
 /*
  * Explain a list of SubPlans (or initPlans, which also use SubPlan nodes).
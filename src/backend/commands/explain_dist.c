@@ -17,6 +17,7 @@
 
 #include "commands/explain_dist.h"
 #include "executor/hashjoin.h"
+#include "executor/producerReceiver.h"
 #include "libpq/libpq.h"
 #include "libpq/pqformat.h"
 #include "nodes/nodeFuncs.h"
@@ -52,6 +53,10 @@ typedef struct
 	Bitmapset  *printed_nodes;
 	/* send str buf */
 	StringInfoData buf;
+	/* root of the serialized plan fragment */
+	PlanState  *root;
+	/* data exchange instrument of the fragment producer, if any */
+	FragmentInstrumentation producer;
 } SerializeState;
 
 /*
@@ -253,6 +258,8 @@ SpecInstrOut(StringInfo buf, NodeTag plantag, PlanState *planstate)
 			int     nbatch = 0;
 			int     nbatch_original = 0;
 			Size    spacePeak = 0;
+			double  bloomChecked = 0;
+			double  bloomRemoved = 0;
 			bool    valid = true;
 			
 			if (hashtable)
@@ -262,6 +269,8 @@ SpecInstrOut(StringInfo buf, NodeTag plantag, PlanState *planstate)
 				nbatch = hashtable->nbatch;
 				nbatch_original = hashtable->nbatch_original;
 				spacePeak = hashtable->spacePeak;
+				bloomChecked = hashtable->bloomChecked;
+				bloomRemoved = hashtable->bloomRemoved;
 			}
 			else if (hashstate->shared_info)
 			{
@@ -277,6 +286,8 @@ SpecInstrOut(StringInfo buf, NodeTag plantag, PlanState *planstate)
 						nbatch = w_stats->nbatch;
 						nbatch_original = w_stats->nbatch_original;
 						spacePeak = w_stats->space_peak;
+						bloomChecked = w_stats->bloom_checked;
+						bloomRemoved = w_stats->bloom_removed;
 						break;
 					}
 				}
@@ -291,10 +302,10 @@ SpecInstrOut(StringInfo buf, NodeTag plantag, PlanState *planstate)
 			{
 				elog(DEBUG1, "send out hash %d peak %zu", planstate->plan->plan_node_id,
 				     spacePeak);
-				appendStringInfo(buf, "1<%d,%d,%d,%d,%ld>",
+				appendStringInfo(buf, "1<%d,%d,%d,%d,%ld,%.0f,%.0f>",
 				                 nbuckets, nbuckets_original,
 				                 nbatch, nbatch_original,
-				                 spacePeak);
+				                 spacePeak, bloomChecked, bloomRemoved);
 			}
 			else
 				appendStringInfo(buf, "0>");
@@ -306,6 +317,27 @@ SpecInstrOut(StringInfo buf, NodeTag plantag, PlanState *planstate)
 	}
 }
 
+/*
+ * FragmentInstrOut
+ *
+ * Serialize data exchange instrument with the format "1<val,val,val,val>",
+ * or "0>" if nothing was collected.
+ */
+static void
+FragmentInstrOut(StringInfo buf, FragmentInstrumentation *instr)
+{
+	if (instr->valid)
+	{
+		appendStringInfo(buf, "1<");
+		appendStringInfo(buf, "%.10f,", instr->recv_time);
+		appendStringInfo(buf, "%.10f,", instr->send_time);
+		appendStringInfo(buf, "%.0f,", instr->send_tuples);
+		appendStringInfo(buf, "%.0f>", instr->spill_tuples);
+	}
+	else
+		appendStringInfo(buf, "0>");
+}
+
 /*
  * InstrIn
  *
@@ -448,6 +480,8 @@ SpecInstrIn(StringInfo str, RemoteInstr *instr)
 				INSTR_READ_FIELD(hash_stat.nbatch);
 				INSTR_READ_FIELD(hash_stat.nbatch_original);
 				INSTR_READ_FIELD(hash_stat.space_peak);
+				INSTR_READ_FIELD(hash_stat.bloom_checked);
+				INSTR_READ_FIELD(hash_stat.bloom_removed);
 			}
 		}
 			break;
@@ -459,6 +493,59 @@ SpecInstrIn(StringInfo str, RemoteInstr *instr)
 	str->cursor = tmp_head - &str->data[0];
 }
 
+/*
+ * FragmentInstrIn
+ *
+ * DeSerialize of data exchange instrument of current node.
+ */
+static void
+FragmentInstrIn(StringInfo str, RemoteInstr *rinstr)
+{
+	char    *tmp_pos;
+	char    *tmp_head = &str->data[str->cursor];
+	FragmentInstrumentation *instr = &rinstr->fragment;
+	
+	instr->valid = (bool) strtod(tmp_head, &tmp_pos);
+	tmp_head = tmp_pos + 1;
+	
+	if (instr->valid)
+	{
+		INSTR_READ_FIELD(recv_time);
+		INSTR_READ_FIELD(send_time);
+		INSTR_READ_FIELD(send_tuples);
+		INSTR_READ_FIELD(spill_tuples);
+	}
+	
+	str->cursor = tmp_head - &str->data[0];
+}
+
+/*
+ * SerializeLocalFragmentInstr
+ *
+ * Collect data exchange instrument of the given planstate: receiving time of
+ * a RemoteSubplan, and sending time of the producer at the fragment root.
+ */
+static void
+SerializeLocalFragmentInstr(PlanState *planstate, SerializeState *ss)
+{
+	FragmentInstrumentation fragment;
+	
+	memset(&fragment, 0, sizeof(FragmentInstrumentation));
+	
+	if (planstate == ss->root && ss->producer.valid)
+		memcpy(&fragment, &ss->producer, sizeof(FragmentInstrumentation));
+	
+	if (IsA(planstate, RemoteSubplanState))
+	{
+		RemoteSubplanState *node = (RemoteSubplanState *) planstate;
+		
+		fragment.valid = true;
+		fragment.recv_time = INSTR_TIME_GET_DOUBLE(node->recv_time);
+	}
+	
+	FragmentInstrOut(&ss->buf, &fragment);
+}
+
 /*
  * SerializeLocalInstr
  *
@@ -500,6 +587,7 @@ SerializeLocalInstr(PlanState *planstate, SerializeState *ss)
 				{
 					InstrOut(&ss->buf, planstate->plan, instrument, node_id);
 					SpecInstrOut(&ss->buf, nodeTag(planstate->plan), planstate);
+					FragmentInstrOut(&ss->buf, &planstate->dn_instrument->instrument[n].fragment);
 				}
 				else
 				{
@@ -512,6 +600,7 @@ SerializeLocalInstr(PlanState *planstate, SerializeState *ss)
 			/* send our own instr */
 			InstrOut(&ss->buf, planstate->plan, planstate->instrument, 0);
 			SpecInstrOut(&ss->buf, nodeTag(planstate->plan), planstate);
+			SerializeLocalFragmentInstr(planstate, ss);
 		}
 	}
 	else
@@ -528,14 +617,19 @@ SerializeLocalInstr(PlanState *planstate, SerializeState *ss)
  * SendLocalInstr
  *
  * Serialize local instrument of the given planstate and send it to upper node.
+ * If dest is a producer, its sending time is reported on the fragment root.
  */
 void
-SendLocalInstr(PlanState *planstate)
+SendLocalInstr(PlanState *planstate, DestReceiver *dest)
 {
 	SerializeState ss;
 	
 	/* Construct str with the same logic in ExplainNode */
 	ss.printed_nodes = NULL;
+	ss.root = planstate;
+	memset(&ss.producer, 0, sizeof(FragmentInstrumentation));
+	if (dest != NULL && dest->mydest == DestProducer)
+		GetProducerFragmentInstr(dest, &ss.producer);
 	pq_beginmessage(&ss.buf, 'i');
 	SerializeLocalInstr(planstate, &ss);
 	pq_endmessage(&ss.buf);
@@ -619,6 +713,9 @@ combineSpecRemoteInstr(RemoteInstr *rtarget, RemoteInstr *rsrc)
 			rtarget->hash_stat.nbatch = Max(rtarget->hash_stat.nbatch, rsrc->hash_stat.nbatch);
 			rtarget->hash_stat.nbatch_original = Max(rtarget->hash_stat.nbatch_original, rsrc->hash_stat.nbatch_original);
 			rtarget->hash_stat.space_peak = Max(rtarget->hash_stat.space_peak, rsrc->hash_stat.space_peak);
+			/* the filter counters add up over the datanodes */
+			rtarget->hash_stat.bloom_checked += rsrc->hash_stat.bloom_checked;
+			rtarget->hash_stat.bloom_removed += rsrc->hash_stat.bloom_removed;
 		}
 			break;
 		default:
@@ -692,6 +789,17 @@ combineRemoteInstr(RemoteInstr *rtarget, RemoteInstr *rsrc)
 	INSTR_MAX_FIELD(bufusage.blk_write_time.tv_sec);
 	INSTR_MAX_FIELD(bufusage.blk_write_time.tv_nsec);
 	
+	/* data exchange instrument */
+	if (rsrc->fragment.valid)
+	{
+		rtarget->fragment.valid = true;
+		rtarget->fragment.recv_time = Max(rtarget->fragment.recv_time, rsrc->fragment.recv_time);
+		rtarget->fragment.send_time = Max(rtarget->fragment.send_time, rsrc->fragment.send_time);
+		/* row counters add up over the workers */
+		rtarget->fragment.send_tuples += rsrc->fragment.send_tuples;
+		rtarget->fragment.spill_tuples += rsrc->fragment.spill_tuples;
+	}
+	
 	combineSpecRemoteInstr(rtarget, rsrc);
 }
 
@@ -729,6 +837,7 @@ HandleRemoteInstr(char *msg_body, size_t len, int nodeid, ResponseCombiner *comb
 		recv_instr.sort_stat.spaceType = -1;
 		InstrIn(recv_str, &recv_instr);
 		SpecInstrIn(recv_str, &recv_instr);
+		FragmentInstrIn(recv_str, &recv_instr);
 		
 		if (recv_instr.key.node_id == 0)
 			recv_instr.key.node_id = nodeid;
@@ -840,6 +949,8 @@ attachRemoteSpecificInstr(PlanState *planstate, RemoteInstr *rinstr)
 				hs->hashtable->nbatch = rinstr->hash_stat.nbatch;
 				hs->hashtable->nbatch_original = rinstr->hash_stat.nbatch_original;
 				hs->hashtable->spacePeak = rinstr->hash_stat.space_peak;
+				hs->hashtable->bloomChecked = rinstr->hash_stat.bloom_checked;
+				hs->hashtable->bloomRemoved = rinstr->hash_stat.bloom_removed;
 			}
 		}
 			break;
@@ -914,6 +1025,7 @@ AttachRemoteInstr(PlanState *planstate, AttachRemoteInstrContext *ctx)
 				elog(DEBUG1, "instr attach plan_node_id %d node %d index %d", plan_node_id, key.node_id, n);
 				planstate->dn_instrument->instrument[n].nodeid = key.node_id;
 				memcpy(&planstate->dn_instrument->instrument[n].instr, &rinstr->instr, sizeof(Instrumentation));
+				memcpy(&planstate->dn_instrument->instrument[n].fragment, &rinstr->fragment, sizeof(FragmentInstrumentation));
 				/* TODO attach all nodes' remote specific instr */
 				rinstr_final.nodeTag = rinstr->nodeTag;
 				rinstr_final.key = rinstr->key;
@@ -957,6 +1069,11 @@ ExplainCommonRemoteInstr(PlanState *planstate, ExplainState *es)
 	double startup_sec_min, startup_sec_max, startup_sec;
 	double total_sec_min, total_sec_max, total_sec;
 	double rows_min, rows_max, rows;
+	/* for data exchange display, in ms */
+	bool   has_fragment = false;
+	double recv_ms_min = 0, recv_ms_max = 0, recv_ms;
+	double send_ms_min = 0, send_ms_max = 0, send_ms;
+	double spill_min = 0, spill_max = 0;
 	/* for verbose */
 	StringInfoData buf;
 	
@@ -1008,6 +1125,22 @@ ExplainCommonRemoteInstr(PlanState *planstate, ExplainState *es)
 		SET_MIN_MAX(total_sec_min, total_sec_max, total_sec);
 		SET_MIN_MAX(rows_min, rows_max, rows);
 		
+		recv_ms = 1000.0 * rinstr[i].fragment.recv_time;
+		send_ms = 1000.0 * rinstr[i].fragment.send_time;
+		if (rinstr[i].fragment.valid)
+		{
+			if (!has_fragment)
+			{
+				recv_ms_min = recv_ms_max = recv_ms;
+				send_ms_min = send_ms_max = send_ms;
+				spill_min = spill_max = rinstr[i].fragment.spill_tuples;
+				has_fragment = true;
+			}
+			SET_MIN_MAX(recv_ms_min, recv_ms_max, recv_ms);
+			SET_MIN_MAX(send_ms_min, send_ms_max, send_ms);
+			SET_MIN_MAX(spill_min, spill_max, rinstr[i].fragment.spill_tuples);
+		}
+		
 		/* one line for each dn if verbose */
 		if (es->verbose)
 		{
@@ -1029,6 +1162,13 @@ ExplainCommonRemoteInstr(PlanState *planstate, ExplainState *es)
 						appendStringInfo(&buf,
 						                 "- %s (actual rows=%.0f loops=%.0f)",
 						                 dnname, rows, nloops);
+					
+					if (es->timing && rinstr[i].fragment.valid)
+						appendStringInfo(&buf,
+						                 " (exchange recv time=%.3f send time=%.3f sent rows=%.0f spilled rows=%.0f)",
+						                 recv_ms, send_ms,
+						                 rinstr[i].fragment.send_tuples,
+						                 rinstr[i].fragment.spill_tuples);
 				}
 			}
 			else
@@ -1041,6 +1181,13 @@ ExplainCommonRemoteInstr(PlanState *planstate, ExplainState *es)
 				}
 				ExplainPropertyFloat("Actual Rows", rows, 0, es);
 				ExplainPropertyFloat("Actual Loops", nloops, 0, es);
+				if (es->timing && rinstr[i].fragment.valid)
+				{
+					ExplainPropertyFloat("Receive Wait Time", recv_ms, 3, es);
+					ExplainPropertyFloat("Send Wait Time", send_ms, 3, es);
+					ExplainPropertyFloat("Sent Rows", rinstr[i].fragment.send_tuples, 0, es);
+					ExplainPropertyFloat("Spilled Rows", rinstr[i].fragment.spill_tuples, 0, es);
+				}
 			}
 		}
 	}
@@ -1066,6 +1213,18 @@ ExplainCommonRemoteInstr(PlanState *planstate, ExplainState *es)
 				appendStringInfo(es->str,
 				                 "DN (actual rows=%.0f..%.0f loops=%.0f..%.0f)",
 				                 rows_min, rows_max, nloops_min, nloops_max);
+			
+			/* where the fragment spent its time exchanging data */
+			if (es->timing && has_fragment && !es->verbose)
+			{
+				appendStringInfoChar(es->str, '\n');
+				appendStringInfoSpaces(es->str, es->indent * 2);
+				appendStringInfo(es->str,
+				                 "DN (exchange recv time=%.3f..%.3f send time=%.3f..%.3f spilled rows=%.0f..%.0f)",
+				                 recv_ms_min, recv_ms_max,
+				                 send_ms_min, send_ms_max,
+				                 spill_min, spill_max);
+			}
 		}
 		
 		if (es->verbose)
@@ -1089,5 +1248,14 @@ ExplainCommonRemoteInstr(PlanState *planstate, ExplainState *es)
 		ExplainPropertyFloat("Actual Max Rows", rows_max, 0, es);
 		ExplainPropertyFloat("Actual Min Loops", nloops_min, 0, es);
 		ExplainPropertyFloat("Actual Max Loops", nloops_max, 0, es);
+		if (es->timing && has_fragment)
+		{
+			ExplainPropertyFloat("Min Receive Wait Time", recv_ms_min, 3, es);
+			ExplainPropertyFloat("Max Receive Wait Time", recv_ms_max, 3, es);
+			ExplainPropertyFloat("Min Send Wait Time", send_ms_min, 3, es);
+			ExplainPropertyFloat("Max Send Wait Time", send_ms_max, 3, es);
+			ExplainPropertyFloat("Min Spilled Rows", spill_min, 0, es);
+			ExplainPropertyFloat("Max Spilled Rows", spill_max, 0, es);
+		}
 	}
 }
@@ -88,6 +88,18 @@ int            vacuum_multixact_freeze_min_age;
 int            vacuum_multixact_freeze_table_age;
 int            vacuum_defer_freeze_min_age;
 
+#ifdef __OPENTENBASE__
+/*
+ * Cost-based delay state shared by the leader and the workers of a parallel
+ * index vacuum.  Both pointers are set only while such a vacuum runs; the
+ * balance a process has put into the shared pool but not yet slept for is
+ * kept in VacuumCostBalanceLocal.
+ */
+pg_atomic_uint32 *VacuumSharedCostBalance = NULL;
+pg_atomic_uint32 *VacuumActiveNWorkers = NULL;
+int            VacuumCostBalanceLocal = 0;
+#endif
+
 /* A few variables that don't seem worth passing around as parameters */
 static MemoryContext vac_context = NULL;
 static BufferAccessStrategy vac_strategy;
@@ -101,6 +113,9 @@ static void vac_truncate_clog(TransactionId frozenXID,
                   MultiXactId lastSaneMinMulti);
 static bool vacuum_rel(Oid relid, RangeVar *relation, int options,
 					   VacuumParams *params, StatSyncOpt *syncOpt);
+#ifdef __OPENTENBASE__
+static int compute_parallel_delay(void);
+#endif
 
 /*
  * Primary entry point for manual VACUUM and ANALYZE commands
@@ -228,6 +243,17 @@ vacuum(int					options,
                 (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
                  errmsg("VACUUM option DISABLE_PAGE_SKIPPING cannot be used with FULL")));
 
+#ifdef __OPENTENBASE__
+    /*
+     * Sanity check PARALLEL option.
+     */
+    if ((options & VACOPT_FULL) != 0 &&
+        (options & VACOPT_PARALLEL) != 0)
+        ereport(ERROR,
+                (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                 errmsg("VACUUM option PARALLEL cannot be used with FULL")));
+#endif
+
     /*
      * Send info about dead objects to the statistics collector, unless we are
      * in autovacuum --- autovacuum.c does this for itself.
@@ -366,6 +392,10 @@ vacuum(int					options,
     {
         in_vacuum = false;
         VacuumCostActive = false;
+#ifdef __OPENTENBASE__
+        VacuumSharedCostBalance = NULL;
+        VacuumActiveNWorkers = NULL;
+#endif
         PG_RE_THROW();
     }
     PG_END_TRY();
@@ -1710,16 +1740,29 @@ vac_close_indexes(int nindexes, Relation *Irel, LOCKMODE lockmode)
 void
 vacuum_delay_point(void)
 {
+    int            msec = 0;
+
     /* Always check for interrupts */
     CHECK_FOR_INTERRUPTS();
 
-    /* Nap if appropriate */
-    if (VacuumCostActive && !InterruptPending &&
-        VacuumCostBalance >= VacuumCostLimit)
-    {
-        int            msec;
+    if (!VacuumCostActive || InterruptPending)
+        return;
 
+#ifdef __OPENTENBASE__
+    /*
+     * In a parallel index vacuum, the leader and the workers draw on one
+     * cost balance so that together they stay within the configured limit.
+     */
+    if (VacuumSharedCostBalance != NULL)
+        msec = compute_parallel_delay();
+    else
+#endif
+    if (VacuumCostBalance >= VacuumCostLimit)
         msec = VacuumCostDelay * VacuumCostBalance / VacuumCostLimit;
+
+    /* Nap if appropriate */
+    if (msec > 0)
+    {
         if (msec > VacuumCostDelay * 4)
             msec = VacuumCostDelay * 4;
 
@@ -1735,6 +1778,49 @@ vacuum_delay_point(void)
     }
 }
 
+#ifdef __OPENTENBASE__
+/*
+ * compute_parallel_delay --- sleep time of a parallel index vacuum process
+ *
+ * Our own balance is moved into the shared one.  Once the shared balance
+ * reaches the limit, only the processes that have done more than their
+ * share of the I/O since they last slept (half of an even split between
+ * the active processes) sleep, for the time their own part is worth, and
+ * take that part out of the shared balance again.
+ */
+static int
+compute_parallel_delay(void)
+{
+    int            msec = 0;
+    uint32        shared_balance;
+    int            nworkers;
+
+    nworkers = pg_atomic_read_u32(VacuumActiveNWorkers);
+
+    /* At least count ourselves */
+    if (nworkers < 1)
+        nworkers = 1;
+
+    shared_balance = pg_atomic_add_fetch_u32(VacuumSharedCostBalance,
+                                             VacuumCostBalance);
+    VacuumCostBalanceLocal += VacuumCostBalance;
+
+    if (shared_balance >= VacuumCostLimit &&
+        VacuumCostBalanceLocal > 0.5 * ((double) VacuumCostLimit / nworkers))
+    {
+        msec = VacuumCostDelay * VacuumCostBalanceLocal / VacuumCostLimit;
+        pg_atomic_sub_fetch_u32(VacuumSharedCostBalance,
+                                VacuumCostBalanceLocal);
+        VacuumCostBalanceLocal = 0;
+    }
+
+    /* It is accounted for in the shared balance now */
+    VacuumCostBalance = 0;
+
+    return msec;
+}
+#endif
+
 #ifdef XCP
 /*
  * For the data node query make up TargetEntry representing specified column
@@ -2219,7 +2305,13 @@ ExecVacuumShard(VacuumShardStmt *stmt)
             A_Const * con = ((A_Const *)lfirst(lc_shard));
             
             ShardID sid = intVal(&(con->val));
-            
+
+            /*
+             * TruncateShard keeps its per-shard state in the current context
+             * across its transactions; each of them leaves us in
+             * TopMemoryContext.
+             */
+            MemoryContextSwitchTo(vac_context);
             s_tuples = TruncateShard(relid, sid, stmt->pause);
 
             elog(INFO, "Vacuum One Shard Success. rel=%d, sid=%d, tuples=%d",
@@ -45,8 +45,10 @@
 #include "access/heapam_xlog.h"
 #include "access/htup_details.h"
 #include "access/multixact.h"
+#include "access/parallel.h"
 #include "access/transam.h"
 #include "access/visibilitymap.h"
+#include "access/xact.h"
 #include "access/xlog.h"
 #include "access/xlogutils.h"
 #include "bootstrap/bootstrap.h"
@@ -62,6 +64,7 @@
 #include "postmaster/autovacuum.h"
 #include "postmaster/postmaster.h"
 #include "storage/bufmgr.h"
+#include "storage/dsm.h"
 #include "storage/freespace.h"
 #include "storage/lmgr.h"
 #include "utils/lsyscache.h"
@@ -142,6 +145,52 @@ typedef struct LVRelStats
     bool        lock_waiter_detected;
 } LVRelStats;
 
+#ifdef __OPENTENBASE__
+/*
+ * Parallel index vacuum.
+ *
+ * With VACUUM (PARALLEL), the dead tuple array lives in a DSM segment and
+ * every bulk-delete round, as well as the final cleanup round, hands the
+ * indexes out to the leader and a set of parallel workers.  Each index is
+ * processed by exactly one process per round; the index statistics are kept
+ * in the segment so that the next round sees them.  pg_class cannot be
+ * updated in parallel mode, so the leader does that once the segment is
+ * gone.  The cost-based delay balance is shared through the segment too.
+ */
+#define PARALLEL_VACUUM_KEY_SHARED			UINT64CONST(0xFFFFFFFFFFF00001)
+#define PARALLEL_VACUUM_KEY_DEAD_TUPLES		UINT64CONST(0xFFFFFFFFFFF00002)
+
+typedef struct LVSharedIndStats
+{
+	Oid			indexoid;		/* index to vacuum */
+	bool		updated;		/* is stats valid? */
+	IndexBulkDeleteResult stats;
+} LVSharedIndStats;
+
+typedef struct LVShared
+{
+	Oid			relid;			/* heap being vacuumed */
+	int			elevel;
+	double		old_live_tuples;
+	int			num_dead_tuples;	/* # of entries of the DSM tuple array */
+	bool		for_cleanup;	/* cleanup round rather than bulk-delete? */
+	double		reltuples;		/* heap tuple estimate for the cleanup */
+	bool		estimated_count;	/* is reltuples an estimate? */
+	int			nindexes;
+	pg_atomic_uint32 nextidx;	/* next index to hand out in this round */
+	pg_atomic_uint32 cost_balance;	/* shared vacuum cost balance */
+	pg_atomic_uint32 active_nworkers;	/* # of processes in this round */
+	LVSharedIndStats indstats[FLEXIBLE_ARRAY_MEMBER];
+} LVShared;
+
+typedef struct LVParallelState
+{
+	ParallelContext *pcxt;
+	LVShared   *lvshared;
+	int			nrounds;		/* # of bulk-delete rounds so far */
+} LVParallelState;
+#endif
+
 int	gts_maintain_option;
 
 static void PrintData(RelFileNode *rnode,
@@ -171,12 +220,18 @@ static void lazy_vacuum_index(Relation indrel,
 static void lazy_cleanup_index(Relation indrel,
                    IndexBulkDeleteResult *stats,
                    LVRelStats *vacrelstats);
+static IndexBulkDeleteResult *lazy_index_vacuum_cleanup(Relation indrel,
+                   IndexBulkDeleteResult *stats,
+                   double reltuples, bool estimated_count);
+static void lazy_update_index_stats(Relation indrel,
+                   IndexBulkDeleteResult *stats, PGRUsage *ru0);
 static int lazy_vacuum_page(Relation onerel, BlockNumber blkno, Buffer buffer,
                  int tupindex, LVRelStats *vacrelstats, Buffer *vmbuffer);
 static bool should_attempt_truncation(LVRelStats *vacrelstats);
 static void lazy_truncate_heap(Relation onerel, LVRelStats *vacrelstats);
 static BlockNumber count_nondeletable_pages(Relation onerel,
                          LVRelStats *vacrelstats);
+static long compute_max_dead_tuples(BlockNumber relblocks, bool hasindex);
 static void lazy_space_alloc(LVRelStats *vacrelstats, BlockNumber relblocks);
 static void lazy_record_dead_tuple(LVRelStats *vacrelstats,
                        ItemPointer itemptr);
@@ -184,6 +239,25 @@ static bool lazy_tid_reaped(ItemPointer itemptr, void *state);
 static int    vac_cmp_itemptr(const void *left, const void *right);
 static bool heap_page_is_all_visible(Relation rel, Buffer buf,
                          TransactionId *visibility_cutoff_xid, bool *all_frozen);
+#ifdef __OPENTENBASE__
+static void lazy_vacuum_all_indexes(Relation *Irel,
+						IndexBulkDeleteResult **indstats,
+						LVRelStats *vacrelstats, int nindexes,
+						LVParallelState *lps);
+static LVParallelState *begin_parallel_vacuum(Relation onerel,
+					  LVRelStats *vacrelstats, Relation *Irel,
+					  int nindexes, BlockNumber nblocks);
+static void end_parallel_vacuum(LVParallelState *lps, LVRelStats *vacrelstats,
+					IndexBulkDeleteResult **indstats, int nindexes);
+static void lazy_cleanup_all_indexes(Relation *Irel,
+						 IndexBulkDeleteResult **indstats,
+						 LVRelStats *vacrelstats, int nindexes,
+						 LVParallelState *lps);
+static void parallel_vacuum_round(Relation *Irel, LVRelStats *vacrelstats,
+					  LVParallelState *lps, bool for_cleanup);
+static void parallel_vacuum_indexes(Relation *Irel, LVShared *lvshared,
+						LVRelStats *vacrelstats);
+#endif
 
 #ifdef __OPENTENBASE__
 static void 
@@ -614,6 +688,9 @@ lazy_scan_heap(Relation onerel, int options, LVRelStats *vacrelstats,
     bool        skipping_blocks;
     xl_heap_freeze_tuple *frozen;
     StringInfoData buf;
+#ifdef __OPENTENBASE__
+	LVParallelState *lps = NULL;
+#endif
     const int    initprog_index[] = {
         PROGRESS_VACUUM_PHASE,
         PROGRESS_VACUUM_TOTAL_HEAP_BLKS,
@@ -642,6 +719,19 @@ lazy_scan_heap(Relation onerel, int options, LVRelStats *vacrelstats,
     vacrelstats->nonempty_pages = 0;
     vacrelstats->latestRemovedXid = InvalidTransactionId;
 
+#ifdef __OPENTENBASE__
+	/*
+	 * With the PARALLEL option, vacuum the indexes using parallel workers.
+	 * There is nothing to share with fewer than two indexes, and workers
+	 * cannot see our local buffers, so temp tables stay serial.
+	 */
+	if ((options & VACOPT_PARALLEL) != 0 && nindexes > 1 &&
+		max_parallel_maintenance_workers > 0 &&
+		!RELATION_IS_LOCAL(onerel) && !IsInParallelMode())
+		lps = begin_parallel_vacuum(onerel, vacrelstats, Irel, nindexes,
+									nblocks);
+	if (lps == NULL)
+#endif
     lazy_space_alloc(vacrelstats, nblocks);
     frozen = palloc(sizeof(xl_heap_freeze_tuple) * MaxHeapTuplesPerPage);
 
@@ -855,10 +945,15 @@ lazy_scan_heap(Relation onerel, int options, LVRelStats *vacrelstats,
                                          PROGRESS_VACUUM_PHASE_VACUUM_INDEX);
 
             /* Remove index entries */
+#ifdef __OPENTENBASE__
+			lazy_vacuum_all_indexes(Irel, indstats, vacrelstats, nindexes,
+									lps);
+#else
             for (i = 0; i < nindexes; i++)
                 lazy_vacuum_index(Irel[i],
                                   &indstats[i],
                                   vacrelstats);
+#endif
 
             /*
              * Report that we are now vacuuming the heap.  We also increase
@@ -1520,10 +1615,14 @@ lazy_scan_heap(Relation onerel, int options, LVRelStats *vacrelstats,
                                      PROGRESS_VACUUM_PHASE_VACUUM_INDEX);
 
         /* Remove index entries */
+#ifdef __OPENTENBASE__
+		lazy_vacuum_all_indexes(Irel, indstats, vacrelstats, nindexes, lps);
+#else
         for (i = 0; i < nindexes; i++)
             lazy_vacuum_index(Irel[i],
                               &indstats[i],
                               vacrelstats);
+#endif
 
         /* Report that we are now vacuuming the heap */
         hvp_val[0] = PROGRESS_VACUUM_PHASE_VACUUM_HEAP;
@@ -1543,6 +1642,11 @@ lazy_scan_heap(Relation onerel, int options, LVRelStats *vacrelstats,
                                  PROGRESS_VACUUM_PHASE_INDEX_CLEANUP);
 
     /* Do post-vacuum cleanup and statistics update for each index */
+#ifdef __OPENTENBASE__
+	if (lps != NULL)
+		lazy_cleanup_all_indexes(Irel, indstats, vacrelstats, nindexes, lps);
+	else
+#endif
     for (i = 0; i < nindexes; i++)
         lazy_cleanup_index(Irel[i], indstats[i], vacrelstats);
 
@@ -1859,29 +1963,54 @@ lazy_cleanup_index(Relation indrel,
                    IndexBulkDeleteResult *stats,
                    LVRelStats *vacrelstats)
 {
-    IndexVacuumInfo ivinfo;
     PGRUsage    ru0;
 
     pg_rusage_init(&ru0);
 
-    ivinfo.index = indrel;
-    ivinfo.analyze_only = false;
-    ivinfo.estimated_count = (vacrelstats->tupcount_pages < vacrelstats->rel_pages);
-    ivinfo.message_level = elevel;
-
 	/*
 	 * Now we can provide a better estimate of total number of surviving
 	 * tuples (we assume indexes are more interested in that than in the
 	 * number of nominally live tuples).
 	 */
-    ivinfo.num_heap_tuples = vacrelstats->new_rel_tuples;
-    ivinfo.strategy = vac_strategy;
-
-    stats = index_vacuum_cleanup(&ivinfo, stats);
+    stats = lazy_index_vacuum_cleanup(indrel, stats,
+                                      vacrelstats->new_rel_tuples,
+                                      vacrelstats->tupcount_pages < vacrelstats->rel_pages);
 
     if (!stats)
         return;
 
+    lazy_update_index_stats(indrel, stats, &ru0);
+
+    pfree(stats);
+}
+
+/*
+ *    lazy_index_vacuum_cleanup() -- run the index AM's cleanup for one index.
+ */
+static IndexBulkDeleteResult *
+lazy_index_vacuum_cleanup(Relation indrel, IndexBulkDeleteResult *stats,
+                          double reltuples, bool estimated_count)
+{
+    IndexVacuumInfo ivinfo;
+
+    ivinfo.index = indrel;
+    ivinfo.analyze_only = false;
+    ivinfo.estimated_count = estimated_count;
+    ivinfo.message_level = elevel;
+    ivinfo.num_heap_tuples = reltuples;
+    ivinfo.strategy = vac_strategy;
+
+    return index_vacuum_cleanup(&ivinfo, stats);
+}
+
+/*
+ *    lazy_update_index_stats() -- store and report the cleanup results of
+ *    one index.
+ */
+static void
+lazy_update_index_stats(Relation indrel, IndexBulkDeleteResult *stats,
+                        PGRUsage *ru0)
+{
     /*
      * Now update statistics in pg_class, but only if the index says the count
      * is accurate.
@@ -1906,10 +2035,310 @@ lazy_cleanup_index(Relation indrel,
                        "%s.",
                        stats->tuples_removed,
                        stats->pages_deleted, stats->pages_free,
-                       pg_rusage_show(&ru0))));
+                       pg_rusage_show(ru0))));
+}
 
-    pfree(stats);
+#ifdef __OPENTENBASE__
+/*
+ *	lazy_vacuum_all_indexes() -- remove the dead tuples from all indexes.
+ *
+ *		Without a parallel context this is the plain serial loop.  Otherwise
+ *		the workers are launched for one round and the leader takes its share
+ *		of the indexes before waiting for them.
+ */
+static void
+lazy_vacuum_all_indexes(Relation *Irel, IndexBulkDeleteResult **indstats,
+						LVRelStats *vacrelstats, int nindexes,
+						LVParallelState *lps)
+{
+	int			i;
+
+	if (lps == NULL)
+	{
+		for (i = 0; i < nindexes; i++)
+			lazy_vacuum_index(Irel[i], &indstats[i], vacrelstats);
+		return;
+	}
+
+	parallel_vacuum_round(Irel, vacrelstats, lps, false);
+}
+
+/*
+ *	lazy_cleanup_all_indexes() -- clean up all indexes in parallel.
+ *
+ *		The index AM cleanup runs in the leader and the workers.  The
+ *		statistics are then copied out of the segment, which is released,
+ *		and the leader stores them in pg_class.
+ */
+static void
+lazy_cleanup_all_indexes(Relation *Irel, IndexBulkDeleteResult **indstats,
+						 LVRelStats *vacrelstats, int nindexes,
+						 LVParallelState *lps)
+{
+	PGRUsage	ru0;
+	int			i;
+
+	pg_rusage_init(&ru0);
+
+	parallel_vacuum_round(Irel, vacrelstats, lps, true);
+	end_parallel_vacuum(lps, vacrelstats, indstats, nindexes);
+
+	for (i = 0; i < nindexes; i++)
+	{
+		if (indstats[i] == NULL)
+			continue;
+
+		lazy_update_index_stats(Irel[i], indstats[i], &ru0);
+		pfree(indstats[i]);
+		indstats[i] = NULL;
+	}
+}
+
+/*
+ * parallel_vacuum_round - run one bulk-delete or cleanup round
+ *
+ * While the round runs, the leader's cost balance goes into the shared one
+ * and vacuum_delay_point draws on that; what is left of it afterwards is
+ * taken back.
+ */
+static void
+parallel_vacuum_round(Relation *Irel, LVRelStats *vacrelstats,
+					  LVParallelState *lps, bool for_cleanup)
+{
+	LVShared   *lvshared = lps->lvshared;
+
+	lvshared->for_cleanup = for_cleanup;
+	lvshared->num_dead_tuples = vacrelstats->num_dead_tuples;
+	lvshared->reltuples = vacrelstats->new_rel_tuples;
+	lvshared->estimated_count =
+		(vacrelstats->tupcount_pages < vacrelstats->rel_pages);
+	pg_atomic_write_u32(&lvshared->nextidx, 0);
+	pg_atomic_write_u32(&lvshared->cost_balance, VacuumCostBalance);
+	pg_atomic_write_u32(&lvshared->active_nworkers, 0);
+
+	if (lps->nrounds > 0)
+		ReinitializeParallelDSM(lps->pcxt);
+	LaunchParallelWorkers(lps->pcxt);
+
+	if (for_cleanup)
+		ereport(elevel,
+				(errmsg("launched %d parallel vacuum workers for index cleanup (planned: %d)",
+						lps->pcxt->nworkers_launched, lps->pcxt->nworkers)));
+	else
+		ereport(elevel,
+				(errmsg("launched %d parallel vacuum workers for index vacuuming (planned: %d)",
+						lps->pcxt->nworkers_launched, lps->pcxt->nworkers)));
+
+	VacuumSharedCostBalance = &lvshared->cost_balance;
+	VacuumActiveNWorkers = &lvshared->active_nworkers;
+	VacuumCostBalanceLocal = 0;
+
+	parallel_vacuum_indexes(Irel, lvshared, vacrelstats);
+
+	WaitForParallelWorkersToFinish(lps->pcxt);
+
+	VacuumCostBalance = pg_atomic_read_u32(&lvshared->cost_balance);
+	VacuumSharedCostBalance = NULL;
+	VacuumActiveNWorkers = NULL;
+	VacuumCostBalanceLocal = 0;
+
+	lps->nrounds++;
+}
+
+/*
+ * parallel_vacuum_indexes - claim indexes one at a time and process them
+ *
+ * Run by the leader and by every worker until all indexes of the current
+ * round are handed out.  Irel must be in the order of lvshared->indstats.
+ */
+static void
+parallel_vacuum_indexes(Relation *Irel, LVShared *lvshared,
+						LVRelStats *vacrelstats)
+{
+	/* Count ourselves in for the cost-based delay */
+	pg_atomic_add_fetch_u32(&lvshared->active_nworkers, 1);
+
+	for (;;)
+	{
+		LVSharedIndStats *shared_indstats;
+		IndexBulkDeleteResult *stats;
+		uint32		idx;
+
+		idx = pg_atomic_fetch_add_u32(&lvshared->nextidx, 1);
+		if (idx >= lvshared->nindexes)
+			break;
+
+		shared_indstats = &lvshared->indstats[idx];
+		stats = shared_indstats->updated ? &shared_indstats->stats : NULL;
+
+		if (lvshared->for_cleanup)
+			stats = lazy_index_vacuum_cleanup(Irel[idx], stats,
+											  lvshared->reltuples,
+											  lvshared->estimated_count);
+		else
+			lazy_vacuum_index(Irel[idx], &stats, vacrelstats);
+
+		/* Keep the result in the segment for the following rounds */
+		if (stats == NULL)
+			shared_indstats->updated = false;
+		else if (stats != &shared_indstats->stats)
+		{
+			memcpy(&shared_indstats->stats, stats,
+				   sizeof(IndexBulkDeleteResult));
+			shared_indstats->updated = true;
+			pfree(stats);
+		}
+	}
+
+	pg_atomic_sub_fetch_u32(&lvshared->active_nworkers, 1);
+}
+
+/*
+ * begin_parallel_vacuum - set up the parallel context for index vacuuming
+ *
+ * The dead tuple array is allocated in the DSM segment instead of local
+ * memory, so vacrelstats is set up here rather than by lazy_space_alloc.
+ */
+static LVParallelState *
+begin_parallel_vacuum(Relation onerel, LVRelStats *vacrelstats,
+					  Relation *Irel, int nindexes, BlockNumber nblocks)
+{
+	LVParallelState *lps;
+	ParallelContext *pcxt;
+	LVShared   *lvshared;
+	ItemPointer dead_tuples;
+	long		maxtuples;
+	Size		est_shared;
+	Size		est_dead_tuples;
+	int			nworkers;
+	int			i;
+
+	/* The leader vacuums indexes as well, so one worker less is enough */
+	nworkers = Min(nindexes - 1, max_parallel_maintenance_workers);
+
+	maxtuples = compute_max_dead_tuples(nblocks, true);
+	est_shared = add_size(offsetof(LVShared, indstats),
+						  mul_size(sizeof(LVSharedIndStats), nindexes));
+	est_dead_tuples = mul_size(sizeof(ItemPointerData), maxtuples);
+
+	EnterParallelMode();
+	pcxt = CreateParallelContext("postgres", "parallel_vacuum_main",
+								 nworkers);
+	shm_toc_estimate_chunk(&pcxt->estimator, est_shared);
+	shm_toc_estimate_chunk(&pcxt->estimator, est_dead_tuples);
+	shm_toc_estimate_keys(&pcxt->estimator, 2);
+	InitializeParallelDSM(pcxt);
+
+	lvshared = (LVShared *) shm_toc_allocate(pcxt->toc, est_shared);
+	MemSet(lvshared, 0, est_shared);
+	lvshared->relid = RelationGetRelid(onerel);
+	lvshared->elevel = elevel;
+	lvshared->old_live_tuples = vacrelstats->old_live_tuples;
+	lvshared->nindexes = nindexes;
+	pg_atomic_init_u32(&lvshared->nextidx, 0);
+	pg_atomic_init_u32(&lvshared->cost_balance, 0);
+	pg_atomic_init_u32(&lvshared->active_nworkers, 0);
+	for (i = 0; i < nindexes; i++)
+		lvshared->indstats[i].indexoid = RelationGetRelid(Irel[i]);
+	shm_toc_insert(pcxt->toc, PARALLEL_VACUUM_KEY_SHARED, lvshared);
+
+	dead_tuples = (ItemPointer) shm_toc_allocate(pcxt->toc, est_dead_tuples);
+	shm_toc_insert(pcxt->toc, PARALLEL_VACUUM_KEY_DEAD_TUPLES, dead_tuples);
+
+	vacrelstats->num_dead_tuples = 0;
+	vacrelstats->max_dead_tuples = (int) maxtuples;
+	vacrelstats->dead_tuples = dead_tuples;
+
+	lps = (LVParallelState *) palloc0(sizeof(LVParallelState));
+	lps->pcxt = pcxt;
+	lps->lvshared = lvshared;
+
+	return lps;
+}
+
+/*
+ * end_parallel_vacuum - copy the index statistics out and tear down
+ *
+ * The dead tuple array goes away with the segment, so this must only be
+ * called once the last round is done.
+ */
+static void
+end_parallel_vacuum(LVParallelState *lps, LVRelStats *vacrelstats,
+					IndexBulkDeleteResult **indstats, int nindexes)
+{
+	int			i;
+
+	for (i = 0; i < nindexes; i++)
+	{
+		LVSharedIndStats *shared_indstats = &lps->lvshared->indstats[i];
+
+		if (!shared_indstats->updated)
+			continue;
+
+		indstats[i] = (IndexBulkDeleteResult *)
+			palloc(sizeof(IndexBulkDeleteResult));
+		memcpy(indstats[i], &shared_indstats->stats,
+			   sizeof(IndexBulkDeleteResult));
+	}
+
+	vacrelstats->num_dead_tuples = 0;
+	vacrelstats->max_dead_tuples = 0;
+	vacrelstats->dead_tuples = NULL;
+
+	DestroyParallelContext(lps->pcxt);
+	ExitParallelMode();
+	pfree(lps);
+}
+
+/*
+ * parallel_vacuum_main - entry point of a parallel index vacuum worker
+ *
+ * The leader holds ShareUpdateExclusiveLock on the heap; as a member of its
+ * lock group we can take the same lock without waiting.
+ */
+void
+parallel_vacuum_main(dsm_segment *seg, shm_toc *toc)
+{
+	LVShared   *lvshared;
+	LVRelStats	vacrelstats;
+	Relation	onerel;
+	Relation   *Irel;
+	int			i;
+
+	lvshared = (LVShared *) shm_toc_lookup(toc, PARALLEL_VACUUM_KEY_SHARED,
+										   false);
+	elevel = lvshared->elevel;
+
+	onerel = heap_open(lvshared->relid, ShareUpdateExclusiveLock);
+	Irel = (Relation *) palloc(sizeof(Relation) * lvshared->nindexes);
+	for (i = 0; i < lvshared->nindexes; i++)
+		Irel[i] = index_open(lvshared->indstats[i].indexoid,
+							 RowExclusiveLock);
+
+	MemSet(&vacrelstats, 0, sizeof(LVRelStats));
+	vacrelstats.hasindex = true;
+	vacrelstats.old_live_tuples = lvshared->old_live_tuples;
+	vacrelstats.num_dead_tuples = lvshared->num_dead_tuples;
+	vacrelstats.max_dead_tuples = lvshared->num_dead_tuples;
+	vacrelstats.dead_tuples = (ItemPointer)
+		shm_toc_lookup(toc, PARALLEL_VACUUM_KEY_DEAD_TUPLES, false);
+
+	vac_strategy = GetAccessStrategy(BAS_VACUUM);
+
+	/* Throttle against the leader's cost limit, shared by all processes */
+	VacuumCostActive = (VacuumCostDelay > 0);
+	VacuumCostBalance = 0;
+	VacuumCostBalanceLocal = 0;
+	VacuumSharedCostBalance = &lvshared->cost_balance;
+	VacuumActiveNWorkers = &lvshared->active_nworkers;
+
+	parallel_vacuum_indexes(Irel, lvshared, &vacrelstats);
+
+	vac_close_indexes(lvshared->nindexes, Irel, RowExclusiveLock);
+	heap_close(onerel, ShareUpdateExclusiveLock);
+	FreeAccessStrategy(vac_strategy);
 }
+#endif
 
 /*
  * should_attempt_truncation - should we attempt to truncate the heap?
@@ -2227,13 +2656,30 @@ count_nondeletable_pages(Relation onerel, LVRelStats *vacrelstats)
  */
 static void
 lazy_space_alloc(LVRelStats *vacrelstats, BlockNumber relblocks)
+{
+    long        maxtuples;
+
+    maxtuples = compute_max_dead_tuples(relblocks, vacrelstats->hasindex);
+
+    vacrelstats->num_dead_tuples = 0;
+    vacrelstats->max_dead_tuples = (int) maxtuples;
+    vacrelstats->dead_tuples = (ItemPointer)
+        palloc(maxtuples * sizeof(ItemPointerData));
+}
+
+/*
+ * compute_max_dead_tuples - how many dead tuple TIDs fit in the vacuum
+ * memory budget
+ */
+static long
+compute_max_dead_tuples(BlockNumber relblocks, bool hasindex)
 {
     long        maxtuples;
     int            vac_work_mem = IsAutoVacuumWorkerProcess() &&
     autovacuum_work_mem != -1 ?
     autovacuum_work_mem : maintenance_work_mem;
 
-    if (vacrelstats->hasindex)
+    if (hasindex)
     {
         maxtuples = (vac_work_mem * 1024L) / sizeof(ItemPointerData);
         maxtuples = Min(maxtuples, INT_MAX);
@@ -2251,10 +2697,7 @@ lazy_space_alloc(LVRelStats *vacrelstats, BlockNumber relblocks)
         maxtuples = MaxHeapTuplesPerPage;
     }
 
-    vacrelstats->num_dead_tuples = 0;
-    vacrelstats->max_dead_tuples = (int) maxtuples;
-    vacrelstats->dead_tuples = (ItemPointer)
-        palloc(maxtuples * sizeof(ItemPointerData));
+    return maxtuples;
 }
 
 /*
@@ -2637,6 +3080,135 @@ truncate_extent_tuples(Relation onerel,
     vac_strategy = NULL;
 }
 
+/*
+ * Remove the index entries of all tuples in a set of extents.
+ *
+ * Unlike truncate_extent_tuples, which pays one pass over every index per
+ * extent, the TIDs of all extents are gathered first and each index is
+ * bulk-deleted once, or once per maintenance_work_mem worth of TIDs. eids
+ * must be sorted so that the TIDs are recorded in order. The pages are only
+ * dropped from the free space and visibility maps; releasing the storage is
+ * up to the caller. Returns the number of tuples found.
+ */
+int64
+truncate_extents_index_tuples(Relation onerel, ExtentID *eids, int neids)
+{
+    LVRelStats *vacrelstats;
+    int         nindexes;
+    Relation   *Irel = NULL;
+    IndexBulkDeleteResult **indstats;
+    BufferAccessStrategy trun_strategy;
+    int64       tuples = 0;
+    int         i;
+    int         e;
+
+    vacrelstats = (LVRelStats *) palloc0(sizeof(LVRelStats));
+    vacrelstats->old_rel_pages = onerel->rd_rel->relpages;
+    vacrelstats->old_live_tuples = onerel->rd_rel->reltuples;
+    vacrelstats->latestRemovedXid = InvalidTransactionId;
+
+    vac_open_indexes(onerel, RowExclusiveLock, &nindexes, &Irel);
+    vacrelstats->hasindex = (nindexes > 0);
+
+    lazy_space_alloc(vacrelstats, (BlockNumber) neids * PAGES_PER_EXTENTS);
+
+    indstats = (IndexBulkDeleteResult **)
+        palloc0(nindexes * sizeof(IndexBulkDeleteResult *));
+
+    trun_strategy = GetAccessStrategy(BAS_VACUUM);
+    vac_strategy = trun_strategy;
+
+    for (e = 0; e < neids; e++)
+    {
+        BlockNumber from_blk = eids[e] * PAGES_PER_EXTENTS;
+        BlockNumber to_blk = (eids[e] + 1) * PAGES_PER_EXTENTS;
+        BlockNumber blkno;
+
+        for (blkno = from_blk; blkno < to_blk; blkno++)
+        {
+            Buffer        buf;
+            Page        page;
+            OffsetNumber offnum,
+                        maxoff;
+
+            if (vacrelstats->max_dead_tuples - vacrelstats->num_dead_tuples <
+                MaxHeapTuplesPerPage)
+            {
+                tuples += vacrelstats->num_dead_tuples;
+                for (i = 0; i < nindexes; i++)
+                    lazy_vacuum_index(Irel[i], &indstats[i], vacrelstats);
+                vacrelstats->num_dead_tuples = 0;
+            }
+
+            vacuum_delay_point();
+
+            buf = ReadBufferExtended(onerel, MAIN_FORKNUM, blkno,
+                                     RBM_NORMAL, trun_strategy);
+            LockBuffer(buf, BUFFER_LOCK_SHARE);
+            page = BufferGetPage(buf);
+
+            if (PageIsNew(page) || PageIsEmpty(page))
+            {
+                UnlockReleaseBuffer(buf);
+                continue;
+            }
+
+            maxoff = PageGetMaxOffsetNumber(page);
+            for (offnum = FirstOffsetNumber;
+                 offnum <= maxoff;
+                 offnum = OffsetNumberNext(offnum))
+            {
+                ItemId        itemid = PageGetItemId(page, offnum);
+                ItemPointerData tid;
+
+                if (!ItemIdIsUsed(itemid))
+                    continue;
+
+                /* heap-only tuples have no index entries of their own */
+                if (ItemIdIsNormal(itemid) &&
+                    HeapTupleHeaderIsHeapOnly((HeapTupleHeader) PageGetItem(page, itemid)))
+                    continue;
+
+                ItemPointerSet(&tid, blkno, offnum);
+                lazy_record_dead_tuple(vacrelstats, &tid);
+            }
+
+            UnlockReleaseBuffer(buf);
+        }
+    }
+
+    if (vacrelstats->num_dead_tuples > 0)
+    {
+        tuples += vacrelstats->num_dead_tuples;
+        for (i = 0; i < nindexes; i++)
+            lazy_vacuum_index(Irel[i], &indstats[i], vacrelstats);
+        vacrelstats->num_dead_tuples = 0;
+    }
+
+    for (e = 0; e < neids; e++)
+    {
+        BlockNumber from_blk = eids[e] * PAGES_PER_EXTENTS;
+        BlockNumber to_blk = (eids[e] + 1) * PAGES_PER_EXTENTS;
+        BlockNumber blkno;
+
+        for (blkno = from_blk; blkno < to_blk; blkno++)
+            RecordPageWithFreeSpace(onerel, blkno, BLCKSZ - 1);
+        UpdateFreeSpaceMap(onerel, from_blk, to_blk - 1, BLCKSZ - 1);
+        visibilitymap_batch_clear(onerel, from_blk, to_blk - 1);
+    }
+
+    vac_close_indexes(nindexes, Irel, NoLock);
+
+    FreeAccessStrategy(trun_strategy);
+    vac_strategy = NULL;
+
+    pfree(vacrelstats->dead_tuples);
+    pfree(vacrelstats);
+    pfree(indstats);
+
+    return tuples;
+}
+
 void
 reinit_extent_pages(Relation rel, ExtentID eid)
 {
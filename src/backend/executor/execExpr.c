@@ -36,6 +36,9 @@
 #include "executor/execExpr.h"
 #include "executor/nodeSubplan.h"
 #include "funcapi.h"
+#ifdef __OPENTENBASE__
+#include "jit/jit.h"
+#endif
 #include "miscadmin.h"
 #include "nodes/makefuncs.h"
 #include "nodes/nodeFuncs.h"
@@ -122,6 +125,9 @@ ExecInitExpr(Expr *node, PlanState *parent)
     /* Initialize ExprState with empty step list */
     state = makeNode(ExprState);
     state->expr = node;
+#ifdef __OPENTENBASE__
+    state->parent = parent;
+#endif
 
     /* Insert EEOP_*_FETCHSOME steps as needed */
     ExecInitExprSlots(state, (Node *) node);
@@ -172,6 +178,9 @@ ExecInitQual(List *qual, PlanState *parent)
 
     state = makeNode(ExprState);
     state->expr = (Expr *) qual;
+#ifdef __OPENTENBASE__
+    state->parent = parent;
+#endif
     /* mark expression as to be used with ExecQual() */
     state->flags = EEO_FLAG_IS_QUAL;
 
@@ -315,6 +324,9 @@ ExecBuildProjectionInfo(List *targetList,
     state = &projInfo->pi_state;
     state->expr = (Expr *) targetList;
     state->resultslot = slot;
+#ifdef __OPENTENBASE__
+    state->parent = parent;
+#endif
 
     /* Insert EEOP_*_FETCHSOME steps as needed */
     ExecInitExprSlots(state, (Node *) targetList);
@@ -573,6 +585,11 @@ ExecCheck(ExprState *state, ExprContext *econtext)
 static void
 ExecReadyExpr(ExprState *state)
 {
+#ifdef __OPENTENBASE__
+    if (jit_compile_expr(state))
+        return;
+#endif
+
     ExecReadyInterpretedExpr(state);
 }
 
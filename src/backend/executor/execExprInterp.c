@@ -131,7 +131,9 @@ static Datum ExecInterpExpr(ExprState *state, ExprContext *econtext, bool *isnul
 static void ExecInitInterpreter(void);
 
 /* support functions */
+#ifndef __OPENTENBASE__
 static void CheckVarSlotCompatibility(TupleTableSlot *slot, int attnum, Oid vartype);
+#endif
 static TupleDesc get_cached_rowtype(Oid type_id, int32 typmod,
                    TupleDesc *cache_field, ExprContext *econtext);
 static void ShutdownTupleDescRef(Datum arg);
@@ -1524,7 +1526,10 @@ out:
  * expression.  This should succeed unless there have been schema changes
  * since the expression tree has been created.
  */
-static void
+#ifndef __OPENTENBASE__
+static
+#endif
+void
 CheckVarSlotCompatibility(TupleTableSlot *slot, int attnum, Oid vartype)
 {
     /*
@@ -973,6 +973,9 @@ InitPlan(QueryDesc *queryDesc, int eflags)
      */
     estate->es_range_table = rangeTable;
     estate->es_plannedstmt = plannedstmt;
+#ifdef __OPENTENBASE__
+    estate->es_jit_flags = plannedstmt->jitFlags;
+#endif
 
     /*
      * initialize result relation stuff, and open/lock the result rels.
@@ -244,6 +244,9 @@ ExecSerializePlan(Plan *plan, EState *estate)
     pstmt->utilityStmt = NULL;
     pstmt->stmt_location = -1;
     pstmt->stmt_len = -1;
+#ifdef __OPENTENBASE__
+    pstmt->jitFlags = estate->es_plannedstmt->jitFlags;
+#endif
 
     /* Return serialized copy of our dummy PlannedStmt. */
     return nodeToString(pstmt);
@@ -58,6 +58,7 @@
 #include "utils/rel.h"
 #include "utils/typcache.h"
 #ifdef __OPENTENBASE__
+#include "jit/jit.h"
 #include "utils/ruleutils.h"
 #endif
 
@@ -162,6 +163,11 @@ CreateExecutorState(void)
     estate->es_remote_subplan_num = 0;
 #endif
 
+#ifdef __OPENTENBASE__
+    estate->es_jit_flags = 0;
+    estate->es_jit = NULL;
+#endif
+
     /*
      * Return the executor state structure
      */
@@ -205,6 +211,15 @@ FreeExecutorState(EState *estate)
         /* FreeExprContext removed the list link for us */
     }
 
+#ifdef __OPENTENBASE__
+    /* release JIT context, if allocated */
+    if (estate->es_jit)
+    {
+        jit_release_context(estate->es_jit);
+        estate->es_jit = NULL;
+    }
+#endif
+
     /*
      * Free the per-query memory context, thereby releasing all working
      * memory, including the EState node itself.
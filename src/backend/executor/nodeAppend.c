@@ -20,6 +20,7 @@
  *        ExecAppend        - retrieve the next tuple from the node
  *        ExecEndAppend    - shut down the append node
  *        ExecReScanAppend - rescan the append node
+ *        ExecIntervalPruning - prune interval partitions by param values
  *
  *     NOTES
  *        Each append node contains a list of one or more subplans which
@@ -63,9 +64,60 @@
 #include "executor/execdebug.h"
 #include "executor/nodeAppend.h"
 #include "miscadmin.h"
+#ifdef __OPENTENBASE__
+#include "access/heapam.h"
+#include "access/stratnum.h"
+#include "catalog/pg_type.h"
+#include "nodes/makefuncs.h"
+#include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
+#include "optimizer/var.h"
+#include "parser/parsetree.h"
+#include "utils/builtins.h"
+#include "utils/datum.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/rel.h"
+#include "utils/ruleutils.h"
+#include "utils/timestamp.h"
+#include "utils/typcache.h"
+
+/*
+ * A timestamptz value is turned into a timestamp in the session time zone,
+ * the way the cross-type operators compare a timestamp with it.  The offset
+ * of the time zone may differ at the time compared, which is less than two
+ * days apart though.
+ */
+#define INTERVAL_PRUNE_TZ_MARGIN    (2 * USECS_PER_DAY)
+
+/* expression computing a param value, prepared once */
+typedef struct IntervalPruneExpr
+{
+    Node       *expr;            /* expression of the pruning qual */
+    ExprState  *exprstate;
+} IntervalPruneExpr;
+
+typedef struct IntervalPruneContext
+{
+    PlanState  *parent;            /* node the quals belong to */
+    List       *pruneexprs;        /* IntervalPruneExprs of the quals */
+    bool        failed;            /* a param could not be turned into a Const */
+} IntervalPruneContext;
+#endif
 
 static TupleTableSlot *ExecAppend(PlanState *pstate);
 static bool exec_append_initialize_next(AppendState *appendstate);
+#ifdef __OPENTENBASE__
+static void exec_append_prune(AppendState *node);
+static bool interval_prune_params_walker(Node *node, void *context);
+static bool interval_prune_is_param_expr(Node *node);
+static bool interval_prune_init_walker(Node *node, IntervalPruneContext *context);
+static bool interval_prune_eval(Node *node, IntervalPruneContext *context,
+                    Datum *value);
+static Node *interval_prune_timestamptz(OpExpr *opexpr,
+                    IntervalPruneContext *context);
+static Node *interval_prune_mutator(Node *node, IntervalPruneContext *context);
+#endif
 
 
 /* ----------------------------------------------------------------
@@ -129,6 +181,11 @@ ExecInitAppend(Append *node, EState *estate, int eflags)
     int            nplans;
     int            i;
     ListCell   *lc;
+#ifdef __OPENTENBASE__
+    Bitmapset  *validchildren = NULL;
+    bool        startup_pruned = false;
+    bool        runtime_pruning = false;
+#endif
 
     /* check for unsupported flags */
     Assert(!(eflags & EXEC_FLAG_MARK));
@@ -168,6 +225,34 @@ ExecInitAppend(Append *node, EState *estate, int eflags)
      */
     ExecInitResultTupleSlot(estate, &appendstate->ps);
 
+#ifdef __OPENTENBASE__
+    /*
+     * Children of an interval partitioned table may be pruned by quals
+     * comparing the partition key with params.  Params known at startup
+     * prune children before they are initialized at all; PARAM_EXEC params
+     * are only set during execution, so those prune again on every rescan.
+     */
+    if (node->interval && node->partprunequals != NIL)
+    {
+        ExecAssignExprContext(estate, &appendstate->ps);
+        appendstate->as_prunecxt =
+            AllocSetContextCreate(CurrentMemoryContext,
+                                  "Append run-time pruning",
+                                  ALLOCSET_SMALL_SIZES);
+        appendstate->as_pruneexprs =
+            ExecInitIntervalPruning(&appendstate->ps, node->partprunequals);
+        startup_pruned = ExecIntervalPruning(&appendstate->ps,
+                                             node->partprunequals,
+                                             appendstate->as_pruneexprs,
+                                             node->appendplans,
+                                             true,
+                                             appendstate->as_prunecxt,
+                                             &validchildren);
+        runtime_pruning =
+            ExecIntervalPruneHasExecParams(node->partprunequals);
+    }
+#endif
+
     /*
      * call ExecInitNode on each of the plans to be executed and save the
      * results into the array "appendplans".
@@ -176,8 +261,18 @@ ExecInitAppend(Append *node, EState *estate, int eflags)
     foreach(lc, node->appendplans)
     {
         Plan       *initNode = (Plan *) lfirst(lc);
+		PlanState  *ret;
 
-		PlanState *ret = ExecInitNode(initNode, estate, eflags);
+#ifdef __OPENTENBASE__
+        if (startup_pruned &&
+            !bms_is_member(((Scan *) initNode)->childidx, validchildren))
+        {
+            appendstate->as_nremoved++;
+            continue;
+        }
+#endif
+
+		ret = ExecInitNode(initNode, estate, eflags);
 		if (ret)
 		{
 			appendplanstates[i] = ret;
@@ -186,6 +281,15 @@ ExecInitAppend(Append *node, EState *estate, int eflags)
     }
 	appendstate->as_nplans = i;
 
+#ifdef __OPENTENBASE__
+    if (runtime_pruning && appendstate->as_nplans > 0)
+    {
+        appendstate->as_pruned =
+            (bool *) palloc0(appendstate->as_nplans * sizeof(bool));
+        appendstate->as_prune_pending = true;
+    }
+#endif
+
     /*
      * initialize output tuple type
      */
@@ -212,6 +316,15 @@ ExecAppend(PlanState *pstate)
 {
     AppendState *node = castNode(AppendState, pstate);
 
+#ifdef __OPENTENBASE__
+    /* every child was pruned */
+    if (node->as_nplans == 0)
+        return ExecClearTuple(node->ps.ps_ResultTupleSlot);
+
+    if (node->as_prune_pending)
+        exec_append_prune(node);
+#endif
+
     for (;;)
     {
         PlanState  *subnode;
@@ -227,6 +340,15 @@ ExecAppend(PlanState *pstate)
         /*
          * get a tuple from the subplan
          */
+#ifdef __OPENTENBASE__
+        if (node->as_pruned && node->as_pruned[node->as_whichplan])
+        {
+            /* counted for EXPLAIN ANALYZE; Append evaluates no qual */
+            InstrCountFiltered1(node, 1);
+            result = NULL;
+        }
+        else
+#endif
         result = ExecProcNode(subnode);
 
         if (!TupIsNull(result))
@@ -288,6 +410,12 @@ ExecReScanAppend(AppendState *node)
 {
     int            i;
 
+#ifdef __OPENTENBASE__
+    /* the params the children were pruned with may have changed */
+    if (node->as_pruned && node->ps.chgParam != NULL)
+        node->as_prune_pending = true;
+#endif
+
     for (i = 0; i < node->as_nplans; i++)
     {
         PlanState  *subnode = node->appendplans[i];
@@ -309,3 +437,419 @@ ExecReScanAppend(AppendState *node)
     node->as_whichplan = 0;
     exec_append_initialize_next(node);
 }
+
+#ifdef __OPENTENBASE__
+/*
+ * exec_append_prune
+ *      Recompute which subplans the current param values prune.
+ */
+static void
+exec_append_prune(AppendState *node)
+{
+    Append       *plan = (Append *) node->ps.plan;
+    Bitmapset  *children = NULL;
+    bool        pruned;
+    int            i;
+
+    MemoryContextReset(node->as_prunecxt);
+    pruned = ExecIntervalPruning(&node->ps, plan->partprunequals,
+                                 node->as_pruneexprs,
+                                 plan->appendplans, false,
+                                 node->as_prunecxt, &children);
+
+    for (i = 0; i < node->as_nplans; i++)
+    {
+        Scan       *scan = (Scan *) node->appendplans[i]->plan;
+
+        node->as_pruned[i] = pruned &&
+            !bms_is_member(scan->childidx, children);
+    }
+    node->as_prune_pending = false;
+}
+
+/*
+ * ExecInitIntervalPruning
+ *      Prepare the expressions of the pruning quals of an Append or
+ *      MergeAppend that compute param values, so that they can be evaluated
+ *      on every pruning.
+ */
+List *
+ExecInitIntervalPruning(PlanState *parent, List *prunequals)
+{
+    IntervalPruneContext context;
+
+    context.parent = parent;
+    context.pruneexprs = NIL;
+    context.failed = false;
+    (void) interval_prune_init_walker((Node *) prunequals, &context);
+
+    return context.pruneexprs;
+}
+
+/*
+ * ExecIntervalPruning
+ *      Compute the children of an interval partitioned table, scanned by
+ *      the subplans of an Append or MergeAppend, that can hold rows passing
+ *      the node's pruning quals with the current param values.
+ *
+ * pruneexprs comes from ExecInitIntervalPruning.  At startup only params
+ * whose values are known before execution begins are used.  Returns false if
+ * the quals do not restrict the children; otherwise returns true and the
+ * partition indexes of the remaining children in *children.  Everything is
+ * allocated in cxt.
+ */
+bool
+ExecIntervalPruning(PlanState *parent, List *prunequals, List *pruneexprs,
+                    List *subplans, bool startup, MemoryContext cxt,
+                    Bitmapset **children)
+{
+    IntervalPruneContext context;
+    MemoryContext oldcxt;
+    Index        scanrelid = 0;
+    List       *quals = NIL;
+    ListCell   *lc;
+    bool        result = false;
+
+    *children = NULL;
+
+    /* all subplans must scan children of the same table */
+    foreach(lc, subplans)
+    {
+        Scan       *scan = (Scan *) lfirst(lc);
+
+        if (!scan->ispartchild ||
+            (scanrelid != 0 && scan->scanrelid != scanrelid))
+            return false;
+        scanrelid = scan->scanrelid;
+    }
+    if (scanrelid == 0)
+        return false;
+
+    oldcxt = MemoryContextSwitchTo(cxt);
+
+    context.parent = parent;
+    context.pruneexprs = pruneexprs;
+    foreach(lc, prunequals)
+    {
+        Node       *qual = (Node *) lfirst(lc);
+
+        if (startup && interval_prune_params_walker(qual, (void *) &startup))
+            continue;
+
+        context.failed = false;
+        qual = interval_prune_mutator(qual, &context);
+        if (!context.failed)
+            quals = lappend(quals, qual);
+    }
+
+    if (quals != NIL)
+    {
+        Relation    relation;
+
+        relation = heap_open(getrelid(scanrelid, parent->state->es_range_table),
+                             AccessShareLock);
+        if (RELATION_IS_INTERVAL(relation) && relation->rd_partitions_info)
+        {
+            *children = RelationGetPartitionsByQuals(relation, quals);
+            result = true;
+        }
+        heap_close(relation, AccessShareLock);
+    }
+
+    MemoryContextSwitchTo(oldcxt);
+
+    return result;
+}
+
+/*
+ * ExecIntervalPruneHasExecParams
+ *      Do the pruning quals use PARAM_EXEC params, set only during execution?
+ */
+bool
+ExecIntervalPruneHasExecParams(List *prunequals)
+{
+    bool        exec_only = true;
+
+    return interval_prune_params_walker((Node *) prunequals,
+                                        (void *) &exec_only);
+}
+
+/*
+ * interval_prune_params_walker
+ *      Does the expression contain a Param?  If context points to true, only
+ *      PARAM_EXEC params count.
+ */
+static bool
+interval_prune_params_walker(Node *node, void *context)
+{
+    if (node == NULL)
+        return false;
+    if (IsA(node, Param))
+    {
+        bool       *exec_only = (bool *) context;
+
+        return exec_only == NULL || !*exec_only ||
+            ((Param *) node)->paramkind == PARAM_EXEC;
+    }
+    return expression_tree_walker(node, interval_prune_params_walker,
+                                  context);
+}
+
+/*
+ * interval_prune_is_param_expr
+ *      Does the expression compute a param value, to be replaced by a Const?
+ */
+static bool
+interval_prune_is_param_expr(Node *node)
+{
+    return !IsA(node, Var) &&
+        interval_prune_params_walker(node, NULL) &&
+        !contain_var_clause(node);
+}
+
+/*
+ * interval_prune_init_walker
+ *      Prepare the param expressions of the pruning quals.
+ */
+static bool
+interval_prune_init_walker(Node *node, IntervalPruneContext *context)
+{
+    if (node == NULL)
+        return false;
+
+    if (interval_prune_is_param_expr(node))
+    {
+        IntervalPruneExpr *pexpr = palloc(sizeof(IntervalPruneExpr));
+
+        pexpr->expr = node;
+        pexpr->exprstate = ExecInitExpr((Expr *) node, context->parent);
+        context->pruneexprs = lappend(context->pruneexprs, pexpr);
+        return false;
+    }
+
+    return expression_tree_walker(node, interval_prune_init_walker,
+                                  (void *) context);
+}
+
+/*
+ * interval_prune_eval
+ *      Evaluate a param expression prepared by ExecInitIntervalPruning.
+ *      Returns false if it is not one or its value is NULL.
+ */
+static bool
+interval_prune_eval(Node *node, IntervalPruneContext *context, Datum *value)
+{
+    ExprContext *econtext = context->parent->ps_ExprContext;
+    ExprState  *exprstate = NULL;
+    Oid            typid = exprType(node);
+    int16        typlen;
+    bool        typbyval;
+    bool        isnull;
+    ListCell   *lc;
+
+    foreach(lc, context->pruneexprs)
+    {
+        IntervalPruneExpr *pexpr = (IntervalPruneExpr *) lfirst(lc);
+
+        if (pexpr->expr == node)
+        {
+            exprstate = pexpr->exprstate;
+            break;
+        }
+    }
+
+    if (exprstate == NULL)
+        return false;
+
+    *value = ExecEvalExprSwitchContext(exprstate, econtext, &isnull);
+    if (isnull)
+    {
+        ResetExprContext(econtext);
+        return false;
+    }
+
+    get_typlenbyval(typid, &typlen, &typbyval);
+    *value = datumCopy(*value, typbyval, typlen);
+    ResetExprContext(econtext);
+
+    return true;
+}
+
+/*
+ * interval_prune_timestamptz
+ *      Turn a comparison of a timestamp partition key with a timestamptz
+ *      param expression into comparisons with timestamp Consts, that hold
+ *      for at least the rows the original one holds for.
+ *
+ * Returns NULL if the comparison is not of that kind.
+ */
+static Node *
+interval_prune_timestamptz(OpExpr *opexpr, IntervalPruneContext *context)
+{
+    Node       *leftarg;
+    Node       *rightarg;
+    Var           *var;
+    Node       *expr;
+    bool        lower = false;
+    bool        upper = false;
+    Datum        value;
+    Timestamp    ts;
+    TypeCacheEntry *typentry;
+    List       *args = NIL;
+
+    if (list_length(opexpr->args) != 2)
+        return NULL;
+
+    leftarg = (Node *) linitial(opexpr->args);
+    rightarg = (Node *) lsecond(opexpr->args);
+    if (IsA(leftarg, Var) && exprType(rightarg) == TIMESTAMPTZOID)
+    {
+        var = (Var *) leftarg;
+        expr = rightarg;
+    }
+    else if (IsA(rightarg, Var) && exprType(leftarg) == TIMESTAMPTZOID)
+    {
+        var = (Var *) rightarg;
+        expr = leftarg;
+    }
+    else
+        return NULL;
+
+    if (var->vartype != TIMESTAMPOID || !interval_prune_is_param_expr(expr))
+        return NULL;
+
+    /* the cross-type operators belong to the btree family of timestamp */
+    typentry = lookup_type_cache(TIMESTAMPOID, TYPECACHE_BTREE_OPFAMILY);
+    switch (get_op_opfamily_strategy(opexpr->opno, typentry->btree_opf))
+    {
+        case BTEqualStrategyNumber:
+            lower = upper = true;
+            break;
+        case BTLessStrategyNumber:
+        case BTLessEqualStrategyNumber:
+            upper = true;
+            break;
+        case BTGreaterStrategyNumber:
+        case BTGreaterEqualStrategyNumber:
+            lower = true;
+            break;
+        default:
+            return NULL;
+    }
+
+    /* the param is on the left, the bounds are the other way round */
+    if (var == (Var *) rightarg && lower != upper)
+    {
+        lower = !lower;
+        upper = !upper;
+    }
+
+    if (!interval_prune_eval(expr, context, &value))
+    {
+        context->failed = true;
+        return (Node *) opexpr;
+    }
+
+    value = DirectFunctionCall1(timestamptz_timestamp, value);
+    ts = DatumGetTimestamp(value);
+    if (TIMESTAMP_NOT_FINITE(ts) ||
+        !IS_VALID_TIMESTAMP(ts - INTERVAL_PRUNE_TZ_MARGIN) ||
+        !IS_VALID_TIMESTAMP(ts + INTERVAL_PRUNE_TZ_MARGIN))
+    {
+        context->failed = true;
+        return (Node *) opexpr;
+    }
+
+    if (lower)
+        args = lappend(args,
+                       make_opclause(get_opfamily_member(typentry->btree_opf,
+                                                         TIMESTAMPOID,
+                                                         TIMESTAMPOID,
+                                                         BTGreaterEqualStrategyNumber),
+                                     BOOLOID, false,
+                                     (Expr *) copyObject(var),
+                                     (Expr *) makeConst(TIMESTAMPOID, -1,
+                                                        InvalidOid,
+                                                        sizeof(Timestamp),
+                                                        TimestampGetDatum(ts - INTERVAL_PRUNE_TZ_MARGIN),
+                                                        false, FLOAT8PASSBYVAL),
+                                     InvalidOid, InvalidOid));
+    if (upper)
+        args = lappend(args,
+                       make_opclause(get_opfamily_member(typentry->btree_opf,
+                                                         TIMESTAMPOID,
+                                                         TIMESTAMPOID,
+                                                         BTLessEqualStrategyNumber),
+                                     BOOLOID, false,
+                                     (Expr *) copyObject(var),
+                                     (Expr *) makeConst(TIMESTAMPOID, -1,
+                                                        InvalidOid,
+                                                        sizeof(Timestamp),
+                                                        TimestampGetDatum(ts + INTERVAL_PRUNE_TZ_MARGIN),
+                                                        false, FLOAT8PASSBYVAL),
+                                     InvalidOid, InvalidOid));
+
+    if (list_length(args) == 1)
+        return (Node *) linitial(args);
+    return (Node *) makeBoolExpr(AND_EXPR, args, -1);
+}
+
+/*
+ * interval_prune_mutator
+ *      Replace the param expressions of a pruning qual by their values, so
+ *      the qual compares the partition key with a Const.
+ *
+ * Only the types partition bounds can be compared with are handled, and
+ * timestamptz values compared with a timestamp partition key; if a value
+ * has another type or is NULL, context->failed is set and the qual must not
+ * be used.  So is it if the qual has a Const of another type, which pruning
+ * would reject.
+ */
+static Node *
+interval_prune_mutator(Node *node, IntervalPruneContext *context)
+{
+    if (node == NULL || context->failed)
+        return node;
+
+    if (IsA(node, OpExpr))
+    {
+        Node       *result = interval_prune_timestamptz((OpExpr *) node,
+                                                        context);
+
+        if (result != NULL)
+            return result;
+    }
+    else if (IsA(node, Const))
+    {
+        Oid            typid = ((Const *) node)->consttype;
+
+        if (typid != INT2OID && typid != INT4OID &&
+            typid != INT8OID && typid != TIMESTAMPOID)
+            context->failed = true;
+        return node;
+    }
+    else if (interval_prune_is_param_expr(node))
+    {
+        Oid            typid = exprType(node);
+        int16        typlen;
+        bool        typbyval;
+        Datum        value;
+
+        if ((typid != INT2OID && typid != INT4OID &&
+             typid != INT8OID && typid != TIMESTAMPOID) ||
+            !interval_prune_eval(node, context, &value))
+        {
+            context->failed = true;
+            return node;
+        }
+
+        get_typlenbyval(typid, &typlen, &typbyval);
+        return (Node *) makeConst(typid, exprTypmod(node),
+                                  exprCollation(node), typlen,
+                                  value, false, typbyval);
+    }
+
+    return expression_tree_mutator(node, interval_prune_mutator,
+                                   (void *) context);
+}
+#endif
@@ -47,6 +47,16 @@
 #ifdef __OPENTENBASE__
 #define HASH_BUCKET_THRESHOLD  1048576
 #define HASH_BATCH_THRESHOLD   32
+
+/*
+ * The runtime join filter is re-evaluated every BLOOM_CHECK_INTERVAL outer
+ * tuples, and dropped if it removed less than BLOOM_MIN_REMOVED_FRACTION of
+ * them: hashing every outer tuple twice is then not paying for itself.
+ */
+#define BLOOM_CHECK_INTERVAL        4096
+#define BLOOM_MIN_REMOVED_FRACTION  0.05
+
+bool enable_hashjoin_bloom_filter = false;
 #endif
 
 static void ExecHashIncreaseNumBatches(HashJoinTable hashtable);
@@ -60,6 +70,11 @@ static void ExecHashSkewTableInsert(HashJoinTable hashtable,
 static void ExecHashRemoveNextSkewBucket(HashJoinTable hashtable);
 
 static void *dense_alloc(HashJoinTable hashtable, Size size);
+#ifdef __OPENTENBASE__
+static void ExecHashBuildBloomFilter(HashJoinTable hashtable);
+static void ExecChooseShmHashTableSize(Plan *outerNode, int nworkers,
+                            int *numbuckets, int *numbatches);
+#endif
 
 /* ----------------------------------------------------------------
  *        ExecHash
@@ -107,6 +122,13 @@ MultiExecHash(HashState *node)
     hashkeys = node->hashkeys;
     econtext = node->ps.ps_ExprContext;
 
+#ifdef __OPENTENBASE__
+    /* planned to spill already, so the runtime filter is needed from the start */
+    if (hashtable->useBloomFilter && hashtable->nbatch > 1 &&
+        hashtable->bloomFilter == NULL)
+        ExecHashBuildBloomFilter(hashtable);
+#endif
+
     /*
      * get all inner tuples and insert into the hash table (or temp files)
      */
@@ -123,6 +145,12 @@ MultiExecHash(HashState *node)
         {
             int            bucketNumber;
 
+#ifdef __OPENTENBASE__
+            if (hashtable->bloomFilter)
+                bloom_add_element(hashtable->bloomFilter,
+                                  (unsigned char *) &hashvalue,
+                                  sizeof(hashvalue));
+#endif
             bucketNumber = ExecHashGetSkewBucket(hashtable, hashvalue);
             if (bucketNumber != INVALID_SKEW_BUCKET_NO)
             {
@@ -277,32 +305,12 @@ ExecHashTableCreate(Hash *node, List *hashOperators, bool keepNulls)
 #ifdef __OPENTENBASE__
     if(IsParallelWorker() && node->plan.parallel_aware)
     {
-        double plan_rows = outerNode->plan_rows;// * max_parallel_workers_per_gather;
-        double mynbatch  = 0.0;
-        
-        ExecChooseHashTableSize(plan_rows, outerNode->plan_width,
-                        false,
-                        &nbuckets, &nbatch, &num_skew_mcvs);
-
-        if (nbuckets < HASH_BUCKET_THRESHOLD)
-            nbuckets = HASH_BUCKET_THRESHOLD;
-
-        /* 
-          * In parallel mode, nbuckets and nbatch can not be changed.
-          * Need to estimate both appropriate value.
-          */
-        mynbatch = ceil(plan_rows / nbuckets);
-
-        /* ... and force it to be a power of 2. */
-        mynbatch = 1 << my_log2((long)mynbatch);
-        
-        nbatch = Max(nbatch, mynbatch);
-
-        
-        //if (nbatch < HASH_BATCH_THRESHOLD)
-        //    nbatch   = nbatch   * max_parallel_workers_per_gather;
-
-        //nbuckets = nbuckets * NumDataNodes * max_parallel_workers_per_gather;
+        /*
+         * Local table of a parallel worker, it takes over the buckets of the
+         * merged share-hashtable, see ExecMergeShmHashTable.
+         */
+        ExecChooseShmHashTableSize(outerNode, 1, &nbuckets, &nbatch);
+        num_skew_mcvs = 0;
     }
     else
     {
@@ -352,6 +360,13 @@ ExecHashTableCreate(Hash *node, List *hashOperators, bool keepNulls)
     hashtable->spaceAllowedSkew =
         hashtable->spaceAllowed * SKEW_WORK_MEM_PERCENT / 100;
     hashtable->chunks = NULL;
+#ifdef __OPENTENBASE__
+    hashtable->useBloomFilter = false;
+    hashtable->bloomPlanRows = outerNode->plan_rows;
+    hashtable->bloomFilter = NULL;
+    hashtable->bloomChecked = 0;
+    hashtable->bloomRemoved = 0;
+#endif
 
 #ifdef HJDEBUG
     printf("Hashjoin %p: initial nbatch = %d, nbuckets = %d\n",
@@ -664,6 +679,16 @@ ExecHashIncreaseNumBatches(HashJoinTable hashtable)
            hashtable, nbatch, hashtable->spaceUsed);
 #endif
 
+#ifdef __OPENTENBASE__
+    /*
+     * We are about to spill.  Everything inserted so far is still in memory,
+     * so the runtime filter can be seeded from the chunks before they are
+     * dumped out.
+     */
+    if (hashtable->useBloomFilter && hashtable->bloomFilter == NULL)
+        ExecHashBuildBloomFilter(hashtable);
+#endif
+
     oldcxt = MemoryContextSwitchTo(hashtable->hashCxt);
 
     if (hashtable->innerBatchFile == NULL)
@@ -1949,6 +1974,10 @@ ExecHashGetInstrumentation(HashInstrumentation *instrument,
 	instrument->nbatch = hashtable->nbatch;
 	instrument->nbatch_original = hashtable->nbatch_original;
 	instrument->space_peak = hashtable->spacePeak;
+#ifdef __OPENTENBASE__
+	instrument->bloom_checked = hashtable->bloomChecked;
+	instrument->bloom_removed = hashtable->bloomRemoved;
+#endif
 }
 
 /*
@@ -2026,6 +2055,93 @@ dense_alloc(HashJoinTable hashtable, Size size)
     /* return pointer to the start of the tuple memory */
     return ptr;
 }
+#ifdef __OPENTENBASE__
+/*
+ * ExecHashBuildBloomFilter
+ *        create the runtime join filter, and add the hash values of all the
+ *        inner tuples currently held in memory
+ *
+ * Later inner tuples are added by MultiExecHash as they are read.
+ */
+static void
+ExecHashBuildBloomFilter(HashJoinTable hashtable)
+{
+    MemoryContext    oldcxt;
+    HashMemoryChunk chunk;
+    double            nelems;
+    int                i;
+
+    nelems = Max(hashtable->bloomPlanRows, hashtable->totalTuples * 2);
+    nelems = Max(nelems, 1);
+
+    oldcxt = MemoryContextSwitchTo(hashtable->hashCxt);
+    hashtable->bloomFilter = bloom_create((int64) Min(nelems, (double) PG_INT64_MAX),
+                                          Max(work_mem / 4, 64), 0);
+    MemoryContextSwitchTo(oldcxt);
+
+    for (chunk = hashtable->chunks; chunk != NULL; chunk = chunk->next)
+    {
+        size_t        idx = 0;
+
+        while (idx < chunk->used)
+        {
+            HashJoinTuple hashTuple = (HashJoinTuple) (chunk->data + idx);
+            MinimalTuple tuple = HJTUPLE_MINTUPLE(hashTuple);
+
+            bloom_add_element(hashtable->bloomFilter,
+                              (unsigned char *) &hashTuple->hashvalue,
+                              sizeof(uint32));
+            idx += MAXALIGN(HJTUPLE_OVERHEAD + tuple->t_len);
+        }
+    }
+
+    for (i = 0; i < hashtable->nSkewBuckets; i++)
+    {
+        HashSkewBucket *bucket = hashtable->skewBucket[hashtable->skewBucketNums[i]];
+        HashJoinTuple    hashTuple;
+
+        for (hashTuple = bucket->tuples; hashTuple != NULL; hashTuple = hashTuple->next)
+            bloom_add_element(hashtable->bloomFilter,
+                              (unsigned char *) &hashTuple->hashvalue,
+                              sizeof(uint32));
+    }
+}
+
+/*
+ * ExecHashBloomFilterRejects
+ *        true if an outer tuple with this hash value cannot have a match
+ *
+ * Only meaningful while the outer relation itself is being scanned; tuples
+ * read back from outer batch files have been checked already.  A filter that
+ * turns out not to remove enough tuples is dropped.
+ */
+bool
+ExecHashBloomFilterRejects(HashJoinTable hashtable, uint32 hashvalue)
+{
+    bloom_filter *filter = hashtable->bloomFilter;
+
+    if (filter == NULL || hashtable->curbatch != 0)
+        return false;
+
+    hashtable->bloomChecked += 1;
+    if (bloom_lacks_element(filter, (unsigned char *) &hashvalue, sizeof(hashvalue)))
+    {
+        hashtable->bloomRemoved += 1;
+        return true;
+    }
+
+    if (fmod(hashtable->bloomChecked, BLOOM_CHECK_INTERVAL) == 0 &&
+        hashtable->bloomRemoved < hashtable->bloomChecked * BLOOM_MIN_REMOVED_FRACTION)
+    {
+        bloom_free(filter);
+        hashtable->bloomFilter = NULL;
+        hashtable->useBloomFilter = false;
+    }
+
+    return false;
+}
+#endif
+
 #ifdef __OPENTENBASE__
 static void
 ExecShmHashSkewTableInsert(HashJoinTable hashtable,
@@ -2324,6 +2440,56 @@ ExecShmHashBuildSkewHash(HashJoinTable hashtable, Hash *node, int mcvsToUse)
 }
 #endif
 
+/*
+ * ExecChooseShmHashTableSize
+ *
+ * In parallel mode, nbuckets and nbatch can not be changed while building,
+ * so estimate both appropriate value up front. outerNode->plan_rows is the
+ * estimate for one worker. The number of batches only depends on that, so
+ * every worker and its local table agree on it. The bucket array is shared
+ * by all nworkers participants once the partial tables are merged, so it is
+ * sized for their combined input, within their combined work_mem.
+ */
+static void
+ExecChooseShmHashTableSize(Plan *outerNode, int nworkers,
+                           int *numbuckets, int *numbatches)
+{
+    double      plan_rows = outerNode->plan_rows;
+    double      mynbatch;
+    long        max_buckets;
+    int         nbuckets;
+    int         nbatch;
+    int         num_skew_mcvs;
+
+    ExecChooseHashTableSize(plan_rows, outerNode->plan_width,
+                            false,
+                            &nbuckets, &nbatch, &num_skew_mcvs);
+
+    if (nbuckets < HASH_BUCKET_THRESHOLD)
+        nbuckets = HASH_BUCKET_THRESHOLD;
+
+    mynbatch = ceil(plan_rows / nbuckets);
+
+    /* ... and force it to be a power of 2. */
+    mynbatch = 1 << my_log2((long)mynbatch);
+
+    nbatch = Max(nbatch, mynbatch);
+
+    if (nworkers > 1)
+    {
+        max_buckets = (work_mem * 1024L / sizeof(HashJoinTuple)) * nworkers;
+        max_buckets = Min(max_buckets, MaxAllocSize / sizeof(HashJoinTuple));
+        max_buckets = Min(max_buckets, INT_MAX / 2);
+
+        while (nbuckets < max_buckets / 2 &&
+               (double) nbuckets < plan_rows * nworkers)
+            nbuckets <<= 1;
+    }
+
+    *numbuckets = nbuckets;
+    *numbatches = nbatch;
+}
+
 /* ----------------------------------------------------------------
  *        ExecShmHashTableCreate
  *
@@ -2331,24 +2497,22 @@ ExecShmHashBuildSkewHash(HashJoinTable hashtable, Hash *node, int mcvsToUse)
  * ----------------------------------------------------------------
  */
 HashJoinTable
-ExecShmHashTableCreate(Hash *node, List *hashOperators, bool keepNulls)
+ExecShmHashTableCreate(Hash *node, List *hashOperators, bool keepNulls,
+                       int nworkers)
 {
     HashJoinTable hashtable;
     Plan       *outerNode;
     int            nbuckets;
     int            nbatch;
-    int            num_skew_mcvs;
     int            log2_nbuckets;
     int            nkeys;
     int            i;
-    double      plan_rows;
     ListCell   *ho;
     MemoryContext oldcxt;
     dsa_pointer dp;
     dsa_pointer dp_buckets;
     dsa_pointer dp_wnum;
     dsa_area * dsa = GetNumWorkerDsa(ParallelWorkerNumber);
-    double mynbatch  = 0.0;
 
     /*
      * Get information about the size of the relation to be hashed (it's the
@@ -2357,28 +2521,7 @@ ExecShmHashTableCreate(Hash *node, List *hashOperators, bool keepNulls)
      */
     outerNode = outerPlan(node);
 
-    plan_rows = outerNode->plan_rows;// * max_parallel_workers_per_gather;
-        
-    ExecChooseHashTableSize(plan_rows, outerNode->plan_width,
-                            false,
-                            &nbuckets, &nbatch, &num_skew_mcvs);
-
-    if (nbuckets < HASH_BUCKET_THRESHOLD)
-        nbuckets = HASH_BUCKET_THRESHOLD;
-
-    /* 
-      * In parallel mode, nbuckets and nbatch can not be changed.
-      * Need to estimate both appropriate value.
-      */
-    mynbatch = ceil(plan_rows / nbuckets);
-
-    /* ... and force it to be a power of 2. */
-    mynbatch = 1 << my_log2((long)mynbatch);
-    
-    nbatch = Max(nbatch, mynbatch);
-    
-    //if (nbatch < HASH_BATCH_THRESHOLD)
-    //    nbatch     = nbatch    * max_parallel_workers_per_gather;
+    ExecChooseShmHashTableSize(outerNode, nworkers, &nbuckets, &nbatch);
 
     /* nbuckets must be a power of 2 */
     log2_nbuckets = my_log2(nbuckets);
@@ -2420,6 +2563,11 @@ ExecShmHashTableCreate(Hash *node, List *hashOperators, bool keepNulls)
     hashtable->spaceAllowedSkew =
         hashtable->spaceAllowed * SKEW_WORK_MEM_PERCENT / 100;
     hashtable->chunks = NULL;
+    hashtable->useBloomFilter = false;
+    hashtable->bloomPlanRows = outerNode->plan_rows;
+    hashtable->bloomFilter = NULL;
+    hashtable->bloomChecked = 0;
+    hashtable->bloomRemoved = 0;
 
 #ifdef HJDEBUG
     printf("Hashjoin %p: initial nbatch = %d, nbuckets = %d\n",
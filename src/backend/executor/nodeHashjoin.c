@@ -27,6 +27,7 @@
 #ifdef __OPENTENBASE__
 #include "access/xact.h"
 #include "executor/execParallel.h"
+#include "pgxc/execRemote.h"
 #endif
 
 /*
@@ -58,6 +59,8 @@ static bool ExecHashJoinNewBatch(HashJoinState *hjstate);
 
 #ifdef __OPENTENBASE__
 static void ExecShareBufFileName(volatile ParallelHashJoinState *parallelState, HashJoinTable hashtable, bool inner);
+static void ExecMergeShmHashBuckets(volatile ParallelHashJoinState *parallelState, int workerLeader,
+                                int lo, int hi);
 static HashJoinTable ExecMergeShmHashTable(HashJoinState * hjstate, volatile ParallelHashJoinState *parallelState, 
                                 Hash *node, List *hashOperators, bool keepNulls);
 static void ExecFormNewOuterBufFile(HashJoinState * hjstate, volatile ParallelHashJoinState *parallelState, 
@@ -164,8 +167,13 @@ ExecHashJoin(PlanState *pstate)
                           !node->hj_OuterNotEmpty))
                 {
 #ifdef __OPENTENBASE__
-                    /* When we need to prefetch inner, we just assume there is at lease one row from outer plan */
-                    if (!hashJoin->join.prefetch_inner)
+                    /*
+                     * When we need to prefetch inner, we just assume there is at lease one row from outer plan.
+                     * The outer plan of adaptive broadcast is not started before the inner one is read either,
+                     * how it is distributed depends on the inner one.
+                     */
+                    if (!hashJoin->join.prefetch_inner &&
+                        !ExecRemoteSubplanProbePending(outerNode))
                     {
                         node->hj_OuterInited = true;
 #endif
@@ -267,7 +275,8 @@ ExecHashJoin(PlanState *pstate)
                         parallelState->statusParallelWorker[ParallelWorkerNumber] = ParallelHashJoin_BuildShmHashTable;
                         hashtable = ExecShmHashTableCreate((Hash *) hashNode->ps.plan,
                                                             node->hj_HashOperators,
-                                                            HJ_FILL_INNER(node));
+                                                            HJ_FILL_INNER(node),
+                                                            parallelState->numLaunchedParallelWorkers);
 
                         hashNode->hashtable = hashtable;
 
@@ -302,6 +311,9 @@ ExecHashJoin(PlanState *pstate)
                         hashtable = ExecHashTableCreate((Hash *) hashNode->ps.plan,
                                                         node->hj_HashOperators,
                                                         HJ_FILL_INNER(node));
+                        /* unmatched outer tuples may only be dropped if not null-filled */
+                        hashtable->useBloomFilter = enable_hashjoin_bloom_filter &&
+                                                    !HJ_FILL_OUTER(node);
                         node->hj_HashTable = hashtable;
 
                         /*
@@ -321,6 +333,11 @@ ExecHashJoin(PlanState *pstate)
                 hashtable = ExecHashTableCreate((Hash *) hashNode->ps.plan,
                                                 node->hj_HashOperators,
                                                 HJ_FILL_INNER(node));
+#ifdef __OPENTENBASE__
+                /* unmatched outer tuples may only be dropped if not null-filled */
+                hashtable->useBloomFilter = enable_hashjoin_bloom_filter &&
+                                            !HJ_FILL_OUTER(node);
+#endif
                 node->hj_HashTable = hashtable;
 
                 /*
@@ -330,6 +347,13 @@ ExecHashJoin(PlanState *pstate)
                 (void) MultiExecProcNode((PlanState *) hashNode);
 #ifdef __OPENTENBASE__
                 }
+
+                /*
+                 * With adaptive broadcast the outer relation may stay where
+                 * it is if the inner relation turned out to be broadcast.
+                 */
+                ExecRemoteSubplanChooseProbe(outerNode,
+                                             outerPlanState(hashNode));
 #endif
                 /*
                  * If the inner relation is completely empty, and we're not
@@ -449,6 +473,11 @@ ExecHashJoin(PlanState *pstate)
 					 * Save it in the corresponding outer-batch file.
 					 */
 					Assert(batchno > hashtable->curbatch);
+#ifdef __OPENTENBASE__
+					/* don't spill a tuple the runtime filter says cannot match */
+					if (ExecHashBloomFilterRejects(hashtable, hashvalue))
+						continue;
+#endif
 					ExecHashJoinSaveTuple(ExecFetchSlotMinimalTuple(outerTupleSlot),
 										  hashvalue,
 										  &hashtable->outerBatchFile[batchno]);
@@ -653,6 +682,10 @@ ExecInitHashJoin(HashJoin *node, EState *estate, int eflags)
 
 	outerPlanState(hjstate) = ExecInitNode(outerNode, estate, eflags);
 	innerPlanState(hjstate) = ExecInitNode((Plan *) hashNode, estate, eflags);
+#ifdef __OPENTENBASE__
+	ExecRemoteSubplanLinkAdaptive(outerPlanState(hjstate),
+								  outerPlanState(innerPlanState(hjstate)));
+#endif
 
 	/*
 	 * tuple table initialization
@@ -1591,288 +1624,250 @@ ExecShareBufFileName(volatile ParallelHashJoinState *parallelState, HashJoinTabl
 }
 
 /*
-  * merge all parallel workers' shared hashtables into local hashtable
+  * link the bucket chains of all parallel workers' shared hashtables into
+  * the buckets [lo, hi) of the leader's shared hashtable
+  */
+static void
+ExecMergeShmHashBuckets(volatile ParallelHashJoinState *parallelState, int workerLeader,
+                                int lo, int hi)
+{
+    int i           = 0;
+    int indexbucket = 0;
+    int nWorkers    = parallelState->numLaunchedParallelWorkers;
+    dsa_area *leaderDsa = GetNumWorkerDsa(workerLeader);
+    volatile dsa_pointer *hashTableParallelWorker = parallelState->hashTableParallelWorker;
+    HashJoinTable ht = (HashJoinTable)dsa_get_address(leaderDsa, hashTableParallelWorker[workerLeader]);
+    HashJoinTupleData **ht_buckets      = (HashJoinTuple *)dsa_get_address(leaderDsa,
+                                                          (dsa_pointer)ht->buckets);
+    HashJoinTupleData **ht_buckets_tail = (HashJoinTuple *)dsa_get_address(leaderDsa,
+                                                          (dsa_pointer)ht->buckets_tail);
+    int *head_workNum                   = (int *)dsa_get_address(leaderDsa,
+                                                          (dsa_pointer)ht->bucket_wNum);
+    int *tail_workNum                   = (int *)dsa_get_address(leaderDsa,
+                                                          (dsa_pointer)ht->bucket_tail_wNum);
+
+    for (i = 0; i < nWorkers; i++)
+    {
+        dsa_area *dsa = NULL;
+        HashJoinTable mergeHashtable = NULL;
+        HashJoinTupleData **merged_buckets = NULL;
+        HashJoinTupleData **merged_buckets_tail = NULL;
+
+        if (i == workerLeader)
+            continue;
+
+        dsa = GetNumWorkerDsa(i);
+        mergeHashtable      = (HashJoinTable)dsa_get_address(dsa, hashTableParallelWorker[i]);
+        merged_buckets      = (HashJoinTuple *)dsa_get_address(dsa,
+                                                  (dsa_pointer)mergeHashtable->buckets);
+        merged_buckets_tail = (HashJoinTuple *)dsa_get_address(dsa,
+                                                  (dsa_pointer)mergeHashtable->buckets_tail);
+
+        if(ht->nbuckets != mergeHashtable->nbuckets)
+        {
+            elog(ERROR, "number of buckets is different in parallel workers' hashtables.");
+        }
+
+        /*
+         * the main work of merging is just linking the hashtable's buckets from
+         * different workers.
+         */
+        for(indexbucket = lo; indexbucket < hi; indexbucket++)
+        {
+            if(ht_buckets[indexbucket])
+            {
+                int workerNumber = tail_workNum[indexbucket];
+                HashJoinTupleData *tail = (HashJoinTupleData *)dsa_get_address(GetNumWorkerDsa(workerNumber),
+                                                                           (dsa_pointer)ht_buckets_tail[indexbucket]);
+                tail->next              = merged_buckets[indexbucket];
+                tail->workerNumber      = i;
+
+                if(merged_buckets[indexbucket])
+                {
+                    ht_buckets_tail[indexbucket] = merged_buckets_tail[indexbucket];
+                    tail_workNum[indexbucket] = i;
+                }
+            }
+            else
+            {
+                if(merged_buckets[indexbucket])
+                {
+                    ht_buckets[indexbucket] = merged_buckets[indexbucket];
+                    ht_buckets_tail[indexbucket] = merged_buckets_tail[indexbucket];
+                    tail_workNum[indexbucket] = i;
+                    head_workNum[indexbucket] = i;
+                }
+            }
+        }
+    }
+}
+
+/*
+  * merge all parallel workers' shared hashtables, and make the local hashtable
+  * use the merged buckets
+  *
+  * All workers merge cooperatively: once every worker has built its part of the
+  * shared hashtable, each of them links the chains of its own slice of buckets,
+  * so the merge is not serialized on the leader. The merged bucket array lives
+  * in the leader's shared memory and is used by all workers directly instead of
+  * being copied into every worker.
   */
 static HashJoinTable
 ExecMergeShmHashTable(HashJoinState * hjstate, volatile ParallelHashJoinState *parallelState, 
                                 Hash *node, List *hashOperators, bool keepNulls)
 {// #lizard forgives
     int i            = 0;
+    int nAttached    = 0;
     int nMerged      = 0;
     int workerLeader = 0;
-    int indexbucket  = 0;
     int indexbatch   = 0;
+    int lo           = 0;
+    int hi           = 0;
     int nWorkers     = parallelState->numLaunchedParallelWorkers;
-    bool *merged     = (bool *)palloc0(sizeof(bool) * nWorkers);
+    bool *attached   = (bool *)palloc0(sizeof(bool) * nWorkers);
     dsa_area * leaderDsa = GetNumWorkerDsa(workerLeader);
     volatile ParallelHashJoinStatus *statusParallelWorker    = parallelState->statusParallelWorker;
     volatile dsa_pointer            *hashTableParallelWorker = parallelState->hashTableParallelWorker;
-    HashJoinTable ht = (HashJoinTable)dsa_get_address(leaderDsa, hashTableParallelWorker[workerLeader]);
+    HashJoinTable ht = NULL;
     
     /* build local hashtable */
     HashJoinTable hashtable = ExecHashTableCreate(node,
                                                   hashOperators,
                                                   keepNulls);
-    i = 0;
-    nMerged = 0;
-    while(nMerged < nWorkers)
+
+    /* 
+      * wait for all workers to finish their shared hashtables, and attach
+      * their inner batch files
+      */
+    while(nAttached < nWorkers)
     {
-        if(!merged[i] && statusParallelWorker[i] >= ParallelHashJoin_BuildShmHashTableDone)
+        bool progress = false;
+
+        for (i = 0; i < nWorkers; i++)
         {
-            dsa_area *dsa = GetNumWorkerDsa(i);
-            HashJoinTable mergeHashtable = (HashJoinTable)dsa_get_address(dsa, hashTableParallelWorker[i]);
-            
-            merged[i] = true;
-            nMerged++;
+            if (attached[i])
+                continue;
 
-            /* 
-              *   merge hashtable buckets 
-              *   worker leader do the merging, other workers just copy the merged hashtable
-              *   into local memory
-              * 
-              *   the main work of merging is just linking the hashtable's buckets from different workers.
-              */
-            if(workerLeader == ParallelWorkerNumber)
+            if (statusParallelWorker[i] >= ParallelHashJoin_BuildShmHashTableDone)
             {
-                if(i != workerLeader)
-                {            
-                    HashJoinTupleData **ht_buckets          = (HashJoinTuple *)dsa_get_address(leaderDsa, 
-                                                                          (dsa_pointer)ht->buckets);
-                    HashJoinTupleData **ht_buckets_tail     = (HashJoinTuple *)dsa_get_address(leaderDsa, 
-                                                                          (dsa_pointer)ht->buckets_tail);
-                    HashJoinTupleData **merged_buckets      = (HashJoinTuple *)dsa_get_address(dsa, 
-                                                                          (dsa_pointer)mergeHashtable->buckets);
-                    HashJoinTupleData **merged_buckets_tail = (HashJoinTuple *)dsa_get_address(dsa, 
-                                                                          (dsa_pointer)mergeHashtable->buckets_tail);
-                    int *head_workNum                       = (int *)dsa_get_address(leaderDsa, 
-                                                                          (dsa_pointer)ht->bucket_wNum);
-                    int *tail_workNum                       = (int *)dsa_get_address(leaderDsa, 
-                                                                          (dsa_pointer)ht->bucket_tail_wNum);
+                dsa_area *dsa = GetNumWorkerDsa(i);
+                HashJoinTable mergeHashtable = (HashJoinTable)dsa_get_address(dsa, hashTableParallelWorker[i]);
+
+                attached[i] = true;
+                nAttached++;
+                progress = true;
+
+                /* merge hashtable inner batch file */
+                if(hashtable->nbatch > 1)
+                {
+                    HashTableBufFileName *bufFileNames = (HashTableBufFileName *)dsa_get_address(dsa, 
+                                                                             parallelState->bufFileNames[i]);
+                    int *nFiles                        = (int *)dsa_get_address(dsa, bufFileNames->nFiles);
                     
-                    if(ht->nbuckets != mergeHashtable->nbuckets)
+                    dsa_pointer *names                 = (dsa_pointer *)dsa_get_address(dsa, bufFileNames->name);
+                    
+                    if(hashtable->nbatch != mergeHashtable->nbatch)
                     {
-                        elog(ERROR, "number of buckets is different in parallel workers' hashtables.");
+                        elog(ERROR, "number of batch is different in parallel workers' hashtables.");
                     }
-
-                    ht->totalTuples = ht->totalTuples + mergeHashtable->totalTuples;
-					ht->spacePeak = Max(ht->spacePeak, mergeHashtable->spacePeak);
                     
-                    /* merge hashtable */
-                    for(indexbucket = 0; indexbucket < ht->nbuckets; indexbucket++)
+                    for(indexbatch = 0; indexbatch < hashtable->nbatch; indexbatch++)
                     {
-                        if(ht_buckets[indexbucket])
-                        {
-                            int workerNumber = tail_workNum[indexbucket];
-                            HashJoinTupleData *tail = (HashJoinTupleData *)dsa_get_address(GetNumWorkerDsa(workerNumber), 
-                                                                                       (dsa_pointer)ht_buckets_tail[indexbucket]);
-                            tail->next              = merged_buckets[indexbucket];
-                            tail->workerNumber      = i;
+                        int fileNum   = 0;
+                        dsa_pointer *fileName = NULL;
 
-                            if(merged_buckets[indexbucket])
-                            {
-                                ht_buckets_tail[indexbucket] = merged_buckets_tail[indexbucket];
-                                tail_workNum[indexbucket] = i;
-                            }
-                        }
-                        else
+                        fileNum     = nFiles[indexbatch];
+
+                        if(fileNum > 0)
                         {
-                            if(merged_buckets[indexbucket])
-                            {
-                                ht_buckets[indexbucket] = merged_buckets[indexbucket];
-                                ht_buckets_tail[indexbucket] = merged_buckets_tail[indexbucket];
-                                tail_workNum[indexbucket] = i;
-                                head_workNum[indexbucket] = i;
-                            }
+                            fileName = (dsa_pointer *)dsa_get_address(dsa, names[indexbatch]);
+                            CreateBufFile(dsa, fileNum, fileName, &hashtable->innerBatchFile[indexbatch]);
                         }
                     }
                 }
             }
-
-            /* merge hashtable inner batch file */
-            if(hashtable->nbatch > 1)
+            else if (statusParallelWorker[i] == ParallelHashJoin_Error || ParallelError())
             {
-                HashTableBufFileName *bufFileNames = (HashTableBufFileName *)dsa_get_address(dsa, 
-                                                                         parallelState->bufFileNames[i]);
-                int *nFiles                        = (int *)dsa_get_address(dsa, bufFileNames->nFiles);
-                
-                dsa_pointer *names                 = (dsa_pointer *)dsa_get_address(dsa, bufFileNames->name);
-                
-                if(hashtable->nbatch != mergeHashtable->nbatch)
-                {
-                    elog(ERROR, "number of batch is different in parallel workers' hashtables.");
-                }
-                
-                for(indexbatch = 0; indexbatch < hashtable->nbatch; indexbatch++)
-                {
-                    int fileNum   = 0;
-                    dsa_pointer *fileName = NULL;
-
-                    fileNum     = nFiles[indexbatch];
-
-                    if(fileNum > 0)
-                    {
-                        fileName = (dsa_pointer *)dsa_get_address(dsa, names[indexbatch]);
-                        CreateBufFile(dsa, fileNum, fileName, &hashtable->innerBatchFile[indexbatch]);
-                    }
-                }
+                elog(ERROR, "[%s:%d]some other workers exit with errors, and we need to exit because"
+                            " of data corrupted.", __FILE__, __LINE__);
             }
         }
-        else if (statusParallelWorker[i] == ParallelHashJoin_Error || ParallelError())
-        {
-            elog(ERROR, "[%s:%d]some other workers exit with errors, and we need to exit because"
-                        " of data corrupted.", __FILE__, __LINE__);
-        }
-#if 0
-        else if (!merged[i] && statusParallelWorker[i] == ParallelHashJoin_None)
-        {
-            elog(LOG, "worker %d not launched while worker %d ExecMergeShmHashTable.", i, ParallelWorkerNumber);
-            merged[i] = true;
-            nMerged++;
-        }
-#endif
-        pg_usleep(1000L);
-        i = (i + 1) % nWorkers;
+
+        if (!progress)
+            pg_usleep(1000L);
     }
 
+    /* merge our slice of buckets */
+    statusParallelWorker[ParallelWorkerNumber] = ParallelHashJoin_MergeShmHashTable;
+
+    ht = (HashJoinTable)dsa_get_address(leaderDsa, hashTableParallelWorker[workerLeader]);
+    lo = (int) ((int64) ht->nbuckets * ParallelWorkerNumber / nWorkers);
+    hi = (int) ((int64) ht->nbuckets * (ParallelWorkerNumber + 1) / nWorkers);
+    ExecMergeShmHashBuckets(parallelState, workerLeader, lo, hi);
+
     if(workerLeader == ParallelWorkerNumber)
     {
-#if 0
-        /* debug */
-        int i = 0;
-        size_t tuple_num = 0;
-        HashJoinTuple hashTuple;
-        dsa_area *dsa = NULL;
-        int work_num = 0;
-
-        HashJoinTupleData **ht_buckets  = (HashJoinTuple *)dsa_get_address(leaderDsa, 
-                                              (dsa_pointer)ht->buckets);
-        int *head_wnum = (int *)dsa_get_address(leaderDsa, 
-                                              (dsa_pointer)ht->bucket_wNum);
-        for(i = 0; i < ht->nbuckets; i++)
+        for (i = 0; i < nWorkers; i++)
         {
-            HashJoinTupleData *temp = NULL;
-            
-            if(ht_buckets[i])
-            {
-                tuple_num++;
+            HashJoinTable mergeHashtable = NULL;
 
-                dsa = GetNumWorkerDsa(head_wnum[i]);
-                hashTuple = (HashJoinTuple)dsa_get_address(dsa, (dsa_pointer)ht_buckets[i]);
+            if (i == workerLeader)
+                continue;
 
-                temp = hashTuple->next;
-                work_num = hashTuple->workerNumber;
-            }
-
-            while(temp)
-            {
-                tuple_num++;
-
-                dsa = GetNumWorkerDsa(work_num);
-                hashTuple = (HashJoinTuple)dsa_get_address(dsa, (dsa_pointer)temp);
-
-                temp = hashTuple->next;
-                work_num = hashTuple->workerNumber;
-            }
+            mergeHashtable = (HashJoinTable)dsa_get_address(GetNumWorkerDsa(i), hashTableParallelWorker[i]);
+            ht->totalTuples = ht->totalTuples + mergeHashtable->totalTuples;
+            ht->spacePeak = Max(ht->spacePeak, mergeHashtable->spacePeak);
         }
-
-        if(tuple_num != ht->totalTuples)
-        {
-            elog(PANIC, "merged hashtable's totaltuple is mismatch, tuple_num %zu, totalTuples %lf.",
-                         tuple_num, ht->totalTuples);
-        }
-#endif
-        statusParallelWorker[workerLeader] = ParallelHashJoin_MergeShmHashTableDone;
     }
 
+    statusParallelWorker[ParallelWorkerNumber] = ParallelHashJoin_MergeShmHashTableDone;
+
     /* 
-      * copy merged hashtable into local hashtable 
-      * should wait for the leader finish merging hashtable
+      * should wait for all workers to finish merging their slices
       */
-    while(statusParallelWorker[workerLeader] < ParallelHashJoin_MergeShmHashTableDone)
+    while(nMerged < nWorkers)
     {
-        if (statusParallelWorker[workerLeader] == ParallelHashJoin_Error || ParallelError())
+        if (statusParallelWorker[nMerged] >= ParallelHashJoin_MergeShmHashTableDone)
+        {
+            nMerged++;
+        }
+        else if (statusParallelWorker[nMerged] == ParallelHashJoin_Error || ParallelError())
         {
             elog(ERROR, "[%s:%d]some other workers exit with errors, and we need to exit because"
                         " of data corrupted.", __FILE__, __LINE__);
         }
-        pg_usleep(1000L);
+        else
+        {
+            pg_usleep(1000L);
+        }
     }
 
+    /* take over the merged buckets, the bucket array is not copied */
     {
-        HashJoinTable ht = (HashJoinTable)dsa_get_address(leaderDsa, hashTableParallelWorker[workerLeader]);
         HashJoinTupleData **ht_buckets  = (HashJoinTuple *)dsa_get_address(leaderDsa, 
                                                       (dsa_pointer)ht->buckets);
         int *bucket_wNum = (int *)dsa_get_address(leaderDsa, (dsa_pointer)ht->bucket_wNum);
-        memcpy(hashtable->buckets, ht_buckets, sizeof(HashJoinTupleData *) * hashtable->nbuckets);
-        memcpy(hashtable->bucket_wNum, bucket_wNum, sizeof(int) * hashtable->nbuckets);
+
+        pfree(hashtable->buckets);
+        pfree(hashtable->bucket_wNum);
+        hashtable->buckets = ht_buckets;
+        hashtable->bucket_wNum = bucket_wNum;
         hashtable->totalTuples = ht->totalTuples;
         hashtable->skewEnabled = false;
         hashtable->growEnabled = false;
-		/* copy instrumentation too */
+		/* batch numbers of outer tuples must be computed as for inner ones */
 		hashtable->nbuckets = ht->nbuckets;
 		hashtable->nbuckets_original = ht->nbuckets_original;
+		hashtable->nbuckets_optimal = ht->nbuckets;
+		hashtable->log2_nbuckets = ht->log2_nbuckets;
+		hashtable->log2_nbuckets_optimal = ht->log2_nbuckets;
+		/* copy instrumentation too */
 		hashtable->nbatch = ht->nbatch;
 		hashtable->nbatch_original = ht->nbatch_original;
 		hashtable->spacePeak = ht->spacePeak;
     }
 
-#if 0
-    /* debug */
-    {
-        int i = 0;
-        size_t tuple_num = 0;
-        HashJoinTuple hashTuple;
-        dsa_area *dsa = NULL;
-        int work_num = 0;
-
-        HashJoinTupleData **ht_buckets  = hashtable->buckets;
-        for(i = 0; i < hashtable->nbuckets; i++)
-        {
-            HashJoinTupleData *temp = NULL;
-            
-            if(ht_buckets[i])
-            {
-                tuple_num++;
-
-                dsa = GetNumWorkerDsa(hashtable->bucket_wNum[i]);
-                hashTuple = (HashJoinTuple)dsa_get_address(dsa, (dsa_pointer)ht_buckets[i]);
-
-                temp = hashTuple->next;
-                work_num = hashTuple->workerNumber;
-            }
-
-            while(temp)
-            {
-                tuple_num++;
-
-                dsa = GetNumWorkerDsa(work_num);
-                hashTuple = (HashJoinTuple)dsa_get_address(dsa, (dsa_pointer)temp);
-
-                temp = hashTuple->next;
-                work_num = hashTuple->workerNumber;
-            }
-        }
-
-        if (hashtable->nbatch > 1)
-        {
-            uint32 hashvalue = 0;
-            
-            for(i = 1; i < hashtable->nbatch; i++)
-            {
-                while (ExecHashJoinGetSavedTuple(hjstate, hashtable->innerBatchFile[i], &hashvalue, hjstate->hj_HashTupleSlot))
-                {
-                    tuple_num++;
-                    ExecClearTuple(hjstate->hj_HashTupleSlot);
-                }
-
-                ReSetBufFile(hashtable->innerBatchFile[i]);
-            }
-        }
-
-        elog(LOG, "worker_num:%d, tuple_num:%zu, totaltuple:%lf", ParallelWorkerNumber, tuple_num, hashtable->totalTuples);
-    }
-#endif
-    pfree(merged);
+    pfree(attached);
 
     return hashtable;
 }
@@ -42,6 +42,10 @@
 #include "executor/nodeMergeAppend.h"
 #include "lib/binaryheap.h"
 #include "miscadmin.h"
+#ifdef __OPENTENBASE__
+#include "executor/nodeAppend.h"
+#include "utils/memutils.h"
+#endif
 
 /*
  * We have one slot for each item in the heap array.  We use SlotNumber
@@ -52,6 +56,9 @@ typedef int32 SlotNumber;
 
 static TupleTableSlot *ExecMergeAppend(PlanState *pstate);
 static int    heap_compare_slots(Datum a, Datum b, void *arg);
+#ifdef __OPENTENBASE__
+static void exec_merge_append_prune(MergeAppendState *node);
+#endif
 
 
 /* ----------------------------------------------------------------
@@ -68,6 +75,11 @@ ExecInitMergeAppend(MergeAppend *node, EState *estate, int eflags)
     int            nplans;
     int            i;
     ListCell   *lc;
+#ifdef __OPENTENBASE__
+    Bitmapset  *validchildren = NULL;
+    bool        startup_pruned = false;
+    bool        runtime_pruning = false;
+#endif
 
     /* check for unsupported flags */
     Assert(!(eflags & (EXEC_FLAG_BACKWARD | EXEC_FLAG_MARK)));
@@ -111,6 +123,29 @@ ExecInitMergeAppend(MergeAppend *node, EState *estate, int eflags)
      */
     ExecInitResultTupleSlot(estate, &mergestate->ps);
 
+#ifdef __OPENTENBASE__
+    /* prune children of an interval partitioned table, as Append does */
+    if (node->interval && node->partprunequals != NIL)
+    {
+        ExecAssignExprContext(estate, &mergestate->ps);
+        mergestate->ms_prunecxt =
+            AllocSetContextCreate(CurrentMemoryContext,
+                                  "MergeAppend run-time pruning",
+                                  ALLOCSET_SMALL_SIZES);
+        mergestate->ms_pruneexprs =
+            ExecInitIntervalPruning(&mergestate->ps, node->partprunequals);
+        startup_pruned = ExecIntervalPruning(&mergestate->ps,
+                                             node->partprunequals,
+                                             mergestate->ms_pruneexprs,
+                                             node->mergeplans,
+                                             true,
+                                             mergestate->ms_prunecxt,
+                                             &validchildren);
+        runtime_pruning =
+            ExecIntervalPruneHasExecParams(node->partprunequals);
+    }
+#endif
+
     /*
      * call ExecInitNode on each of the plans to be executed and save the
      * results into the array "mergeplans".
@@ -120,9 +155,33 @@ ExecInitMergeAppend(MergeAppend *node, EState *estate, int eflags)
     {
         Plan       *initNode = (Plan *) lfirst(lc);
 
+#ifdef __OPENTENBASE__
+        if (startup_pruned &&
+            !bms_is_member(((Scan *) initNode)->childidx, validchildren))
+        {
+            mergestate->ms_nremoved++;
+            continue;
+        }
+
+        /* children of dropped partitions are not initialized */
+        mergeplanstates[i] = ExecInitNode(initNode, estate, eflags);
+        if (mergeplanstates[i] != NULL)
+            i++;
+#else
         mergeplanstates[i] = ExecInitNode(initNode, estate, eflags);
         i++;
+#endif
+    }
+#ifdef __OPENTENBASE__
+    mergestate->ms_nplans = i;
+
+    if (runtime_pruning && mergestate->ms_nplans > 0)
+    {
+        mergestate->ms_pruned =
+            (bool *) palloc0(mergestate->ms_nplans * sizeof(bool));
+        mergestate->ms_prune_pending = true;
     }
+#endif
 
     /*
      * initialize output tuple type
@@ -182,12 +241,25 @@ ExecMergeAppend(PlanState *pstate)
 
     if (!node->ms_initialized)
     {
+#ifdef __OPENTENBASE__
+        if (node->ms_prune_pending)
+            exec_merge_append_prune(node);
+#endif
+
         /*
          * First time through: pull the first tuple from each subplan, and set
          * up the heap.
          */
         for (i = 0; i < node->ms_nplans; i++)
         {
+#ifdef __OPENTENBASE__
+            if (node->ms_pruned && node->ms_pruned[i])
+            {
+                InstrCountFiltered1(node, 1);
+                node->ms_slots[i] = NULL;
+                continue;
+            }
+#endif
             node->ms_slots[i] = ExecProcNode(node->mergeplans[i]);
             if (!TupIsNull(node->ms_slots[i]))
                 binaryheap_add_unordered(node->ms_heap, Int32GetDatum(i));
@@ -299,6 +371,12 @@ ExecReScanMergeAppend(MergeAppendState *node)
 {
     int            i;
 
+#ifdef __OPENTENBASE__
+    /* the params the children were pruned with may have changed */
+    if (node->ms_pruned && node->ps.chgParam != NULL)
+        node->ms_prune_pending = true;
+#endif
+
     for (i = 0; i < node->ms_nplans; i++)
     {
         PlanState  *subnode = node->mergeplans[i];
@@ -320,3 +398,33 @@ ExecReScanMergeAppend(MergeAppendState *node)
     binaryheap_reset(node->ms_heap);
     node->ms_initialized = false;
 }
+
+#ifdef __OPENTENBASE__
+/*
+ * exec_merge_append_prune
+ *      Recompute which subplans the current param values prune.
+ */
+static void
+exec_merge_append_prune(MergeAppendState *node)
+{
+    MergeAppend *plan = (MergeAppend *) node->ps.plan;
+    Bitmapset  *children = NULL;
+    bool        pruned;
+    int            i;
+
+    MemoryContextReset(node->ms_prunecxt);
+    pruned = ExecIntervalPruning(&node->ps, plan->partprunequals,
+                                 node->ms_pruneexprs,
+                                 plan->mergeplans, false,
+                                 node->ms_prunecxt, &children);
+
+    for (i = 0; i < node->ms_nplans; i++)
+    {
+        Scan       *scan = (Scan *) node->mergeplans[i]->plan;
+
+        node->ms_pruned[i] = pruned &&
+            !bms_is_member(scan->childidx, children);
+    }
+    node->ms_prune_pending = false;
+}
+#endif
@@ -36,6 +36,13 @@
 #ifdef _MLS_
 #include "utils/mls.h"
 #endif
+#ifdef __OPENTENBASE__
+#include "access/skey.h"
+#include "catalog/pg_proc.h"
+#include "nodes/nodeFuncs.h"
+#include "utils/datamask.h"
+#include "utils/lsyscache.h"
+#endif
 
 #ifdef __AUDIT_FGA__
 #include "audit/audit_fga.h"
@@ -44,6 +51,15 @@
 
 static bool InitScanRelation(SeqScanState *node, EState *estate, int eflags);
 static TupleTableSlot *SeqNext(SeqScanState *node);
+#ifdef __OPENTENBASE__
+static List *SeqScanExtractScanKeys(SeqScanState *node, List *quals);
+
+/*
+ * Evaluate simple "column op constant" quals of a plain seqscan as heap scan
+ * keys, which heapgetpage applies to a whole page at a time.
+ */
+bool		enable_seqscan_batch_filter = false;
+#endif
 
 /* ----------------------------------------------------------------
  *						Scan Support
@@ -79,9 +95,15 @@ SeqNext(SeqScanState *node)
 		 * We reach here if the scan is not parallel, or if we're executing a
 		 * scan that was intended to be parallel serially.
 		 */
+#ifdef __OPENTENBASE__
+		scandesc = heap_beginscan(node->ss.ss_currentRelation,
+								  estate->es_snapshot,
+								  node->ss_NumScanKeys, node->ss_ScanKeys);
+#else
 		scandesc = heap_beginscan(node->ss.ss_currentRelation,
 								  estate->es_snapshot,
 								  0, NULL);
+#endif
 		if(enable_distri_print)
 		{
 			elog(LOG, "seq scan snapshot local %d start ts "INT64_FORMAT " rel %s", estate->es_snapshot->local,
@@ -130,6 +152,28 @@ SeqNext(SeqScanState *node)
 static bool
 SeqRecheck(SeqScanState *node, TupleTableSlot *slot)
 {
+#ifdef __OPENTENBASE__
+	int			i;
+
+	/*
+	 * Quals converted to scan keys are no longer part of ps.qual, so the
+	 * recheck has to apply them.
+	 */
+	for (i = 0; i < node->ss_NumScanKeys; i++)
+	{
+		ScanKey		key = &node->ss_ScanKeys[i];
+		Datum		value;
+		bool		isnull;
+
+		value = slot_getattr(slot, key->sk_attno, &isnull);
+		if (isnull)
+			return false;
+		if (!DatumGetBool(FunctionCall2Coll(&key->sk_func,
+											key->sk_collation,
+											value, key->sk_argument)))
+			return false;
+	}
+#endif
 	/*
 	 * Note that unlike IndexScan, SeqScan never use keys in heap_beginscan
 	 * (and this is very bad) - so, here we do not check are keys ok or not.
@@ -293,9 +337,146 @@ ExecInitSeqScan(SeqScan *node, EState *estate, int eflags)
 	ExecAssignResultTypeFromTL(&scanstate->ss.ps);
 	ExecAssignScanProjectionInfo(&scanstate->ss);
 
+#ifdef __OPENTENBASE__
+	/*
+	 * Move the quals that heapam can evaluate itself into scan keys, and
+	 * leave only the rest to ExecQual.  Parallel scans build their scan
+	 * descriptor elsewhere, so leave them alone.
+	 */
+	if (enable_seqscan_batch_filter && !node->plan.parallel_aware &&
+		node->plan.qual != NIL)
+	{
+		List	   *quals;
+
+		quals = SeqScanExtractScanKeys(scanstate, node->plan.qual);
+		if (scanstate->ss_NumScanKeys > 0)
+			scanstate->ss.ps.qual =
+				ExecInitQual(quals, (PlanState *) scanstate);
+	}
+#endif
+
 	return scanstate;
 }
 
+#ifdef __OPENTENBASE__
+/*
+ * SeqScanExtractScanKeys
+ *
+ *		Convert quals of the form "var op const" (or "const op var") into
+ *		heap scan keys stored in the scan state, and return the quals that
+ *		still need to be evaluated by the executor.
+ *
+ *		Only strict, leakproof, non-volatile operators qualify, so evaluating
+ *		them ahead of the remaining quals is safe even under security
+ *		barrier quals.  Tables with data masking or transparent encryption
+ *		keep everything in the executor, since the stored values differ
+ *		from what the quals must see.
+ */
+static List *
+SeqScanExtractScanKeys(SeqScanState *node, List *quals)
+{
+	SeqScan    *plan = (SeqScan *) node->ss.ps.plan;
+	Relation	rel = node->ss.ss_currentRelation;
+	TupleDesc	tupdesc = RelationGetDescr(rel);
+	List	   *remaining = NIL;
+	ScanKey		keys;
+	int			nkeys = 0;
+	ListCell   *lc;
+
+#ifdef _MLS_
+	if (tupdesc->tdatamask != NULL || tupdesc->transp_crypt != NULL ||
+		tupdesc->use_attrs_ext ||
+		node->ss.ps.skip_data_mask_check != DATA_MASK_SKIP_ALL_TRUE)
+		return quals;
+#endif
+
+	keys = (ScanKey) palloc(list_length(quals) * sizeof(ScanKeyData));
+
+	foreach(lc, quals)
+	{
+		Expr	   *qual = (Expr *) lfirst(lc);
+		OpExpr	   *op;
+		Expr	   *leftop;
+		Expr	   *rightop;
+		Var		   *var;
+		Const	   *con;
+		Oid			opfuncid;
+
+		if (!IsA(qual, OpExpr) || list_length(((OpExpr *) qual)->args) != 2)
+		{
+			remaining = lappend(remaining, qual);
+			continue;
+		}
+
+		op = (OpExpr *) qual;
+		set_opfuncid(op);
+		opfuncid = op->opfuncid;
+
+		leftop = (Expr *) linitial(op->args);
+		rightop = (Expr *) lsecond(op->args);
+		if (leftop && IsA(leftop, RelabelType))
+			leftop = ((RelabelType *) leftop)->arg;
+		if (rightop && IsA(rightop, RelabelType))
+			rightop = ((RelabelType *) rightop)->arg;
+
+		if (IsA(rightop, Var) && IsA(leftop, Const))
+		{
+			Oid			commutator = get_commutator(op->opno);
+
+			if (!OidIsValid(commutator))
+			{
+				remaining = lappend(remaining, qual);
+				continue;
+			}
+			opfuncid = get_opcode(commutator);
+			var = (Var *) rightop;
+			con = (Const *) leftop;
+		}
+		else if (IsA(leftop, Var) && IsA(rightop, Const))
+		{
+			var = (Var *) leftop;
+			con = (Const *) rightop;
+		}
+		else
+		{
+			remaining = lappend(remaining, qual);
+			continue;
+		}
+
+		if (var->varno != plan->scanrelid || var->varlevelsup != 0 ||
+			var->varattno <= 0 || var->varattno > tupdesc->natts ||
+			con->constisnull || !OidIsValid(opfuncid) ||
+			!func_strict(opfuncid) || !get_func_leakproof(opfuncid) ||
+			func_volatile(opfuncid) == PROVOLATILE_VOLATILE)
+		{
+			remaining = lappend(remaining, qual);
+			continue;
+		}
+
+		ScanKeyEntryInitialize(&keys[nkeys++],
+							   0,
+							   var->varattno,
+							   InvalidStrategy,
+							   InvalidOid,
+							   op->inputcollid,
+							   opfuncid,
+							   con->constvalue);
+	}
+
+	if (nkeys == 0)
+	{
+		pfree(keys);
+		list_free(remaining);
+		return quals;
+	}
+
+	node->ss_NumScanKeys = nkeys;
+	node->ss_ScanKeys = keys;
+
+	return remaining;
+}
+#endif
+
 /* ----------------------------------------------------------------
  *		ExecEndSeqScan
  *
@@ -19,13 +19,21 @@
 #include "postgres.h"
 #include "miscadmin.h"
 
+#include "access/htup_details.h"
 #include "executor/producerReceiver.h"
 #include "pgxc/nodemgr.h"
+#include "pgxc/planner.h"
 #include "tcop/pquery.h"
+#include "utils/lsyscache.h"
 #include "utils/tuplestore.h"
 #include "utils/timestamp.h"
 #include "postmaster/postmaster.h"
 
+#ifdef __OPENTENBASE__
+/* GUC: size up to which the build side of adaptive broadcast is broadcast */
+int adaptive_broadcast_threshold = 8192;
+#endif
+
 typedef struct
 {
     DestReceiver pub;
@@ -51,9 +59,36 @@ typedef struct
 #ifdef __OPENTENBASE__
     uint64      send_tuples;        /* number of tuples sent to remote */
     TimestampTz send_total_time;    /* total time to send tuples */
+    /* data exchange breakdown, collected under EXPLAIN ANALYZE */
+    instr_time  instr_send_time;
+    double      instr_send_tuples;
+    double      instr_spill_tuples;
+    /* routing of tuples with a hot distribution key value */
+    char        skewPolicy;         /* SKEW_POLICY_xxx */
+    int         nskewvalues;
+    Datum      *skewvalues;
+    Oid         skewcollation;
+    FmgrInfo    skeweqfunc;         /* matches key against hot values */
+    int         nskewcons;          /* consumers hot tuples may go to */
+    int        *skewcons;
+    int         skewnext;           /* next consumer to spread to */
+    /* runtime choice between broadcast and redistribution */
+    Tuplestorestate *adaptivestore; /* tuples buffered until the choice */
+    Size        adaptivebytes;      /* size of the buffered tuples */
+    int         nadaptivecons;      /* consumers broadcast tuples go to */
+    int        *adaptivecons;
+    int         adaptivelocal;      /* consumer on this node to keep tuples */
+    bool        broadcast;          /* sent all tuples to every consumer */
+    bool        redistributed;      /* chose not to broadcast */
 #endif
 } ProducerState;
 
+static void producerDispatchSlot(ProducerState *myState, TupleTableSlot *slot,
+                                 int *targets, int ncount, bool direct);
+#ifdef __OPENTENBASE__
+static void producerAdaptiveDecide(ProducerState *myState, bool broadcast);
+#endif
+
 
 /*
  * Prepare to receive tuples from executor.
@@ -83,6 +118,27 @@ producerStartupReceiver(DestReceiver *self, int operation, TupleDesc typeinfo)
         (*myState->consumer->rStartup) (myState->consumer, operation, typeinfo);
 }
 
+#ifdef __OPENTENBASE__
+/*
+ * Check if the distribution key value is one of the hot values.
+ */
+static bool
+producerIsSkewValue(ProducerState *myState, Datum value)
+{
+    int i;
+
+    for (i = 0; i < myState->nskewvalues; i++)
+    {
+        if (DatumGetBool(FunctionCall2Coll(&myState->skeweqfunc,
+                                           myState->skewcollation,
+                                           value,
+                                           myState->skewvalues[i])))
+            return true;
+    }
+    return false;
+}
+#endif
+
 /*
  * Receive a tuple from the executor and dispatch it to the proper consumer
  */
@@ -92,7 +148,34 @@ producerReceiveSlot(TupleTableSlot *slot, DestReceiver *self)
     ProducerState *myState = (ProducerState *) self;
     Datum        value;
     bool        isnull;
-    int         ncount, i;
+    int         ncount;
+    int        *targets = myState->distNodes;
+    bool        skewed = false;
+
+#ifdef __OPENTENBASE__
+    /*
+     * Tuples of the build side of adaptive broadcast are buffered until the
+     * producer knows whether to broadcast or to redistribute them.
+     */
+    if (myState->adaptivestore)
+    {
+        MinimalTuple tuple = ExecFetchSlotMinimalTuple(slot);
+
+        myState->adaptivebytes += tuple->t_len;
+        tuplestore_puttupleslot(myState->adaptivestore, slot);
+        if (myState->adaptivebytes > (Size) adaptive_broadcast_threshold * 1024L)
+            producerAdaptiveDecide(myState, false);
+        return true;
+    }
+
+    /* The build side was broadcast, keep the probe side on this node */
+    if (myState->adaptivelocal != SQ_CONS_NONE)
+    {
+        myState->tcount++;
+        producerDispatchSlot(myState, slot, &myState->adaptivelocal, 1, true);
+        return true;
+    }
+#endif
 
     if (myState->distKey == InvalidAttrNumber)
     {
@@ -101,22 +184,60 @@ producerReceiveSlot(TupleTableSlot *slot, DestReceiver *self)
     }
     else
         value = slot_getattr(slot, myState->distKey, &isnull);
+#ifdef __OPENTENBASE__
+    /*
+     * Tuples with a hot key value are spread round-robin over the consumers,
+     * or sent to all of them, instead of going to the one the key hashes to.
+     * The targets are consumer indexes already.
+     */
+    if (myState->nskewcons > 0 && !isnull &&
+        producerIsSkewValue(myState, value))
+    {
+        skewed = true;
+        if (myState->skewPolicy == SKEW_POLICY_SPREAD)
+        {
+            targets = &myState->skewcons[myState->skewnext];
+            myState->skewnext = (myState->skewnext + 1) % myState->nskewcons;
+            ncount = 1;
+        }
+        else
+        {
+            targets = myState->skewcons;
+            ncount = myState->nskewcons;
+        }
+    }
+    else
+#endif
 #ifdef __COLD_HOT__
     ncount = GET_NODES(myState->locator, value, isnull, 0, true, NULL);
 #else
     ncount = GET_NODES(myState->locator, value, isnull, NULL);
 #endif
     myState->tcount++;
-    /* Dispatch the tuple */
+    producerDispatchSlot(myState, slot, targets, ncount, skewed);
+
+    return true;
+}
+
+/*
+ * Send the tuple to the consumers the locator returned. If direct is true the
+ * targets are consumer indexes already.
+ */
+static void
+producerDispatchSlot(ProducerState *myState, TupleTableSlot *slot,
+                     int *targets, int ncount, bool direct)
+{// #lizard forgives
+    int         i;
+
     for (i = 0; i < ncount; i++)
     {
         int consumerIdx;
 
         char locatorType = getLocatorDisType(myState->locator);
 
-        if ('S' == locatorType)
+        if ('S' == locatorType && !direct)
         {
-            int nodeid = myState->distNodes[i];
+            int nodeid = targets[i];
 
             Assert(nodeid < MAX_NODES_NUMBER);
 
@@ -137,7 +258,7 @@ producerReceiveSlot(TupleTableSlot *slot, DestReceiver *self)
         }
         else
         {
-            consumerIdx = myState->distNodes[i];
+            consumerIdx = targets[i];
         }
 
         if (consumerIdx == SQ_CONS_NONE)
@@ -159,8 +280,25 @@ producerReceiveSlot(TupleTableSlot *slot, DestReceiver *self)
              * are not yet pushed to the consumer queue.
              */
             MemoryContext savecontext;
+#ifdef __OPENTENBASE__
+            bool        instrument;
+            bool        timer;
+            instr_time  instr_start;
+            int64       nstored = 0;
+#endif
             Assert(ActivePortal);
             savecontext = MemoryContextSwitchTo(PortalGetHeapMemory(ActivePortal));
+#ifdef __OPENTENBASE__
+            instrument = (ActivePortal->up_instrument != 0);
+            timer = (ActivePortal->up_instrument & INSTRUMENT_TIMER) != 0;
+            if (instrument)
+            {
+                if (myState->tstores[consumerIdx])
+                    nstored = tuplestore_tuple_count(myState->tstores[consumerIdx]);
+                if (timer)
+                    INSTR_TIME_SET_CURRENT(instr_start);
+            }
+#endif
             if (g_UseDataPump)
             {
                 TimestampTz begin = 0;
@@ -188,15 +326,84 @@ producerReceiveSlot(TupleTableSlot *slot, DestReceiver *self)
                 SharedQueueWrite(myState->squeue, consumerIdx, slot,
                                  &myState->tstores[consumerIdx], myState->tmpcxt);
             }
+#ifdef __OPENTENBASE__
+            if (instrument)
+            {
+                instr_time  instr_end;
+                int64       nstored_after = 0;
+
+                if (timer)
+                {
+                    INSTR_TIME_SET_CURRENT(instr_end);
+                    INSTR_TIME_ACCUM_DIFF(myState->instr_send_time,
+                                          instr_end, instr_start);
+                }
+                myState->instr_send_tuples++;
+
+                /*
+                 * The local store only grows when the consumer queue is full;
+                 * it is cleared once completely dumped to the queue.
+                 */
+                if (myState->tstores[consumerIdx])
+                    nstored_after = tuplestore_tuple_count(myState->tstores[consumerIdx]);
+                if (nstored_after > 0 && nstored_after != nstored)
+                    myState->instr_spill_tuples++;
+            }
+#endif
             MemoryContextSwitchTo(savecontext);
             myState->othercount++;
         }
     }
-
-    return true;
 }
 
 
+#ifdef __OPENTENBASE__
+/*
+ * Stop buffering the build side of adaptive broadcast and send the buffered
+ * tuples either to all consumers, or to those the locator determines, like
+ * all tuples that follow.
+ */
+static void
+producerAdaptiveDecide(ProducerState *myState, bool broadcast)
+{
+    Tuplestorestate *store = myState->adaptivestore;
+
+    myState->adaptivestore = NULL;
+    if (broadcast)
+    {
+        myState->broadcast = true;
+        SharedQueueSetBroadcast(myState->squeue);
+    }
+    else
+    {
+        myState->redistributed = true;
+        SharedQueueSetRedistributed(myState->squeue);
+    }
+
+    if (tuplestore_tuple_count(store) > 0)
+    {
+        TupleTableSlot *slot = MakeSingleTupleTableSlot(myState->typeinfo);
+
+        while (tuplestore_gettupleslot(store, true, false, slot))
+        {
+            if (broadcast)
+            {
+                myState->tcount++;
+                producerDispatchSlot(myState, slot, myState->adaptivecons,
+                                     myState->nadaptivecons, true);
+            }
+            else
+                producerReceiveSlot(slot, (DestReceiver *) myState);
+        }
+        ExecDropSingleTupleTableSlot(slot);
+    }
+    tuplestore_end(store);
+
+    elog(DEBUG1, "adaptive broadcast: %s %zu bytes",
+         broadcast ? "broadcast" : "redistributed", myState->adaptivebytes);
+}
+#endif
+
 /*
  * Clean up at end of an executor run
  */
@@ -242,6 +449,13 @@ producerDestroyReceiver(DestReceiver *self)
         pfree(myState->nodeMap);
         myState->nodeMap = NULL;
     }
+
+    /* Executor did not complete, nobody needs the buffered tuples */
+    if (myState->adaptivestore)
+    {
+        tuplestore_end(myState->adaptivestore);
+        myState->adaptivestore = NULL;
+    }
 #endif
 
     /* Make sure all data are in the squeue */
@@ -304,6 +518,16 @@ CreateProducerDestReceiver(void)
     self->send_tuples     = 0;
     self->send_total_time = 0;
     self->nodeMap = NULL;
+    INSTR_TIME_SET_ZERO(self->instr_send_time);
+    self->instr_send_tuples = 0;
+    self->instr_spill_tuples = 0;
+    self->skewPolicy = SKEW_POLICY_NONE;
+    self->nskewvalues = 0;
+    self->nskewcons = 0;
+    self->adaptivestore = NULL;
+    self->adaptivelocal = SQ_CONS_NONE;
+    self->broadcast = false;
+    self->redistributed = false;
 #endif
 
     return (DestReceiver *) self;
@@ -390,6 +614,11 @@ ProducerReceiverPushBuffers(DestReceiver *self)
     ProducerState *myState = (ProducerState *) self;
 
     Assert(myState->pub.mydest == DestProducer);
+#ifdef __OPENTENBASE__
+    /* All tuples of the build side fit into the buffer, broadcast them */
+    if (myState->adaptivestore)
+        producerAdaptiveDecide(myState, true);
+#endif
     if (myState->tstores)
     {
         if (SharedQueueFinish(myState->squeue, myState->typeinfo,
@@ -417,4 +646,135 @@ SetProducerNodeMap(DestReceiver *self, int16 *nodemap)
 
     memcpy(myState->nodeMap, nodemap, sizeof(int16) * MAX_NODES_NUMBER);
 }
+
+/*
+ * Report data exchange time and volume collected for EXPLAIN ANALYZE.
+ */
+void
+GetProducerFragmentInstr(DestReceiver *self, FragmentInstrumentation *instr)
+{
+    ProducerState *myState = (ProducerState *) self;
+
+    Assert(myState->pub.mydest == DestProducer);
+    instr->valid = true;
+    instr->send_time = INSTR_TIME_GET_DOUBLE(myState->instr_send_time);
+    instr->send_tuples = myState->instr_send_tuples;
+    instr->spill_tuples = myState->instr_spill_tuples;
+}
+
+/*
+ * Set up routing of tuples with a hot distribution key value. consMap is
+ * the consumer map the locator was created with.
+ */
+void
+SetProducerSkewValues(DestReceiver *self, char skewPolicy, List *skewValues,
+                      Oid skewEqOp, int *consMap, int len)
+{
+    ProducerState *myState = (ProducerState *) self;
+    ListCell   *lc;
+    int         i;
+
+    Assert(myState->pub.mydest == DestProducer);
+    Assert(skewPolicy == SKEW_POLICY_SPREAD ||
+           skewPolicy == SKEW_POLICY_BROADCAST);
+
+    if (skewValues == NIL)
+        return;
+
+    myState->skewPolicy = skewPolicy;
+    myState->nskewvalues = 0;
+    myState->skewvalues = (Datum *) palloc(list_length(skewValues) * sizeof(Datum));
+    foreach(lc, skewValues)
+    {
+        Const *c = (Const *) lfirst(lc);
+
+        Assert(IsA(c, Const) && !c->constisnull);
+        myState->skewvalues[myState->nskewvalues++] = c->constvalue;
+        myState->skewcollation = c->constcollid;
+    }
+    fmgr_info(get_opcode(skewEqOp), &myState->skeweqfunc);
+
+    /* Consumers which won't read never get hot tuples */
+    myState->nskewcons = 0;
+    myState->skewcons = (int *) palloc(len * sizeof(int));
+    for (i = 0; i < len; i++)
+    {
+        if (consMap[i] != SQ_CONS_NONE)
+            myState->skewcons[myState->nskewcons++] = consMap[i];
+    }
+
+    /* Producers should not all start spreading at the same consumer */
+    if (myState->nskewcons > 0)
+        myState->skewnext = MyProcPid % myState->nskewcons;
+}
+
+/*
+ * Set up the runtime choice between broadcast and redistribution. The build
+ * side buffers its tuples, the probe side keeps its tuples on this node if
+ * the build side was broadcast. consMap is the consumer map the locator was
+ * created with.
+ */
+void
+SetProducerAdaptivePolicy(DestReceiver *self, char adaptivePolicy,
+                          List *distributionNodes, int *consMap, int len)
+{
+    ProducerState *myState = (ProducerState *) self;
+    ListCell   *lc;
+    int         i;
+
+    Assert(myState->pub.mydest == DestProducer);
+
+    if (adaptivePolicy == ADAPTIVE_POLICY_BUILD)
+    {
+        /* Consumers which won't read never get broadcast tuples */
+        myState->nadaptivecons = 0;
+        myState->adaptivecons = (int *) palloc(len * sizeof(int));
+        for (i = 0; i < len; i++)
+        {
+            if (consMap[i] != SQ_CONS_NONE)
+                myState->adaptivecons[myState->nadaptivecons++] = consMap[i];
+        }
+
+        myState->adaptivebytes = 0;
+        myState->adaptivestore = tuplestore_begin_heap(false, false, work_mem);
+    }
+    else if (adaptivePolicy == ADAPTIVE_POLICY_PROBE_LOCAL)
+    {
+        /* Tuples are redistributed if this node does not consume them */
+        i = 0;
+        foreach(lc, distributionNodes)
+        {
+            if (lfirst_int(lc) == PGXCNodeId - 1)
+            {
+                myState->adaptivelocal = consMap[i];
+                break;
+            }
+            i++;
+        }
+    }
+}
+
+/*
+ * Check if the producer sent all tuples to every consumer.
+ */
+bool
+ProducerReceiverBroadcast(DestReceiver *self)
+{
+    ProducerState *myState = (ProducerState *) self;
+
+    Assert(myState->pub.mydest == DestProducer);
+    return myState->broadcast;
+}
+
+/*
+ * Check if the producer chose not to send all tuples to every consumer.
+ */
+bool
+ProducerReceiverRedistributed(DestReceiver *self)
+{
+    ProducerState *myState = (ProducerState *) self;
+
+    Assert(myState->pub.mydest == DestProducer);
+    return myState->redistributed;
+}
 #endif
@@ -0,0 +1,397 @@
+/*-------------------------------------------------------------------------
+ *
+ * llvmjit.c
+ *      Core part of the LLVM JIT provider.
+ *
+ * Sets up the LLVM target, two ORC LLJIT instances (one generating code
+ * without optimization, one optimizing aggressively), and manages the
+ * lifetime of the code emitted on behalf of an executor.
+ *
+ * Portions Copyright (c) 1996-2017, PostgreSQL Global Development Group
+ *
+ * This source code file contains modifications made by THL A29 Limited ("Tencent Modifications").
+ * All Tencent Modifications are Copyright (C) 2023 THL A29 Limited.
+ *
+ * IDENTIFICATION
+ *      src/backend/jit/llvm/llvmjit.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+/* must come first, some backend headers define macros clashing with LLVM */
+#include "jit/llvmjit.h"
+
+#include <llvm-c/Analysis.h>
+#include <llvm-c/Error.h>
+#include <llvm-c/ErrorHandling.h>
+#include <llvm-c/Orc.h>
+#include <llvm-c/Target.h>
+#include <llvm-c/TargetMachine.h>
+#include <llvm-c/Transforms/PassBuilder.h>
+
+#include "fmgr.h"
+#include "miscadmin.h"
+#include "portability/instr_time.h"
+#include "utils/memutils.h"
+#include "utils/resowner_private.h"
+
+
+PG_MODULE_MAGIC;
+
+
+/* types used by generated code */
+LLVMContextRef llvm_context;
+LLVMTypeRef TypeVoid;
+LLVMTypeRef TypeParamBool;
+LLVMTypeRef TypeStorageBool;
+LLVMTypeRef TypeInt8;
+LLVMTypeRef TypeInt16;
+LLVMTypeRef TypeInt32;
+LLVMTypeRef TypeInt64;
+LLVMTypeRef TypeSizeT;
+LLVMTypeRef TypeDatum;
+LLVMTypeRef TypePtr;
+
+
+static bool llvm_session_initialized = false;
+static size_t llvm_generation = 0;
+
+static LLVMOrcThreadSafeContextRef llvm_ts_context;
+static LLVMTargetMachineRef llvm_opt0_tm;
+static LLVMTargetMachineRef llvm_opt3_tm;
+static LLVMOrcLLJITRef llvm_opt0_orc;
+static LLVMOrcLLJITRef llvm_opt3_orc;
+static char *llvm_triple = NULL;
+static char *llvm_layout = NULL;
+
+static void llvm_release_context(JitContext *context);
+static void llvm_session_initialize(void);
+static LLVMOrcLLJITRef llvm_create_jit_instance(LLVMCodeGenOptLevel level,
+                         LLVMTargetMachineRef *tm_for_passes);
+static void llvm_fatal_error_handler(const char *reason);
+static void llvm_raise_error(LLVMErrorRef error, const char *what)
+            pg_attribute_noreturn();
+
+
+/*
+ * Initialize LLVM JIT provider.
+ */
+void
+_PG_jit_provider_init(JitProviderCallbacks *cb)
+{
+    cb->release_context = llvm_release_context;
+    cb->compile_expr = llvm_compile_expr;
+}
+
+/*
+ * Create a context for JITing work.
+ *
+ * The context, including subsidiary resources, will be cleaned up either when
+ * the context is explicitly released, or when the lifetime of
+ * CurrentResourceOwner ends (usually the end of the current [sub]xact).
+ */
+LLVMJitContext *
+llvm_create_context(int jitFlags)
+{
+    LLVMJitContext *context;
+    LLVMOrcJITDylibRef dylib;
+
+    llvm_session_initialize();
+
+    ResourceOwnerEnlargeJIT(CurrentResourceOwner);
+
+    context = MemoryContextAllocZero(TopMemoryContext,
+                                     sizeof(LLVMJitContext));
+    context->base.flags = jitFlags;
+
+    if (jitFlags & PGJIT_OPT3)
+        context->lljit = llvm_opt3_orc;
+    else
+        context->lljit = llvm_opt0_orc;
+
+    dylib = LLVMOrcLLJITGetMainJITDylib(context->lljit);
+    context->resource_tracker = LLVMOrcJITDylibCreateResourceTracker(dylib);
+
+    /* ensure cleanup */
+    context->base.resowner = CurrentResourceOwner;
+    ResourceOwnerRememberJIT(CurrentResourceOwner, PointerGetDatum(context));
+
+    return context;
+}
+
+/*
+ * Release resources required by one llvm context.
+ */
+static void
+llvm_release_context(JitContext *context)
+{
+    LLVMJitContext *llvm_jit_context = (LLVMJitContext *) context;
+
+    if (llvm_jit_context->resource_tracker)
+    {
+        LLVMErrorRef error;
+
+        error = LLVMOrcResourceTrackerRemove(llvm_jit_context->resource_tracker);
+        LLVMOrcReleaseResourceTracker(llvm_jit_context->resource_tracker);
+        llvm_jit_context->resource_tracker = NULL;
+        if (error)
+        {
+            char       *msg = LLVMGetErrorMessage(error);
+
+            elog(WARNING, "failed to release JIT code: %s", msg);
+            LLVMDisposeErrorMessage(msg);
+        }
+    }
+
+    list_free_deep(llvm_jit_context->deform_functions);
+    llvm_jit_context->deform_functions = NIL;
+}
+
+/*
+ * Return a new module, in the context used for all generated code, ready to
+ * have functions added to it.
+ */
+LLVMModuleRef
+llvm_create_module(LLVMJitContext *context)
+{
+    LLVMModuleRef module;
+
+    module = LLVMModuleCreateWithNameInContext("pg", llvm_context);
+    LLVMSetTarget(module, llvm_triple);
+    LLVMSetDataLayout(module, llvm_layout);
+
+    return module;
+}
+
+/*
+ * Return a function name that is unique within the session, as all JITed
+ * code of a backend ends up in the same symbol namespace.
+ */
+char *
+llvm_expand_funcname(LLVMJitContext *context, const char *basename)
+{
+    return psprintf("%s_%zu", basename, ++llvm_generation);
+}
+
+/*
+ * Optimize the module and hand it to the JIT, transferring ownership.  The
+ * machine code is generated once a function of the module is looked up.
+ */
+void
+llvm_emit_module(LLVMJitContext *context, LLVMModuleRef module)
+{
+    LLVMOrcThreadSafeModuleRef ts_module;
+    LLVMPassBuilderOptionsRef options;
+    LLVMErrorRef error;
+    LLVMTargetMachineRef tm;
+    const char *passes;
+    instr_time    starttime;
+    instr_time    endtime;
+
+#ifdef USE_ASSERT_CHECKING
+    LLVMVerifyModule(module, LLVMAbortProcessAction, NULL);
+#endif
+
+    /* optimize according to the chosen optimization settings */
+    INSTR_TIME_SET_CURRENT(starttime);
+
+    if (context->base.flags & PGJIT_OPT3)
+    {
+        tm = llvm_opt3_tm;
+        passes = "default<O3>";
+    }
+    else
+    {
+        /* just get rid of the stack slots the generated code uses */
+        tm = llvm_opt0_tm;
+        passes = "mem2reg";
+    }
+
+    options = LLVMCreatePassBuilderOptions();
+    error = LLVMRunPasses(module, passes, tm, options);
+    LLVMDisposePassBuilderOptions(options);
+    if (error)
+        llvm_raise_error(error, "failed to optimize module");
+
+    INSTR_TIME_SET_CURRENT(endtime);
+    INSTR_TIME_ACCUM_DIFF(context->base.instr.optimization_counter,
+                          endtime, starttime);
+
+    /* and hand it to the JIT */
+    INSTR_TIME_SET_CURRENT(starttime);
+
+    ts_module = LLVMOrcCreateNewThreadSafeModule(module, llvm_ts_context);
+    error = LLVMOrcLLJITAddLLVMIRModuleWithRT(context->lljit,
+                                              context->resource_tracker,
+                                              ts_module);
+    if (error)
+        llvm_raise_error(error, "failed to JIT module");
+
+    INSTR_TIME_SET_CURRENT(endtime);
+    INSTR_TIME_ACCUM_DIFF(context->base.instr.emission_counter,
+                          endtime, starttime);
+}
+
+/*
+ * Return the address of an emitted function, generating machine code for
+ * its module if that hasn't happened yet.
+ */
+void *
+llvm_get_function(LLVMJitContext *context, const char *funcname)
+{
+    LLVMOrcExecutorAddress addr;
+    LLVMErrorRef error;
+    instr_time    starttime;
+    instr_time    endtime;
+
+    INSTR_TIME_SET_CURRENT(starttime);
+
+    error = LLVMOrcLLJITLookup(context->lljit, &addr, funcname);
+    if (error)
+        llvm_raise_error(error, "failed to JIT function");
+    if (addr == 0)
+        elog(ERROR, "failed to JIT: %s", funcname);
+
+    INSTR_TIME_SET_CURRENT(endtime);
+    INSTR_TIME_ACCUM_DIFF(context->base.instr.emission_counter,
+                          endtime, starttime);
+
+    return (void *) (uintptr_t) addr;
+}
+
+/*
+ * Per session initialization.
+ */
+static void
+llvm_session_initialize(void)
+{
+    MemoryContext oldcontext;
+    LLVMTargetRef llvm_target;
+    LLVMTargetMachineRef tm;
+    LLVMTargetDataRef layout;
+    char       *error = NULL;
+    char       *triple;
+
+    if (llvm_session_initialized)
+        return;
+
+    oldcontext = MemoryContextSwitchTo(TopMemoryContext);
+
+    LLVMInitializeNativeTarget();
+    LLVMInitializeNativeAsmPrinter();
+    LLVMInitializeNativeAsmParser();
+
+    /* route LLVM's fatal errors through our error handling */
+    LLVMInstallFatalErrorHandler(llvm_fatal_error_handler);
+
+    triple = LLVMGetDefaultTargetTriple();
+    llvm_triple = pstrdup(triple);
+    LLVMDisposeMessage(triple);
+
+    if (LLVMGetTargetFromTriple(llvm_triple, &llvm_target, &error) != 0)
+        elog(FATAL, "failed to query triple %s", error);
+
+    /* determine the data layout code is generated for */
+    tm = LLVMCreateTargetMachine(llvm_target, llvm_triple, "", "",
+                                 LLVMCodeGenLevelNone, LLVMRelocDefault,
+                                 LLVMCodeModelJITDefault);
+    layout = LLVMCreateTargetDataLayout(tm);
+    {
+        char       *layout_str = LLVMCopyStringRepOfTargetData(layout);
+
+        llvm_layout = pstrdup(layout_str);
+        LLVMDisposeMessage(layout_str);
+    }
+    LLVMDisposeTargetData(layout);
+    LLVMDisposeTargetMachine(tm);
+
+    /* all generated code lives in one LLVM context */
+    llvm_ts_context = LLVMOrcCreateNewThreadSafeContext();
+    llvm_context = LLVMOrcThreadSafeContextGetContext(llvm_ts_context);
+
+    TypeVoid = LLVMVoidTypeInContext(llvm_context);
+    TypeParamBool = LLVMInt1TypeInContext(llvm_context);
+    TypeStorageBool = LLVMInt8TypeInContext(llvm_context);
+    TypeInt8 = LLVMInt8TypeInContext(llvm_context);
+    TypeInt16 = LLVMInt16TypeInContext(llvm_context);
+    TypeInt32 = LLVMInt32TypeInContext(llvm_context);
+    TypeInt64 = LLVMInt64TypeInContext(llvm_context);
+    TypeSizeT = LLVMIntTypeInContext(llvm_context, sizeof(size_t) * 8);
+    TypeDatum = LLVMIntTypeInContext(llvm_context, sizeof(Datum) * 8);
+    TypePtr = LLVMPointerType(TypeInt8, 0);
+
+    llvm_opt0_orc = llvm_create_jit_instance(LLVMCodeGenLevelNone,
+                                             &llvm_opt0_tm);
+    llvm_opt3_orc = llvm_create_jit_instance(LLVMCodeGenLevelAggressive,
+                                             &llvm_opt3_tm);
+
+    llvm_session_initialized = true;
+
+    MemoryContextSwitchTo(oldcontext);
+}
+
+/*
+ * Create an LLJIT instance generating code for the host, with the given
+ * code generation level.  A separate target machine with the same settings
+ * is returned for use by the IR optimizer, as the JIT takes ownership of
+ * the one it is built with.
+ */
+static LLVMOrcLLJITRef
+llvm_create_jit_instance(LLVMCodeGenOptLevel level,
+                         LLVMTargetMachineRef *tm_for_passes)
+{
+    LLVMOrcLLJITBuilderRef builder;
+    LLVMOrcJITTargetMachineBuilderRef tm_builder;
+    LLVMOrcLLJITRef lljit;
+    LLVMTargetRef llvm_target;
+    LLVMErrorRef error;
+    char       *cpu;
+    char       *features;
+    char       *msg = NULL;
+
+    if (LLVMGetTargetFromTriple(llvm_triple, &llvm_target, &msg) != 0)
+        elog(FATAL, "failed to query triple %s", msg);
+
+    cpu = LLVMGetHostCPUName();
+    features = LLVMGetHostCPUFeatures();
+
+    *tm_for_passes = LLVMCreateTargetMachine(llvm_target, llvm_triple,
+                                             cpu, features, level,
+                                             LLVMRelocDefault,
+                                             LLVMCodeModelJITDefault);
+    tm_builder = LLVMOrcJITTargetMachineBuilderCreateFromTargetMachine(
+        LLVMCreateTargetMachine(llvm_target, llvm_triple, cpu, features,
+                                level, LLVMRelocDefault,
+                                LLVMCodeModelJITDefault));
+
+    LLVMDisposeMessage(cpu);
+    LLVMDisposeMessage(features);
+
+    builder = LLVMOrcCreateLLJITBuilder();
+    LLVMOrcLLJITBuilderSetJITTargetMachineBuilder(builder, tm_builder);
+
+    error = LLVMOrcCreateLLJIT(&lljit, builder);
+    if (error)
+        llvm_raise_error(error, "failed to create LLJIT instance");
+
+    return lljit;
+}
+
+static void
+llvm_fatal_error_handler(const char *reason)
+{
+    ereport(FATAL,
+            (errcode(ERRCODE_OUT_OF_MEMORY),
+             errmsg("fatal llvm error: %s", reason)));
+}
+
+static void
+llvm_raise_error(LLVMErrorRef error, const char *what)
+{
+    char       *msg = LLVMGetErrorMessage(error);
+    char       *copy = pstrdup(msg);
+
+    LLVMDisposeErrorMessage(msg);
+    elog(ERROR, "%s: %s", what, copy);
+}
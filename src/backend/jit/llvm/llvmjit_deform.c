@@ -0,0 +1,356 @@
+/*-------------------------------------------------------------------------
+ *
+ * llvmjit_deform.c
+ *      Generate code for deforming a heap tuple.
+ *
+ * This gains performance benefits over unJITed deforming from compile-time
+ * knowledge of the tuple descriptor.  Fixed column widths, NOT NULLness, etc
+ * can be taken advantage of.
+ *
+ * The generated function only handles the common case of a slot holding a
+ * physical tuple that hasn't been deformed at all yet and has all requested
+ * columns; everything else is handed to slot_getsomeattrs().
+ *
+ * Portions Copyright (c) 1996-2017, PostgreSQL Global Development Group
+ *
+ * This source code file contains modifications made by THL A29 Limited ("Tencent Modifications").
+ * All Tencent Modifications are Copyright (C) 2023 THL A29 Limited.
+ *
+ * IDENTIFICATION
+ *      src/backend/jit/llvm/llvmjit_deform.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/htup_details.h"
+#include "executor/tuptable.h"
+#include "jit/llvmjit.h"
+
+
+static size_t llvmjit_varsize_any(void *ptr);
+static LLVMValueRef l_align(LLVMBuilderRef b, LLVMValueRef off, char attalign);
+
+
+/*
+ * Create a function that deforms natts columns of a tuple with descriptor
+ * desc into a slot's values/isnull arrays.  The function takes the slot as
+ * its only argument.
+ */
+LLVMValueRef
+slot_compile_deform(LLVMJitContext *context, LLVMModuleRef mod,
+                    TupleDesc desc, int natts, const char *funcname)
+{
+    LLVMBuilderRef b;
+    LLVMTypeRef deform_sig;
+    LLVMValueRef v_deform_fn;
+    LLVMBasicBlockRef b_entry;
+    LLVMBasicBlockRef b_fallback;
+    LLVMBasicBlockRef b_check;
+    LLVMBasicBlockRef b_out;
+    LLVMBasicBlockRef *attstartblocks;
+    LLVMValueRef v_slot;
+    LLVMValueRef v_offp;
+    LLVMValueRef v_tuple;
+    LLVMValueRef v_tupheader;
+    LLVMValueRef v_tupdata;
+    LLVMValueRef v_bits;
+    LLVMValueRef v_hasnulls;
+    LLVMValueRef v_values;
+    LLVMValueRef v_nulls;
+    LLVMValueRef v_infomask;
+    LLVMValueRef v_maxatt;
+    LLVMValueRef v_hoff;
+    LLVMValueRef v_cond;
+    Form_pg_attribute *att = desc->attrs;
+    int            attnum;
+
+    /* offset of the current column, as long as it's known at compile time */
+    bool        known_off_valid = true;
+    long        known_off = 0;
+
+    Assert(natts > 0 && natts <= desc->natts);
+
+    deform_sig = LLVMFunctionType(TypeVoid, &TypePtr, 1, false);
+    v_deform_fn = LLVMAddFunction(mod, funcname, deform_sig);
+    LLVMSetLinkage(v_deform_fn, LLVMExternalLinkage);
+
+    b = LLVMCreateBuilderInContext(llvm_context);
+
+    b_entry = l_bb_append(v_deform_fn, "entry");
+    b_fallback = l_bb_append(v_deform_fn, "fallback");
+    b_check = l_bb_append(v_deform_fn, "check");
+    b_out = l_bb_append(v_deform_fn, "out");
+
+    attstartblocks = palloc(sizeof(LLVMBasicBlockRef) * natts);
+    for (attnum = 0; attnum < natts; attnum++)
+        attstartblocks[attnum] = l_bb_append(v_deform_fn, "attstart");
+
+    v_slot = LLVMGetParam(v_deform_fn, 0);
+
+    /*
+     * Only handle a slot that is known to contain a not yet deformed physical
+     * tuple of the expected type, otherwise use the generic code.
+     */
+    LLVMPositionBuilderAtEnd(b, b_entry);
+    v_offp = LLVMBuildAlloca(b, TypeSizeT, "v_offp");
+
+    v_cond = LLVMBuildICmp(b, LLVMIntEQ,
+                           l_load_field(b, TypePtr, v_slot,
+                                        offsetof(TupleTableSlot, tts_tupleDescriptor),
+                                        "tupdesc"),
+                           l_ptr_const(desc), "");
+#ifdef PGXC
+    v_cond = LLVMBuildAnd(b, v_cond,
+                          LLVMBuildIsNull(b,
+                                          l_load_field(b, TypePtr, v_slot,
+                                                       offsetof(TupleTableSlot, tts_datarow),
+                                                       "datarow"),
+                                          ""),
+                          "");
+#endif
+    v_cond = LLVMBuildAnd(b, v_cond,
+                          LLVMBuildICmp(b, LLVMIntEQ,
+                                        l_load_field(b, TypeInt32, v_slot,
+                                                     offsetof(TupleTableSlot, tts_nvalid),
+                                                     "nvalid"),
+                                        l_int32_const(0), ""),
+                          "");
+    v_tuple = l_load_field(b, TypePtr, v_slot,
+                           offsetof(TupleTableSlot, tts_tuple), "tuple");
+    v_cond = LLVMBuildAnd(b, v_cond, LLVMBuildIsNotNull(b, v_tuple, ""), "");
+    LLVMBuildCondBr(b, v_cond, b_check, b_fallback);
+
+    /* generic code path */
+    LLVMPositionBuilderAtEnd(b, b_fallback);
+    {
+        LLVMTypeRef params[2] = {TypePtr, TypeInt32};
+        LLVMValueRef args[2] = {v_slot, l_int32_const(natts)};
+
+        l_call(b, TypeVoid, slot_getsomeattrs, params, args, 2);
+        LLVMBuildRetVoid(b);
+    }
+
+    /* the tuple needs to have all the columns we're going to deform */
+    LLVMPositionBuilderAtEnd(b, b_check);
+    v_tupheader = l_load_field(b, TypePtr, v_tuple,
+                               offsetof(HeapTupleData, t_data), "t_data");
+    v_infomask = l_load_field(b, TypeInt16, v_tupheader,
+                              offsetof(HeapTupleHeaderData, t_infomask),
+                              "infomask");
+    v_maxatt = LLVMBuildAnd(b,
+                            l_load_field(b, TypeInt16, v_tupheader,
+                                         offsetof(HeapTupleHeaderData, t_infomask2),
+                                         "infomask2"),
+                            l_int16_const(HEAP_NATTS_MASK), "maxatt");
+    v_hasnulls = LLVMBuildICmp(b, LLVMIntNE,
+                               LLVMBuildAnd(b, v_infomask,
+                                            l_int16_const(HEAP_HASNULL), ""),
+                               l_int16_const(0), "hasnulls");
+    v_hoff = LLVMBuildZExt(b,
+                           l_load_field(b, TypeInt8, v_tupheader,
+                                        offsetof(HeapTupleHeaderData, t_hoff),
+                                        "t_hoff"),
+                           TypeSizeT, "");
+    v_tupdata = l_gep(b, v_tupheader, v_hoff);
+    v_bits = l_gep_const(b, v_tupheader, offsetof(HeapTupleHeaderData, t_bits));
+    v_values = l_load_field(b, TypePtr, v_slot,
+                            offsetof(TupleTableSlot, tts_values), "values");
+    v_nulls = l_load_field(b, TypePtr, v_slot,
+                           offsetof(TupleTableSlot, tts_isnull), "nulls");
+    LLVMBuildStore(b, l_sizet_const(0), v_offp);
+
+    LLVMBuildCondBr(b,
+                    LLVMBuildICmp(b, LLVMIntUGE, v_maxatt,
+                                  l_int16_const(natts), ""),
+                    attstartblocks[0], b_fallback);
+
+    for (attnum = 0; attnum < natts; attnum++)
+    {
+        Form_pg_attribute thisatt = att[attnum];
+        LLVMBasicBlockRef b_next;
+        LLVMValueRef v_off;
+        LLVMValueRef v_attdatap;
+        LLVMValueRef v_value;
+
+        b_next = (attnum + 1 < natts) ? attstartblocks[attnum + 1] : b_out;
+
+        LLVMPositionBuilderAtEnd(b, attstartblocks[attnum]);
+
+        /*
+         * Check for nulls if the tuple has any, unless the column is declared
+         * NOT NULL.  Tuples with fewer columns than natts never get here, so
+         * a NOT NULL column is reliably present.
+         */
+        if (!thisatt->attnotnull)
+        {
+            LLVMBasicBlockRef b_isnull = l_bb_append(v_deform_fn, "isnull");
+            LLVMBasicBlockRef b_checkbit = l_bb_append(v_deform_fn, "checkbit");
+            LLVMBasicBlockRef b_notnull = l_bb_append(v_deform_fn, "notnull");
+            LLVMValueRef v_byte;
+            LLVMValueRef v_bit;
+
+            LLVMBuildCondBr(b, v_hasnulls, b_checkbit, b_notnull);
+
+            LLVMPositionBuilderAtEnd(b, b_checkbit);
+            v_byte = l_load(b, TypeInt8,
+                            l_gep_const(b, v_bits, attnum >> 3), "nullbyte");
+            v_bit = LLVMBuildAnd(b, v_byte, l_int8_const(1 << (attnum & 0x07)), "");
+            LLVMBuildCondBr(b,
+                            LLVMBuildICmp(b, LLVMIntEQ, v_bit, l_int8_const(0), ""),
+                            b_isnull, b_notnull);
+
+            LLVMPositionBuilderAtEnd(b, b_isnull);
+            l_store(b, l_sizet_const(0),
+                    l_gep_const(b, v_values, attnum * sizeof(Datum)));
+            l_store(b, l_int8_const(1),
+                    l_gep_const(b, v_nulls, attnum * sizeof(bool)));
+            LLVMBuildBr(b, b_next);
+
+            LLVMPositionBuilderAtEnd(b, b_notnull);
+        }
+
+        l_store(b, l_int8_const(0),
+                l_gep_const(b, v_nulls, attnum * sizeof(bool)));
+
+        /* determine the column's offset */
+        if (known_off_valid &&
+            (thisatt->attlen != -1 ||
+             known_off == att_align_nominal(known_off, thisatt->attalign)))
+        {
+            known_off = att_align_nominal(known_off, thisatt->attalign);
+            v_off = l_sizet_const(known_off);
+        }
+        else if (thisatt->attlen == -1)
+        {
+            LLVMValueRef v_curoff = LLVMBuildLoad2(b, TypeSizeT, v_offp, "");
+            LLVMValueRef v_padbyte;
+
+            /*
+             * A varlena is either aligned, or starts with a nonzero short
+             * header byte right away; see att_align_pointer().
+             */
+            v_padbyte = l_load(b, TypeInt8, l_gep(b, v_tupdata, v_curoff), "");
+            v_off = LLVMBuildSelect(b,
+                                    LLVMBuildICmp(b, LLVMIntNE, v_padbyte,
+                                                  l_int8_const(0), ""),
+                                    v_curoff,
+                                    l_align(b, v_curoff, thisatt->attalign),
+                                    "");
+        }
+        else
+            v_off = l_align(b, LLVMBuildLoad2(b, TypeSizeT, v_offp, ""),
+                            thisatt->attalign);
+
+        v_attdatap = l_gep(b, v_tupdata, v_off);
+
+        /* fetch the value, see fetch_att() */
+        if (thisatt->attbyval && thisatt->attlen == sizeof(Datum))
+            v_value = l_load(b, TypeDatum, v_attdatap, "");
+        else if (thisatt->attbyval)
+        {
+            LLVMTypeRef vartype = LLVMIntTypeInContext(llvm_context,
+                                                       thisatt->attlen * 8);
+
+            v_value = LLVMBuildSExt(b, l_load(b, vartype, v_attdatap, ""),
+                                    TypeDatum, "");
+        }
+        else
+            v_value = LLVMBuildPtrToInt(b, v_attdatap, TypeDatum, "");
+        l_store(b, v_value, l_gep_const(b, v_values, attnum * sizeof(Datum)));
+
+        /* and advance past it */
+        if (thisatt->attlen > 0)
+        {
+            known_off += thisatt->attlen;
+            v_off = LLVMBuildAdd(b, v_off, l_sizet_const(thisatt->attlen), "");
+        }
+        else
+        {
+            LLVMValueRef v_len;
+
+            if (thisatt->attlen == -1)
+            {
+                LLVMValueRef arg = v_attdatap;
+
+                v_len = l_call(b, TypeSizeT, llvmjit_varsize_any,
+                               &TypePtr, &arg, 1);
+            }
+            else
+            {
+                LLVMValueRef arg = v_attdatap;
+
+                Assert(thisatt->attlen == -2);
+                v_len = l_call(b, TypeSizeT, strlen, &TypePtr, &arg, 1);
+                v_len = LLVMBuildAdd(b, v_len, l_sizet_const(1), "");
+            }
+            v_off = LLVMBuildAdd(b, v_off, v_len, "");
+        }
+        LLVMBuildStore(b, v_off, v_offp);
+
+        /*
+         * The offset of following columns stays a compile time constant only
+         * as long as all preceding columns have a fixed width and can't be
+         * NULL.
+         */
+        if (thisatt->attlen <= 0 || !thisatt->attnotnull)
+            known_off_valid = false;
+
+        LLVMBuildBr(b, b_next);
+    }
+
+    /* save state for an incremental slot_getsomeattrs() later on */
+    LLVMPositionBuilderAtEnd(b, b_out);
+    l_store_field(b, l_int32_const(natts), v_slot,
+                  offsetof(TupleTableSlot, tts_nvalid));
+    l_store_field(b, LLVMBuildLoad2(b, TypeSizeT, v_offp, ""), v_slot,
+                  offsetof(TupleTableSlot, tts_off));
+    l_store_field(b, l_int8_const(1), v_slot,
+                  offsetof(TupleTableSlot, tts_slow));
+    LLVMBuildRetVoid(b);
+
+    LLVMDisposeBuilder(b);
+    pfree(attstartblocks);
+
+    return v_deform_fn;
+}
+
+/* Length of a varlena, see VARSIZE_ANY(); called by generated code. */
+static size_t
+llvmjit_varsize_any(void *ptr)
+{
+    return VARSIZE_ANY(ptr);
+}
+
+/* align off for a column with alignment attalign */
+static LLVMValueRef
+l_align(LLVMBuilderRef b, LLVMValueRef off, char attalign)
+{
+    size_t        alignto;
+
+    switch (attalign)
+    {
+        case 'i':
+            alignto = ALIGNOF_INT;
+            break;
+        case 'c':
+            alignto = 1;
+            break;
+        case 'd':
+            alignto = ALIGNOF_DOUBLE;
+            break;
+        case 's':
+            alignto = ALIGNOF_SHORT;
+            break;
+        default:
+            elog(ERROR, "unknown alignment %c", attalign);
+            alignto = 0;        /* keep compiler quiet */
+            break;
+    }
+
+    if (alignto == 1)
+        return off;
+
+    off = LLVMBuildAdd(b, off, l_sizet_const(alignto - 1), "");
+    return LLVMBuildAnd(b, off, l_sizet_const(~(alignto - 1)), "");
+}
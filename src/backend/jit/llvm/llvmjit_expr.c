@@ -0,0 +1,1642 @@
+/*-------------------------------------------------------------------------
+ *
+ * llvmjit_expr.c
+ *      JIT compile expressions.
+ *
+ * The steps of an ExprState, as built by execExpr.c, are translated into
+ * one function, with a basic block per step.  Simple steps are implemented
+ * in IR, more complicated ones call the ExecEval* helpers shared with the
+ * interpreter in execExprInterp.c.
+ *
+ * Code is generated lazily, when an expression is evaluated for the first
+ * time.  That way expressions that are never evaluated don't incur any
+ * compilation overhead, and the slots the expression is evaluated against
+ * are known, which allows to generate tuple deforming code specific to their
+ * descriptors.
+ *
+ * Portions Copyright (c) 1996-2017, PostgreSQL Global Development Group
+ *
+ * This source code file contains modifications made by THL A29 Limited ("Tencent Modifications").
+ * All Tencent Modifications are Copyright (C) 2023 THL A29 Limited.
+ *
+ * IDENTIFICATION
+ *      src/backend/jit/llvm/llvmjit_expr.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/htup_details.h"
+#include "executor/execExpr.h"
+#include "executor/tuptable.h"
+#include "jit/llvmjit.h"
+#include "nodes/execnodes.h"
+#include "utils/expandeddatum.h"
+#include "utils/fmgroids.h"
+#include "utils/memutils.h"
+
+
+/*
+ * Builtin operators that are emitted as IR instead of being called when
+ * inlining is enabled.  Only strict functions that can't return NULL are
+ * candidates, so the IR doesn't need to deal with NULLs.
+ */
+typedef enum InlineOpKind
+{
+    INLINE_EQ,
+    INLINE_NE,
+    INLINE_LT,
+    INLINE_LE,
+    INLINE_GT,
+    INLINE_GE,
+    INLINE_PL,
+    INLINE_MI,
+    INLINE_MUL
+} InlineOpKind;
+
+typedef struct InlineOp
+{
+    Oid            fn_oid;
+    char        lefttype;        /* 'h' int2, 'i' int4, 'l' int8, 'o' oid */
+    char        righttype;
+    InlineOpKind kind;
+} InlineOp;
+
+#define INLINE_CMP_OPS(prefix, l, r) \
+    {prefix##EQ, l, r, INLINE_EQ}, \
+    {prefix##NE, l, r, INLINE_NE}, \
+    {prefix##LT, l, r, INLINE_LT}, \
+    {prefix##LE, l, r, INLINE_LE}, \
+    {prefix##GT, l, r, INLINE_GT}, \
+    {prefix##GE, l, r, INLINE_GE}
+
+static const InlineOp inline_ops[] =
+{
+    INLINE_CMP_OPS(F_INT2, 'h', 'h'),
+    INLINE_CMP_OPS(F_INT4, 'i', 'i'),
+    INLINE_CMP_OPS(F_INT8, 'l', 'l'),
+    INLINE_CMP_OPS(F_INT24, 'h', 'i'),
+    INLINE_CMP_OPS(F_INT42, 'i', 'h'),
+    INLINE_CMP_OPS(F_INT28, 'h', 'l'),
+    INLINE_CMP_OPS(F_INT82, 'l', 'h'),
+    INLINE_CMP_OPS(F_INT48, 'i', 'l'),
+    INLINE_CMP_OPS(F_INT84, 'l', 'i'),
+    INLINE_CMP_OPS(F_OID, 'o', 'o'),
+    INLINE_CMP_OPS(F_DATE_, 'i', 'i'),
+    INLINE_CMP_OPS(F_TIMESTAMP_, 'l', 'l'),
+    {F_INT4PL, 'i', 'i', INLINE_PL},
+    {F_INT4MI, 'i', 'i', INLINE_MI},
+    {F_INT4MUL, 'i', 'i', INLINE_MUL},
+    {F_INT8PL, 'l', 'l', INLINE_PL},
+    {F_INT8MI, 'l', 'l', INLINE_MI},
+    {F_INT8MUL, 'l', 'l', INLINE_MUL}
+};
+
+/* state needed while building the function for one expression */
+typedef struct ExprCompileState
+{
+    LLVMJitContext *context;
+    LLVMModuleRef mod;
+    LLVMBuilderRef b;
+    LLVMValueRef fn;
+    ExprState  *state;
+
+    /* function parameters */
+    LLVMValueRef v_state;
+    LLVMValueRef v_econtext;
+
+    /* slots of the expression context, loaded in the entry block */
+    LLVMValueRef v_innerslot;
+    LLVMValueRef v_outerslot;
+    LLVMValueRef v_scanslot;
+
+    /*
+     * Deforming functions generated into this module, not yet emitted, and
+     * their names.  The names are kept separately as the module is owned by
+     * the JIT once emitted.
+     */
+    List       *pending_deforms;
+    List       *pending_names;
+} ExprCompileState;
+
+
+static Datum ExecRunCompiledExpr(ExprState *state, ExprContext *econtext,
+                    bool *isNull);
+static ExprStateEvalFunc llvm_compile_expr_now(LLVMJitContext *context,
+                      ExprState *state, ExprContext *econtext);
+static bool expr_step_supported(ExprEvalOp opcode);
+static void build_fetchsome(ExprCompileState *cs, ExprEvalStep *op,
+                LLVMValueRef v_slot, TupleTableSlot *slot,
+                LLVMBasicBlockRef b_next);
+static void build_var(ExprCompileState *cs, ExprEvalStep *op,
+          LLVMValueRef v_slot, TupleTableSlot *slot, bool first);
+static void build_sysvar(ExprCompileState *cs, ExprEvalStep *op,
+             LLVMValueRef v_slot);
+static void build_assign_var(ExprCompileState *cs, ExprEvalStep *op,
+                 LLVMValueRef v_slot);
+static void build_funcexpr(ExprCompileState *cs, ExprEvalStep *op,
+               bool strict, LLVMBasicBlockRef b_next);
+static LLVMValueRef build_v1call(ExprCompileState *cs, FunctionCallInfo fcinfo,
+             PGFunction fn_addr, LLVMValueRef *v_isnull);
+static bool build_inline_op(ExprCompileState *cs, ExprEvalStep *op,
+                LLVMBasicBlockRef b_next);
+static void build_evalfunc(ExprCompileState *cs, const void *fn,
+               ExprEvalStep *op, bool pass_econtext);
+static LLVMValueRef l_bool_datum(LLVMBuilderRef b, LLVMValueRef v_bool);
+static LLVMValueRef l_datum_is_true(LLVMBuilderRef b, LLVMValueRef v_datum);
+static LLVMValueRef l_inline_arg(LLVMBuilderRef b, LLVMValueRef v_datum,
+             char type);
+
+
+/*
+ * JIT compile expression.
+ *
+ * Only checks whether the expression can be compiled; the actual work is
+ * deferred to its first evaluation.
+ */
+bool
+llvm_compile_expr(ExprState *state)
+{
+    int            i;
+
+    /*
+     * Very simple expressions are handled well by the interpreter's fast
+     * paths, compiling them isn't worth it.
+     */
+    if (state->steps_len <= 3)
+        return false;
+
+    for (i = 0; i < state->steps_len; i++)
+    {
+        if (!expr_step_supported((ExprEvalOp) state->steps[i].opcode))
+            return false;
+    }
+
+    state->evalfunc = ExecRunCompiledExpr;
+
+    return true;
+}
+
+/*
+ * Evaluation function of an expression that hasn't been compiled yet:
+ * compile it and replace itself with the generated function.
+ */
+static Datum
+ExecRunCompiledExpr(ExprState *state, ExprContext *econtext, bool *isNull)
+{
+    EState       *estate = state->parent->state;
+    ExprStateEvalFunc func;
+
+    if (estate->es_jit == NULL)
+        estate->es_jit = &llvm_create_context(estate->es_jit_flags)->base;
+
+    func = llvm_compile_expr_now((LLVMJitContext *) estate->es_jit,
+                                 state, econtext);
+    state->evalfunc = func;
+
+    return func(state, econtext, isNull);
+}
+
+/* is the opcode implemented by the code generator? */
+static bool
+expr_step_supported(ExprEvalOp opcode)
+{
+    switch (opcode)
+    {
+            /* tracking function usage isn't worth implementing */
+        case EEOP_FUNCEXPR_FUSAGE:
+        case EEOP_FUNCEXPR_STRICT_FUSAGE:
+        case EEOP_LAST:
+            return false;
+        default:
+            return true;
+    }
+}
+
+/*
+ * Generate, emit and return the function evaluating state, for evaluation
+ * in the given expression context.
+ */
+static ExprStateEvalFunc
+llvm_compile_expr_now(LLVMJitContext *context, ExprState *state,
+                      ExprContext *econtext)
+{
+    ExprCompileState cs;
+    LLVMBuilderRef b;
+    LLVMTypeRef eval_sig;
+    LLVMTypeRef param_types[3];
+    LLVMBasicBlockRef entry;
+    LLVMBasicBlockRef *opblocks;
+    ExprStateEvalFunc func;
+    MemoryContext oldcontext;
+    ListCell   *lc;
+    ListCell   *lc2;
+    char       *funcname;
+    int            i;
+    instr_time    starttime;
+    instr_time    endtime;
+
+    INSTR_TIME_SET_CURRENT(starttime);
+
+    memset(&cs, 0, sizeof(cs));
+    cs.context = context;
+    cs.state = state;
+    cs.mod = llvm_create_module(context);
+    cs.b = b = LLVMCreateBuilderInContext(llvm_context);
+
+    funcname = llvm_expand_funcname(context, "evalexpr");
+
+    /* Datum (*)(ExprState *, ExprContext *, bool *) */
+    param_types[0] = TypePtr;
+    param_types[1] = TypePtr;
+    param_types[2] = TypePtr;
+    eval_sig = LLVMFunctionType(TypeDatum, param_types, 3, false);
+    cs.fn = LLVMAddFunction(cs.mod, funcname, eval_sig);
+    LLVMSetLinkage(cs.fn, LLVMExternalLinkage);
+
+    entry = l_bb_append(cs.fn, "entry");
+
+    /* build one block for each step */
+    opblocks = palloc(sizeof(LLVMBasicBlockRef) * state->steps_len);
+    for (i = 0; i < state->steps_len; i++)
+        opblocks[i] = l_bb_append(cs.fn, "b.op.start");
+
+    LLVMPositionBuilderAtEnd(b, entry);
+    cs.v_state = LLVMGetParam(cs.fn, 0);
+    cs.v_econtext = LLVMGetParam(cs.fn, 1);
+    cs.v_innerslot = l_load_field(b, TypePtr, cs.v_econtext,
+                                  offsetof(ExprContext, ecxt_innertuple),
+                                  "v_innerslot");
+    cs.v_outerslot = l_load_field(b, TypePtr, cs.v_econtext,
+                                  offsetof(ExprContext, ecxt_outertuple),
+                                  "v_outerslot");
+    cs.v_scanslot = l_load_field(b, TypePtr, cs.v_econtext,
+                                 offsetof(ExprContext, ecxt_scantuple),
+                                 "v_scanslot");
+    LLVMBuildBr(b, opblocks[0]);
+
+    for (i = 0; i < state->steps_len; i++)
+    {
+        ExprEvalStep *op = &state->steps[i];
+        ExprEvalOp    opcode = (ExprEvalOp) op->opcode;
+        LLVMBasicBlockRef b_next;
+        LLVMValueRef v_resvaluep;
+        LLVMValueRef v_resnullp;
+
+        LLVMPositionBuilderAtEnd(b, opblocks[i]);
+
+        b_next = (i + 1 < state->steps_len) ? opblocks[i + 1] : NULL;
+        v_resvaluep = l_ptr_const(op->resvalue);
+        v_resnullp = l_ptr_const(op->resnull);
+
+        switch (opcode)
+        {
+            case EEOP_DONE:
+                {
+                    LLVMValueRef v_tmpvalue;
+                    LLVMValueRef v_tmpisnull;
+
+                    v_tmpvalue = l_load(b, TypeDatum,
+                                        l_ptr_const(&state->resvalue), "");
+                    v_tmpisnull = l_load(b, TypeStorageBool,
+                                         l_ptr_const(&state->resnull), "");
+                    l_store(b, v_tmpisnull, LLVMGetParam(cs.fn, 2));
+                    LLVMBuildRet(b, v_tmpvalue);
+                    break;
+                }
+
+            case EEOP_INNER_FETCHSOME:
+                build_fetchsome(&cs, op, cs.v_innerslot,
+                                econtext->ecxt_innertuple, b_next);
+                break;
+
+            case EEOP_OUTER_FETCHSOME:
+                build_fetchsome(&cs, op, cs.v_outerslot,
+                                econtext->ecxt_outertuple, b_next);
+                break;
+
+            case EEOP_SCAN_FETCHSOME:
+                build_fetchsome(&cs, op, cs.v_scanslot,
+                                econtext->ecxt_scantuple, b_next);
+                break;
+
+            case EEOP_INNER_VAR_FIRST:
+            case EEOP_INNER_VAR:
+                build_var(&cs, op, cs.v_innerslot, econtext->ecxt_innertuple,
+                          opcode == EEOP_INNER_VAR_FIRST);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_OUTER_VAR_FIRST:
+            case EEOP_OUTER_VAR:
+                build_var(&cs, op, cs.v_outerslot, econtext->ecxt_outertuple,
+                          opcode == EEOP_OUTER_VAR_FIRST);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_SCAN_VAR_FIRST:
+            case EEOP_SCAN_VAR:
+                build_var(&cs, op, cs.v_scanslot, econtext->ecxt_scantuple,
+                          opcode == EEOP_SCAN_VAR_FIRST);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_INNER_SYSVAR:
+                build_sysvar(&cs, op, cs.v_innerslot);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_OUTER_SYSVAR:
+                build_sysvar(&cs, op, cs.v_outerslot);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_SCAN_SYSVAR:
+                build_sysvar(&cs, op, cs.v_scanslot);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_WHOLEROW:
+                build_evalfunc(&cs, ExecEvalWholeRowVar, op, true);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_ASSIGN_INNER_VAR:
+                build_assign_var(&cs, op, cs.v_innerslot);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_ASSIGN_OUTER_VAR:
+                build_assign_var(&cs, op, cs.v_outerslot);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_ASSIGN_SCAN_VAR:
+                build_assign_var(&cs, op, cs.v_scanslot);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_ASSIGN_TMP:
+            case EEOP_ASSIGN_TMP_MAKE_RO:
+                {
+                    TupleTableSlot *resultslot = state->resultslot;
+                    size_t        resultnum = op->d.assign_tmp.resultnum;
+                    LLVMValueRef v_value;
+                    LLVMValueRef v_isnull;
+                    LLVMValueRef v_resultvalues;
+                    LLVMValueRef v_resultnulls;
+
+                    v_value = l_load(b, TypeDatum,
+                                     l_ptr_const(&state->resvalue), "");
+                    v_isnull = l_load(b, TypeStorageBool,
+                                      l_ptr_const(&state->resnull), "");
+                    v_resultvalues = l_load_field(b, TypePtr,
+                                                  l_ptr_const(resultslot),
+                                                  offsetof(TupleTableSlot, tts_values),
+                                                  "");
+                    v_resultnulls = l_load_field(b, TypePtr,
+                                                 l_ptr_const(resultslot),
+                                                 offsetof(TupleTableSlot, tts_isnull),
+                                                 "");
+
+                    if (opcode == EEOP_ASSIGN_TMP_MAKE_RO)
+                    {
+                        LLVMBasicBlockRef b_notnull;
+                        LLVMBasicBlockRef b_store;
+                        LLVMBasicBlockRef b_cur = LLVMGetInsertBlock(b);
+                        LLVMValueRef v_ro;
+                        LLVMValueRef v_phi;
+                        LLVMValueRef incoming_values[2];
+                        LLVMBasicBlockRef incoming_blocks[2];
+
+                        b_notnull = l_bb_append(cs.fn, "assign_tmp.notnull");
+                        b_store = l_bb_append(cs.fn, "assign_tmp.store");
+
+                        LLVMBuildCondBr(b, l_as_bool(b, v_isnull),
+                                        b_store, b_notnull);
+
+                        LLVMPositionBuilderAtEnd(b, b_notnull);
+                        v_ro = l_call(b, TypeDatum,
+                                      MakeExpandedObjectReadOnlyInternal,
+                                      &TypeDatum, &v_value, 1);
+                        LLVMBuildBr(b, b_store);
+
+                        LLVMPositionBuilderAtEnd(b, b_store);
+                        v_phi = LLVMBuildPhi(b, TypeDatum, "");
+                        incoming_values[0] = v_value;
+                        incoming_blocks[0] = b_cur;
+                        incoming_values[1] = v_ro;
+                        incoming_blocks[1] = b_notnull;
+                        LLVMAddIncoming(v_phi, incoming_values,
+                                        incoming_blocks, 2);
+                        v_value = v_phi;
+                    }
+
+                    l_store(b, v_value,
+                            l_gep_const(b, v_resultvalues,
+                                        resultnum * sizeof(Datum)));
+                    l_store(b, v_isnull,
+                            l_gep_const(b, v_resultnulls,
+                                        resultnum * sizeof(bool)));
+                    LLVMBuildBr(b, b_next);
+                    break;
+                }
+
+            case EEOP_CONST:
+                l_store(b, LLVMConstInt(TypeDatum, op->d.constval.value, false),
+                        v_resvaluep);
+                l_store(b, l_int8_const(op->d.constval.isnull), v_resnullp);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_FUNCEXPR:
+            case EEOP_FUNCEXPR_STRICT:
+                build_funcexpr(&cs, op, opcode == EEOP_FUNCEXPR_STRICT,
+                               b_next);
+                break;
+
+            case EEOP_BOOL_AND_STEP_FIRST:
+            case EEOP_BOOL_AND_STEP:
+            case EEOP_BOOL_OR_STEP_FIRST:
+            case EEOP_BOOL_OR_STEP:
+                {
+                    bool        is_and = (opcode == EEOP_BOOL_AND_STEP_FIRST ||
+                                          opcode == EEOP_BOOL_AND_STEP);
+                    LLVMValueRef v_anynullp = l_ptr_const(op->d.boolexpr.anynull);
+                    LLVMBasicBlockRef b_isnull;
+                    LLVMBasicBlockRef b_notnull;
+                    LLVMValueRef v_value;
+                    LLVMValueRef v_done;
+
+                    if (opcode == EEOP_BOOL_AND_STEP_FIRST ||
+                        opcode == EEOP_BOOL_OR_STEP_FIRST)
+                        l_store(b, l_int8_const(0), v_anynullp);
+
+                    b_isnull = l_bb_append(cs.fn, "boolstep.isnull");
+                    b_notnull = l_bb_append(cs.fn, "boolstep.notnull");
+
+                    LLVMBuildCondBr(b,
+                                    l_as_bool(b, l_load(b, TypeStorageBool,
+                                                        v_resnullp, "")),
+                                    b_isnull, b_notnull);
+
+                    /* remember that a NULL was seen */
+                    LLVMPositionBuilderAtEnd(b, b_isnull);
+                    l_store(b, l_int8_const(1), v_anynullp);
+                    LLVMBuildBr(b, b_next);
+
+                    /* the result is determined by a false (true) input */
+                    LLVMPositionBuilderAtEnd(b, b_notnull);
+                    v_value = l_load(b, TypeDatum, v_resvaluep, "");
+                    v_done = l_datum_is_true(b, v_value);
+                    if (is_and)
+                        v_done = LLVMBuildNot(b, v_done, "");
+                    LLVMBuildCondBr(b, v_done,
+                                    opblocks[op->d.boolexpr.jumpdone],
+                                    b_next);
+                    break;
+                }
+
+            case EEOP_BOOL_AND_STEP_LAST:
+            case EEOP_BOOL_OR_STEP_LAST:
+                {
+                    bool        is_and = (opcode == EEOP_BOOL_AND_STEP_LAST);
+                    LLVMBasicBlockRef b_notnull;
+                    LLVMBasicBlockRef b_checkany;
+                    LLVMBasicBlockRef b_setnull;
+                    LLVMValueRef v_determined;
+
+                    b_notnull = l_bb_append(cs.fn, "boollast.notnull");
+                    b_checkany = l_bb_append(cs.fn, "boollast.checkany");
+                    b_setnull = l_bb_append(cs.fn, "boollast.setnull");
+
+                    /* a NULL input leaves the NULL result in place */
+                    LLVMBuildCondBr(b,
+                                    l_as_bool(b, l_load(b, TypeStorageBool,
+                                                        v_resnullp, "")),
+                                    b_next, b_notnull);
+
+                    /* so does a false (true) input */
+                    LLVMPositionBuilderAtEnd(b, b_notnull);
+                    v_determined = l_datum_is_true(b, l_load(b, TypeDatum,
+                                                             v_resvaluep, ""));
+                    if (is_and)
+                        v_determined = LLVMBuildNot(b, v_determined, "");
+                    LLVMBuildCondBr(b, v_determined, b_next, b_checkany);
+
+                    /* otherwise the result is NULL if any input was NULL */
+                    LLVMPositionBuilderAtEnd(b, b_checkany);
+                    LLVMBuildCondBr(b,
+                                    l_as_bool(b, l_load(b, TypeStorageBool,
+                                                        l_ptr_const(op->d.boolexpr.anynull),
+                                                        "")),
+                                    b_setnull, b_next);
+
+                    LLVMPositionBuilderAtEnd(b, b_setnull);
+                    l_store(b, l_sizet_const(0), v_resvaluep);
+                    l_store(b, l_int8_const(1), v_resnullp);
+                    LLVMBuildBr(b, b_next);
+                    break;
+                }
+
+            case EEOP_BOOL_NOT_STEP:
+                {
+                    LLVMValueRef v_value;
+
+                    v_value = l_load(b, TypeDatum, v_resvaluep, "");
+                    v_value = LLVMBuildNot(b, l_datum_is_true(b, v_value), "");
+                    l_store(b, l_bool_datum(b, v_value), v_resvaluep);
+                    LLVMBuildBr(b, b_next);
+                    break;
+                }
+
+            case EEOP_QUAL:
+                {
+                    LLVMBasicBlockRef b_fail;
+                    LLVMValueRef v_isnull;
+                    LLVMValueRef v_false;
+
+                    b_fail = l_bb_append(cs.fn, "qual.fail");
+
+                    v_isnull = l_as_bool(b, l_load(b, TypeStorageBool,
+                                                   v_resnullp, ""));
+                    v_false = LLVMBuildNot(b,
+                                           l_datum_is_true(b, l_load(b, TypeDatum,
+                                                                     v_resvaluep, "")),
+                                           "");
+                    LLVMBuildCondBr(b, LLVMBuildOr(b, v_isnull, v_false, ""),
+                                    b_fail, b_next);
+
+                    /* bail out early, returning FALSE */
+                    LLVMPositionBuilderAtEnd(b, b_fail);
+                    l_store(b, l_int8_const(0), v_resnullp);
+                    l_store(b, l_sizet_const(0), v_resvaluep);
+                    LLVMBuildBr(b, opblocks[op->d.qualexpr.jumpdone]);
+                    break;
+                }
+
+            case EEOP_JUMP:
+                LLVMBuildBr(b, opblocks[op->d.jump.jumpdone]);
+                break;
+
+            case EEOP_JUMP_IF_NULL:
+            case EEOP_JUMP_IF_NOT_NULL:
+            case EEOP_JUMP_IF_NOT_TRUE:
+                {
+                    LLVMValueRef v_isnull;
+                    LLVMValueRef v_cond;
+
+                    v_isnull = l_as_bool(b, l_load(b, TypeStorageBool,
+                                                   v_resnullp, ""));
+                    if (opcode == EEOP_JUMP_IF_NULL)
+                        v_cond = v_isnull;
+                    else if (opcode == EEOP_JUMP_IF_NOT_NULL)
+                        v_cond = LLVMBuildNot(b, v_isnull, "");
+                    else
+                        v_cond = LLVMBuildOr(b, v_isnull,
+                                             LLVMBuildNot(b,
+                                                          l_datum_is_true(b,
+                                                                          l_load(b, TypeDatum,
+                                                                                 v_resvaluep, "")),
+                                                          ""),
+                                             "");
+                    LLVMBuildCondBr(b, v_cond,
+                                    opblocks[op->d.jump.jumpdone], b_next);
+                    break;
+                }
+
+            case EEOP_NULLTEST_ISNULL:
+            case EEOP_NULLTEST_ISNOTNULL:
+                {
+                    LLVMValueRef v_isnull;
+
+                    v_isnull = l_as_bool(b, l_load(b, TypeStorageBool,
+                                                   v_resnullp, ""));
+                    if (opcode == EEOP_NULLTEST_ISNOTNULL)
+                        v_isnull = LLVMBuildNot(b, v_isnull, "");
+                    l_store(b, l_bool_datum(b, v_isnull), v_resvaluep);
+                    l_store(b, l_int8_const(0), v_resnullp);
+                    LLVMBuildBr(b, b_next);
+                    break;
+                }
+
+            case EEOP_NULLTEST_ROWISNULL:
+                build_evalfunc(&cs, ExecEvalRowNull, op, true);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_NULLTEST_ROWISNOTNULL:
+                build_evalfunc(&cs, ExecEvalRowNotNull, op, true);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_BOOLTEST_IS_TRUE:
+            case EEOP_BOOLTEST_IS_NOT_TRUE:
+            case EEOP_BOOLTEST_IS_FALSE:
+            case EEOP_BOOLTEST_IS_NOT_FALSE:
+                {
+                    LLVMBasicBlockRef b_isnull;
+                    LLVMBasicBlockRef b_notnull;
+                    bool        null_result;
+
+                    b_isnull = l_bb_append(cs.fn, "booltest.isnull");
+                    b_notnull = l_bb_append(cs.fn, "booltest.notnull");
+
+                    LLVMBuildCondBr(b,
+                                    l_as_bool(b, l_load(b, TypeStorageBool,
+                                                        v_resnullp, "")),
+                                    b_isnull, b_notnull);
+
+                    /* NULL input yields a non-NULL result */
+                    LLVMPositionBuilderAtEnd(b, b_isnull);
+                    null_result = (opcode == EEOP_BOOLTEST_IS_NOT_TRUE ||
+                                   opcode == EEOP_BOOLTEST_IS_NOT_FALSE);
+                    l_store(b, l_sizet_const(null_result), v_resvaluep);
+                    l_store(b, l_int8_const(0), v_resnullp);
+                    LLVMBuildBr(b, b_next);
+
+                    /* otherwise the input is either the result, or inverted */
+                    LLVMPositionBuilderAtEnd(b, b_notnull);
+                    if (opcode == EEOP_BOOLTEST_IS_NOT_TRUE ||
+                        opcode == EEOP_BOOLTEST_IS_FALSE)
+                    {
+                        LLVMValueRef v_value;
+
+                        v_value = l_datum_is_true(b, l_load(b, TypeDatum,
+                                                            v_resvaluep, ""));
+                        v_value = LLVMBuildNot(b, v_value, "");
+                        l_store(b, l_bool_datum(b, v_value), v_resvaluep);
+                    }
+                    LLVMBuildBr(b, b_next);
+                    break;
+                }
+
+            case EEOP_PARAM_EXEC:
+                build_evalfunc(&cs, ExecEvalParamExec, op, true);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_PARAM_EXTERN:
+                build_evalfunc(&cs, ExecEvalParamExtern, op, true);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_CASE_TESTVAL:
+            case EEOP_DOMAIN_TESTVAL:
+                {
+                    LLVMValueRef v_valuep;
+                    LLVMValueRef v_isnullp;
+
+                    /* see the interpreter for why econtext is consulted */
+                    if (op->d.casetest.value)
+                    {
+                        v_valuep = l_ptr_const(op->d.casetest.value);
+                        v_isnullp = l_ptr_const(op->d.casetest.isnull);
+                    }
+                    else if (opcode == EEOP_CASE_TESTVAL)
+                    {
+                        v_valuep = l_gep_const(b, cs.v_econtext,
+                                               offsetof(ExprContext, caseValue_datum));
+                        v_isnullp = l_gep_const(b, cs.v_econtext,
+                                                offsetof(ExprContext, caseValue_isNull));
+                    }
+                    else
+                    {
+                        v_valuep = l_gep_const(b, cs.v_econtext,
+                                               offsetof(ExprContext, domainValue_datum));
+                        v_isnullp = l_gep_const(b, cs.v_econtext,
+                                                offsetof(ExprContext, domainValue_isNull));
+                    }
+
+                    l_store(b, l_load(b, TypeDatum, v_valuep, ""), v_resvaluep);
+                    l_store(b, l_load(b, TypeStorageBool, v_isnullp, ""),
+                            v_resnullp);
+                    LLVMBuildBr(b, b_next);
+                    break;
+                }
+
+            case EEOP_MAKE_READONLY:
+                {
+                    LLVMBasicBlockRef b_notnull;
+                    LLVMValueRef v_isnull;
+                    LLVMValueRef v_value;
+
+                    b_notnull = l_bb_append(cs.fn, "readonly.notnull");
+
+                    v_isnull = l_load(b, TypeStorageBool,
+                                      l_ptr_const(op->d.make_readonly.isnull), "");
+                    l_store(b, v_isnull, v_resnullp);
+                    LLVMBuildCondBr(b, l_as_bool(b, v_isnull), b_next, b_notnull);
+
+                    LLVMPositionBuilderAtEnd(b, b_notnull);
+                    v_value = l_load(b, TypeDatum,
+                                     l_ptr_const(op->d.make_readonly.value), "");
+                    v_value = l_call(b, TypeDatum,
+                                     MakeExpandedObjectReadOnlyInternal,
+                                     &TypeDatum, &v_value, 1);
+                    l_store(b, v_value, v_resvaluep);
+                    LLVMBuildBr(b, b_next);
+                    break;
+                }
+
+            case EEOP_IOCOERCE:
+                {
+                    FunctionCallInfo fcinfo_out = op->d.iocoerce.fcinfo_data_out;
+                    FunctionCallInfo fcinfo_in = op->d.iocoerce.fcinfo_data_in;
+                    LLVMBasicBlockRef b_isnull;
+                    LLVMBasicBlockRef b_output;
+                    LLVMBasicBlockRef b_input;
+                    LLVMBasicBlockRef b_calli;
+                    LLVMValueRef v_str;
+                    LLVMValueRef v_strnull;
+                    LLVMValueRef v_isnull;
+                    LLVMValueRef v_fcinfo_isnull;
+                    LLVMValueRef incoming_values[2];
+                    LLVMBasicBlockRef incoming_blocks[2];
+
+                    b_isnull = l_bb_append(cs.fn, "iocoerce.isnull");
+                    b_output = l_bb_append(cs.fn, "iocoerce.output");
+                    b_input = l_bb_append(cs.fn, "iocoerce.input");
+                    b_calli = l_bb_append(cs.fn, "iocoerce.calli");
+
+                    v_isnull = l_load(b, TypeStorageBool, v_resnullp, "");
+                    LLVMBuildCondBr(b, l_as_bool(b, v_isnull),
+                                    b_isnull, b_output);
+
+                    /* output functions are not called on nulls */
+                    LLVMPositionBuilderAtEnd(b, b_isnull);
+                    LLVMBuildBr(b, b_input);
+
+                    /* call output function (similar to OutputFunctionCall) */
+                    LLVMPositionBuilderAtEnd(b, b_output);
+                    l_store(b, l_load(b, TypeDatum, v_resvaluep, ""),
+                            l_ptr_const(&fcinfo_out->arg[0]));
+                    l_store(b, l_int8_const(0),
+                            l_ptr_const(&fcinfo_out->argnull[0]));
+                    v_str = build_v1call(&cs, fcinfo_out,
+                                         op->d.iocoerce.finfo_out->fn_addr,
+                                         &v_fcinfo_isnull);
+                    LLVMBuildBr(b, b_input);
+
+                    LLVMPositionBuilderAtEnd(b, b_input);
+                    v_strnull = LLVMBuildPhi(b, TypeDatum, "");
+                    incoming_values[0] = l_sizet_const(0);
+                    incoming_blocks[0] = b_isnull;
+                    incoming_values[1] = v_str;
+                    incoming_blocks[1] = b_output;
+                    LLVMAddIncoming(v_strnull, incoming_values,
+                                    incoming_blocks, 2);
+
+                    /* a strict input function isn't called on NULL */
+                    if (op->d.iocoerce.finfo_in->fn_strict)
+                        LLVMBuildCondBr(b, l_as_bool(b, v_isnull),
+                                        b_next, b_calli);
+                    else
+                        LLVMBuildBr(b, b_calli);
+
+                    /* call input function (similar to InputFunctionCall) */
+                    LLVMPositionBuilderAtEnd(b, b_calli);
+                    l_store(b, v_strnull, l_ptr_const(&fcinfo_in->arg[0]));
+                    l_store(b, v_isnull, l_ptr_const(&fcinfo_in->argnull[0]));
+                    l_store(b,
+                            build_v1call(&cs, fcinfo_in,
+                                         op->d.iocoerce.finfo_in->fn_addr,
+                                         &v_fcinfo_isnull),
+                            v_resvaluep);
+                    LLVMBuildBr(b, b_next);
+                    break;
+                }
+
+            case EEOP_DISTINCT:
+            case EEOP_NULLIF:
+                {
+                    FunctionCallInfo fcinfo = op->d.func.fcinfo_data;
+                    LLVMBasicBlockRef b_anynull;
+                    LLVMBasicBlockRef b_call;
+                    LLVMValueRef v_argnull0;
+                    LLVMValueRef v_argnull1;
+                    LLVMValueRef v_result;
+                    LLVMValueRef v_fcinfo_isnull;
+
+                    b_anynull = l_bb_append(cs.fn, "cmp.anynull");
+                    b_call = l_bb_append(cs.fn, "cmp.call");
+
+                    v_argnull0 = l_as_bool(b, l_load(b, TypeStorageBool,
+                                                     l_ptr_const(&fcinfo->argnull[0]),
+                                                     ""));
+                    v_argnull1 = l_as_bool(b, l_load(b, TypeStorageBool,
+                                                     l_ptr_const(&fcinfo->argnull[1]),
+                                                     ""));
+                    LLVMBuildCondBr(b, LLVMBuildOr(b, v_argnull0, v_argnull1, ""),
+                                    b_anynull, b_call);
+
+                    LLVMPositionBuilderAtEnd(b, b_anynull);
+                    if (opcode == EEOP_DISTINCT)
+                    {
+                        /* distinct unless both are NULL */
+                        l_store(b,
+                                l_bool_datum(b, LLVMBuildXor(b, v_argnull0,
+                                                             v_argnull1, "")),
+                                v_resvaluep);
+                        l_store(b, l_int8_const(0), v_resnullp);
+                    }
+                    else
+                    {
+                        /* if either argument is NULL they can't be equal */
+                        l_store(b,
+                                l_load(b, TypeDatum,
+                                       l_ptr_const(&fcinfo->arg[0]), ""),
+                                v_resvaluep);
+                        l_store(b, LLVMBuildZExt(b, v_argnull0, TypeStorageBool, ""),
+                                v_resnullp);
+                    }
+                    LLVMBuildBr(b, b_next);
+
+                    /* neither NULL, so apply the equality function */
+                    LLVMPositionBuilderAtEnd(b, b_call);
+                    v_result = build_v1call(&cs, fcinfo, op->d.func.fn_addr,
+                                            &v_fcinfo_isnull);
+                    if (opcode == EEOP_DISTINCT)
+                    {
+                        /* must invert result of "="; safe to do even if null */
+                        l_store(b,
+                                l_bool_datum(b, LLVMBuildNot(b,
+                                                             l_datum_is_true(b, v_result),
+                                                             "")),
+                                v_resvaluep);
+                        l_store(b, v_fcinfo_isnull, v_resnullp);
+                        LLVMBuildBr(b, b_next);
+                    }
+                    else
+                    {
+                        LLVMBasicBlockRef b_equal;
+                        LLVMBasicBlockRef b_unequal;
+                        LLVMValueRef v_equal;
+
+                        b_equal = l_bb_append(cs.fn, "nullif.equal");
+                        b_unequal = l_bb_append(cs.fn, "nullif.unequal");
+
+                        /* if the arguments are equal return null */
+                        v_equal = LLVMBuildAnd(b,
+                                               LLVMBuildNot(b, l_as_bool(b, v_fcinfo_isnull), ""),
+                                               l_datum_is_true(b, v_result), "");
+                        LLVMBuildCondBr(b, v_equal, b_equal, b_unequal);
+
+                        LLVMPositionBuilderAtEnd(b, b_equal);
+                        l_store(b, l_sizet_const(0), v_resvaluep);
+                        l_store(b, l_int8_const(1), v_resnullp);
+                        LLVMBuildBr(b, b_next);
+
+                        /* arguments aren't equal, so return the first one */
+                        LLVMPositionBuilderAtEnd(b, b_unequal);
+                        l_store(b,
+                                l_load(b, TypeDatum,
+                                       l_ptr_const(&fcinfo->arg[0]), ""),
+                                v_resvaluep);
+                        l_store(b, l_int8_const(0), v_resnullp);
+                        LLVMBuildBr(b, b_next);
+                    }
+                    break;
+                }
+
+            case EEOP_SQLVALUEFUNCTION:
+                build_evalfunc(&cs, ExecEvalSQLValueFunction, op, false);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_CURRENTOFEXPR:
+                build_evalfunc(&cs, ExecEvalCurrentOfExpr, op, false);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_NEXTVALUEEXPR:
+                build_evalfunc(&cs, ExecEvalNextValueExpr, op, false);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_ARRAYEXPR:
+                build_evalfunc(&cs, ExecEvalArrayExpr, op, false);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_ARRAYCOERCE:
+                build_evalfunc(&cs, ExecEvalArrayCoerce, op, false);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_ROW:
+                build_evalfunc(&cs, ExecEvalRow, op, false);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_ROWCOMPARE_STEP:
+                {
+                    FunctionCallInfo fcinfo = op->d.rowcompare_step.fcinfo_data;
+                    LLVMBasicBlockRef b_null;
+                    LLVMBasicBlockRef b_call;
+                    LLVMBasicBlockRef b_notnull;
+                    LLVMValueRef v_result;
+                    LLVMValueRef v_fcinfo_isnull;
+                    LLVMValueRef v_cmp;
+
+                    b_null = l_bb_append(cs.fn, "rowcmp.null");
+                    b_call = l_bb_append(cs.fn, "rowcmp.call");
+                    b_notnull = l_bb_append(cs.fn, "rowcmp.notnull");
+
+                    /* force NULL result if strict fn and NULL input */
+                    if (op->d.rowcompare_step.finfo->fn_strict)
+                    {
+                        LLVMValueRef v_anynull;
+
+                        v_anynull = LLVMBuildOr(b,
+                                                l_as_bool(b, l_load(b, TypeStorageBool,
+                                                                    l_ptr_const(&fcinfo->argnull[0]),
+                                                                    "")),
+                                                l_as_bool(b, l_load(b, TypeStorageBool,
+                                                                    l_ptr_const(&fcinfo->argnull[1]),
+                                                                    "")),
+                                                "");
+                        LLVMBuildCondBr(b, v_anynull, b_null, b_call);
+                    }
+                    else
+                        LLVMBuildBr(b, b_call);
+
+                    LLVMPositionBuilderAtEnd(b, b_null);
+                    l_store(b, l_int8_const(1), v_resnullp);
+                    LLVMBuildBr(b, opblocks[op->d.rowcompare_step.jumpnull]);
+
+                    /* apply comparison function */
+                    LLVMPositionBuilderAtEnd(b, b_call);
+                    v_result = build_v1call(&cs, fcinfo,
+                                            op->d.rowcompare_step.fn_addr,
+                                            &v_fcinfo_isnull);
+                    l_store(b, v_result, v_resvaluep);
+                    LLVMBuildCondBr(b, l_as_bool(b, v_fcinfo_isnull),
+                                    b_null, b_notnull);
+
+                    /* if unequal, no need to compare remaining columns */
+                    LLVMPositionBuilderAtEnd(b, b_notnull);
+                    l_store(b, l_int8_const(0), v_resnullp);
+                    v_cmp = LLVMBuildICmp(b, LLVMIntNE,
+                                          LLVMBuildTrunc(b, v_result, TypeInt32, ""),
+                                          l_int32_const(0), "");
+                    LLVMBuildCondBr(b, v_cmp,
+                                    opblocks[op->d.rowcompare_step.jumpdone],
+                                    b_next);
+                    break;
+                }
+
+            case EEOP_ROWCOMPARE_FINAL:
+                {
+                    LLVMValueRef v_cmpresult;
+                    LLVMIntPredicate predicate;
+
+                    switch (op->d.rowcompare_final.rctype)
+                    {
+                            /* EQ and NE cases aren't allowed here */
+                        case ROWCOMPARE_LT:
+                            predicate = LLVMIntSLT;
+                            break;
+                        case ROWCOMPARE_LE:
+                            predicate = LLVMIntSLE;
+                            break;
+                        case ROWCOMPARE_GT:
+                            predicate = LLVMIntSGT;
+                            break;
+                        case ROWCOMPARE_GE:
+                            predicate = LLVMIntSGE;
+                            break;
+                        default:
+                            elog(ERROR, "unrecognized rowcompare type: %d",
+                                 (int) op->d.rowcompare_final.rctype);
+                            predicate = 0;    /* keep compiler quiet */
+                            break;
+                    }
+
+                    v_cmpresult = LLVMBuildTrunc(b,
+                                                 l_load(b, TypeDatum, v_resvaluep, ""),
+                                                 TypeInt32, "");
+                    v_cmpresult = LLVMBuildICmp(b, predicate, v_cmpresult,
+                                                l_int32_const(0), "");
+                    l_store(b, l_int8_const(0), v_resnullp);
+                    l_store(b, l_bool_datum(b, v_cmpresult), v_resvaluep);
+                    LLVMBuildBr(b, b_next);
+                    break;
+                }
+
+            case EEOP_MINMAX:
+                build_evalfunc(&cs, ExecEvalMinMax, op, false);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_FIELDSELECT:
+                build_evalfunc(&cs, ExecEvalFieldSelect, op, true);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_FIELDSTORE_DEFORM:
+                build_evalfunc(&cs, ExecEvalFieldStoreDeForm, op, true);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_FIELDSTORE_FORM:
+                build_evalfunc(&cs, ExecEvalFieldStoreForm, op, true);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_ARRAYREF_SUBSCRIPT:
+                {
+                    LLVMTypeRef params[2] = {TypePtr, TypePtr};
+                    LLVMValueRef args[2];
+                    LLVMValueRef v_ret;
+
+                    args[0] = l_ptr_const(state);
+                    args[1] = l_ptr_const(op);
+                    v_ret = l_call(b, TypeStorageBool, ExecEvalArrayRefSubscript,
+                                   params, args, 2);
+
+                    /* subscript is null, short-circuit ArrayRef to NULL */
+                    LLVMBuildCondBr(b, l_as_bool(b, v_ret), b_next,
+                                    opblocks[op->d.arrayref_subscript.jumpdone]);
+                    break;
+                }
+
+            case EEOP_ARRAYREF_OLD:
+                build_evalfunc(&cs, ExecEvalArrayRefOld, op, false);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_ARRAYREF_ASSIGN:
+                build_evalfunc(&cs, ExecEvalArrayRefAssign, op, false);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_ARRAYREF_FETCH:
+                build_evalfunc(&cs, ExecEvalArrayRefFetch, op, false);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_DOMAIN_NOTNULL:
+                build_evalfunc(&cs, ExecEvalConstraintNotNull, op, false);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_DOMAIN_CHECK:
+                build_evalfunc(&cs, ExecEvalConstraintCheck, op, false);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_CONVERT_ROWTYPE:
+                build_evalfunc(&cs, ExecEvalConvertRowtype, op, true);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_SCALARARRAYOP:
+                build_evalfunc(&cs, ExecEvalScalarArrayOp, op, false);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_XMLEXPR:
+                build_evalfunc(&cs, ExecEvalXmlExpr, op, false);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_AGGREF:
+            case EEOP_WINDOW_FUNC:
+                {
+                    LLVMValueRef v_no;
+                    LLVMValueRef v_aggvalues;
+                    LLVMValueRef v_aggnulls;
+
+                    /*
+                     * Return the precomputed value found in the expression
+                     * context.  The number is read at runtime, as it's only
+                     * assigned once the plan node is fully initialized.
+                     */
+                    if (opcode == EEOP_AGGREF)
+                        v_no = l_load(b, TypeInt32,
+                                      l_ptr_const(&op->d.aggref.astate->aggno),
+                                      "aggno");
+                    else
+                        v_no = l_load(b, TypeInt32,
+                                      l_ptr_const(&op->d.window_func.wfstate->wfuncno),
+                                      "wfuncno");
+
+                    v_aggvalues = l_load_field(b, TypePtr, cs.v_econtext,
+                                               offsetof(ExprContext, ecxt_aggvalues),
+                                               "aggvalues");
+                    v_aggnulls = l_load_field(b, TypePtr, cs.v_econtext,
+                                              offsetof(ExprContext, ecxt_aggnulls),
+                                              "aggnulls");
+
+                    l_store(b,
+                            l_load(b, TypeDatum,
+                                   l_array_elem(b, v_aggvalues, v_no, sizeof(Datum)),
+                                   ""),
+                            v_resvaluep);
+                    l_store(b,
+                            l_load(b, TypeStorageBool,
+                                   l_array_elem(b, v_aggnulls, v_no, sizeof(bool)),
+                                   ""),
+                            v_resnullp);
+                    LLVMBuildBr(b, b_next);
+                    break;
+                }
+
+            case EEOP_GROUPING_FUNC:
+                build_evalfunc(&cs, ExecEvalGroupingFunc, op, false);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_SUBPLAN:
+                build_evalfunc(&cs, ExecEvalSubPlan, op, true);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_ALTERNATIVE_SUBPLAN:
+                build_evalfunc(&cs, ExecEvalAlternativeSubPlan, op, true);
+                LLVMBuildBr(b, b_next);
+                break;
+
+            case EEOP_FUNCEXPR_FUSAGE:
+            case EEOP_FUNCEXPR_STRICT_FUSAGE:
+            case EEOP_LAST:
+                elog(ERROR, "unexpected expression step %d", (int) opcode);
+                break;
+        }
+    }
+
+    LLVMDisposeBuilder(b);
+    pfree(opblocks);
+
+    INSTR_TIME_SET_CURRENT(endtime);
+    INSTR_TIME_ACCUM_DIFF(context->base.instr.generation_counter,
+                          endtime, starttime);
+
+    /* generate machine code and look up the functions */
+    llvm_emit_module(context, cs.mod);
+
+    func = (ExprStateEvalFunc) llvm_get_function(context, funcname);
+    context->base.instr.created_functions++;
+
+    oldcontext = MemoryContextSwitchTo(TopMemoryContext);
+    forboth(lc, cs.pending_deforms, lc2, cs.pending_names)
+    {
+        LLVMJitDeform *deform = (LLVMJitDeform *) lfirst(lc);
+        LLVMJitDeform *emitted = palloc(sizeof(LLVMJitDeform));
+
+        emitted->desc = deform->desc;
+        emitted->natts = deform->natts;
+        emitted->func = llvm_get_function(context, (char *) lfirst(lc2));
+        context->deform_functions = lappend(context->deform_functions,
+                                            emitted);
+        context->base.instr.created_functions++;
+    }
+    MemoryContextSwitchTo(oldcontext);
+
+    return func;
+}
+
+/*
+ * Make sure the first last_var columns of a slot are deformed.
+ *
+ * If the slot's descriptor is known, use a deforming function generated for
+ * it, otherwise call slot_getsomeattrs().
+ */
+static void
+build_fetchsome(ExprCompileState *cs, ExprEvalStep *op, LLVMValueRef v_slot,
+                TupleTableSlot *slot, LLVMBasicBlockRef b_next)
+{
+    LLVMBuilderRef b = cs->b;
+    LLVMBasicBlockRef b_fetch;
+    LLVMValueRef v_nvalid;
+    TupleDesc    desc = slot ? slot->tts_tupleDescriptor : NULL;
+    int            natts = op->d.fetch.last_var;
+
+    b_fetch = l_bb_append(cs->fn, "fetchsome.fetch");
+
+    /* quick out if we have 'em all already */
+    v_nvalid = l_load_field(b, TypeInt32, v_slot,
+                            offsetof(TupleTableSlot, tts_nvalid), "nvalid");
+    LLVMBuildCondBr(b,
+                    LLVMBuildICmp(b, LLVMIntSGE, v_nvalid,
+                                  l_int32_const(natts), ""),
+                    b_next, b_fetch);
+
+    LLVMPositionBuilderAtEnd(b, b_fetch);
+
+    if ((cs->context->base.flags & PGJIT_DEFORM) &&
+        desc != NULL && natts > 0 && natts <= desc->natts
+#ifdef _MLS_
+        && !desc->use_attrs_ext
+#endif
+        )
+    {
+        LLVMTypeRef deform_sig = LLVMFunctionType(TypeVoid, &TypePtr, 1, false);
+        LLVMValueRef v_deform = NULL;
+        ListCell   *lc;
+
+        /* already emitted before? */
+        foreach(lc, cs->context->deform_functions)
+        {
+            LLVMJitDeform *deform = (LLVMJitDeform *) lfirst(lc);
+
+            if (deform->desc == desc && deform->natts == natts)
+            {
+                v_deform = l_func_const(deform_sig, deform->func);
+                break;
+            }
+        }
+
+        /* or generated for this expression? */
+        if (v_deform == NULL)
+        {
+            foreach(lc, cs->pending_deforms)
+            {
+                LLVMJitDeform *deform = (LLVMJitDeform *) lfirst(lc);
+
+                if (deform->desc == desc && deform->natts == natts)
+                {
+                    v_deform = (LLVMValueRef) deform->func;
+                    break;
+                }
+            }
+        }
+
+        if (v_deform == NULL)
+        {
+            LLVMJitDeform *deform = palloc(sizeof(LLVMJitDeform));
+            char       *deformname;
+
+            deformname = llvm_expand_funcname(cs->context, "deform");
+            v_deform = slot_compile_deform(cs->context, cs->mod, desc, natts,
+                                           deformname);
+            deform->desc = desc;
+            deform->natts = natts;
+            deform->func = v_deform;
+            cs->pending_deforms = lappend(cs->pending_deforms, deform);
+            cs->pending_names = lappend(cs->pending_names, deformname);
+        }
+
+        LLVMBuildCall2(b, deform_sig, v_deform, &v_slot, 1, "");
+    }
+    else
+    {
+        LLVMTypeRef params[2] = {TypePtr, TypeInt32};
+        LLVMValueRef args[2];
+
+        args[0] = v_slot;
+        args[1] = l_int32_const(natts);
+        l_call(b, TypeVoid, slot_getsomeattrs, params, args, 2);
+    }
+
+    LLVMBuildBr(b, b_next);
+}
+
+/* fetch a column that has already been deformed into the slot */
+static void
+build_var(ExprCompileState *cs, ExprEvalStep *op, LLVMValueRef v_slot,
+          TupleTableSlot *slot, bool first)
+{
+    LLVMBuilderRef b = cs->b;
+    int            attnum = op->d.var.attnum;
+    LLVMValueRef v_values;
+    LLVMValueRef v_nulls;
+
+    /*
+     * Check whether the attribute matches the Var, once.  If the slot is
+     * known already, do so right away.
+     */
+    if (first && slot != NULL)
+        CheckVarSlotCompatibility(slot, attnum + 1, op->d.var.vartype);
+    else if (first)
+    {
+        LLVMTypeRef params[3] = {TypePtr, TypeInt32, TypeInt32};
+        LLVMValueRef args[3];
+
+        args[0] = v_slot;
+        args[1] = l_int32_const(attnum + 1);
+        args[2] = l_int32_const(op->d.var.vartype);
+        l_call(b, TypeVoid, CheckVarSlotCompatibility, params, args, 3);
+    }
+
+    v_values = l_load_field(b, TypePtr, v_slot,
+                            offsetof(TupleTableSlot, tts_values), "");
+    v_nulls = l_load_field(b, TypePtr, v_slot,
+                           offsetof(TupleTableSlot, tts_isnull), "");
+    l_store(b,
+            l_load(b, TypeDatum,
+                   l_gep_const(b, v_values, attnum * sizeof(Datum)), ""),
+            l_ptr_const(op->resvalue));
+    l_store(b,
+            l_load(b, TypeStorageBool,
+                   l_gep_const(b, v_nulls, attnum * sizeof(bool)), ""),
+            l_ptr_const(op->resnull));
+}
+
+/* fetch a system column of the slot's physical tuple */
+static void
+build_sysvar(ExprCompileState *cs, ExprEvalStep *op, LLVMValueRef v_slot)
+{
+    LLVMBuilderRef b = cs->b;
+    LLVMTypeRef params[4] = {TypePtr, TypeInt32, TypePtr, TypePtr};
+    LLVMValueRef args[4];
+
+    /* heap_getsysattr has sufficient defenses against bad attnums */
+    args[0] = l_load_field(b, TypePtr, v_slot,
+                           offsetof(TupleTableSlot, tts_tuple), "");
+    args[1] = l_int32_const(op->d.var.attnum);
+    args[2] = l_load_field(b, TypePtr, v_slot,
+                           offsetof(TupleTableSlot, tts_tupleDescriptor), "");
+    args[3] = l_ptr_const(op->resnull);
+    l_store(b, l_call(b, TypeDatum, heap_getsysattr, params, args, 4),
+            l_ptr_const(op->resvalue));
+}
+
+/* copy a column of a slot into the expression's result slot */
+static void
+build_assign_var(ExprCompileState *cs, ExprEvalStep *op, LLVMValueRef v_slot)
+{
+    LLVMBuilderRef b = cs->b;
+    TupleTableSlot *resultslot = cs->state->resultslot;
+    size_t        resultnum = op->d.assign_var.resultnum;
+    size_t        attnum = op->d.assign_var.attnum;
+    LLVMValueRef v_values;
+    LLVMValueRef v_nulls;
+    LLVMValueRef v_resultvalues;
+    LLVMValueRef v_resultnulls;
+
+    v_values = l_load_field(b, TypePtr, v_slot,
+                            offsetof(TupleTableSlot, tts_values), "");
+    v_nulls = l_load_field(b, TypePtr, v_slot,
+                           offsetof(TupleTableSlot, tts_isnull), "");
+    v_resultvalues = l_load_field(b, TypePtr, l_ptr_const(resultslot),
+                                  offsetof(TupleTableSlot, tts_values), "");
+    v_resultnulls = l_load_field(b, TypePtr, l_ptr_const(resultslot),
+                                 offsetof(TupleTableSlot, tts_isnull), "");
+
+    l_store(b,
+            l_load(b, TypeDatum,
+                   l_gep_const(b, v_values, attnum * sizeof(Datum)), ""),
+            l_gep_const(b, v_resultvalues, resultnum * sizeof(Datum)));
+    l_store(b,
+            l_load(b, TypeStorageBool,
+                   l_gep_const(b, v_nulls, attnum * sizeof(bool)), ""),
+            l_gep_const(b, v_resultnulls, resultnum * sizeof(bool)));
+}
+
+/*
+ * Function call, arguments have previously been evaluated directly into
+ * fcinfo->arg.
+ */
+static void
+build_funcexpr(ExprCompileState *cs, ExprEvalStep *op, bool strict,
+               LLVMBasicBlockRef b_next)
+{
+    LLVMBuilderRef b = cs->b;
+    FunctionCallInfo fcinfo = op->d.func.fcinfo_data;
+    LLVMValueRef v_result;
+    LLVMValueRef v_fcinfo_isnull;
+    int            argno;
+
+    /* strict function, so check for NULL args */
+    if (strict && op->d.func.nargs > 0)
+    {
+        LLVMBasicBlockRef b_nonull;
+        LLVMBasicBlockRef b_isnull;
+
+        b_nonull = l_bb_append(cs->fn, "funcexpr.nonull");
+        b_isnull = l_bb_append(cs->fn, "funcexpr.isnull");
+
+        for (argno = 0; argno < op->d.func.nargs; argno++)
+        {
+            LLVMBasicBlockRef b_argok;
+            LLVMValueRef v_argnull;
+
+            b_argok = (argno + 1 < op->d.func.nargs) ?
+                l_bb_append(cs->fn, "funcexpr.argok") : b_nonull;
+
+            v_argnull = l_load(b, TypeStorageBool,
+                               l_ptr_const(&fcinfo->argnull[argno]), "");
+            LLVMBuildCondBr(b, l_as_bool(b, v_argnull), b_isnull, b_argok);
+            LLVMPositionBuilderAtEnd(b, b_argok);
+        }
+
+        LLVMPositionBuilderAtEnd(b, b_isnull);
+        l_store(b, l_int8_const(1), l_ptr_const(op->resnull));
+        LLVMBuildBr(b, b_next);
+
+        LLVMPositionBuilderAtEnd(b, b_nonull);
+
+        /* builtin operators can be evaluated in IR, without a call */
+        if ((cs->context->base.flags & PGJIT_INLINE) &&
+            build_inline_op(cs, op, b_next))
+            return;
+    }
+
+    v_result = build_v1call(cs, fcinfo, op->d.func.fn_addr, &v_fcinfo_isnull);
+    l_store(b, v_result, l_ptr_const(op->resvalue));
+    l_store(b, v_fcinfo_isnull, l_ptr_const(op->resnull));
+    LLVMBuildBr(b, b_next);
+}
+
+/*
+ * Call a V1 function, returning its result and, in *v_isnull, the isnull
+ * flag it set.
+ */
+static LLVMValueRef
+build_v1call(ExprCompileState *cs, FunctionCallInfo fcinfo,
+             PGFunction fn_addr, LLVMValueRef *v_isnull)
+{
+    LLVMBuilderRef b = cs->b;
+    LLVMValueRef v_fcinfo = l_ptr_const(fcinfo);
+    LLVMValueRef v_result;
+
+    l_store(b, l_int8_const(0), l_ptr_const(&fcinfo->isnull));
+    v_result = l_call(b, TypeDatum, fn_addr, &TypePtr, &v_fcinfo, 1);
+    *v_isnull = l_load(b, TypeStorageBool, l_ptr_const(&fcinfo->isnull), "");
+
+    return v_result;
+}
+
+/*
+ * Emit the IR implementing a builtin operator, if it's one of those in
+ * inline_ops.  The arguments are known not to be NULL.  Returns false if the
+ * function isn't known, without emitting anything.
+ */
+static bool
+build_inline_op(ExprCompileState *cs, ExprEvalStep *op,
+                LLVMBasicBlockRef b_next)
+{
+    LLVMBuilderRef b = cs->b;
+    FunctionCallInfo fcinfo = op->d.func.fcinfo_data;
+    const InlineOp *inl = NULL;
+    LLVMValueRef v_left;
+    LLVMValueRef v_right;
+    LLVMValueRef v_result;
+    int            i;
+
+    if (op->d.func.nargs != 2)
+        return false;
+
+    for (i = 0; i < lengthof(inline_ops); i++)
+    {
+        if (inline_ops[i].fn_oid == op->d.func.finfo->fn_oid)
+        {
+            inl = &inline_ops[i];
+            break;
+        }
+    }
+    if (inl == NULL)
+        return false;
+
+    v_left = l_load(b, TypeDatum, l_ptr_const(&fcinfo->arg[0]), "");
+    v_right = l_load(b, TypeDatum, l_ptr_const(&fcinfo->arg[1]), "");
+
+    if (inl->kind <= INLINE_GE)
+    {
+        LLVMIntPredicate predicate;
+        bool        is_unsigned = (inl->lefttype == 'o');
+
+        switch (inl->kind)
+        {
+            case INLINE_EQ:
+                predicate = LLVMIntEQ;
+                break;
+            case INLINE_NE:
+                predicate = LLVMIntNE;
+                break;
+            case INLINE_LT:
+                predicate = is_unsigned ? LLVMIntULT : LLVMIntSLT;
+                break;
+            case INLINE_LE:
+                predicate = is_unsigned ? LLVMIntULE : LLVMIntSLE;
+                break;
+            case INLINE_GT:
+                predicate = is_unsigned ? LLVMIntUGT : LLVMIntSGT;
+                break;
+            default:
+                predicate = is_unsigned ? LLVMIntUGE : LLVMIntSGE;
+                break;
+        }
+
+        /* compare both sides widened to 64 bit */
+        v_result = LLVMBuildICmp(b, predicate,
+                                 l_inline_arg(b, v_left, inl->lefttype),
+                                 l_inline_arg(b, v_right, inl->righttype),
+                                 "");
+        v_result = l_bool_datum(b, v_result);
+    }
+    else
+    {
+        LLVMBasicBlockRef b_overflow;
+        LLVMBasicBlockRef b_ok;
+        LLVMTypeRef type;
+        LLVMTypeRef fntype;
+        LLVMValueRef v_fn;
+        LLVMValueRef args[2];
+        LLVMValueRef v_ret;
+        const char *name;
+        unsigned    id;
+
+        type = (inl->lefttype == 'i') ? TypeInt32 : TypeInt64;
+        if (inl->kind == INLINE_PL)
+            name = "llvm.sadd.with.overflow";
+        else if (inl->kind == INLINE_MI)
+            name = "llvm.ssub.with.overflow";
+        else
+            name = "llvm.smul.with.overflow";
+
+        id = LLVMLookupIntrinsicID(name, strlen(name));
+        v_fn = LLVMGetIntrinsicDeclaration(cs->mod, id, &type, 1);
+        fntype = LLVMIntrinsicGetType(llvm_context, id, &type, 1);
+
+        if (type == TypeInt32)
+        {
+            args[0] = LLVMBuildTrunc(b, v_left, type, "");
+            args[1] = LLVMBuildTrunc(b, v_right, type, "");
+        }
+        else
+        {
+            args[0] = v_left;
+            args[1] = v_right;
+        }
+        v_ret = LLVMBuildCall2(b, fntype, v_fn, args, 2, "");
+
+        b_overflow = l_bb_append(cs->fn, "inline.overflow");
+        b_ok = l_bb_append(cs->fn, "inline.ok");
+        LLVMBuildCondBr(b, LLVMBuildExtractValue(b, v_ret, 1, ""),
+                        b_overflow, b_ok);
+
+        /* let the real function report the overflow */
+        LLVMPositionBuilderAtEnd(b, b_overflow);
+        {
+            LLVMValueRef v_isnull;
+
+            v_result = build_v1call(cs, fcinfo, op->d.func.fn_addr, &v_isnull);
+            l_store(b, v_result, l_ptr_const(op->resvalue));
+            l_store(b, v_isnull, l_ptr_const(op->resnull));
+            LLVMBuildBr(b, b_next);
+        }
+
+        LLVMPositionBuilderAtEnd(b, b_ok);
+        v_result = LLVMBuildExtractValue(b, v_ret, 0, "");
+        if (type == TypeInt32)
+            v_result = LLVMBuildSExt(b, v_result, TypeDatum, "");
+    }
+
+    l_store(b, v_result, l_ptr_const(op->resvalue));
+    l_store(b, l_int8_const(0), l_ptr_const(op->resnull));
+    LLVMBuildBr(b, b_next);
+
+    return true;
+}
+
+/* call one of the ExecEval* helpers shared with the interpreter */
+static void
+build_evalfunc(ExprCompileState *cs, const void *fn, ExprEvalStep *op,
+               bool pass_econtext)
+{
+    LLVMTypeRef params[3] = {TypePtr, TypePtr, TypePtr};
+    LLVMValueRef args[3];
+
+    args[0] = l_ptr_const(cs->state);
+    args[1] = l_ptr_const(op);
+    args[2] = cs->v_econtext;
+
+    l_call(cs->b, TypeVoid, fn, params, args, pass_econtext ? 3 : 2);
+}
+
+/* convert an i1 into a boolean Datum */
+static LLVMValueRef
+l_bool_datum(LLVMBuilderRef b, LLVMValueRef v_bool)
+{
+    return LLVMBuildZExt(b, v_bool, TypeDatum, "");
+}
+
+/* DatumGetBool(), as an i1 */
+static LLVMValueRef
+l_datum_is_true(LLVMBuilderRef b, LLVMValueRef v_datum)
+{
+    return LLVMBuildICmp(b, LLVMIntNE, v_datum, l_sizet_const(0), "");
+}
+
+/* extract an argument of the given type from a Datum, widened to 64 bit */
+static LLVMValueRef
+l_inline_arg(LLVMBuilderRef b, LLVMValueRef v_datum, char type)
+{
+    switch (type)
+    {
+        case 'h':
+            return LLVMBuildSExt(b, LLVMBuildTrunc(b, v_datum, TypeInt16, ""),
+                                 TypeInt64, "");
+        case 'i':
+            return LLVMBuildSExt(b, LLVMBuildTrunc(b, v_datum, TypeInt32, ""),
+                                 TypeInt64, "");
+        case 'o':
+            return LLVMBuildZExt(b, LLVMBuildTrunc(b, v_datum, TypeInt32, ""),
+                                 TypeInt64, "");
+        default:
+            return v_datum;
+    }
+}
@@ -122,6 +122,12 @@ _copyPlannedStmt(const PlannedStmt *from)
     COPY_SCALAR_FIELD(distributionKey);
     COPY_NODE_FIELD(distributionNodes);
     COPY_NODE_FIELD(distributionRestrict);
+#ifdef __OPENTENBASE__
+    COPY_SCALAR_FIELD(skewPolicy);
+    COPY_NODE_FIELD(skewValues);
+    COPY_SCALAR_FIELD(skewEqOp);
+    COPY_SCALAR_FIELD(adaptivePolicy);
+#endif
 #endif
     COPY_NODE_FIELD(utilityStmt);
     COPY_LOCATION_FIELD(stmt_location);
@@ -132,6 +138,7 @@ _copyPlannedStmt(const PlannedStmt *from)
     COPY_SCALAR_FIELD(partrelindex);
     COPY_BITMAPSET_FIELD(partpruning);
     COPY_SCALAR_FIELD(need_snapshot);
+    COPY_SCALAR_FIELD(jitFlags);
 #endif
 
 #ifdef __AUDIT__
@@ -298,6 +305,7 @@ _copyAppend(const Append *from)
     COPY_NODE_FIELD(appendplans);
 #ifdef __OPENTENBASE__
     COPY_SCALAR_FIELD(interval);
+    COPY_NODE_FIELD(partprunequals);
 #endif
 
     return newnode;
@@ -328,6 +336,7 @@ _copyMergeAppend(const MergeAppend *from)
     COPY_POINTER_FIELD(nullsFirst, from->numCols * sizeof(bool));
 #ifdef __OPENTENBASE__
     COPY_SCALAR_FIELD(interval);
+    COPY_NODE_FIELD(partprunequals);
 #endif
 
     return newnode;
@@ -1429,6 +1438,10 @@ _copyRemoteSubplan(const RemoteSubplan *from)
 #ifdef __OPENTENBASE__
     COPY_SCALAR_FIELD(parallelWorkerSendTuple);
 	COPY_BITMAPSET_FIELD(initPlanParams);
+    COPY_SCALAR_FIELD(skewPolicy);
+    COPY_NODE_FIELD(skewValues);
+    COPY_SCALAR_FIELD(skewEqOp);
+    COPY_SCALAR_FIELD(adaptivePolicy);
 #endif
     return newnode;
 }
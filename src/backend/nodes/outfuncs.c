@@ -561,6 +561,7 @@ _outPlannedStmt(StringInfo str, const PlannedStmt *node)
     WRITE_BOOL_FIELD(haspart_tobe_modify);
     WRITE_UINT_FIELD(partrelindex);
     WRITE_BITMAPSET_FIELD(partpruning);
+    WRITE_INT_FIELD(jitFlags);
 #endif
 
 #ifdef __AUDIT__
@@ -713,6 +714,7 @@ _outAppend(StringInfo str, const Append *node)
     WRITE_NODE_FIELD(appendplans);
 #ifdef __OPENTENBASE__
     WRITE_BOOL_FIELD(interval);
+    WRITE_NODE_FIELD(partprunequals);
 #endif
 }
 
@@ -789,6 +791,7 @@ _outMergeAppend(StringInfo str, const MergeAppend *node)
         appendStringInfo(str, " %s", booltostr(node->nullsFirst[i]));
 #ifdef __OPENTENBASE__
     WRITE_BOOL_FIELD(interval);
+    WRITE_NODE_FIELD(partprunequals);
 #endif
 }
 
@@ -1709,6 +1712,13 @@ _outRemoteSubplan(StringInfo str, const RemoteSubplan *node)
 	WRITE_INT64_FIELD(unique);
     WRITE_BOOL_FIELD(parallelWorkerSendTuple);
 	WRITE_BITMAPSET_FIELD(initPlanParams);
+    WRITE_CHAR_FIELD(skewPolicy);
+    WRITE_NODE_FIELD(skewValues);
+    if (portable_output)
+        WRITE_OPERID_FIELD(skewEqOp);
+    else
+        WRITE_OID_FIELD(skewEqOp);
+    WRITE_CHAR_FIELD(adaptivePolicy);
 
 #ifdef __OPENTENBASE__
     if (IS_PGXC_COORDINATOR && !g_set_global_snapshot)
@@ -1786,10 +1796,18 @@ _outRemoteStmt(StringInfo str, const RemoteStmt *node)
 #ifdef __OPENTENBASE__
     WRITE_BOOL_FIELD(parallelModeNeeded);
     WRITE_BOOL_FIELD(parallelWorkerSendTuple);
+    WRITE_CHAR_FIELD(skewPolicy);
+    WRITE_NODE_FIELD(skewValues);
+    if (portable_output)
+        WRITE_OPERID_FIELD(skewEqOp);
+    else
+        WRITE_OID_FIELD(skewEqOp);
+    WRITE_CHAR_FIELD(adaptivePolicy);
 
     WRITE_BOOL_FIELD(haspart_tobe_modify);
     WRITE_UINT_FIELD(partrelindex);
     WRITE_BITMAPSET_FIELD(partpruning);
+    WRITE_INT_FIELD(jitFlags);
 #endif
 
 #ifdef __AUDIT__
@@ -2383,6 +2383,7 @@ _readPlannedStmt(void)
     READ_BOOL_FIELD(haspart_tobe_modify);
     READ_UINT_FIELD(partrelindex);
     READ_BITMAPSET_FIELD(partpruning);
+    READ_INT_FIELD(jitFlags);
 #endif
 
 #ifdef __AUDIT__
@@ -2479,6 +2480,7 @@ _readAppend(void)
     READ_NODE_FIELD(appendplans);
 #ifdef __OPENTENBASE__
     READ_BOOL_FIELD(interval);
+    READ_NODE_FIELD(partprunequals);
 #endif
 
     READ_DONE();
@@ -2576,6 +2578,7 @@ _readMergeAppend(void)
     READ_BOOL_ARRAY(nullsFirst, local_node->numCols);
 #ifdef __OPENTENBASE__
     READ_BOOL_FIELD(interval);
+    READ_NODE_FIELD(partprunequals);
 #endif
 
     READ_DONE();
@@ -3835,6 +3838,13 @@ _readRemoteSubplan(void)
     READ_INT64_FIELD(unique);
     READ_BOOL_FIELD(parallelWorkerSendTuple);
 	READ_BITMAPSET_FIELD(initPlanParams);
+    READ_CHAR_FIELD(skewPolicy);
+    READ_NODE_FIELD(skewValues);
+    if (portable_input)
+        READ_OPERID_FIELD(skewEqOp);
+    else
+        READ_OID_FIELD(skewEqOp);
+    READ_CHAR_FIELD(adaptivePolicy);
 
     READ_DONE();
 }
@@ -4006,10 +4016,18 @@ _readRemoteStmt(void)
 #ifdef __OPENTENBASE__
     READ_BOOL_FIELD(parallelModeNeeded);
     READ_BOOL_FIELD(parallelWorkerSendTuple);
+    READ_CHAR_FIELD(skewPolicy);
+    READ_NODE_FIELD(skewValues);
+    if (portable_input)
+        READ_OPERID_FIELD(skewEqOp);
+    else
+        READ_OID_FIELD(skewEqOp);
+    READ_CHAR_FIELD(adaptivePolicy);
 
     READ_BOOL_FIELD(haspart_tobe_modify);
     READ_UINT_FIELD(partrelindex);
     READ_BITMAPSET_FIELD(partpruning);
+    READ_INT_FIELD(jitFlags);
 #endif
 
 #ifdef __AUDIT__
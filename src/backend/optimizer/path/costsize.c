@@ -104,6 +104,8 @@
 #include "optimizer/planner.h"
 #include "utils/ruleutils.h"
 #include "storage/lmgr.h"
+#include "postmaster/netcalibrator.h"
+#include "pgxc/planner.h"
 #endif
 #ifdef __COLD_HOT__
 #include "pgxc/shardmap.h"
@@ -145,6 +147,8 @@ bool		enable_hashjoin = true;
 bool		enable_fast_query_shipping = true;
 bool		enable_gathermerge = true;
 bool        enable_partition_wise_join = false;
+bool        enable_partition_wise_agg = false;
+bool        enable_partition_wise_hashjoin = false;
 bool		enable_nestloop_suppression = false;
 
 typedef struct
@@ -5303,8 +5307,43 @@ cost_remote_subplan(Path *path,
               Cost input_startup_cost, Cost input_total_cost,
 			  double tuples, int width, int replication)
 {
-    Cost        startup_cost = input_startup_cost + remote_query_cost;
+    Cost        startup_cost;
     Cost        run_cost = input_total_cost - input_startup_cost;
+#ifdef __OPENTENBASE__
+	double		transfer_factor = 1.0;
+	double		latency_factor = 1.0;
+	char		adaptivePolicy = ((RemoteSubPath *) path)->adaptivePolicy;
+
+	/*
+	 * With adaptive broadcast the build side is expected to be broadcast and
+	 * the probe side to stay on its nodes, see set_joinpath_adaptive.
+	 */
+	if (adaptivePolicy == ADAPTIVE_POLICY_BUILD && path->distribution)
+		replication = bms_num_members(path->distribution->nodes);
+
+	/*
+	 * Scale the network costs by the performance measured for the links the
+	 * data is sent over: from the nodes the subplan runs on to the nodes of
+	 * the new distribution, or to the coordinator if there is none.
+	 */
+	if (enable_network_calibration)
+	{
+		Path	   *subpath = ((RemoteSubPath *) path)->subpath;
+		Bitmapset  *sources = NULL;
+		Bitmapset  *targets = NULL;
+
+		if (subpath && subpath->distribution)
+			sources = subpath->distribution->nodes;
+		if (path->distribution)
+			targets = path->distribution->nodes;
+
+		NetworkCalibrationCostFactors(sources, targets,
+									  &transfer_factor, &latency_factor);
+	}
+	startup_cost = input_startup_cost + remote_query_cost * latency_factor;
+#else
+	startup_cost = input_startup_cost + remote_query_cost;
+#endif
 
 	path->rows = tuples * replication;
 
@@ -5316,7 +5355,12 @@ cost_remote_subplan(Path *path,
     /*
      * Estimate cost of sending data over network
      */
+#ifdef __OPENTENBASE__
+	if (adaptivePolicy != ADAPTIVE_POLICY_PROBE)
+		run_cost += network_byte_cost * transfer_factor * tuples * width * replication;
+#else
 	run_cost += network_byte_cost * tuples * width * replication;
+#endif
 
     path->startup_cost = startup_cost;
     path->total_cost = startup_cost + run_cost;
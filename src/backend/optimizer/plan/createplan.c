@@ -351,6 +351,16 @@ static bool set_plan_parallel(Plan *plan);
 static void set_plan_nonparallel(Plan *plan);
 static Plan *materialize_top_remote_subplan(Plan *node);
 static bool contain_node_walker(Plan *node, NodeTag type, bool search_nonparallel);
+static Index interval_append_relid(Plan *plan);
+static List *interval_partprune_quals(PlannerInfo *root, Path *best_path,
+                                      List *scan_clauses, AttrNumber partkey);
+static bool contain_params_walker(Node *node, void *context);
+static bool get_interval_partition_info(PlannerInfo *root, Index relid,
+                            FormData_pg_partition_interval *info);
+static Plan *create_partition_wise_agg_plan(PlannerInfo *root, Agg *agg);
+static Plan *create_partition_wise_hashjoin_plan(PlannerInfo *root,
+                                    HashJoin *join);
+static Plan *create_partition_wise_plans(PlannerInfo *root, Plan *plan);
 #endif
 static RemoteSubplan *find_push_down_plan(Plan *plan, bool force);
 
@@ -389,6 +399,12 @@ create_plan(PlannerInfo *root, Path *best_path)
     /* Recursively process the path tree, demanding the correct tlist result */
     plan = create_plan_recurse(root, best_path, CP_EXACT_TLIST);
 
+#ifdef __OPENTENBASE__
+    /* process interval partitioned tables child by child */
+    if (enable_partition_wise_agg || enable_partition_wise_hashjoin)
+        plan = create_partition_wise_plans(root, plan);
+#endif
+
     /*
      * Make sure the topmost plan node's targetlist exposes the original
      * column names and other decorative info.  Targetlists generated within
@@ -600,7 +616,7 @@ create_scan_plan(PlannerInfo *root, Path *best_path, int flags)
     bool    need_merge_append = false;            /* need MergeAppend */
 //    bool    need_pullup_filter = false;         /* need pull up filter */
     bool    isbackward = false;                 /* indexscan is backward ?*/
-    AttrNumber partkey;
+    AttrNumber partkey = InvalidAttrNumber;
 //    List        *outtlist = NULL;
 //    List        *qual = NULL;
 
@@ -1031,6 +1047,9 @@ create_scan_plan(PlannerInfo *root, Path *best_path, int flags)
                         mappend->plan.qual = NULL;
                     }
                     mappend->interval = true;
+                    mappend->partprunequals =
+                        interval_partprune_quals(root, best_path,
+                                                 scan_clauses, partkey);
                     mappend->plan.parallel_aware = best_path->parallel_aware;
                     plan = (Plan *)mappend;
                 }
@@ -1039,6 +1058,9 @@ create_scan_plan(PlannerInfo *root, Path *best_path, int flags)
                     Append *append = NULL;
                     append = make_append(scanlist, tlist, NULL);
                     append->interval = true;
+                    append->partprunequals =
+                        interval_partprune_quals(root, best_path,
+                                                 scan_clauses, partkey);
                     append->plan.parallel_aware = best_path->parallel_aware;
                     plan = (Plan *)append;
                 }
@@ -3247,6 +3269,36 @@ create_remotescan_plan(PlannerInfo *root,
                               best_path->path.pathkeys);
 
 #ifdef __OPENTENBASE__
+    /* route rows with hot key values as decided by set_joinpath_distribution */
+    if (best_path->skewValues && plan->distributionKey != InvalidAttrNumber)
+    {
+        plan->skewPolicy = best_path->skewPolicy;
+        plan->skewValues = best_path->skewValues;
+        plan->skewEqOp = best_path->skewEqOp;
+
+        /* parallel workers would route tuples by themselves, ignoring skew */
+        if (plan->parallelWorkerSendTuple)
+        {
+            plan->parallelWorkerSendTuple = false;
+            ((Gather *) plan->scan.plan.lefttree)->parallelWorker_sendTuple = false;
+        }
+    }
+
+    /* broadcast or redistribution is decided by the producers at runtime */
+    if ((best_path->adaptivePolicy == ADAPTIVE_POLICY_BUILD ||
+         best_path->adaptivePolicy == ADAPTIVE_POLICY_PROBE) &&
+        plan->distributionKey != InvalidAttrNumber)
+    {
+        plan->adaptivePolicy = best_path->adaptivePolicy;
+
+        /* parallel workers would route tuples by themselves */
+        if (plan->parallelWorkerSendTuple)
+        {
+            plan->parallelWorkerSendTuple = false;
+            ((Gather *) plan->scan.plan.lefttree)->parallelWorker_sendTuple = false;
+        }
+    }
+
     if (olap_optimizer)
     {
         plan->scan.plan.startup_cost = ((Path *)best_path)->startup_cost;
@@ -7169,6 +7221,9 @@ make_remotesubplan(PlannerInfo *root,
     node->unique = 0;
 
 #ifdef __OPENTENBASE__
+    node->skewPolicy = SKEW_POLICY_NONE;
+    node->adaptivePolicy = ADAPTIVE_POLICY_NONE;
+
     /* 
       * if gather node is under remotesubplan, parallel workers can send tuples directly
       * without gather motion to speed up the data transfering.
@@ -9785,6 +9840,357 @@ partkey_match_index(Oid indexoid, AttrNumber partkey)
     return result;
 }
 
+/*
+ * interval_partprune_quals
+ *      Collect the restriction clauses on the partition key of an interval
+ *      partitioned table that compare it with Params.  Their values are not
+ *      known while planning, so the executor uses them to prune the children
+ *      of the Append or MergeAppend once the Params are set.
+ */
+static List *
+interval_partprune_quals(PlannerInfo *root, Path *best_path,
+                         List *scan_clauses, AttrNumber partkey)
+{
+    Index     relid = best_path->parent->relid;
+    List     *clauses;
+    List     *result = NIL;
+    ListCell *lc;
+
+    clauses = extract_actual_clauses(scan_clauses, false);
+    if (best_path->param_info)
+        clauses = (List *) replace_nestloop_params(root, (Node *) clauses);
+
+    foreach(lc, clauses)
+    {
+        Node      *clause = (Node *) lfirst(lc);
+        Bitmapset *attnos = NULL;
+
+        if (!contain_params_walker(clause, NULL) ||
+            contain_volatile_functions(clause) ||
+            contain_subplans(clause))
+            continue;
+
+        pull_varattnos(clause, relid, &attnos);
+        if (bms_is_member(partkey - FirstLowInvalidHeapAttributeNumber, attnos))
+            result = lappend(result, copyObject(clause));
+        bms_free(attnos);
+    }
+
+    return result;
+}
+
+/*
+ * contain_params_walker
+ *      Does the expression contain a Param?
+ */
+static bool
+contain_params_walker(Node *node, void *context)
+{
+    if (node == NULL)
+        return false;
+    if (IsA(node, Param))
+        return true;
+    return expression_tree_walker(node, contain_params_walker, context);
+}
+
+/*
+ * interval_append_relid
+ *      If the plan is the Append createplan builds over the children of an
+ *      interval partitioned table, return the range table index of the table,
+ *      otherwise 0.
+ */
+static Index
+interval_append_relid(Plan *plan)
+{
+    Append   *append;
+    Index     relid = 0;
+    ListCell *lc;
+
+    if (!IsA(plan, Append) || !((Append *) plan)->interval ||
+        plan->parallel_aware)
+        return 0;
+
+    append = (Append *) plan;
+    if (list_length(append->appendplans) < 2)
+        return 0;
+
+    foreach(lc, append->appendplans)
+    {
+        Scan *child = (Scan *) lfirst(lc);
+
+        if (!child->ispartchild || child->plan.parallel_aware)
+            return 0;
+        if (relid != 0 && child->scanrelid != relid)
+            return 0;
+        relid = child->scanrelid;
+    }
+
+    return relid;
+}
+
+/*
+ * get_interval_partition_info
+ *      Fetch the interval partitioning scheme of a range table entry.
+ */
+static bool
+get_interval_partition_info(PlannerInfo *root, Index relid,
+                            FormData_pg_partition_interval *info)
+{
+    RangeTblEntry *rte = root->simple_rte_array[relid];
+    Relation       relation;
+    bool           found = false;
+
+    if (rte->rtekind != RTE_RELATION)
+        return false;
+
+    relation = heap_open(rte->relid, NoLock);
+    if (RELATION_IS_INTERVAL(relation) && relation->rd_partitions_info)
+    {
+        memcpy(info, relation->rd_partitions_info,
+               sizeof(FormData_pg_partition_interval));
+        found = true;
+    }
+    heap_close(relation, NoLock);
+
+    return found;
+}
+
+/*
+ * create_partition_wise_plans
+ *      Replace the aggregations and hash joins of this query level that can
+ *      process interval partitioned tables child by child with an Append of
+ *      them.
+ *
+ * This is done once the plan tree is complete rather than in create_agg_plan
+ * and create_hashjoin_plan.  Their callers may still assign a projection to
+ * the node they get, which an Append cannot do, and the plans of subqueries
+ * belong to a different query level and are processed by their own
+ * create_plan.
+ */
+static Plan *
+create_partition_wise_plans(PlannerInfo *root, Plan *plan)
+{
+    ListCell   *lc;
+
+    if (plan == NULL)
+        return NULL;
+
+    plan->lefttree = create_partition_wise_plans(root, plan->lefttree);
+    plan->righttree = create_partition_wise_plans(root, plan->righttree);
+
+    if (IsA(plan, Append))
+    {
+        foreach(lc, ((Append *) plan)->appendplans)
+            lfirst(lc) = create_partition_wise_plans(root, (Plan *) lfirst(lc));
+    }
+    else if (IsA(plan, MergeAppend))
+    {
+        foreach(lc, ((MergeAppend *) plan)->mergeplans)
+            lfirst(lc) = create_partition_wise_plans(root, (Plan *) lfirst(lc));
+    }
+    else if (IsA(plan, Agg) && enable_partition_wise_agg)
+        return create_partition_wise_agg_plan(root, (Agg *) plan);
+    else if (IsA(plan, HashJoin) && enable_partition_wise_hashjoin)
+        return create_partition_wise_hashjoin_plan(root, (HashJoin *) plan);
+
+    return plan;
+}
+
+/*
+ * create_partition_wise_agg_plan
+ *      Push a hash aggregation grouped by the partition key of an interval
+ *      partitioned table below the Append of its children.
+ *
+ * No group spans two children, so each child is aggregated into a hash table
+ * of its own, sized for that child and with its own work_mem, instead of one
+ * table for the whole relation that is likely to spill.  Returns the
+ * original plan when that is not possible.
+ */
+static Plan *
+create_partition_wise_agg_plan(PlannerInfo *root, Agg *agg)
+{
+    Plan       *subplan = agg->plan.lefttree;
+    Append     *append;
+    List       *aggplans = NIL;
+    Index       relid;
+    FormData_pg_partition_interval info;
+    bool        found = false;
+    int         nchildren;
+    int         i;
+    ListCell   *lc;
+
+    if (agg->aggstrategy != AGG_HASHED || agg->groupingSets != NIL ||
+        agg->chain != NIL || agg->plan.parallel_aware)
+        return (Plan *) agg;
+
+    relid = interval_append_relid(subplan);
+    if (relid == 0 || !get_interval_partition_info(root, relid, &info))
+        return (Plan *) agg;
+
+    /* the partition key has to be one of the grouping columns */
+    for (i = 0; i < agg->numCols && !found; i++)
+    {
+        TargetEntry *tle = get_tle_by_resno(subplan->targetlist,
+                                            agg->grpColIdx[i]);
+        Var         *var = (Var *) (tle ? tle->expr : NULL);
+
+        if (var && IsA(var, Var) && var->varno == relid &&
+            var->varlevelsup == 0 && var->varattno == info.partpartkey)
+            found = true;
+    }
+
+    if (!found)
+        return (Plan *) agg;
+
+    append = (Append *) subplan;
+    nchildren = list_length(append->appendplans);
+
+    /* don't copy the whole subplan for every child */
+    agg->plan.lefttree = NULL;
+
+    foreach(lc, append->appendplans)
+    {
+        Agg *child_agg = (Agg *) copyObject(agg);
+
+        child_agg->plan.lefttree = (Plan *) lfirst(lc);
+        child_agg->numGroups = Max(agg->numGroups / nchildren, 1);
+        child_agg->plan.plan_rows = clamp_row_est(agg->plan.plan_rows / nchildren);
+        child_agg->plan.startup_cost = agg->plan.startup_cost / nchildren;
+        child_agg->plan.total_cost = agg->plan.total_cost / nchildren;
+
+        aggplans = lappend(aggplans, child_agg);
+    }
+
+    append = make_append(aggplans, agg->plan.targetlist, NIL);
+    copy_plan_costsize(&append->plan, &agg->plan);
+    append->plan.startup_cost = ((Plan *) linitial(aggplans))->startup_cost;
+    append->plan.parallel_safe = agg->plan.parallel_safe;
+
+    return (Plan *) append;
+}
+
+/*
+ * create_partition_wise_hashjoin_plan
+ *      Join two interval partitioned tables with the same partitioning scheme
+ *      child by child, if they are joined on their partition keys.
+ *
+ * Rows can only match rows of the child covering the same interval, so an
+ * inner or semi join becomes an Append of joins between those children, each
+ * with a hash table built from a single inner child.  Children without a
+ * counterpart on the other side produce no rows.  Returns the original plan
+ * when that is not possible.
+ */
+static Plan *
+create_partition_wise_hashjoin_plan(PlannerInfo *root, HashJoin *join)
+{
+    Plan       *outer_plan = join->join.plan.lefttree;
+    Hash       *hash_plan = (Hash *) join->join.plan.righttree;
+    Plan       *inner_plan = hash_plan->plan.lefttree;
+    Index       outer_relid;
+    Index       inner_relid;
+    FormData_pg_partition_interval outer_info;
+    FormData_pg_partition_interval inner_info;
+    List       *pairs = NIL;
+    List       *joinplans = NIL;
+    Append     *append;
+    bool        found = false;
+    int         npairs;
+    ListCell   *lc;
+    ListCell   *lc2;
+
+    if ((join->join.jointype != JOIN_INNER && join->join.jointype != JOIN_SEMI) ||
+        join->join.plan.parallel_aware || hash_plan->plan.parallel_aware)
+        return (Plan *) join;
+
+    outer_relid = interval_append_relid(outer_plan);
+    inner_relid = interval_append_relid(inner_plan);
+    if (outer_relid == 0 || inner_relid == 0 ||
+        !get_interval_partition_info(root, outer_relid, &outer_info) ||
+        !get_interval_partition_info(root, inner_relid, &inner_info))
+        return (Plan *) join;
+
+    /* children with the same index have to cover the same interval */
+    if (outer_info.partinterval_type != inner_info.partinterval_type ||
+        outer_info.partdatatype != inner_info.partdatatype ||
+        outer_info.partstartvalue_int != inner_info.partstartvalue_int ||
+        outer_info.partstartvalue_ts != inner_info.partstartvalue_ts ||
+        outer_info.partinterval_int != inner_info.partinterval_int)
+        return (Plan *) join;
+
+    /* the hash clauses have the outer side on the left */
+    foreach(lc, join->hashclauses)
+    {
+        OpExpr *clause = (OpExpr *) lfirst(lc);
+        Node   *left = strip_implicit_coercions((Node *) linitial(clause->args));
+        Node   *right = strip_implicit_coercions((Node *) lsecond(clause->args));
+
+        if (IsA(left, Var) && IsA(right, Var) &&
+            ((Var *) left)->varno == outer_relid &&
+            ((Var *) left)->varattno == outer_info.partpartkey &&
+            ((Var *) right)->varno == inner_relid &&
+            ((Var *) right)->varattno == inner_info.partpartkey)
+        {
+            found = true;
+            break;
+        }
+    }
+
+    if (!found)
+        return (Plan *) join;
+
+    foreach(lc, ((Append *) outer_plan)->appendplans)
+    {
+        Scan *outer_child = (Scan *) lfirst(lc);
+
+        foreach(lc2, ((Append *) inner_plan)->appendplans)
+        {
+            Scan *inner_child = (Scan *) lfirst(lc2);
+
+            if (outer_child->childidx == inner_child->childidx)
+            {
+                pairs = lappend(pairs, list_make2(outer_child, inner_child));
+                break;
+            }
+        }
+    }
+
+    npairs = list_length(pairs);
+    if (npairs < 2)
+        return (Plan *) join;
+
+    /* don't copy the whole subplans for every pair */
+    join->join.plan.lefttree = NULL;
+    join->join.plan.righttree = NULL;
+    hash_plan->plan.lefttree = NULL;
+
+    foreach(lc, pairs)
+    {
+        List     *pair = (List *) lfirst(lc);
+        Plan     *inner_child = (Plan *) lsecond(pair);
+        Hash     *child_hash = (Hash *) copyObject(hash_plan);
+        HashJoin *child_join = (HashJoin *) copyObject(join);
+
+        child_hash->plan.lefttree = inner_child;
+        copy_plan_costsize(&child_hash->plan, inner_child);
+        child_hash->plan.startup_cost = child_hash->plan.total_cost;
+
+        child_join->join.plan.lefttree = (Plan *) linitial(pair);
+        child_join->join.plan.righttree = (Plan *) child_hash;
+        child_join->join.plan.plan_rows = clamp_row_est(join->join.plan.plan_rows / npairs);
+        child_join->join.plan.startup_cost = child_hash->plan.startup_cost;
+        child_join->join.plan.total_cost = join->join.plan.total_cost / npairs;
+
+        joinplans = lappend(joinplans, child_join);
+    }
+
+    append = make_append(joinplans, join->join.plan.targetlist, NIL);
+    copy_plan_costsize(&append->plan, &join->join.plan);
+    append->plan.startup_cost = ((Plan *) linitial(joinplans))->startup_cost;
+    append->plan.parallel_safe = join->join.plan.parallel_safe;
+
+    return (Plan *) append;
+}
+
 List *
 build_physical_tlist_with_sysattr(List *relation_tlist, List *physical_tlist)
 {
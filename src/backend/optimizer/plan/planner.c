@@ -26,6 +26,7 @@
 #include "access/sysattr.h"
 #include "access/xact.h"
 #include "catalog/pg_constraint_fn.h"
+#include "catalog/pg_operator.h"
 #include "catalog/pg_proc.h"
 #include "catalog/pg_type.h"
 #include "executor/executor.h"
@@ -66,6 +67,7 @@
 #include "utils/lsyscache.h"
 #include "utils/syscache.h"
 #ifdef __OPENTENBASE__
+#include "jit/jit.h"
 #include "optimizer/distribution.h"
 #endif
 
@@ -123,6 +125,14 @@ typedef struct
     int           *tleref_to_colnum_map;
 } grouping_sets_data;
 
+#ifdef __OPENTENBASE__
+/*
+ * Largest pushed down LIMIT + OFFSET for which the coordinator reads the
+ * remaining rows of every datanode rather than cancelling them early.
+ */
+#define REMOTE_LIMIT_DRAIN_ROWS 10000
+#endif
+
 /* Local functions */
 static Node *preprocess_expression(PlannerInfo *root, Node *expr, int kind);
 static void preprocess_qual_conditions(PlannerInfo *root, Node *jtnode);
@@ -136,6 +146,11 @@ static double preprocess_limit(PlannerInfo *root,
                  double tuple_fraction,
                  int64 *offset_est, int64 *count_est);
 static bool limit_needed(Query *parse);
+#ifdef __OPENTENBASE__
+static Node *make_remote_limit_count(Query *parse, int64 offset_est,
+                        int64 count_est);
+static bool contain_exec_params_walker(Node *node, void *context);
+#endif
 static void remove_useless_groupby_columns(PlannerInfo *root);
 static List *preprocess_groupclause(PlannerInfo *root, List *force);
 static List *extract_rollup_sets(List *groupingSets);
@@ -565,6 +580,32 @@ standard_planner(Query *parse, int cursorOptions, ParamListInfo boundParams)
     result->haspart_tobe_modify = root->haspart_tobe_modify;
     result->partrelindex = root->partrelindex;
     result->partpruning = bms_copy(root->partpruning);
+
+    /* decide which forms of JIT are worthwhile for this plan */
+    result->jitFlags = PGJIT_NONE;
+    if (jit_enabled && jit_above_cost >= 0 &&
+        top_plan->total_cost > jit_above_cost)
+    {
+        result->jitFlags |= PGJIT_PERFORM;
+
+        /*
+         * Decide how much effort should be put into generating better code.
+         */
+        if (jit_optimize_above_cost >= 0 &&
+            top_plan->total_cost > jit_optimize_above_cost)
+            result->jitFlags |= PGJIT_OPT3;
+        if (jit_inline_above_cost >= 0 &&
+            top_plan->total_cost > jit_inline_above_cost)
+            result->jitFlags |= PGJIT_INLINE;
+
+        /*
+         * Decide which operations should be JITed.
+         */
+        if (jit_expressions)
+            result->jitFlags |= PGJIT_EXPR;
+        if (jit_tuple_deforming)
+            result->jitFlags |= PGJIT_DEFORM;
+    }
 #endif
 
     return result;
@@ -2510,37 +2551,42 @@ grouping_planner(PlannerInfo *root, bool inheritance_update,
                  * This can be done even if there is an ORDER BY clause, as
                  * long as we fetch at least (limit + offset) rows from all the
                  * nodes and then do a local sort and apply the original limit.
-                 *
-                 * We can only push down the LIMIT clause when it's a constant.
-                 * Similarly, if the OFFSET is specified, then it must be constant
-                 * too.
+                 * The remote Limit also lets a Sort below it on the datanodes
+                 * run as a bounded (top-N) sort.
                  *
                  * Simple expressions get folded into constants by the time we come
                  * here. So this works well in case of constant expressions such as
                  *
                  *     SELECT .. LIMIT (1024 * 1024);
+                 *
+                 * Stable non-constant expressions, such as the parameters of
+                 * a prepared paging query, are evaluated by the datanodes.
                  */
-                if (parse->limitCount && IsA(parse->limitCount, Const) &&
-                    ((parse->limitOffset == NULL) || IsA(parse->limitOffset, Const)))
+                Node *limitCount = make_remote_limit_count(parse, offset_est,
+                                                           count_est);
+
+                if (limitCount)
                 {
-                    Node *limitCount = (Node *) makeConst(INT8OID, -1,
-                                                   InvalidOid,
-                                                   sizeof(int64),
-                                       Int64GetDatum(offset_est + count_est),
-                                                   false, FLOAT8PASSBYVAL);
+                    int64 remote_est = -1;
+
+                    if (count_est > 0 && offset_est >= 0)
+                        remote_est = offset_est + count_est;
 
                     path = (Path *) create_limit_path(root, final_rel, path,
                                               NULL,
                                               limitCount, /* LIMIT + OFFSET */
-											  0, offset_est + count_est,
+											  0, remote_est,
 											  false);
 #ifdef __OPENTENBASE__
 					/*
 					 * Upper level limit node could skip early ExecFinishNode to save
 					 * 2~3ms of meaningless communication, since we've already push
-					 * down the limit.
+					 * down the limit.  That only pays off if few rows are left to
+					 * be drained from the datanodes; otherwise they are told to
+					 * stop as soon as the limit is reached.
 					 */
-					pushDown = true;
+					if (remote_est > 0 && remote_est <= REMOTE_LIMIT_DRAIN_ROWS)
+						pushDown = true;
 #endif
                 }
 
@@ -3343,6 +3389,100 @@ limit_needed(Query *parse)
     return false;                /* don't need a Limit plan node */
 }
 
+#ifdef __OPENTENBASE__
+/*
+ * make_remote_limit_count
+ *    Build the LIMIT expression of a Limit node pushed down below a
+ *    RemoteSubplan, or return NULL if the limit cannot be pushed down.
+ *
+ * Every datanode has to return (limit + offset) rows.  Constant clauses are
+ * added up here; otherwise the datanodes compute
+ *
+ *     LEAST(limit, INT64_MAX - offset) + offset
+ *
+ * which cannot overflow for any offset the Limit node on top accepts, and
+ * yields NULL (no limit) when the offset is NULL.  A LIMIT ALL has nothing
+ * to push down.
+ */
+static Node *
+make_remote_limit_count(Query *parse, int64 offset_est, int64 count_est)
+{
+    Node       *count = parse->limitCount;
+    Node       *offset = parse->limitOffset;
+    MinMaxExpr *least;
+    Expr       *room;
+
+    if (count == NULL)
+        return NULL;
+
+    if (IsA(count, Const) &&
+        (offset == NULL || IsA(offset, Const)))
+    {
+        /* preprocess_limit has already evaluated the constants */
+        if (((Const *) count)->constisnull)
+            return NULL;
+
+        return (Node *) makeConst(INT8OID, -1, InvalidOid, sizeof(int64),
+                                  Int64GetDatum(offset_est + count_est),
+                                  false, FLOAT8PASSBYVAL);
+    }
+
+    if (IsA(count, Const) && ((Const *) count)->constisnull)
+        return NULL;
+
+    /* the expressions are evaluated once more, on every datanode */
+    if (contain_volatile_functions(count) || contain_subplans(count) ||
+        contain_exec_params_walker(count, NULL))
+        return NULL;
+
+    if (offset == NULL)
+        return (Node *) copyObject(count);
+
+    if (contain_volatile_functions(offset) || contain_subplans(offset) ||
+        contain_exec_params_walker(offset, NULL))
+        return NULL;
+
+    room = make_opclause(Int8MinusOperator, INT8OID, false,
+                         (Expr *) makeConst(INT8OID, -1, InvalidOid,
+                                            sizeof(int64),
+                                            Int64GetDatum(PG_INT64_MAX),
+                                            false, FLOAT8PASSBYVAL),
+                         (Expr *) copyObject(offset),
+                         InvalidOid, InvalidOid);
+    set_opfuncid((OpExpr *) room);
+
+    least = makeNode(MinMaxExpr);
+    least->minmaxtype = INT8OID;
+    least->minmaxcollid = InvalidOid;
+    least->inputcollid = InvalidOid;
+    least->op = IS_LEAST;
+    least->args = list_make2(copyObject(count), room);
+    least->location = -1;
+
+    room = make_opclause(Int8PlusOperator, INT8OID, false,
+                         (Expr *) least, (Expr *) copyObject(offset),
+                         InvalidOid, InvalidOid);
+    set_opfuncid((OpExpr *) room);
+
+    return (Node *) room;
+}
+
+/*
+ * contain_exec_params_walker
+ *    Does the expression reference PARAM_EXEC Params?  Those belong to the
+ *    plan on the coordinator, so such limits are not pushed down.
+ */
+static bool
+contain_exec_params_walker(Node *node, void *context)
+{
+    if (node == NULL)
+        return false;
+    if (IsA(node, Param))
+        return ((Param *) node)->paramkind == PARAM_EXEC;
+    return expression_tree_walker(node, contain_exec_params_walker, context);
+}
+#endif
+
 
 /*
  * remove_useless_groupby_columns
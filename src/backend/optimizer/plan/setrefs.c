@@ -973,6 +973,11 @@ set_plan_refs(PlannerInfo *root, Plan *plan, int rtoffset)
                 {
                     lfirst_int(l) += rtoffset;
                 }
+#ifdef __OPENTENBASE__
+                splan->partprunequals = (List *)
+                    fix_scan_expr(root, (Node *) splan->partprunequals,
+                                  rtoffset);
+#endif
                 foreach(l, splan->appendplans)
                 {
                     lfirst(l) = set_plan_refs(root,
@@ -995,6 +1000,11 @@ set_plan_refs(PlannerInfo *root, Plan *plan, int rtoffset)
                 {
                     lfirst_int(l) += rtoffset;
                 }
+#ifdef __OPENTENBASE__
+                splan->partprunequals = (List *)
+                    fix_scan_expr(root, (Node *) splan->partprunequals,
+                                  rtoffset);
+#endif
                 foreach(l, splan->mergeplans)
                 {
                     lfirst(l) = set_plan_refs(root,
@@ -5299,6 +5299,10 @@ finalize_plan(PlannerInfo *root, Plan *plan, int gather_param, Bitmapset *valid_
             {
                 ListCell   *l;
 
+#ifdef __OPENTENBASE__
+                finalize_primnode((Node *) ((Append *) plan)->partprunequals,
+                                  &context);
+#endif
                 foreach(l, ((Append *) plan)->appendplans)
                 {
                     context.paramids =
@@ -5316,6 +5320,10 @@ finalize_plan(PlannerInfo *root, Plan *plan, int gather_param, Bitmapset *valid_
             {
                 ListCell   *l;
 
+#ifdef __OPENTENBASE__
+                finalize_primnode((Node *) ((MergeAppend *) plan)->partprunequals,
+                                  &context);
+#endif
                 foreach(l, ((MergeAppend *) plan)->mergeplans)
                 {
                     context.paramids =
@@ -44,6 +44,7 @@
 #include "pgxc/nodemgr.h"
 #include "utils/rel.h"
 #ifdef __OPENTENBASE__
+#include "catalog/pg_statistic.h"
 #include "catalog/pgxc_key_values.h"
 #include "executor/nodeAgg.h"
 #include "optimizer/distribution.h"
@@ -51,7 +52,10 @@
 #include "optimizer/planner.h"
 #include "optimizer/pgxcship.h"
 #include "pgxc/groupmgr.h"
+#include "parser/parse_coerce.h"
 #include "pgxc/pgxcnode.h"
+#include "pgxc/planner.h"
+#include "utils/datum.h"
 #include "utils/memutils.h"
 #endif
 
@@ -70,6 +74,12 @@ int replication_level;
 bool restrict_query = false;
 /* Support fast query shipping for subquery */
 bool enable_subquery_shipping = false;
+/* Spread rows of hot join keys when redistributing both sides of a join */
+bool enable_skew_redistribution = false;
+/* Minimal frequency of a join key value to be handled as hot */
+double skew_redistribution_threshold = 0.1;
+/* Decide at runtime whether to broadcast the build side of a hash join */
+bool enable_adaptive_broadcast = false;
 
 /* join will happen in these nodes forcibly */
 char  *g_constrain_group; /* the GUC variable */
@@ -112,6 +122,12 @@ extern void PoolPingNodes(void);
 
 #ifdef __OPENTENBASE__
 static int get_num_connections(int numnodes, int nRemotePlans);
+static bool set_joinpath_skew(PlannerInfo *root, JoinPath *pathnode,
+                              RestrictInfo *ri,
+                              Expr *outer_key, Expr *inner_key);
+static bool set_joinpath_adaptive(PlannerInfo *root, JoinPath *pathnode,
+                                  char distType, Expr *outer_key,
+                                  Expr *inner_key, Bitmapset *nodes);
 #endif
 
 /*****************************************************************************
@@ -1593,6 +1609,193 @@ redistribute_path(PlannerInfo *root, Path *subpath, List *pathkeys,
 }
 
 
+#ifdef __OPENTENBASE__
+/*
+ * get_remotesubpath
+ *    Find the RemoteSubPath created by redistribute_path.
+ */
+static RemoteSubPath *
+get_remotesubpath(Path *path)
+{
+    if (IsA(path, MaterialPath))
+        path = ((MaterialPath *) path)->subpath;
+
+    return IsA(path, RemoteSubPath) ? (RemoteSubPath *) path : NULL;
+}
+
+/*
+ * set_joinpath_skew
+ *    Handle hot values of the join key when both join sides are redistributed.
+ *
+ * All rows with the same key value are sent to one node, which becomes the
+ * straggler of the join if the value is frequent. If the MCV statistics of
+ * the outer key show such values, the outer side spreads their rows
+ * round-robin over the nodes and the inner side sends its matching rows to
+ * all of them. Each outer row still meets all its inner matches exactly
+ * once, so this is fine as long as the inner side is not preserved.
+ *
+ * Returns true if skew handling was set up. The join result is no longer
+ * distributed by the join key in that case.
+ */
+static bool
+set_joinpath_skew(PlannerInfo *root, JoinPath *pathnode, RestrictInfo *ri,
+                  Expr *outer_key, Expr *inner_key)
+{
+    OpExpr           *opexpr = (OpExpr *) ri->clause;
+    Oid               keytype = exprType((Node *) outer_key);
+    Oid               keycoll = exprCollation((Node *) outer_key);
+    RemoteSubPath    *outer_path;
+    RemoteSubPath    *inner_path;
+    VariableStatData  vardata;
+    AttStatsSlot      sslot;
+    List             *skewValues = NIL;
+    int16             typlen;
+    bool              typbyval;
+    int               i;
+
+    if (!enable_skew_redistribution)
+        return false;
+
+    if (pathnode->jointype != JOIN_INNER &&
+        pathnode->jointype != JOIN_LEFT &&
+        pathnode->jointype != JOIN_SEMI &&
+        pathnode->jointype != JOIN_ANTI)
+        return false;
+
+    /* Both sides match hot values with the same constants and operator */
+    if (keytype != exprType((Node *) inner_key))
+        return false;
+
+    outer_path = get_remotesubpath(pathnode->outerjoinpath);
+    inner_path = get_remotesubpath(pathnode->innerjoinpath);
+    if (outer_path == NULL || inner_path == NULL)
+        return false;
+
+    examine_variable(root, (Node *) outer_key, 0, &vardata);
+    if (HeapTupleIsValid(vardata.statsTuple) &&
+        get_attstatsslot(&sslot, vardata.statsTuple,
+                         STATISTIC_KIND_MCV, InvalidOid,
+                         ATTSTATSSLOT_VALUES | ATTSTATSSLOT_NUMBERS))
+    {
+        if (IsBinaryCoercible(sslot.valuetype, keytype))
+        {
+            get_typlenbyval(keytype, &typlen, &typbyval);
+
+            for (i = 0; i < sslot.nvalues; i++)
+            {
+                if (sslot.numbers[i] < skew_redistribution_threshold)
+                    continue;
+
+                skewValues = lappend(skewValues,
+                                     makeConst(keytype, -1, keycoll, typlen,
+                                               datumCopy(sslot.values[i],
+                                                         typbyval, typlen),
+                                               false, typbyval));
+            }
+        }
+        free_attstatsslot(&sslot);
+    }
+    ReleaseVariableStats(vardata);
+
+    if (skewValues == NIL)
+        return false;
+
+    outer_path->skewPolicy = SKEW_POLICY_SPREAD;
+    outer_path->skewValues = skewValues;
+    outer_path->skewEqOp = opexpr->opno;
+    inner_path->skewPolicy = SKEW_POLICY_BROADCAST;
+    inner_path->skewValues = skewValues;
+    inner_path->skewEqOp = opexpr->opno;
+
+    return true;
+}
+
+/*
+ * set_joinpath_adaptive
+ *    Leave the choice between replicating the inner side of a hash join and
+ *    redistributing both sides to the executor.
+ *
+ * The planner replicates the inner side if it estimates it small, and a bad
+ * estimate means the whole inner relation is sent to every node. Instead,
+ * both sides are redistributed by hash on the join keys, and the RemoteSubplan
+ * of the inner (build) side is marked so that its producers buffer their
+ * tuples and broadcast them if they stay below adaptive_broadcast_threshold.
+ * The outer (probe) side keeps its tuples on the nodes they are on if all
+ * build producers broadcast, so the plan runs as if the inner side was
+ * replicated, and it is redistributed otherwise. The probe side is costed as
+ * staying local, and the build side as being broadcast.
+ *
+ * The outer rows stay where they are only if they are already on the join
+ * nodes, and each of them meets every matching inner row exactly once in
+ * both modes only if the inner side is not preserved.
+ *
+ * Returns true if the join sides were set up that way. The join result is
+ * not distributed by the join key then.
+ */
+static bool
+set_joinpath_adaptive(PlannerInfo *root, JoinPath *pathnode, char distType,
+                      Expr *outer_key, Expr *inner_key, Bitmapset *nodes)
+{
+    Distribution   *outerd = pathnode->outerjoinpath->distribution;
+    RemoteSubPath  *outer_path;
+    RemoteSubPath  *inner_path;
+    Path           *subpath;
+
+    if (!enable_adaptive_broadcast || !IsA(pathnode, HashPath))
+        return false;
+
+    if (pathnode->jointype != JOIN_INNER &&
+        pathnode->jointype != JOIN_LEFT &&
+        pathnode->jointype != JOIN_SEMI &&
+        pathnode->jointype != JOIN_ANTI)
+        return false;
+
+    if (outerd == NULL || !bms_equal(outerd->nodes, nodes) ||
+        !bms_is_empty(outerd->restrictNodes))
+        return false;
+
+    /*
+     * redistribute_path reuses a RemoteSubPath below a Material, which is
+     * shared with other paths then.
+     */
+    if (IsA(pathnode->outerjoinpath, MaterialPath) ||
+        IsA(pathnode->innerjoinpath, MaterialPath))
+        return false;
+
+    outer_path = (RemoteSubPath *) redistribute_path(root,
+                                                     pathnode->outerjoinpath,
+                                                     NIL,
+                                                     distType,
+                                                     (Node *) outer_key,
+                                                     nodes,
+                                                     NULL);
+    inner_path = (RemoteSubPath *) redistribute_path(root,
+                                                     pathnode->innerjoinpath,
+                                                     NIL,
+                                                     distType,
+                                                     (Node *) inner_key,
+                                                     nodes,
+                                                     NULL);
+
+    outer_path->adaptivePolicy = ADAPTIVE_POLICY_PROBE;
+    subpath = outer_path->subpath;
+    cost_remote_subplan((Path *) outer_path, subpath->startup_cost,
+                        subpath->total_cost, subpath->rows,
+                        subpath->parent->reltarget->width, 1);
+
+    inner_path->adaptivePolicy = ADAPTIVE_POLICY_BUILD;
+    subpath = inner_path->subpath;
+    cost_remote_subplan((Path *) inner_path, subpath->startup_cost,
+                        subpath->total_cost, subpath->rows,
+                        subpath->parent->reltarget->width, 1);
+
+    pathnode->outerjoinpath = (Path *) outer_path;
+    pathnode->innerjoinpath = (Path *) inner_path;
+
+    return true;
+}
+#endif
+
 /*
  * Analyze join parameters and set distribution of the join node.
  * If there are possible alternate distributions the respective pathes are
@@ -2435,6 +2638,8 @@ not_allowed_join:
 			double inner_size = inner_rel->rows * inner_rel->reltarget->width;
 			int outer_nodes = bms_num_members(outerd->nodes);
 			int inner_nodes = bms_num_members(innerd->nodes);
+			bool skewed = false;
+			bool adaptive = false;
 #endif
 
             /* If we redistribute both parts do join on all nodes ... */
@@ -2636,7 +2841,15 @@ not_allowed_join:
 				 * replicate inner rel, just set LOCATOR_TYPE_NONE to remove
 				 * the path distribution.
 				 */
-                if(replicate_inner)
+                if (replicate_inner && new_inner_key &&
+                    set_joinpath_adaptive(root, pathnode, distType,
+                                          new_outer_key, new_inner_key,
+                                          nodes))
+                {
+                    /* both sides are redistributed, or not, at runtime */
+                    adaptive = true;
+                }
+                else if(replicate_inner)
                 {
                     pathnode->innerjoinpath = redistribute_path(
                                                 root,
@@ -2669,6 +2882,12 @@ not_allowed_join:
                 }
 #endif
             }
+#ifdef __OPENTENBASE__
+            if (new_inner_key && new_outer_key &&
+                !replicate_inner && !replicate_outer)
+                skewed = set_joinpath_skew(root, pathnode, preferred,
+                                           new_outer_key, new_inner_key);
+#endif
             targetd = makeNode(Distribution);
             targetd->distributionType = distType;
             targetd->nodes = nodes;
@@ -2696,6 +2915,14 @@ not_allowed_join:
             if (pathnode->jointype == JOIN_FULL)
                 /* both parts are nullable */
                 targetd->distributionExpr = NULL;
+#ifdef __OPENTENBASE__
+            else if (skewed)
+                /* rows of hot keys are spread over all nodes */
+                targetd->distributionExpr = NULL;
+            else if (adaptive)
+                /* outer rows may stay where they are or be redistributed */
+                targetd->distributionExpr = NULL;
+#endif
             else if (pathnode->jointype == JOIN_RIGHT)
                 targetd->distributionExpr =
                         pathnode->innerjoinpath->distribution->distributionExpr;
@@ -90,6 +90,8 @@
 #ifdef __OPENTENBASE__
 /* GUC to enable transform insert into multi-values to copy from */
 bool   g_transform_insert_to_copy;
+/* GUC to ship the transformed rows to datanodes in binary copy format */
+bool   g_transform_insert_to_copy_binary;
 #endif
 
 /* Hook for plugins to get control at end of parse analysis */
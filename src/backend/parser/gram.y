@@ -11064,6 +11064,7 @@ vacuum_option_elem:
 			| VERBOSE			{ $$ = VACOPT_VERBOSE; }
 			| FREEZE			{ $$ = VACOPT_FREEZE; }
 			| FULL				{ $$ = VACOPT_FULL; }
+			| PARALLEL			{ $$ = VACOPT_PARALLEL; }
 			| IDENT
 				{
 					if (strcmp($1, "disable_page_skipping") == 0)
@@ -135,7 +135,11 @@ static PGXCNodeAllHandles *get_exec_connections(RemoteQueryState *planstate,
 
 
 static bool pgxc_start_command_on_connection(PGXCNodeHandle *connection,
-                    RemoteQueryState *remotestate, Snapshot snapshot);
+                    RemoteQueryState *remotestate, Snapshot snapshot,
+                    bool flush);
+#ifdef __OPENTENBASE__
+static char *pgxc_failed_node_names(PGXCNodeHandle **connections, int count);
+#endif
 
 static void pgxc_node_remote_count(int *dnCount, int dnNodeIds[],
         int *coordCount, int coordNodeIds[]);
@@ -3456,6 +3460,14 @@ handle_response(PGXCNodeHandle *conn, ResponseCombiner *combiner)
 					HandleRemoteInstr(msg, msg_len, conn->nodeid, combiner);
 				/* just break to return EOF. */
 				break;
+			case 'J': /* Build side of adaptive broadcast was broadcast */
+				if (combiner && IsA(combiner, RemoteSubplanState))
+					((RemoteSubplanState *) combiner)->adaptive_broadcasts++;
+				break;
+			case 'j': /* Build side of adaptive broadcast is redistributed */
+				if (combiner && IsA(combiner, RemoteSubplanState))
+					((RemoteSubplanState *) combiner)->adaptive_redistributed = true;
+				break;
 #endif
             default:
                 /* sync lost? */
@@ -3558,6 +3570,18 @@ pgxc_node_begin(int conn_count, PGXCNodeHandle **connections,
 
     for (i = 0; i < conn_count; i++)
     {
+#ifdef __OPENTENBASE__
+		/*
+		 * Whether and which BEGIN to send depends on this connection's own
+		 * transaction status and flags. Carrying the decision over from an
+		 * earlier connection would send BEGIN to a node already in a
+		 * transaction block, or BEGIN_SUBTXN to a node that was not flagged
+		 * for a subtransaction. Callers that begin one connection at a time
+		 * always got the per-connection decision.
+		 */
+		need_send_begin = false;
+		cmd = begin_cmd;
+#endif
         if (!readOnly && !IsConnFromDatanode())
             connections[i]->read_only = false;
         /*
@@ -3679,17 +3703,20 @@ pgxc_node_begin(int conn_count, PGXCNodeHandle **connections,
         /* Send BEGIN if not already in transaction */
         if (need_send_begin)
         {
-            /* Send the BEGIN TRANSACTION command and check for errors */
-            if (pgxc_node_send_query(connections[i], cmd))
+            /*
+             * Only queue the BEGIN TRANSACTION command here, all the nodes
+             * are flushed together below.
+             */
+            if (pgxc_node_queue_query(connections[i], cmd))
             {
                 return EOF;
             }
 
-			elog(DEBUG5, "pgxc_node_begin send %s to node %s, pid:%d", cmd,
-					connections[i]->nodename, connections[i]->backend_pid);
-			new_connections[new_count++] = connections[i];
-			/* if send begin, register current connection */
-			register_transaction_handles(connections[i]);
+            elog(DEBUG5, "pgxc_node_begin send %s to node %s, pid:%d", cmd,
+                    connections[i]->nodename, connections[i]->backend_pid);
+            new_connections[new_count++] = connections[i];
+            /* if send begin, register current connection */
+            register_transaction_handles(connections[i]);
         }
     }
 
@@ -3700,6 +3727,12 @@ pgxc_node_begin(int conn_count, PGXCNodeHandle **connections,
     if (new_count == 0)
         return 0;
 
+    if (pgxc_node_flush_all(new_connections, new_count))
+    {
+        elog(WARNING, "pgxc_node_begin sending BEGIN fails.");
+        return EOF;
+    }
+
     InitResponseCombiner(&combiner, new_count, COMBINE_TYPE_NONE);
     /*
      * Make sure there are zeroes in unused fields
@@ -6701,10 +6734,47 @@ get_exec_connections(RemoteQueryState *planstate,
 }
 
 
+#ifdef __OPENTENBASE__
+/*
+ * Names of the nodes a batched BEGIN or send failed on, for error reports.
+ * Handles that failed carry an error message; if none does, all the nodes
+ * of the batch are named.
+ */
+static char *
+pgxc_failed_node_names(PGXCNodeHandle **connections, int count)
+{
+    StringInfoData names;
+    int            i;
+
+    initStringInfo(&names);
+    for (i = 0; i < count; i++)
+    {
+        if (connections[i]->error[0] != '\0')
+            appendStringInfo(&names, "%s%s", names.len > 0 ? "," : "",
+                             connections[i]->nodename);
+    }
+
+    if (names.len == 0)
+    {
+        for (i = 0; i < count; i++)
+            appendStringInfo(&names, "%s%s", names.len > 0 ? "," : "",
+                             connections[i]->nodename);
+    }
+
+    return names.data;
+}
+#endif
+
+/*
+ * Send the command of the remote query down to the connection. With flush
+ * false the messages are only queued and the caller must flush them, which
+ * lets a fan-out put the command on the wire for all the nodes at once.
+ */
 static bool
 pgxc_start_command_on_connection(PGXCNodeHandle *connection,
                                     RemoteQueryState *remotestate,
-                                    Snapshot snapshot)
+                                    Snapshot snapshot,
+                                    bool flush)
 {// #lizard forgives
     CommandId    cid;
     ResponseCombiner *combiner = (ResponseCombiner *) remotestate;
@@ -6783,23 +6853,48 @@ pgxc_start_command_on_connection(PGXCNodeHandle *connection,
 #endif
         combiner->extended_query = true;
 
-        if (pgxc_node_send_query_extended(connection,
-                            prepared ? NULL : step->sql_statement,
-                            step->statement,
-                            step->cursor,
-                            remotestate->rqs_num_params,
-                            remotestate->rqs_param_types,
-                            remotestate->paramval_len,
-                            remotestate->paramval_data,
-                            step->has_row_marks ? true : step->read_only,
-                            fetch) != 0)
-            return false;
+        if (flush)
+        {
+            if (pgxc_node_send_query_extended(connection,
+                                prepared ? NULL : step->sql_statement,
+                                step->statement,
+                                step->cursor,
+                                remotestate->rqs_num_params,
+                                remotestate->rqs_param_types,
+                                remotestate->paramval_len,
+                                remotestate->paramval_data,
+                                step->has_row_marks ? true : step->read_only,
+                                fetch) != 0)
+                return false;
+        }
+        else
+        {
+            if (pgxc_node_queue_query_extended(connection,
+                                prepared ? NULL : step->sql_statement,
+                                step->statement,
+                                step->cursor,
+                                remotestate->rqs_num_params,
+                                remotestate->rqs_param_types,
+                                remotestate->paramval_len,
+                                remotestate->paramval_data,
+                                step->has_row_marks ? true : step->read_only,
+                                fetch) != 0)
+                return false;
+        }
     }
     else
     {
         combiner->extended_query = false;
-        if (pgxc_node_send_query(connection, step->sql_statement) != 0)
-            return false;
+        if (flush)
+        {
+            if (pgxc_node_send_query(connection, step->sql_statement) != 0)
+                return false;
+        }
+        else
+        {
+            if (pgxc_node_queue_query(connection, step->sql_statement) != 0)
+                return false;
+        }
     }
     return true;
 }
@@ -9150,7 +9245,8 @@ ExecRemoteQuery(PlanState *pstate)
 			/* If explicit transaction is needed gxid is already sent */
 			if (!pgxc_start_command_on_connection(primaryconnection,
 												  node,
-												  snapshot))
+												  snapshot,
+												  true))
 			{
 				pgxc_node_remote_abort(TXN_TYPE_RollbackTxn, true);
 				pfree_pgxc_all_handles(pgxc_connections);
@@ -9204,22 +9300,28 @@ ExecRemoteQuery(PlanState *pstate)
             combiner->current_conn = 0;
         }
 #endif
-        for (i = 0; i < regular_conn_count; i++)
-        {
-            //connections[i]->read_only = true;
 #ifdef __OPENTENBASE__
+        for (i = 0; i < regular_conn_count; i++)
 			connections[i]->recv_datarows = 0;
 #endif
 
-			if (pgxc_node_begin(1, &connections[i], gxid, need_tran_block,
-								step->read_only))
-				ereport(ERROR,
-						(errcode(ERRCODE_INTERNAL_ERROR),
-						 errmsg("Could not begin transaction on data node:%s.",
-								 connections[i]->nodename)));
+		/*
+		 * Begin on all the nodes in one round trip, then queue the command
+		 * for every connection and put them on the wire together, rather
+		 * than waiting for each node in turn.
+		 */
+		if (pgxc_node_begin(regular_conn_count, connections, gxid,
+							need_tran_block, step->read_only))
+			ereport(ERROR,
+					(errcode(ERRCODE_INTERNAL_ERROR),
+					 errmsg("Could not begin transaction on data node:%s.",
+							pgxc_failed_node_names(connections,
+												   regular_conn_count))));
 
+        for (i = 0; i < regular_conn_count; i++)
+        {
 			/* If explicit transaction is needed gxid is already sent */
-			if (!pgxc_start_command_on_connection(connections[i], node, snapshot))
+			if (!pgxc_start_command_on_connection(connections[i], node, snapshot, false))
 			{
 				pgxc_node_remote_abort(TXN_TYPE_RollbackTxn, true);
 				pfree_pgxc_all_handles(pgxc_connections);
@@ -9230,6 +9332,19 @@ ExecRemoteQuery(PlanState *pstate)
 			connections[i]->combiner = combiner;
 		}
 
+		if (pgxc_node_flush_all(connections, regular_conn_count))
+		{
+			char	   *nodenames = pgxc_failed_node_names(connections,
+														   regular_conn_count);
+
+			pgxc_node_remote_abort(TXN_TYPE_RollbackTxn, true);
+			pfree_pgxc_all_handles(pgxc_connections);
+			ereport(ERROR,
+					(errcode(ERRCODE_INTERNAL_ERROR),
+					 errmsg("Failed to send command to data node:%s",
+							nodenames)));
+		}
+
 		if (step->cursor)
 		{
 			int conn_size = regular_conn_count * sizeof(PGXCNodeHandle *);
@@ -10402,6 +10517,10 @@ ExecInitRemoteSubplan(RemoteSubplan *node, EState *estate, int eflags)
         rstmt.distributionNodes = node->distributionNodes;
         rstmt.distributionRestrict = node->distributionRestrict;
 #ifdef __OPENTENBASE__
+        rstmt.skewPolicy = node->skewPolicy;
+        rstmt.skewValues = node->skewValues;
+        rstmt.skewEqOp = node->skewEqOp;
+        rstmt.adaptivePolicy = node->adaptivePolicy;
         rstmt.parallelWorkerSendTuple = node->parallelWorkerSendTuple;
         if(IsParallelWorker())
         {
@@ -10424,6 +10543,8 @@ ExecInitRemoteSubplan(RemoteSubplan *node, EState *estate, int eflags)
             rstmt.partrelindex = 0;
             rstmt.partpruning = NULL;
         }
+
+        rstmt.jitFlags = estate->es_plannedstmt->jitFlags;
 #endif
 
         /*
@@ -10453,6 +10574,19 @@ ExecInitRemoteSubplan(RemoteSubplan *node, EState *estate, int eflags)
             }
 #endif
             remotestate->subplanstr = nodeToString(&rstmt);
+#ifdef __OPENTENBASE__
+            /*
+             * The probe side of adaptive broadcast is redistributed, unless
+             * the build side turns out to be broadcast. Keep the variant
+             * for that case at hand, see ExecRemoteSubplanChooseProbe.
+             */
+            if (node->adaptivePolicy == ADAPTIVE_POLICY_PROBE)
+            {
+                remotestate->adaptive_hash_subplanstr = remotestate->subplanstr;
+                rstmt.adaptivePolicy = ADAPTIVE_POLICY_PROBE_LOCAL;
+                remotestate->adaptive_local_subplanstr = nodeToString(&rstmt);
+            }
+#endif
 #ifdef __AUDIT__
             rstmt.queryString = NULL;
             rstmt.parseTree = NULL;
@@ -10485,8 +10619,12 @@ ExecInitRemoteSubplan(RemoteSubplan *node, EState *estate, int eflags)
             {
                 //ExecFinishInitRemoteSubplan(remotestate);
 #ifdef __OPENTENBASE__
-                /* Not parallel aware, build connections. */
-                if (!node->scan.plan.parallel_aware)
+                /*
+                 * Not parallel aware, build connections. The probe side of
+                 * adaptive broadcast is sent once the build side is read.
+                 */
+                if (!node->scan.plan.parallel_aware &&
+                    node->adaptivePolicy != ADAPTIVE_POLICY_PROBE)
                 {
                     ExecFinishInitRemoteSubplan(remotestate);
                 }
@@ -10648,16 +10786,22 @@ ExecFinishInitRemoteSubplan(RemoteSubplanState *node)
     }
 #endif 
 
+	/*
+	 * Begin on all the nodes in one round trip, then queue the subplan for
+	 * every connection and flush them all together.
+	 */
+	if (pgxc_node_begin(combiner->conn_count, combiner->connections, gxid,
+						true, is_read_only))
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("Could not begin transaction on data node:%s.",
+						pgxc_failed_node_names(combiner->connections,
+											   combiner->conn_count))));
+
     for (i = 0; i < combiner->conn_count; i++)
     {
         PGXCNodeHandle *connection = combiner->connections[i];
 
-		if (pgxc_node_begin(1, &connection, gxid, true, is_read_only))
-			ereport(ERROR,
-					(errcode(ERRCODE_INTERNAL_ERROR),
-					 errmsg("Could not begin transaction on data node:%s.",
-							 connection->nodename)));
-
         if (pgxc_node_send_timestamp(connection, timestamp))
         {
             combiner->conn_count = 0;
@@ -10692,15 +10836,19 @@ ExecFinishInitRemoteSubplan(RemoteSubplanState *node)
 				      MyProcPid, connection->backend_pid, connection->nodehost,
 					  connection->nodeport, connection->sock, cursor);
 		}
-		
-		if (pgxc_node_flush(connection))
-		{
-			combiner->conn_count = 0;
-			pfree(combiner->connections);
-			ereport(ERROR,
-					(errcode(ERRCODE_INTERNAL_ERROR),
-					 errmsg("Failed to send subplan to data nodes")));
-		}
+	}
+
+	if (pgxc_node_flush_all(combiner->connections, combiner->conn_count))
+	{
+		char	   *nodenames = pgxc_failed_node_names(combiner->connections,
+													   combiner->conn_count);
+
+		combiner->conn_count = 0;
+		pfree(combiner->connections);
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("Failed to send subplan to data node:%s",
+						nodenames)));
 	}
 }
 
@@ -10895,6 +11043,13 @@ ExecRemoteSubplan(PlanState *pstate)
 #ifdef __OPENTENBASE__
 	if ((node->eflags & EXEC_FLAG_EXPLAIN_ONLY) != 0)
 		return NULL;
+
+    /* the probe side of adaptive broadcast was started while building */
+    if (node->adaptive_prefetched)
+    {
+        node->adaptive_prefetched = false;
+        return node->adaptive_first;
+    }
 	
     if (!node->local_exec && (!node->finish_init) && (!(node->eflags & EXEC_FLAG_SUBPLAN)))
     {
@@ -10991,6 +11146,9 @@ primary_mode_phase_two:
         combiner->recv_tuples     = 0;
         combiner->recv_total_time = -1;
         combiner->recv_datarows = 0;
+        node->adaptive_producers = count;
+        node->adaptive_broadcasts = 0;
+        node->adaptive_redistributed = false;
 #endif
 
         /*
@@ -11259,11 +11417,40 @@ primary_mode_phase_two:
     }
     else
     {
-        TupleTableSlot *slot = FetchTuple(combiner);
+        TupleTableSlot *slot;
+#ifdef __OPENTENBASE__
+        Instrumentation *instr = node->combiner.ss.ps.instrument;
+        instr_time  fetch_start;
+
+        /* time the wait only when EXPLAIN ANALYZE asks for timing */
+        if (instr && instr->need_timer)
+            INSTR_TIME_SET_CURRENT(fetch_start);
+#endif
+        slot = FetchTuple(combiner);
+#ifdef __OPENTENBASE__
+        if (instr && instr->need_timer)
+        {
+            instr_time  fetch_end;
+
+            INSTR_TIME_SET_CURRENT(fetch_end);
+            INSTR_TIME_ACCUM_DIFF(node->recv_time, fetch_end, fetch_start);
+        }
+#endif
         if (!TupIsNull(slot))
         {
             if (log_remotesubplan_stats)
                 ShowUsageCommon("ExecRemoteSubplan", &start_r, &start_t);
+#ifdef __OPENTENBASE__
+            /*
+             * Once a build producer of adaptive broadcast redistributes, the
+             * probe side is redistributed as well; start it right away, so it
+             * runs while the rest of the build side is read.
+             */
+            if (node->adaptive_redistributed && node->adaptive_probe &&
+                !node->adaptive_probe->finish_init)
+                ExecRemoteSubplanChooseProbe((PlanState *) node->adaptive_probe,
+                                             (PlanState *) node);
+#endif
             return slot;
         }
         else if (combiner->probing_primary)
@@ -11325,10 +11512,209 @@ ExecReScanRemoteSubplan(RemoteSubplanState *node)
     node->bound = false;
 #ifdef __OPENTENBASE__
     node->eflags &= ~(EXEC_FLAG_DISCONN);
+    node->adaptive_prefetched = false;
+    node->adaptive_first = NULL;
 #endif
 }
 
 #ifdef __OPENTENBASE__
+/*
+ * ExecRemoteSubplanLinkAdaptive
+ *    Let the build side of a hash join with adaptive broadcast start the probe
+ *    side as soon as it knows the probe side is redistributed.
+ */
+void
+ExecRemoteSubplanLinkAdaptive(PlanState *probe, PlanState *build)
+{
+    if (probe == NULL || !IsA(probe, RemoteSubplanState) ||
+        build == NULL || !IsA(build, RemoteSubplanState))
+        return;
+
+    if (((RemoteSubplanState *) probe)->adaptive_local_subplanstr != NULL &&
+        ((RemoteSubplan *) build->plan)->adaptivePolicy == ADAPTIVE_POLICY_BUILD)
+        ((RemoteSubplanState *) build)->adaptive_probe =
+            (RemoteSubplanState *) probe;
+}
+
+/*
+ * ExecRemoteSubplanProbePending
+ *    Is this the probe side of adaptive broadcast, not distributed yet?
+ */
+bool
+ExecRemoteSubplanProbePending(PlanState *probe)
+{
+    RemoteSubplanState *pnode = (RemoteSubplanState *) probe;
+
+    return probe != NULL && IsA(probe, RemoteSubplanState) &&
+           pnode->adaptive_local_subplanstr != NULL &&
+           !pnode->local_exec && !pnode->finish_init;
+}
+
+/*
+ * Close the statement a RemoteSubplan sent down, so that the next execution
+ * sends down subplanstr in its place, under the same name.
+ */
+static void
+ExecRemoteSubplanReplace(RemoteSubplanState *node, char *subplanstr)
+{
+    ResponseCombiner *combiner = (ResponseCombiner *) node;
+    RemoteSubplan  *plan = (RemoteSubplan *) combiner->ss.ps.plan;
+    PGXCNodeHandle **connections;
+    char            cursor[NAMEDATALEN];
+    int             count;
+    int             i;
+
+    if (plan->unique)
+        snprintf(cursor, NAMEDATALEN, "%s_"INT64_FORMAT, plan->cursor, plan->unique);
+    else
+        strlcpy(cursor, plan->cursor, sizeof(cursor));
+
+    /* Consume any possible pending input */
+    pgxc_connections_cleanup(combiner);
+
+    combiner->extended_query = true;
+    count = 0;
+    connections = (PGXCNodeHandle **)
+        palloc(Max(combiner->conn_count, 1) * sizeof(PGXCNodeHandle *));
+    for (i = 0; i < combiner->conn_count; i++)
+    {
+        PGXCNodeHandle *conn = combiner->connections[i];
+
+        if (!conn)
+            continue;
+
+        CHECK_OWNERSHIP(conn, combiner);
+
+        if (pgxc_node_send_close(conn, true, cursor) != 0 ||
+            pgxc_node_send_sync(conn) != 0)
+            ereport(ERROR,
+                    (errcode(ERRCODE_INTERNAL_ERROR),
+                     errmsg("Failed to close data node statement on node %s",
+                            conn->nodename)));
+        PGXCNodeSetConnectionState(conn, DN_CONNECTION_STATE_CLOSE);
+        connections[count++] = conn;
+    }
+
+    while (count > 0)
+    {
+        if (pgxc_node_receive(count, connections, NULL))
+            ereport(ERROR,
+                    (errcode(ERRCODE_INTERNAL_ERROR),
+                     errmsg("Failed to close remote subplan")));
+
+        i = 0;
+        while (i < count)
+        {
+            int res = handle_response(connections[i], combiner);
+
+            if (res == RESPONSE_EOF)
+                i++;
+            else if (res == RESPONSE_READY ||
+                     (res == RESPONSE_COMPLETE &&
+                      connections[i]->state == DN_CONNECTION_STATE_ERROR_FATAL))
+            {
+                if (--count > i)
+                    connections[i] = connections[count];
+            }
+            else if (res == RESPONSE_DATAROW)
+            {
+                /* the statement may still have been producing, see above */
+                pfree(combiner->currentRow);
+                combiner->currentRow = NULL;
+            }
+            /* Ignore other possible responses */
+        }
+    }
+    pfree(connections);
+
+    if (combiner->errorMessage)
+        pgxc_node_report_error(combiner);
+
+    /* Connect and send down the new subplan on next execution */
+    if (combiner->connections)
+        pfree(combiner->connections);
+    combiner->connections = NULL;
+    combiner->conn_count = 0;
+    combiner->command_complete_count = 0;
+    combiner->description_count = 0;
+    node->finish_init = false;
+    node->bound = false;
+    node->subplanstr = subplanstr;
+}
+
+/*
+ * ExecRemoteSubplanChooseProbe
+ *    Choose how the probe side of a hash join with adaptive broadcast is
+ *    distributed.
+ *
+ * Every producer of the build side reports whether it broadcast its tuples,
+ * at its end if it did, or as soon as it starts redistributing otherwise.
+ * If all of them broadcast, each node has the whole build side, and the
+ * producers of the probe side may keep their tuples on their own node. This
+ * is called once the build side is read then. As soon as one producer
+ * redistributes, the probe side is redistributed by hash, and it is started
+ * at once. The consumers on all nodes get the same reports, so they send the
+ * same variant of the probe subplan down.
+ */
+void
+ExecRemoteSubplanChooseProbe(PlanState *probe, PlanState *build)
+{
+    RemoteSubplanState *pnode;
+    RemoteSubplanState *bnode = NULL;
+    bool                broadcast = false;
+
+    if (probe == NULL || !IsA(probe, RemoteSubplanState))
+        return;
+
+    pnode = (RemoteSubplanState *) probe;
+    if (pnode->adaptive_local_subplanstr == NULL || pnode->local_exec)
+        return;
+
+    if (build && IsA(build, RemoteSubplanState) &&
+        ((RemoteSubplan *) build->plan)->adaptivePolicy == ADAPTIVE_POLICY_BUILD)
+    {
+        bnode = (RemoteSubplanState *) build;
+        broadcast = !bnode->local_exec && !bnode->adaptive_redistributed &&
+                    bnode->adaptive_producers > 0 &&
+                    bnode->adaptive_broadcasts == bnode->adaptive_producers;
+    }
+
+    /*
+     * The probe subplan is sent down already when the join is rescanned. If
+     * the build side is no longer broadcast, fall back to the variant
+     * redistributing the probe side. The opposite change is left alone, the
+     * redistributed probe side is correct either way.
+     */
+    if (pnode->finish_init)
+    {
+        if (pnode->subplanstr == pnode->adaptive_local_subplanstr && !broadcast)
+        {
+            elog(DEBUG1, "adaptive broadcast: build side no longer broadcast, "
+                 "probe side redistributed on rescan");
+            ExecRemoteSubplanReplace(pnode, pnode->adaptive_hash_subplanstr);
+        }
+        return;
+    }
+
+    pnode->subplanstr = broadcast ? pnode->adaptive_local_subplanstr :
+                                    pnode->adaptive_hash_subplanstr;
+
+    elog(DEBUG1, "adaptive broadcast: %d of %d build producers broadcast, probe side %s",
+         bnode ? bnode->adaptive_broadcasts : 0,
+         bnode ? bnode->adaptive_producers : 0,
+         broadcast ? "kept local" : "redistributed");
+
+    /*
+     * While the build side is still read, start the probe side by fetching
+     * its first tuple, it is returned by the next ExecRemoteSubplan.
+     */
+    if (bnode && bnode->adaptive_redistributed)
+    {
+        pnode->adaptive_first = ExecProcNode(probe);
+        pnode->adaptive_prefetched = true;
+    }
+}
+
 /*
  * ExecShutdownRemoteSubplan
  * 
@@ -12793,7 +13179,7 @@ ExecRemoteDML(ModifyTableState *mtstate, ItemPointer tupleid, HeapTuple oldtuple
     if (operation == CMD_UPDATE || operation == CMD_DELETE ||
         (operation == CMD_INSERT && mtstate->mt_onconflict != ONCONFLICT_UPDATE))
     {
-        if (!pgxc_start_command_on_connection(connections[i], node, snapshot))
+        if (!pgxc_start_command_on_connection(connections[i], node, snapshot, true))
         {
             pgxc_node_remote_abort(TXN_TYPE_RollbackTxn, true);
             pfree_pgxc_all_handles(pgxc_connections);
@@ -12828,7 +13214,7 @@ UPSERT:
                 step->sql_statement = step->sql_select;
                 step->statement = step->select_cursor;
 
-                if (!pgxc_start_command_on_connection(connections[i], node, snapshot))
+                if (!pgxc_start_command_on_connection(connections[i], node, snapshot, true))
                 {
                     pgxc_node_remote_abort(TXN_TYPE_RollbackTxn, true);
                     pfree_pgxc_all_handles(pgxc_connections);
@@ -12848,7 +13234,7 @@ UPSERT:
             /* no conflict tuple found, try to insert */
             case UPSERT_INSERT:
             {
-                if (!pgxc_start_command_on_connection(connections[i], node, snapshot))
+                if (!pgxc_start_command_on_connection(connections[i], node, snapshot, true))
                 {
                     pgxc_node_remote_abort(TXN_TYPE_RollbackTxn, true);
                     pfree_pgxc_all_handles(pgxc_connections);
@@ -60,6 +60,7 @@
 #include "utils/syscache.h"
 #include "utils/lsyscache.h"
 #include "utils/formatting.h"
+#include "utils/timestamp.h"
 #include "utils/tqual.h"
 #include "../interfaces/libpq/libpq-int.h"
 #include "../interfaces/libpq/libpq-fe.h"
@@ -163,6 +164,22 @@ static void pgxc_node_all_free(void);
 static int    get_int(PGXCNodeHandle * conn, size_t len, int *out);
 static int    get_char(PGXCNodeHandle * conn, char *out);
 
+static int	pgxc_node_send_my_sync_internal(PGXCNodeHandle * handle, bool flush);
+static int	pgxc_node_send_query_extended_internal(PGXCNodeHandle *handle,
+									   const char *query, const char *statement,
+									   const char *portal, int num_params,
+									   Oid *param_types, int paramlen,
+									   char *params, bool send_describe,
+									   int fetch_size, bool flush);
+
+/* send() flag used by pgxc_node_flush_all to never block on a single socket */
+#ifdef MSG_DONTWAIT
+#define PGXC_SEND_NOWAIT MSG_DONTWAIT
+#else
+#define PGXC_SEND_NOWAIT 0
+#endif
+static int send_some_internal(PGXCNodeHandle *handle, int len, bool nowait);
+
 #ifdef __OPENTENBASE__
 static ParamEntry * paramlist_get_paramentry(List *param_list, const char *name);
 static ParamEntry * paramentry_copy(ParamEntry * src_entry);
@@ -1912,6 +1929,17 @@ ensure_out_buffer_capacity(size_t bytes_needed, PGXCNodeHandle *handle)
  */
 int
 send_some(PGXCNodeHandle *handle, int len)
+{
+    return send_some_internal(handle, len, false);
+}
+
+/*
+ * Workhorse for send_some. With nowait set, only what the socket accepts
+ * right now is written and the rest is left at the start of the buffer,
+ * instead of polling until everything is out.
+ */
+static int
+send_some_internal(PGXCNodeHandle *handle, int len, bool nowait)
 {// #lizard forgives
     char       *ptr = handle->outBuffer;
     int            remaining = handle->outEnd;
@@ -1923,7 +1951,7 @@ send_some(PGXCNodeHandle *handle, int len)
         int            sent;
 
 #ifndef WIN32
-        sent = send(handle->sock, ptr, len, 0);
+        sent = send(handle->sock, ptr, len, nowait ? PGXC_SEND_NOWAIT : 0);
 #else
         /*
          * Windows can fail on large sends, per KB article Q201213. The failure-point
@@ -1987,6 +2015,9 @@ send_some(PGXCNodeHandle *handle, int len)
             remaining -= sent;
         }
 
+        if (len > 0 && nowait)
+            break;
+
         if (len > 0)
         {
             struct pollfd pool_fd;
@@ -2543,6 +2574,16 @@ pgxc_node_send_sync(PGXCNodeHandle * handle)
  */
 int
 pgxc_node_send_my_sync(PGXCNodeHandle * handle)
+{
+	return pgxc_node_send_my_sync_internal(handle, true);
+}
+
+/*
+ * Append SYNC and FLUSH messages to the connection buffer, optionally
+ * putting them on the wire right away
+ */
+static int
+pgxc_node_send_my_sync_internal(PGXCNodeHandle * handle, bool flush)
 {
     /* size */
     int			msgLen = 4;
@@ -2579,6 +2620,8 @@ pgxc_node_send_my_sync(PGXCNodeHandle * handle)
 
     handle->in_extended_query = true;
 
+	if (!flush)
+		return 0;
     return pgxc_node_flush(handle);
 }
 
@@ -2631,6 +2674,40 @@ pgxc_node_send_query_extended(PGXCNodeHandle *handle, const char *query,
                               int num_params, Oid *param_types,
                               int paramlen, char *params,
                               bool send_describe, int fetch_size)
+{
+	return pgxc_node_send_query_extended_internal(handle, query, statement,
+												  portal, num_params,
+												  param_types, paramlen,
+												  params, send_describe,
+												  fetch_size, true);
+}
+
+/*
+ * Same as pgxc_node_send_query_extended, but only queue the messages in the
+ * connection buffer. The caller is responsible for flushing it, normally
+ * with pgxc_node_flush_all once all the connections have been prepared.
+ */
+int
+pgxc_node_queue_query_extended(PGXCNodeHandle *handle, const char *query,
+							   const char *statement, const char *portal,
+							   int num_params, Oid *param_types,
+							   int paramlen, char *params,
+							   bool send_describe, int fetch_size)
+{
+	return pgxc_node_send_query_extended_internal(handle, query, statement,
+												  portal, num_params,
+												  param_types, paramlen,
+												  params, send_describe,
+												  fetch_size, false);
+}
+
+static int
+pgxc_node_send_query_extended_internal(PGXCNodeHandle *handle, const char *query,
+									   const char *statement, const char *portal,
+									   int num_params, Oid *param_types,
+									   int paramlen, char *params,
+									   bool send_describe, int fetch_size,
+									   bool flush)
 {// #lizard forgives
     /* NULL query indicates already prepared statement */
     if (query)
@@ -2644,7 +2721,7 @@ pgxc_node_send_query_extended(PGXCNodeHandle *handle, const char *query,
     if (fetch_size >= 0)
         if (pgxc_node_send_execute(handle, portal, fetch_size))
             return EOF;
-	if (pgxc_node_send_my_sync(handle))
+    if (pgxc_node_send_my_sync_internal(handle, flush))
         return EOF;
 
     return 0;
@@ -2686,6 +2763,155 @@ pgxc_node_flush(PGXCNodeHandle *handle)
     return 0;
 }
 
+/*
+ * Flush the outgoing buffers of a set of connections together.
+ *
+ * Callers queue the whole message batch (BEGIN, gxid, snapshot, query...)
+ * on every handle first and push it out here, so a fan-out to many nodes
+ * does not pay for the sockets one after another. Each socket is written
+ * with its whole buffer at once and we only wait for POLLOUT when none of
+ * the remaining sockets can take more data, so a slow node does not hold
+ * up the others. If none of the sockets accepts data for
+ * PGXC_RESULT_TIME_OUT seconds the remaining handles are failed. Returns 0
+ * if all buffers went out, EOF otherwise; the failing handles get an error
+ * message as with pgxc_node_flush. A handle failed after a partial send is
+ * out of sync with its node, so it is also marked fatal to keep it from
+ * being reused.
+ */
+int
+pgxc_node_flush_all(PGXCNodeHandle **connections, int count)
+{// #lizard forgives
+	PGXCNodeHandle **pending;
+	struct pollfd   *pfds;
+	int				 npending = 0;
+	int				 result = 0;
+	int				 i;
+	char			 errmsg_buf[MAX_ERROR_MSG_LENGTH];
+	TimestampTz		 last_progress;
+
+	if (count <= 0)
+		return 0;
+	if (count == 1)
+		return pgxc_node_flush(connections[0]);
+
+	pending = (PGXCNodeHandle **) palloc(sizeof(PGXCNodeHandle *) * count);
+	pfds = (struct pollfd *) palloc(sizeof(struct pollfd) * count);
+
+	for (i = 0; i < count; i++)
+	{
+		if (connections[i]->outEnd > 0)
+			pending[npending++] = connections[i];
+	}
+
+	last_progress = GetCurrentTimestamp();
+	while (npending > 0)
+	{
+		int		nleft = 0;
+		int		poll_ret;
+
+		CHECK_FOR_INTERRUPTS();
+
+		for (i = 0; i < npending; i++)
+		{
+			PGXCNodeHandle *handle = pending[i];
+			size_t			before = handle->outEnd;
+
+			if (before == 0)
+				continue;
+
+			/* send_some_internal reports and classifies send failures */
+			if (send_some_internal(handle, handle->outEnd, true) < 0)
+			{
+				result = EOF;
+				continue;
+			}
+
+			if (handle->outEnd < before)
+				last_progress = GetCurrentTimestamp();
+			if (handle->outEnd == 0)
+				continue;
+
+			pending[nleft++] = handle;
+		}
+
+		npending = nleft;
+		if (npending <= 0)
+			break;
+
+		if (TimestampDifferenceExceeds(last_progress, GetCurrentTimestamp(),
+									   PGXC_RESULT_TIME_OUT * 1000))
+		{
+			for (i = 0; i < npending; i++)
+			{
+				elog(LOG, "pgxc_node_flush_all data to node:%s fd:%d timed out "
+					 "after %d seconds", pending[i]->nodename,
+					 pending[i]->sock, PGXC_RESULT_TIME_OUT);
+				snprintf(errmsg_buf, sizeof(errmsg_buf),
+						 "timed out sending data to node %s",
+						 pending[i]->nodename);
+				add_error_message(pending[i], errmsg_buf);
+				pending[i]->outEnd = 0;
+				PGXCNodeSetConnectionState(pending[i],
+										   DN_CONNECTION_STATE_ERROR_FATAL);
+			}
+			result = EOF;
+			break;
+		}
+
+		/* Wait for any of the remaining sockets to become writable */
+		for (i = 0; i < npending; i++)
+		{
+			pfds[i].fd = pending[i]->sock;
+			pfds[i].events = POLLOUT;
+			pfds[i].revents = 0;
+		}
+
+		poll_ret = poll(pfds, npending, 1000);
+		if (poll_ret < 0)
+		{
+			int		save_errno = errno;
+
+			if (save_errno == EAGAIN || save_errno == EINTR)
+				continue;
+
+			for (i = 0; i < npending; i++)
+			{
+				snprintf(errmsg_buf, sizeof(errmsg_buf),
+						 "poll failed sending data to node %s: %s",
+						 pending[i]->nodename, strerror(save_errno));
+				add_error_message(pending[i], errmsg_buf);
+				pending[i]->outEnd = 0;
+				PGXCNodeSetConnectionState(pending[i],
+										   DN_CONNECTION_STATE_ERROR_FATAL);
+			}
+			result = EOF;
+			break;
+		}
+
+		for (i = 0; i < npending; i++)
+		{
+			if (pfds[i].revents & (POLLHUP | POLLERR | POLLNVAL))
+			{
+				elog(LOG, "pgxc_node_flush_all data to node:%s fd:%d failed, "
+					 "remote end disconnected", pending[i]->nodename,
+					 pending[i]->sock);
+				snprintf(errmsg_buf, sizeof(errmsg_buf),
+						 "remote end disconnected, node %s",
+						 pending[i]->nodename);
+				add_error_message(pending[i], errmsg_buf);
+				pending[i]->outEnd = 0;
+				PGXCNodeSetConnectionState(pending[i],
+										   DN_CONNECTION_STATE_ERROR_FATAL);
+				result = EOF;
+			}
+		}
+	}
+
+	pfree(pending);
+	pfree(pfds);
+	return result;
+}
+
 /*
  * This method won't return until network buffer is empty or error occurs
  * To ensure all data in network buffers is read and wasted
@@ -2765,7 +2991,7 @@ pgxc_node_flush_read(PGXCNodeHandle *handle)
  */
 static int
 pgxc_node_send_query_internal(PGXCNodeHandle * handle, const char *query,
-        bool rollback)
+        bool rollback, bool flush)
 {
     int            strLen;
     int            msgLen;
@@ -2806,6 +3032,8 @@ pgxc_node_send_query_internal(PGXCNodeHandle * handle, const char *query,
     PGXCNodeSetConnectionState(handle, DN_CONNECTION_STATE_QUERY);
 
     handle->in_extended_query = false;
+	if (!flush)
+		return 0;
      return pgxc_node_flush(handle);
 }
 
@@ -2818,7 +3046,7 @@ pgxc_node_send_rollback(PGXCNodeHandle *handle, const char *query)
         capacity_stack = SEND_ROLLBACK;
     }
 #endif
-    return pgxc_node_send_query_internal(handle, query, true);
+    return pgxc_node_send_query_internal(handle, query, true, true);
 }
 
 int
@@ -2833,7 +3061,26 @@ pgxc_node_send_query(PGXCNodeHandle *handle, const char *query)
         capacity_stack = SEND_QUERY;
     }
 #endif
-    return pgxc_node_send_query_internal(handle, query, false);
+    return pgxc_node_send_query_internal(handle, query, false, true);
+}
+
+/*
+ * Queue the specified statement in the connection buffer without sending it.
+ * The caller is responsible for flushing, see pgxc_node_flush_all.
+ */
+int
+pgxc_node_queue_query(PGXCNodeHandle *handle, const char *query)
+{
+#ifdef __TWO_PHASE_TESTS__
+     if ((IN_REMOTE_PREPARE == twophase_in && !handle->read_only) ||
+        IN_PREPARE_ERROR == twophase_in ||
+        IN_REMOTE_FINISH == twophase_in ||
+        IN_PG_CLEAN == twophase_in)
+    {
+        capacity_stack = SEND_QUERY;
+    }
+#endif
+    return pgxc_node_send_query_internal(handle, query, false, false);
 }
 
 /*
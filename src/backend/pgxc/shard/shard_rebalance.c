@@ -0,0 +1,395 @@
+/*
+ * Copyright (c) 2023 THL A29 Limited, a Tencent company.
+ *
+ * This source code file is licensed under the BSD 3-Clause License,
+ * you may obtain a copy of the License at http://opensource.org/license/bsd-3-clause/
+ */
+/*-------------------------------------------------------------------------
+ *
+ * shard_rebalance.c
+ *      Plan shardgroup moves that even out the load of the datanodes of a
+ *      group, based on the shard statistic kept by each datanode.
+ *
+ * The load of a datanode is the sum of the load of the shardgroups it is
+ * the primary copy of.  Moves are planned greedily: while the most loaded
+ * node exceeds the group average by more than the allowed imbalance, the
+ * shardgroup of that node whose load is closest to half the gap to the
+ * least loaded node is moved there.  Every move strictly lowers the larger
+ * of the two loads, so the plan ends, and it uses few moves because large
+ * gaps are closed by large shardgroups first.
+ *
+ * The result is a list of moves which can be executed with MOVE DATA.
+ *
+ * IDENTIFICATION
+ *      src/backend/pgxc/shard/shard_rebalance.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "funcapi.h"
+#include "access/genam.h"
+#include "access/heapam.h"
+#include "access/htup_details.h"
+#include "catalog/indexing.h"
+#include "catalog/pg_type.h"
+#include "catalog/pgxc_shard_map.h"
+#include "executor/executor.h"
+#include "nodes/makefuncs.h"
+#include "pgxc/execRemote.h"
+#include "pgxc/pgxc.h"
+#include "pgxc/pgxcnode.h"
+#include "pgxc/shardmap.h"
+#include "utils/builtins.h"
+#include "utils/fmgroids.h"
+#include "utils/lsyscache.h"
+#include "utils/snapmgr.h"
+
+typedef enum
+{
+    SHARD_LOAD_SIZE,            /* bytes stored */
+    SHARD_LOAD_WRITE,           /* tuples inserted, updated and deleted */
+    SHARD_LOAD_READ             /* tuples scanned */
+} ShardLoadMetric;
+
+/* one planned shardgroup move */
+typedef struct
+{
+    int32   shardgroupid;
+    Oid     from_node;
+    Oid     to_node;
+    int64   load;
+} ShardMove;
+
+/* Working status for opentenbase_shard_rebalance_plan */
+typedef struct
+{
+    int        currIdx;
+    int        nmoves;
+    ShardMove *moves;
+} ShardRebalance_State;
+
+static ShardLoadMetric get_shard_load_metric(const char *name);
+static void fetch_shard_load(const char *group_name, int ndns, Oid *dnoids,
+                             ShardLoadMetric metric, int64 *shard_load);
+static ShardMove *plan_shard_moves(Oid group, int ndns, Oid *dnoids,
+                                   int64 *shard_load, double max_imbalance,
+                                   int *nmoves);
+
+static ShardLoadMetric
+get_shard_load_metric(const char *name)
+{
+    if (pg_strcasecmp(name, "size") == 0)
+        return SHARD_LOAD_SIZE;
+    if (pg_strcasecmp(name, "write") == 0)
+        return SHARD_LOAD_WRITE;
+    if (pg_strcasecmp(name, "read") == 0)
+        return SHARD_LOAD_READ;
+
+    ereport(ERROR,
+            (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+             errmsg("invalid shard load metric \"%s\"", name),
+             errhint("Valid metrics are \"size\", \"write\" and \"read\".")));
+    return SHARD_LOAD_SIZE;        /* keep compiler quiet */
+}
+
+/*
+ * Sum up the shard statistic of all datanodes of the group into shard_load,
+ * indexed by shard id. Only rows the datanodes report for this group are
+ * counted.
+ */
+static void
+fetch_shard_load(const char *group_name, int ndns, Oid *dnoids,
+                 ShardLoadMetric metric, int64 *shard_load)
+{
+    EState             *estate;
+    MemoryContext       oldcontext;
+    RemoteQuery        *plan;
+    RemoteQueryState   *pstate;
+    TupleTableSlot     *result;
+    StringInfoData      query;
+    int                 i;
+
+    initStringInfo(&query);
+    appendStringInfoString(&query, "SELECT shard_id, ");
+    switch (metric)
+    {
+        case SHARD_LOAD_SIZE:
+            appendStringInfoString(&query, "size");
+            break;
+        case SHARD_LOAD_WRITE:
+            appendStringInfoString(&query,
+                                   "ntups_insert + ntups_update + ntups_delete");
+            break;
+        case SHARD_LOAD_READ:
+            appendStringInfoString(&query, "ntups_select");
+            break;
+    }
+    appendStringInfo(&query,
+                     " FROM pg_catalog.opentenbase_shard_statistic()"
+                     " WHERE group_name = %s",
+                     quote_literal_cstr(group_name));
+
+    plan = makeNode(RemoteQuery);
+    plan->combine_type = COMBINE_TYPE_NONE;
+    plan->exec_nodes = makeNode(ExecNodes);
+    plan->exec_type = EXEC_ON_DATANODES;
+    for (i = 0; i < ndns; i++)
+    {
+        char ntype = PGXC_NODE_DATANODE;
+        int  nodeid = PGXCNodeGetNodeId(dnoids[i], &ntype);
+
+        if (nodeid < 0)
+            ereport(ERROR,
+                    (errcode(ERRCODE_INTERNAL_ERROR),
+                     errmsg("Unknown node Oid: %u", dnoids[i])));
+        plan->exec_nodes->nodeList = lappend_int(plan->exec_nodes->nodeList,
+                                                 nodeid);
+    }
+    plan->sql_statement = query.data;
+    plan->force_autocommit = false;
+    plan->scan.plan.targetlist =
+        list_make2(makeTargetEntry((Expr *) makeVar(1, 1, INT4OID, -1, InvalidOid, 0),
+                                   1, NULL, false),
+                   makeTargetEntry((Expr *) makeVar(1, 2, INT8OID, -1, InvalidOid, 0),
+                                   2, NULL, false));
+
+    estate = CreateExecutorState();
+    oldcontext = MemoryContextSwitchTo(estate->es_query_cxt);
+    estate->es_snapshot = GetActiveSnapshot();
+    pstate = ExecInitRemoteQuery(plan, estate, 0);
+    MemoryContextSwitchTo(oldcontext);
+
+    result = ExecRemoteQuery((PlanState *) pstate);
+    while (result != NULL && !TupIsNull(result))
+    {
+        bool    isnull1;
+        bool    isnull2;
+        int32   sid;
+        int64   load;
+
+        sid = DatumGetInt32(slot_getattr(result, 1, &isnull1));
+        load = DatumGetInt64(slot_getattr(result, 2, &isnull2));
+
+        if (!isnull1 && !isnull2 && sid >= 0 && sid < MAX_SHARDS && load > 0)
+            shard_load[sid] += load;
+
+        result = ExecRemoteQuery((PlanState *) pstate);
+    }
+    ExecEndRemoteQuery(pstate);
+    FreeExecutorState(estate);
+
+    pfree(query.data);
+}
+
+/*
+ * Greedy planning, see the file header.
+ */
+static ShardMove *
+plan_shard_moves(Oid group, int ndns, Oid *dnoids, int64 *shard_load,
+                 double max_imbalance, int *nmoves)
+{
+    Relation     shardmapRel;
+    ScanKeyData  skey;
+    SysScanDesc  scan;
+    HeapTuple    tuple;
+    int32        nshards = 0;
+    int32       *shardgroups;
+    int         *owner;
+    int64       *node_load;
+    int64        total = 0;
+    ShardMove   *moves;
+    int          maxmoves;
+    int          i;
+
+    shardgroups = (int32 *) palloc(sizeof(int32) * MAX_SHARDS);
+    owner = (int *) palloc(sizeof(int) * MAX_SHARDS);
+    node_load = (int64 *) palloc0(sizeof(int64) * ndns);
+
+    shardmapRel = heap_open(PgxcShardMapRelationId, AccessShareLock);
+    ScanKeyInit(&skey,
+                Anum_pgxc_shard_map_nodegroup,
+                BTEqualStrategyNumber, F_OIDEQ,
+                ObjectIdGetDatum(group));
+    scan = systable_beginscan(shardmapRel,
+                              PgxcShardMapGroupIndexId, true,
+                              NULL, 1, &skey);
+    while (HeapTupleIsValid(tuple = systable_getnext(scan)))
+    {
+        Form_pgxc_shard_map pgxc_shard = (Form_pgxc_shard_map) GETSTRUCT(tuple);
+
+        if (nshards >= MAX_SHARDS ||
+            pgxc_shard->shardgroupid < 0 || pgxc_shard->shardgroupid >= MAX_SHARDS)
+            continue;
+
+        for (i = 0; i < ndns; i++)
+        {
+            if (dnoids[i] == pgxc_shard->primarycopy)
+                break;
+        }
+        if (i == ndns)
+            continue;
+
+        shardgroups[nshards] = pgxc_shard->shardgroupid;
+        owner[nshards] = i;
+        node_load[i] += shard_load[pgxc_shard->shardgroupid];
+        total += shard_load[pgxc_shard->shardgroupid];
+        nshards++;
+    }
+    systable_endscan(scan);
+    heap_close(shardmapRel, AccessShareLock);
+
+    maxmoves = Max(nshards, 1);
+    moves = (ShardMove *) palloc(sizeof(ShardMove) * maxmoves);
+    *nmoves = 0;
+
+    while (*nmoves < maxmoves && total > 0)
+    {
+        int     from = 0;
+        int     to = 0;
+        int64   gap;
+        int     best = -1;
+
+        for (i = 1; i < ndns; i++)
+        {
+            if (node_load[i] > node_load[from])
+                from = i;
+            if (node_load[i] < node_load[to])
+                to = i;
+        }
+
+        if ((double) node_load[from] <=
+            (double) total / ndns * (1.0 + max_imbalance))
+            break;
+
+        /*
+         * Moving a shardgroup of load l from 'from' to 'to' helps as long as
+         * 0 < l < gap; the closer l is to gap / 2, the better.
+         */
+        gap = node_load[from] - node_load[to];
+        for (i = 0; i < nshards; i++)
+        {
+            int64 l = shard_load[shardgroups[i]];
+
+            if (owner[i] != from || l <= 0 || l >= gap)
+                continue;
+            if (best < 0 ||
+                Abs(gap - 2 * l) < Abs(gap - 2 * shard_load[shardgroups[best]]))
+                best = i;
+        }
+        if (best < 0)
+            break;
+
+        moves[*nmoves].shardgroupid = shardgroups[best];
+        moves[*nmoves].from_node = dnoids[from];
+        moves[*nmoves].to_node = dnoids[to];
+        moves[*nmoves].load = shard_load[shardgroups[best]];
+        (*nmoves)++;
+
+        owner[best] = to;
+        node_load[from] -= shard_load[shardgroups[best]];
+        node_load[to] += shard_load[shardgroups[best]];
+    }
+
+    pfree(shardgroups);
+    pfree(owner);
+    pfree(node_load);
+
+    return moves;
+}
+
+/*
+ * opentenbase_shard_rebalance_plan(group_name, metric, max_imbalance)
+ *
+ * List the shardgroup moves which bring every datanode of the group within
+ * max_imbalance (a fraction, e.g. 0.1 for 10%) of the average load.  The
+ * metric is one of "size", "write" or "read".  Coordinator only.
+ */
+Datum
+opentenbase_shard_rebalance_plan(PG_FUNCTION_ARGS)
+{
+#define REBALANCE_PLAN_NCOLUMNS 4
+    FuncCallContext      *funcctx;
+    ShardRebalance_State *status;
+
+    if (SRF_IS_FIRSTCALL())
+    {
+        MemoryContext   oldcontext;
+        TupleDesc       tupdesc;
+        char           *group_name = text_to_cstring(PG_GETARG_TEXT_PP(0));
+        char           *metric_name = text_to_cstring(PG_GETARG_TEXT_PP(1));
+        double          max_imbalance = PG_GETARG_FLOAT8(2);
+        ShardLoadMetric metric;
+        Oid             group;
+        Oid            *dnoids = NULL;
+        int             ndns;
+        int64          *shard_load;
+
+        if (!IS_PGXC_COORDINATOR)
+            ereport(ERROR,
+                    (errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+                     errmsg("shard rebalance can only be planned on coordinator")));
+
+        if (max_imbalance < 0)
+            ereport(ERROR,
+                    (errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+                     errmsg("max_imbalance must not be negative")));
+
+        metric = get_shard_load_metric(metric_name);
+
+        group = get_pgxc_groupoid(group_name);
+        if (!OidIsValid(group))
+            elog(ERROR, "group with name:%s not found", group_name);
+
+        funcctx = SRF_FIRSTCALL_INIT();
+        oldcontext = MemoryContextSwitchTo(funcctx->multi_call_memory_ctx);
+
+        tupdesc = CreateTemplateTupleDesc(REBALANCE_PLAN_NCOLUMNS, false);
+        TupleDescInitEntry(tupdesc, (AttrNumber) 1, "shard_id",
+                           INT4OID, -1, 0);
+        TupleDescInitEntry(tupdesc, (AttrNumber) 2, "from_node",
+                           TEXTOID, -1, 0);
+        TupleDescInitEntry(tupdesc, (AttrNumber) 3, "to_node",
+                           TEXTOID, -1, 0);
+        TupleDescInitEntry(tupdesc, (AttrNumber) 4, "load",
+                           INT8OID, -1, 0);
+        funcctx->tuple_desc = BlessTupleDesc(tupdesc);
+
+        status = (ShardRebalance_State *) palloc0(sizeof(ShardRebalance_State));
+        funcctx->user_fctx = (void *) status;
+
+        ndns = get_pgxc_groupmembers(group, &dnoids);
+        if (ndns > 1)
+        {
+            shard_load = (int64 *) palloc0(sizeof(int64) * MAX_SHARDS);
+            fetch_shard_load(group_name, ndns, dnoids, metric, shard_load);
+            status->moves = plan_shard_moves(group, ndns, dnoids, shard_load,
+                                             max_imbalance, &status->nmoves);
+            pfree(shard_load);
+        }
+
+        MemoryContextSwitchTo(oldcontext);
+    }
+
+    funcctx = SRF_PERCALL_SETUP();
+    status = (ShardRebalance_State *) funcctx->user_fctx;
+
+    if (status->currIdx < status->nmoves)
+    {
+        ShardMove  *move = &status->moves[status->currIdx++];
+        Datum       values[REBALANCE_PLAN_NCOLUMNS];
+        bool        nulls[REBALANCE_PLAN_NCOLUMNS];
+        HeapTuple   tuple;
+
+        MemSet(nulls, 0, sizeof(nulls));
+        values[0] = Int32GetDatum(move->shardgroupid);
+        values[1] = CStringGetTextDatum(get_pgxc_nodename(move->from_node));
+        values[2] = CStringGetTextDatum(get_pgxc_nodename(move->to_node));
+        values[3] = Int64GetDatum(move->load);
+
+        tuple = heap_form_tuple(funcctx->tuple_desc, values, nulls);
+        SRF_RETURN_NEXT(funcctx, HeapTupleGetDatum(tuple));
+    }
+
+    SRF_RETURN_DONE(funcctx);
+}
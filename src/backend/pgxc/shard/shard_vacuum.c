@@ -31,6 +31,10 @@
 #include "access/genam.h"
 #include "catalog/indexing.h"
 #include "utils/fmgroids.h"
+#include "pgxc/shardmap.h"
+#include "storage/lmgr.h"
+#include "storage/proc.h"
+#include "storage/procarray.h"
 
 
 static void
@@ -38,6 +42,9 @@ split_shard_from_tablename(char *str, char **shards_str, char **tablename_str, i
 
 static char *trimwhitespace(char *str);
 
+static int64 purge_shard_extents(Oid reloid, Bitmapset *to_vacuum, int sleep_interval);
+static void wait_for_older_snapshots(Snapshot snapshot);
+
 
 
 Datum
@@ -58,6 +65,7 @@ vacuum_hidden_shards(PG_FUNCTION_ARGS)
     Snapshot    vacuum_snapshot = NULL;
     bool        need_new_snapshot = false;
     SnapshotSatisfiesFunc snapfunc_tmp = NULL;
+    bool        waited_snapshots = false;
 
     Oid            reloid;
 
@@ -111,12 +119,35 @@ vacuum_hidden_shards(PG_FUNCTION_ARGS)
     foreach(lc, table_oid_list)
     {
         Relation shardrel;
+        bool     has_extent;
+
         reloid = lfirst_oid(lc);
         shardrel = heap_open(reloid,RowExclusiveLock);
-        
-        vacuumed_rows += vacuum_shard_internal(shardrel, to_vacuum, vacuum_snapshot, sleep_interval, true);
+        has_extent = RelationHasExtent(shardrel);
+
+        /*
+         * Extent tables keep each shard in its own extents, so the hidden
+         * shards can be released extent by extent instead of deleting their
+         * tuples one at a time.
+         */
+        if (!has_extent)
+            vacuumed_rows += vacuum_shard_internal(shardrel, to_vacuum, vacuum_snapshot, sleep_interval, true);
         
         heap_close(shardrel,RowExclusiveLock);
+
+        if (has_extent)
+        {
+            /*
+             * Snapshots taken before the shards were hidden still see their
+             * rows, and the extents must not go away under them.
+             */
+            if (!waited_snapshots)
+            {
+                wait_for_older_snapshots(vacuum_snapshot);
+                waited_snapshots = true;
+            }
+            vacuumed_rows += purge_shard_extents(reloid, to_vacuum, sleep_interval);
+        }
     }
 
     bms_free(to_vacuum);
@@ -411,6 +442,94 @@ int64 vacuum_shard_internal(Relation rel, Bitmapset *to_vacuum, Snapshot vacuum_
 }
 
 
+/*
+ * Wait until no other transaction of this database runs with a snapshot
+ * older than ours, as CREATE INDEX CONCURRENTLY does.
+ *
+ * Local snapshots are ordered by their xmin. Backends serving distributed
+ * queries see data as of their global start timestamp instead, and their
+ * local xmin may well be newer than ours while their start timestamp is
+ * older, so they are waited for by timestamp. Distributed snapshots taken
+ * from now on carry the current shard map, which no longer has the hidden
+ * shards, so only the ones already running matter.
+ */
+static void
+wait_for_older_snapshots(Snapshot snapshot)
+{
+    VirtualTransactionId *old_snapshots;
+    int            n_old_snapshots;
+    int            i;
+
+    old_snapshots = GetCurrentVirtualXIDs(snapshot->xmin, true, false,
+                                          PROC_IS_AUTOVACUUM | PROC_IN_VACUUM,
+                                          &n_old_snapshots);
+
+    for (i = 0; i < n_old_snapshots; i++)
+    {
+        if (!VirtualTransactionIdIsValid(old_snapshots[i]))
+            continue;
+
+        CHECK_FOR_INTERRUPTS();
+        VirtualXactLock(old_snapshots[i], true);
+    }
+    pfree(old_snapshots);
+
+#ifdef __SUPPORT_DISTRIBUTED_TRANSACTION__
+    {
+        GlobalTimestamp limit_ts;
+
+        limit_ts = snapshot->local ? GetLatestCommitTS() : snapshot->start_ts;
+        old_snapshots = GetVirtualXIDsBeforeTs(limit_ts,
+                                               PROC_IS_AUTOVACUUM | PROC_IN_VACUUM,
+                                               &n_old_snapshots);
+
+        for (i = 0; i < n_old_snapshots; i++)
+        {
+            CHECK_FOR_INTERRUPTS();
+            VirtualXactLock(old_snapshots[i], true);
+        }
+        pfree(old_snapshots);
+    }
+#endif
+}
+
+/*
+ * Release the extents of the given hidden shards of a relation, including its
+ * interval partitions and toast table. Each leaf relation is purged on its
+ * own, so no lock is held on the parent while the children are processed.
+ */
+static int64
+purge_shard_extents(Oid reloid, Bitmapset *to_vacuum, int sleep_interval)
+{
+    Relation    rel;
+    Oid            toastoid;
+    List       *childs = NIL;
+    ListCell   *lc;
+    bool        purge_self;
+    int64        n = 0;
+
+    rel = heap_open(reloid, AccessShareLock);
+    toastoid = rel->rd_rel->reltoastrelid;
+    if(RELATION_IS_INTERVAL(rel))
+        childs = RelationGetAllPartitions(rel);
+    purge_self = (rel->rd_rel->relkind != RELKIND_PARTITIONED_TABLE &&
+                  RelationHasExtent(rel));
+    heap_close(rel, AccessShareLock);
+
+    foreach(lc, childs)
+    {
+        n += purge_shard_extents(lfirst_oid(lc), to_vacuum, sleep_interval);
+    }
+
+    if (purge_self)
+        n += PurgeShardExtents(reloid, to_vacuum, sleep_interval);
+
+    if (OidIsValid(toastoid))
+        (void) purge_shard_extents(toastoid, to_vacuum, sleep_interval);
+
+    return n;
+}
+
 char *trimwhitespace(char *str)
 {
   char *end;
@@ -11,6 +11,7 @@
 #include "storage/smgr.h"
 #include "storage/spin.h"
 #include "storage/lwlock.h"
+#include "storage/lmgr.h"
 #include "storage/lockdefs.h"
 #include "storage/proc.h"
 #include "utils/hsearch.h"
@@ -51,6 +52,9 @@
 #include "utils/builtins.h"
 #include "utils/regproc.h"
 #include "catalog/namespace.h"
+#include "portability/instr_time.h"
+#include "access/xlogutils.h"
+#include "storage/ipc.h"
 #include <sys/stat.h>
 #ifdef __COLD_HOT__
 #include "catalog/pgxc_key_values.h"
@@ -97,6 +101,7 @@ typedef struct
     bool           needLock;                      /* whether we need lock */
     slock_t           lock[MAX_SHARDING_NODE_GROUP]; /* locks to protect used fields */
     bool            used[MAX_SHARDING_NODE_GROUP];
+    pg_atomic_uint64 version;                    /* bumped when any shard map changes */
 
     GroupShardInfo *members[MAX_SHARDING_NODE_GROUP];
 }ShardNodeGroupInfo;
@@ -108,10 +113,43 @@ typedef struct
     bool           needLock;                      /* whether we need lock */
     slock_t           lock; /* locks to protect used fields */
     bool            used;
+    pg_atomic_uint64 version;                    /* bumped when the shard map changes */
 
     GroupShardInfo *members;
 }ShardNodeGroupInfo_DN;
 
+/*
+ * Backend-local snapshot of the shard map of one group.
+ *
+ * Routing reads the snapshot without any lock.  Writers rebuild the shared
+ * map under ShardMapLock as before and publish the change by bumping the
+ * shared version just before releasing the lock; a backend notices the new
+ * version on its next lookup and copies the map once under a shared lock.
+ * Until then it keeps routing with the map it has, so a rebuild never stalls
+ * running DML.
+ */
+typedef struct
+{
+    Oid     group;
+    uint64  version;                /* shared version this copy was taken at */
+    bool    used;                   /* DN only: shard map is set up */
+    int32   numShards;
+    int32   numShardNodes;
+    int32   maxGlblNdIdx;
+    int32   shardnodes[MAX_GROUP_NODE_NUMBER];
+    int32   nodeMap[OPENTENBASE_MAX_DATANODE_NUMBER];
+    int32   nodeindex[SHARD_MAP_GROUP_NUM];
+}ShardMapSnapshot;
+
+typedef struct
+{
+    Oid               group;
+    ShardMapSnapshot *snap;
+}ShardMapSnapshotEnt;
+
+static HTAB             *g_ShardMapSnapshots_CN = NULL;
+static ShardMapSnapshot *g_ShardMapSnapshot_DN = NULL;
+
 /*For CN*/
 static ShardNodeGroupInfo *g_GroupShardingMgr = NULL;
 static HTAB               *g_GroupHashTab     = NULL;
@@ -172,12 +210,40 @@ typedef struct
 
 ShardStatistic *shardStatInfo = NULL;
 
+/*
+ * Backend-local shard statistic delta.
+ *
+ * Writers accumulate their counts here and merge them into the shared pool
+ * at transaction end, or once SHARD_STAT_LOCAL_FLUSH_THRESHOLD updates are
+ * pending, so the shared cache lines are touched once per shard and flush
+ * instead of once per tuple.  ntuples and size may go negative.
+ */
+typedef struct
+{
+    int64 ntuples_select;
+    int64 ntuples_insert;
+    int64 ntuples_update;
+    int64 ntuples_delete;
+    int64 ntuples;
+    int64 size;
+} LocalShardStatistic;
+
+#define SHARD_STAT_LOCAL_FLUSH_THRESHOLD 10000
+
+static LocalShardStatistic *localShardStat = NULL;
+static ShardID *localShardStatDirty = NULL;
+static bool    *localShardStatIsDirty = NULL;    /* sid in the list above? */
+static int      nLocalShardStatDirty = 0;
+static int      nLocalShardStatPending = 0;
+static int      nLocalShardStatSelectSkipped = 0;
+
 #define SHARD_STATISTIC_FILE_PATH "pg_stat/shard.stat"
 
 /* GUC used for shard statistic */
 bool   g_StatShardInfo = true;
 int    g_MaxSessionsPerPool = 250;
 int    g_ShardInfoFlushInterval = 60;
+int    g_ShardInfoSelectSample = 1;
 
 typedef struct
 {
@@ -243,6 +309,51 @@ typedef struct
     Oid      coldGroup;
 }KeyValuePair;
 
+/*
+ * g_TempKeyValueList compiled into a hash table keyed by (table, value),
+ * so routing a row does not walk the list.
+ */
+typedef struct
+{
+    Oid      table;
+    NameData value;
+}TempKeyValueKey;
+
+typedef struct
+{
+    TempKeyValueKey key;
+    Oid      hotGroup;
+    Oid      coldGroup;
+}TempKeyValueEnt;
+
+static HTAB *g_TempKeyValueHash = NULL;
+
+/*
+ * Routing information of the last cold-hot relation routed by this backend.
+ * Rows of one statement are routed against the same relation, so a single
+ * entry avoids opening the relation (and its parent) for every row.  It is
+ * reset by relcache invalidation.
+ */
+typedef struct
+{
+    Oid         relation;               /* relation passed to the router */
+    AttrNumber  secAttr;
+    Oid         routeRelation;          /* parent of an interval child */
+    bool        isInterval;             /* interval relation or child */
+    bool        hasRouterInfo;
+    int32       partitionStrategy;
+    int32       interval_step;
+    TimestampTz start_timestamp;
+}ColdHotRouterInfo;
+
+static ColdHotRouterInfo g_ColdHotRouterInfo = {InvalidOid};
+static bool g_ColdHotRouterCallbackRegistered = false;
+
+/* g_ManualHotDataTime converted to a timestamp, and the value it came from */
+static struct pg_tm g_HotDataTimeKey;
+static Timestamp    g_HotDataTime = 0;
+static bool         g_HotDataTimeValid = false;
+
 /* 2000-01-01 00:00:00 */
 static struct pg_tm g_keyvalue_base_time = { 0,
                                              0,
@@ -280,17 +391,26 @@ static void   FreshGroupShardMap(Oid group);
 static void   BuildDatanodeVisibilityMap(Form_pgxc_shard_map tuple, Oid self_oid);
 static void GetShardNodes_CN(Oid group, int32 ** nodes, int32 *num_nodes, bool *isextension);
 static void GetShardNodes_DN(Oid group, int32 ** nodes, int32 *num_nodes, bool *isextension);
+static void PublishShardMap(void);
+static void CopyShardMapSnapshot(ShardMapSnapshot *snap, GroupShardInfo *info);
+static ShardMapSnapshot *GetShardMapSnapshot_CN(Oid group);
+static ShardMapSnapshot *GetShardMapSnapshot_DN(void);
 
 extern Datum  pg_stat_table_shard(PG_FUNCTION_ARGS);
 extern Datum  pg_stat_all_shard(PG_FUNCTION_ARGS);
 
 static void RefreshShardStatistic(ShardStat *shardstat);
+static void ApplyShardStatistic(int index, LocalShardStatistic *delta);
+static void ShardStatisticShmemExit(int code, Datum arg);
 
 #ifdef __COLD_HOT__
 static Datum pg_set_cold_access(void);
 static Datum pg_clear_cold_access(void);
 static bool AddDualWriteInfo(Oid relation, AttrNumber attr, int32 gap, char *table, char *column, char *value);
 static long compute_keyvalue_hash(Oid type, Datum value);
+static bool NeedDualWriteWithStrategy(Oid relation, AttrNumber attr, Datum value,
+                                      int32 partitionStrategy);
+static void BuildTempKeyValueHash(void);
 
 #endif
 
@@ -326,6 +446,7 @@ void InvalidateShmemShardMap(bool iscommit)
                         RemoveShardMapEntry(g_UpdateShardingGroupInfo.group[i]);
                     }                    
                 }
+                PublishShardMap();
                 LWLockRelease(ShardMapLock);
                 /* reset flag */
                 g_GroupShardingMgr->needLock = false;
@@ -345,6 +466,7 @@ void InvalidateShmemShardMap(bool iscommit)
                     {
                         LWLockAcquire(ShardMapLock, LW_EXCLUSIVE);
                         RemoveShardMapEntry(g_UpdateShardingGroupInfo.group[i]);
+                        PublishShardMap();
                         LWLockRelease(ShardMapLock);
                     }
                 }                
@@ -415,6 +537,7 @@ void ShardMapShmemInit_CN(void)
     }
     g_GroupShardingMgr->inited   = false;
     g_GroupShardingMgr->needLock = false;
+    pg_atomic_init_u64(&g_GroupShardingMgr->version, 1);
     
     groupshard = (GroupShardInfo *)ShmemInitStruct("Group shard major",
                                                         MAXALIGN64(sizeof(GroupShardInfo)) + MAXALIGN64(sizeof(ShardMapItemDef)) * (SHARD_MAP_GROUP_NUM - 1),
@@ -481,6 +604,7 @@ void ShardMapShmemInit_DN(void)
     }
     g_GroupShardingMgr_DN->inited   = false;
     g_GroupShardingMgr_DN->needLock = false;
+    pg_atomic_init_u64(&g_GroupShardingMgr_DN->version, 1);
     
     groupshard = (GroupShardInfo *)ShmemInitStruct("Group shard major",
                                                         MAXALIGN64(sizeof(GroupShardInfo)) + MAXALIGN64(sizeof(ShardMapItemDef)) * (SHARD_MAP_GROUP_NUM - 1),
@@ -578,7 +702,8 @@ static void SyncShardMapList_CN(bool force)
 	g_GroupShardingMgr->inited = false;
     SyncShardMapList_Node_CN();
     g_GroupShardingMgr->inited = true;
-        
+
+    PublishShardMap();
     LWLockRelease(ShardMapLock);
     
     /*reset flag*/
@@ -620,7 +745,8 @@ static void SyncShardMapList_DN(bool force)
 	g_GroupShardingMgr_DN->inited = false;
     
     g_GroupShardingMgr_DN->inited = SyncShardMapList_Node_DN();
-        
+
+    PublishShardMap();
     LWLockRelease(ShardMapLock);
     
     /*reset flag*/
@@ -942,6 +1068,7 @@ static void ShardMapInitDone_CN(int32 map, Oid group, bool need_lock)
 
         if (need_lock)
         {
+            PublishShardMap();
             LWLockRelease(ShardMapLock);
         }
         elog(ERROR, "ShardMapInitDone_CN corrupted shared hash table");
@@ -998,6 +1125,7 @@ static void ShardMapInitDone_CN(int32 map, Oid group, bool need_lock)
     
     if (need_lock)
     {
+        PublishShardMap();
         LWLockRelease(ShardMapLock);
     }
 }
@@ -1077,6 +1205,7 @@ static void ShardMapInitDone_DN(Oid group, bool need_lock)
     
     if (need_lock)
     {
+        PublishShardMap();
         LWLockRelease(ShardMapLock);
     }
 }
@@ -1219,74 +1348,184 @@ List* ShardMapRouter(Oid group, Oid relation, Oid type, Datum dvalue, RelationAc
     return list_make1_int(GetNodeIndexByHashValue(group, hashvalue));
 }
 #endif
-int32  GetNodeIndexByHashValue(Oid group, long hashvalue)
-{// #lizard forgives    
-    int            shardIdx;
-    int            nodeIdx = 0;
-    bool           needLock = false;
-    bool           found;
-    GroupLookupTag tag;
-    GroupLookupEnt *ent;
-    ShardMapItemDef *shardgroup;
-    int slot = 0;
-    
-    if(IS_PGXC_COORDINATOR && !OidIsValid(group))
+/*
+ * Publish a change of the shared shard map to the backend-local snapshots.
+ * Call with ShardMapLock held exclusively, after the change is complete.
+ */
+static void
+PublishShardMap(void)
+{
+    if (IS_PGXC_COORDINATOR)
     {
-        elog(PANIC, "[GetNodeIndexByHashValue]group oid can not be invalid.");
+        pg_atomic_fetch_add_u64(&g_GroupShardingMgr->version, 1);
+    }
+    else if (IS_PGXC_DATANODE)
+    {
+        pg_atomic_fetch_add_u64(&g_GroupShardingMgr_DN->version, 1);
     }
+}
 
-    if (IS_PGXC_COORDINATOR)
+static void
+CopyShardMapSnapshot(ShardMapSnapshot *snap, GroupShardInfo *info)
+{
+    int32 i;
+    int32 nshards = Min(info->shmemNumShardGroups, SHARD_MAP_GROUP_NUM);
+
+    snap->group         = info->group;
+    snap->numShards     = info->shmemNumShards;
+    snap->numShardNodes = Min(info->shmemNumShardNodes, MAX_GROUP_NODE_NUMBER);
+    snap->maxGlblNdIdx  = Min(info->shardMaxGlblNdIdx, OPENTENBASE_MAX_DATANODE_NUMBER);
+
+    memcpy(snap->shardnodes, info->shmemshardnodes, sizeof(int32) * snap->numShardNodes);
+    memcpy(snap->nodeMap, info->shmemNodeMap, sizeof(int32) * snap->maxGlblNdIdx);
+    for (i = 0; i < nshards; i++)
     {
-        needLock  = g_GroupShardingMgr->needLock;
-        if (needLock)
-        {
-            LWLockAcquire(ShardMapLock, LW_SHARED);
-        }
+        snap->nodeindex[i] = info->shmemshardmap[i].nodeindex;
+    }
+}
 
-        tag.group =  group;
-        ent = (GroupLookupEnt*)hash_search(g_GroupHashTab, (void *) &tag, HASH_FIND, &found);            
-        if (!found)
-        {
-            elog(ERROR , "no shard group of %u found", group);
-        }
+/*
+ * Get the snapshot of the shard map of a group, copying the shared map if it
+ * changed since the last call.
+ */
+static ShardMapSnapshot *
+GetShardMapSnapshot_CN(Oid group)
+{
+    ShardMapSnapshotEnt *snapent;
+    GroupLookupTag       tag;
+    GroupLookupEnt      *ent;
+    bool                 found;
+    bool                 needLock;
+    uint64               version;
 
-        slot = ent->shardIndex;
+    if (g_ShardMapSnapshots_CN == NULL)
+    {
+        HASHCTL ctl;
 
-        shardIdx     = abs(hashvalue) % (g_GroupShardingMgr->members[slot]->shmemNumShards);
-        shardgroup   = &g_GroupShardingMgr->members[slot]->shmemshardmap[shardIdx];
-        nodeIdx      = shardgroup->nodeindex;
+        MemSet(&ctl, 0, sizeof(ctl));
+        ctl.keysize   = sizeof(Oid);
+        ctl.entrysize = sizeof(ShardMapSnapshotEnt);
+        ctl.hcxt      = TopMemoryContext;
+        g_ShardMapSnapshots_CN = hash_create("Shard map snapshots", 16, &ctl,
+                                             HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
     }
-    else if (IS_PGXC_DATANODE)
+
+    snapent = (ShardMapSnapshotEnt *) hash_search(g_ShardMapSnapshots_CN, &group, HASH_ENTER, &found);
+    if (!found)
+    {
+        snapent->snap = NULL;
+    }
+
+    if (snapent->snap &&
+        snapent->snap->version == pg_atomic_read_u64(&g_GroupShardingMgr->version))
+    {
+        return snapent->snap;
+    }
+
+    if (snapent->snap == NULL)
+    {
+        snapent->snap = (ShardMapSnapshot *) MemoryContextAllocZero(TopMemoryContext,
+                                                                    sizeof(ShardMapSnapshot));
+    }
+
+    needLock = g_GroupShardingMgr->needLock;
+    if (needLock)
+    {
+        LWLockAcquire(ShardMapLock, LW_SHARED);
+    }
+    version = pg_atomic_read_u64(&g_GroupShardingMgr->version);
+
+    tag.group =  group;
+    ent = (GroupLookupEnt*)hash_search(g_GroupHashTab, (void *) &tag, HASH_FIND, &found);            
+    if (!found)
     {
-        needLock  = g_GroupShardingMgr_DN->needLock;
         if (needLock)
         {
-            LWLockAcquire(ShardMapLock, LW_SHARED);
+            LWLockRelease(ShardMapLock);
         }
+        /* don't leave a stale copy which would look current */
+        snapent->snap->version = 0;
+        elog(ERROR , "no shard group of %u found", group);
+    }
 
-        shardIdx     = abs(hashvalue) % (g_GroupShardingMgr_DN->members->shmemNumShards);
-		if (g_ShardMapValid)
-			shardgroup = &g_ShardMap[shardIdx];
-		else
-        shardgroup   = &g_GroupShardingMgr_DN->members->shmemshardmap[shardIdx];
-        nodeIdx      = shardgroup->nodeindex;
+    CopyShardMapSnapshot(snapent->snap, g_GroupShardingMgr->members[ent->shardIndex]);
+    snapent->snap->version = version;
+    if (needLock)
+    {
+        LWLockRelease(ShardMapLock);
     }
 
+    return snapent->snap;
+}
+
+static ShardMapSnapshot *
+GetShardMapSnapshot_DN(void)
+{
+    ShardMapSnapshot *snap = g_ShardMapSnapshot_DN;
+    bool              needLock;
+
+    if (snap && snap->version == pg_atomic_read_u64(&g_GroupShardingMgr_DN->version))
+    {
+        return snap;
+    }
+
+    if (snap == NULL)
+    {
+        snap = (ShardMapSnapshot *) MemoryContextAllocZero(TopMemoryContext,
+                                                           sizeof(ShardMapSnapshot));
+        g_ShardMapSnapshot_DN = snap;
+    }
+
+    needLock = g_GroupShardingMgr_DN->needLock;
+    if (needLock)
+    {
+        LWLockAcquire(ShardMapLock, LW_SHARED);
+    }
+    snap->version = pg_atomic_read_u64(&g_GroupShardingMgr_DN->version);
+    snap->used = g_GroupShardingMgr_DN->used;
+    CopyShardMapSnapshot(snap, g_GroupShardingMgr_DN->members);
     if (needLock)
     {
         LWLockRelease(ShardMapLock);
     }
+
+    return snap;
+}
+
+int32  GetNodeIndexByHashValue(Oid group, long hashvalue)
+{
+    int            shardIdx;
+    int            nodeIdx = 0;
+    ShardMapSnapshot *snap;
+    
+    if(IS_PGXC_COORDINATOR && !OidIsValid(group))
+    {
+        elog(PANIC, "[GetNodeIndexByHashValue]group oid can not be invalid.");
+    }
+
+    if (IS_PGXC_COORDINATOR)
+    {
+        snap     = GetShardMapSnapshot_CN(group);
+        shardIdx = abs(hashvalue) % (snap->numShards);
+        nodeIdx  = snap->nodeindex[shardIdx];
+    }
+    else if (IS_PGXC_DATANODE)
+    {
+        snap     = GetShardMapSnapshot_DN();
+        shardIdx = abs(hashvalue) % (snap->numShards);
+		if (g_ShardMapValid)
+			nodeIdx = g_ShardMap[shardIdx].nodeindex;
+		else
+			nodeIdx = snap->nodeindex[shardIdx];
+    }
+
     return nodeIdx;
 }
 
 /* Get node index map of group. */
 void  GetGroupNodeIndexMap(Oid group, int32 *map)
-{// #lizard forgives
-    bool           needLock = false;
-    bool           found;
-    GroupLookupTag tag;
-    GroupLookupEnt *ent;
-    int slot = 0;
+{
+    ShardMapSnapshot *snap;
     
     if(!OidIsValid(group))
     {
@@ -1295,40 +1534,17 @@ void  GetGroupNodeIndexMap(Oid group, int32 *map)
 
     if (IS_PGXC_COORDINATOR)
     {
-        needLock  = g_GroupShardingMgr->needLock;
-        if (needLock)
-        {
-            LWLockAcquire(ShardMapLock, LW_SHARED);
-        }
-
-        tag.group =  group;
-        ent = (GroupLookupEnt*)hash_search(g_GroupHashTab, (void *) &tag, HASH_FIND, &found);            
-        if (!found)
-        {
-            elog(ERROR , "no shard group of %u found", group);
-        }
-
-        slot = ent->shardIndex;
-        memcpy(map, g_GroupShardingMgr->members[slot]->shmemNodeMap, sizeof(int32) * g_GroupShardingMgr->members[slot]->shardMaxGlblNdIdx);
+        snap = GetShardMapSnapshot_CN(group);
+        memcpy(map, snap->nodeMap, sizeof(int32) * snap->maxGlblNdIdx);
     }
     else if (IS_PGXC_DATANODE)
     {
-        if (group != g_GroupShardingMgr_DN->members->group)
+        snap = GetShardMapSnapshot_DN();
+        if (group != snap->group)
         {
-            elog(ERROR, "GetGroupNodeIndexMap group oid:%u is not the stored group:%u.", group, g_GroupShardingMgr_DN->members->group);    
+            elog(ERROR, "GetGroupNodeIndexMap group oid:%u is not the stored group:%u.", group, snap->group);    
         }
-        
-        needLock  = g_GroupShardingMgr_DN->needLock;
-        if (needLock)
-        {
-            LWLockAcquire(ShardMapLock, LW_SHARED);
-        }
-        memcpy(map, g_GroupShardingMgr_DN->members->shmemNodeMap, sizeof(int32) * g_GroupShardingMgr_DN->members->shardMaxGlblNdIdx);
-    }
-
-    if (needLock)
-    {
-        LWLockRelease(ShardMapLock);
+        memcpy(map, snap->nodeMap, sizeof(int32) * snap->maxGlblNdIdx);
     }
 }
 
@@ -1349,13 +1565,8 @@ void GetShardNodes(Oid group, int32 ** nodes, int32 *num_nodes, bool *isextensio
 
 
 static void GetShardNodes_CN(Oid group, int32 ** nodes, int32 *num_nodes, bool *isextension)
-{// #lizard forgives
-    bool           found;
-    bool           needLock;
-    int             nNodes = 0;
-    GroupLookupTag tag;
-    GroupLookupEnt *ent;
-    tag.group =  group;        
+{
+    ShardMapSnapshot *snap;
 
     if (!IS_PGXC_COORDINATOR)
     {
@@ -1365,49 +1576,31 @@ static void GetShardNodes_CN(Oid group, int32 ** nodes, int32 *num_nodes, bool *
 
     SyncShardMapList(false);
 
-    needLock  = g_GroupShardingMgr->needLock;
-    if (needLock)
-    {
-        LWLockAcquire(ShardMapLock, LW_SHARED);
-    }
-    
-    ent = (GroupLookupEnt*)hash_search(g_GroupHashTab, (void *) &tag, HASH_FIND, &found);            
-    if (!found)
-    {
-        elog(ERROR , "corrupted catalog, no shard group of %u found", group);
-    }
-
-    nNodes = g_GroupShardingMgr->members[ent->shardIndex]->shmemNumShardNodes;
+    snap = GetShardMapSnapshot_CN(group);
     
     if(num_nodes)
-        *num_nodes = nNodes;    
+        *num_nodes = snap->numShardNodes;    
     
     if(nodes)
     {
-        *nodes = (int32 *)palloc0((nNodes) * sizeof(int32));
-        memcpy((char*)*nodes, (char*)&(g_GroupShardingMgr->members[ent->shardIndex]->shmemshardnodes), (nNodes) * sizeof(int32));
+        *nodes = (int32 *)palloc0((snap->numShardNodes) * sizeof(int32));
+        memcpy((char*)*nodes, (char*)snap->shardnodes, (snap->numShardNodes) * sizeof(int32));
     }
     
     if(isextension)
     {
-        if (g_GroupShardingMgr->members[ent->shardIndex]->shmemNumShards == SHARD_MAP_SHARD_NUM)
+        if (snap->numShards == SHARD_MAP_SHARD_NUM)
             *isextension = false;
-        else if(g_GroupShardingMgr->members[ent->shardIndex]->shmemNumShards == EXTENSION_SHARD_MAP_SHARD_NUM)
+        else if(snap->numShards == EXTENSION_SHARD_MAP_SHARD_NUM)
             *isextension= true;
         else
-            elog(ERROR, "shards(%d) of group is invalid ", g_GroupShardingMgr->members[ent->shardIndex]->shmemNumShards);
-    }
-    
-    if (needLock)
-    {
-        LWLockRelease(ShardMapLock);
+            elog(ERROR, "shards(%d) of group is invalid ", snap->numShards);
     }
 }
 
 static void GetShardNodes_DN(Oid group, int32 ** nodes, int32 *num_nodes, bool *isextension)
-{// #lizard forgives
-    bool           needLock;
-    int             nNodes = 0;    
+{
+    ShardMapSnapshot *snap;
 
 
     if (!IS_PGXC_DATANODE)
@@ -1418,41 +1611,30 @@ static void GetShardNodes_DN(Oid group, int32 ** nodes, int32 *num_nodes, bool *
 
     SyncShardMapList(false);
 
-    needLock  = g_GroupShardingMgr_DN->needLock;
-    if (needLock)
-    {
-        LWLockAcquire(ShardMapLock, LW_SHARED);
-    }
+    snap = GetShardMapSnapshot_DN();
 
-    if (!g_GroupShardingMgr_DN->used || g_GroupShardingMgr_DN->members->group != group)
+    if (!snap->used || snap->group != group)
     {
         elog(ERROR , "[GetShardNodes_DN]corrupted catalog, no shard group of %u found", group);
     }
     
-    nNodes = g_GroupShardingMgr_DN->members->shmemNumShardNodes;
-    
     if(num_nodes)
-        *num_nodes = nNodes;    
+        *num_nodes = snap->numShardNodes;    
     
     if(nodes)
     {
-        *nodes = (int32 *)palloc0((nNodes) * sizeof(int32));
-        memcpy((char*)*nodes, (char*)&(g_GroupShardingMgr_DN->members->shmemshardnodes), (nNodes) * sizeof(int32));
+        *nodes = (int32 *)palloc0((snap->numShardNodes) * sizeof(int32));
+        memcpy((char*)*nodes, (char*)snap->shardnodes, (snap->numShardNodes) * sizeof(int32));
     }
     
     if(isextension)
     {
-        if (g_GroupShardingMgr_DN->members->shmemNumShards == SHARD_MAP_SHARD_NUM)
+        if (snap->numShards == SHARD_MAP_SHARD_NUM)
             *isextension = false;
-        else if(g_GroupShardingMgr_DN->members->shmemNumShards == EXTENSION_SHARD_MAP_SHARD_NUM)
+        else if(snap->numShards == EXTENSION_SHARD_MAP_SHARD_NUM)
             *isextension= true;
         else
-            elog(ERROR, "shards(%d) of group is invalid ", g_GroupShardingMgr_DN->members->shmemNumShards);
-    }
-    
-    if (needLock)
-    {
-        LWLockRelease(ShardMapLock);
+            elog(ERROR, "shards(%d) of group is invalid ", snap->numShards);
     }
 }
 
@@ -1900,6 +2082,7 @@ void ForceRefreshShardMap(Oid groupoid)
             g_GroupShardingMgr_DN->inited = SyncShardMapList_Node_DN();
         }
     }
+    PublishShardMap();
     LWLockRelease(ShardMapLock);
 	
         /*
@@ -2176,6 +2359,25 @@ TruncateShard(Oid reloid, ShardID sid, int pausetime)
     int    tuples = 0;
     Relation rel = NULL;
     Oid        toastoid = InvalidOid;
+#ifndef DISABLE_FALLOCATE
+    /*
+     * The extent list lives across the transactions below, so it goes into
+     * a child of the caller's context rather than a transaction context.
+     * Committing leaves us in TopMemoryContext, so remember the caller's
+     * context for the toast recursion too.
+     */
+    MemoryContext caller_cxt = CurrentMemoryContext;
+    MemoryContext truncate_cxt;
+    ExtentID   *freed_eids = NULL;
+    int            nfreed = 0;
+    int            maxfreed = 0;
+    instr_time    start_time;
+    instr_time    duration;
+
+    truncate_cxt = AllocSetContextCreate(caller_cxt,
+                                         "TruncateShard",
+                                         ALLOCSET_SMALL_SIZES);
+#endif
 
     StartTransactionCommand();
     rel = heap_open(reloid, AccessShareLock);
@@ -2263,6 +2465,20 @@ TruncateShard(Oid reloid, ShardID sid, int pausetime)
          */
         FreeExtent(rel, eid);
         heap_close(rel, AccessExclusiveLock);
+#ifndef DISABLE_FALLOCATE
+        /* remember the extent, its buffers are dropped in step 4 */
+        if (nfreed >= maxfreed)
+        {
+            maxfreed = maxfreed ? maxfreed * 2 : 64;
+            if (freed_eids)
+                freed_eids = (ExtentID *) repalloc(freed_eids,
+                                                   sizeof(ExtentID) * maxfreed);
+            else
+                freed_eids = (ExtentID *) MemoryContextAlloc(truncate_cxt,
+                                                   sizeof(ExtentID) * maxfreed);
+        }
+        freed_eids[nfreed++] = eid;
+#endif
         rel = NULL;
         
         eid = RelOidGetShardScanHead(reloid, sid);
@@ -2278,9 +2494,16 @@ TruncateShard(Oid reloid, ShardID sid, int pausetime)
      * step 4: invalidate buf page.
      */
 #ifndef DISABLE_FALLOCATE
+    INSTR_TIME_SET_CURRENT(start_time);
     rel = heap_open(reloid, AccessShareLock);    
-    DropRelfileNodeShardBuffers(rel->rd_node, sid);
+    DropRelfileNodeShardExtentBuffers(rel->rd_node, sid, freed_eids, nfreed);
     heap_close(rel, AccessShareLock);
+    INSTR_TIME_SET_CURRENT(duration);
+    INSTR_TIME_SUBTRACT(duration, start_time);
+
+    elog(LOG, "truncate shard %d of relation %u: invalidated buffers of %d "
+              "extents in %.3f ms", sid, reloid, nfreed,
+              INSTR_TIME_GET_MILLISEC(duration));
 #endif
 
     /*
@@ -2288,7 +2511,12 @@ TruncateShard(Oid reloid, ShardID sid, int pausetime)
      */
     RemoveShardBarrier();
     CommitTransactionCommand();
-    
+
+#ifndef DISABLE_FALLOCATE
+    MemoryContextSwitchTo(caller_cxt);
+    MemoryContextDelete(truncate_cxt);
+#endif
+
     if(OidIsValid(toastoid))
     {
         TruncateShard(toastoid, sid, pausetime);
@@ -2296,6 +2524,111 @@ TruncateShard(Oid reloid, ShardID sid, int pausetime)
     
     return tuples;
 }
+
+/*
+ * Purge every extent of the given shards of a relation within the current
+ * transaction.
+ *
+ * Unlike TruncateShard this neither commits nor takes a shard barrier, so it
+ * is only meant for shards nobody can see or write any more, i.e. hidden
+ * shards left behind after they moved to another node, and only once the
+ * snapshots that could still see them are gone.
+ *
+ * The index entries of all extents are removed first, with one bulk delete
+ * per index. The relation is then locked exclusively for one extent at a
+ * time only, while its buffers are dropped, its storage is released with a
+ * single dealloc WAL record and it is returned to the free extent bitmap.
+ * We sleep sleep_interval milliseconds between extents. Returns the number
+ * of tuples purged.
+ */
+int64
+PurgeShardExtents(Oid reloid, Bitmapset *sids, int sleep_interval)
+{
+    Relation    rel;
+    ExtentID   *eids;
+    int            neids = 0;
+    int            maxeids = 64;
+    int64        tuples;
+    int            sid;
+    int            i;
+
+    /* keep out VACUUM and DDL, but not readers and writers of other shards */
+    rel = heap_open(reloid, ShareUpdateExclusiveLock);
+
+    if (!RelationHasExtent(rel))
+        elog(ERROR, "only sharded table can be purged by extent.");
+
+    eids = (ExtentID *) palloc(sizeof(ExtentID) * maxeids);
+    sid = -1;
+    while ((sid = bms_next_member(sids, sid)) >= 0)
+    {
+        ExtentID    eid = GetShardScanHead(rel, sid);
+
+        while (ExtentIdIsValid(eid))
+        {
+            if (neids >= maxeids)
+            {
+                maxeids *= 2;
+                eids = (ExtentID *) repalloc(eids, sizeof(ExtentID) * maxeids);
+            }
+            eids[neids++] = eid;
+            eid = ema_next_scan(rel, eid, true, NULL, NULL, NULL, NULL);
+        }
+    }
+
+    if (neids == 0)
+    {
+        pfree(eids);
+        heap_close(rel, ShareUpdateExclusiveLock);
+        return 0;
+    }
+
+    qsort(eids, neids, sizeof(ExtentID), cmp_int32);
+    tuples = truncate_extents_index_tuples(rel, eids, neids);
+
+    for (i = 0; i < neids; i++)
+    {
+        ExtentID    eid = eids[i];
+
+        LockRelationOid(reloid, AccessExclusiveLock);
+
+        RelationOpenSmgr(rel);
+#ifndef DISABLE_FALLOCATE
+        /*
+         * Nobody else can load these pages while we hold the relation lock,
+         * so drop the buffers before punching the hole to keep a checkpoint
+         * from writing stale pages back into it.
+         */
+        DropRelfileNodeExtentBuffers(rel->rd_node, eid);
+        log_smgrdealloc(&rel->rd_node, eid, SMGR_DEALLOC_FREESTORAGE);
+        smgrdealloc(rel->rd_smgr, MAIN_FORKNUM, eid * PAGES_PER_EXTENTS);
+#else
+        log_smgrdealloc(&rel->rd_node, eid, SMGR_DEALLOC_REINIT);
+        reinit_extent_pages(rel, eid);
+#endif
+        if(trace_extent)
+        {
+            ereport(LOG,
+                (errmsg("[trace extent]Purge:[rel:%d/%d/%d][eid:%d]",
+                        rel->rd_node.dbNode, rel->rd_node.spcNode, rel->rd_node.relNode,
+                        eid)));
+        }
+
+        FreeExtent(rel, eid);
+
+        UnlockRelationOid(reloid, AccessExclusiveLock);
+
+        CHECK_FOR_INTERRUPTS();
+        if (sleep_interval > 0 && i < neids - 1)
+            pg_usleep(sleep_interval * 1000L);
+    }
+
+    pfree(eids);
+    heap_close(rel, ShareUpdateExclusiveLock);
+
+    return tuples;
+}
+
 void StatShardRelation(Oid relid, ShardStat *shardstat, int32 shardnumber)
 {
     int32        shardid;
@@ -3410,68 +3743,163 @@ ShardStatisticShmemInit(void)
 }
 
 
+/*
+ * add a shard statistic delta to one entry of the shared pools.
+ */
+static void
+ApplyShardStatistic(int index, LocalShardStatistic *delta)
+{
+    ShardStatistic *stat = &shardStatInfo[index];
+
+    if (delta->ntuples_select)
+        pg_atomic_fetch_add_u64(&stat->ntuples_select, delta->ntuples_select);
+    if (delta->ntuples_insert)
+        pg_atomic_fetch_add_u64(&stat->ntuples_insert, delta->ntuples_insert);
+    if (delta->ntuples_update)
+        pg_atomic_fetch_add_u64(&stat->ntuples_update, delta->ntuples_update);
+    if (delta->ntuples_delete)
+        pg_atomic_fetch_add_u64(&stat->ntuples_delete, delta->ntuples_delete);
+    /* negative deltas wrap around, which is what the shared counters expect */
+    if (delta->ntuples)
+        pg_atomic_fetch_add_u64(&stat->ntuples, (uint64) delta->ntuples);
+    if (delta->size)
+        pg_atomic_fetch_add_u64(&stat->size, (uint64) delta->size);
+}
+
 /*
  * update shard statistic info by each backend which do select/insert/update/delete.
+ *
+ * Normal backends only touch their local delta, see FlushLocalShardStatistic.
+ * The startup process replays without transaction boundaries, so it applies
+ * its counts to shared memory directly.
  */
 void
 UpdateShardStatistic(CmdType cmd, ShardID sid, int64 new_size, int64 old_size)
 {
-    int index = 0;
+    LocalShardStatistic  delta;
+    LocalShardStatistic *stat;
     int nelems = MAX_SHARDS;
     int npools = (MaxBackends / g_MaxSessionsPerPool) + 1;
 
     if (!ShardIDIsValid(sid))
         return;
 
-    index = (MyProc->pgprocno % npools) * nelems + sid;
-    
+    /* in sampling mode, count one of every g_ShardInfoSelectSample scanned tuples */
+    if (cmd == CMD_SELECT && g_ShardInfoSelectSample > 1)
+    {
+        if (++nLocalShardStatSelectSkipped < g_ShardInfoSelectSample)
+            return;
+        nLocalShardStatSelectSkipped = 0;
+    }
+
+    if (InRecovery)
+    {
+        MemSet(&delta, 0, sizeof(LocalShardStatistic));
+        stat = &delta;
+    }
+    else
+    {
+        if (localShardStat == NULL)
+        {
+            localShardStat = (LocalShardStatistic *)
+                MemoryContextAllocZero(TopMemoryContext,
+                                       sizeof(LocalShardStatistic) * nelems);
+            localShardStatDirty = (ShardID *)
+                MemoryContextAlloc(TopMemoryContext, sizeof(ShardID) * nelems);
+            localShardStatIsDirty = (bool *)
+                MemoryContextAllocZero(TopMemoryContext, sizeof(bool) * nelems);
+            on_shmem_exit(ShardStatisticShmemExit, 0);
+        }
+
+        /*
+         * Counters that cancel out (an insert and a delete) leave a shard
+         * all zero, so membership is tracked separately from the counts.
+         */
+        if (!localShardStatIsDirty[sid])
+        {
+            Assert(nLocalShardStatDirty < nelems);
+            localShardStatIsDirty[sid] = true;
+            localShardStatDirty[nLocalShardStatDirty++] = sid;
+        }
+        stat = &localShardStat[sid];
+    }
+
     switch(cmd)
     {
         case CMD_SELECT:
-            {
-                pg_atomic_fetch_add_u64(&shardStatInfo[index].ntuples_select, 1);
-            }
+            stat->ntuples_select += Max(g_ShardInfoSelectSample, 1);
             break;
         case CMD_UPDATE:
-            {
-                pg_atomic_fetch_add_u64(&shardStatInfo[index].ntuples_update, 1);
-
-                if (new_size > old_size)
-                {
-                    int64 size = new_size - old_size;
-
-                    pg_atomic_fetch_add_u64(&shardStatInfo[index].size, size);
-                }
-                else if (new_size < old_size)
-                {
-                    int64 size = old_size - new_size;
-
-                    pg_atomic_fetch_sub_u64(&shardStatInfo[index].size, size);
-                }
-            }
+            stat->ntuples_update++;
+            stat->size += new_size - old_size;
             break;
         case CMD_INSERT:
-            {
-                pg_atomic_fetch_add_u64(&shardStatInfo[index].ntuples_insert, 1);
-
-                pg_atomic_fetch_add_u64(&shardStatInfo[index].ntuples, 1);
-
-                pg_atomic_fetch_add_u64(&shardStatInfo[index].size, new_size);
-            }
+            stat->ntuples_insert++;
+            stat->ntuples++;
+            stat->size += new_size;
             break;
         case CMD_DELETE:
-            {
-                pg_atomic_fetch_add_u64(&shardStatInfo[index].ntuples_delete, 1);
-
-                pg_atomic_fetch_sub_u64(&shardStatInfo[index].ntuples, 1);
-
-                pg_atomic_fetch_sub_u64(&shardStatInfo[index].size, old_size);
-            }
+            stat->ntuples_delete++;
+            stat->ntuples--;
+            stat->size -= old_size;
             break;
         default:
             elog(LOG, "Unsupported CmdType %d in UpdateShardStatistic", cmd);
             break;
     }
+
+    if (InRecovery)
+        ApplyShardStatistic((MyProc->pgprocno % npools) * nelems + sid, &delta);
+    else if (++nLocalShardStatPending >= SHARD_STAT_LOCAL_FLUSH_THRESHOLD)
+        FlushLocalShardStatistic();
+}
+
+/*
+ * merge the local shard statistic delta of this backend into shared memory.
+ */
+void
+FlushLocalShardStatistic(void)
+{
+    int i = 0;
+    int nelems = MAX_SHARDS;
+    int npools = (MaxBackends / g_MaxSessionsPerPool) + 1;
+    int pool;
+
+    if (nLocalShardStatDirty == 0)
+        return;
+
+    pool = (MyProc->pgprocno % npools) * nelems;
+
+    for (i = 0; i < nLocalShardStatDirty; i++)
+    {
+        ShardID sid = localShardStatDirty[i];
+
+        ApplyShardStatistic(pool + sid, &localShardStat[sid]);
+        MemSet(&localShardStat[sid], 0, sizeof(LocalShardStatistic));
+        localShardStatIsDirty[sid] = false;
+    }
+
+    nLocalShardStatDirty = 0;
+    nLocalShardStatPending = 0;
+}
+
+/*
+ * transaction end: publish what this transaction counted.
+ */
+void
+AtEOXact_ShardStatistic(void)
+{
+    FlushLocalShardStatistic();
+}
+
+/*
+ * don't lose the counts of a backend exiting in the middle of a transaction.
+ */
+static void
+ShardStatisticShmemExit(int code, Datum arg)
+{
+    if (MyProc != NULL)
+        FlushLocalShardStatistic();
 }
 
 static void
@@ -3710,6 +4138,9 @@ opentenbase_shard_statistic(PG_FUNCTION_ARGS)
         status->currIdx = 0;
         rec = (ShardStatistic *)palloc(size);
 
+        /* make our own pending counts visible */
+        FlushLocalShardStatistic();
+
         for (i = 0; i < nelems; i++)
         {
             InitShardStatistic(&rec[i]);
@@ -4070,21 +4501,13 @@ pg_clear_cold_access(void)
  * Need dual write or not
  */
 bool NeedDualWrite(Oid relation, AttrNumber attr, Datum value)
-{// #lizard forgives
-    bool  found;
-    bool  needlock;
-    int32 gap;
-    DTag  tag;
+{
     int32        partitionStrategy        = 0;
     Relation                  rel            = NULL;
     Form_pg_partition_interval routerinfo   = NULL;
 
-    needlock = g_DualWriteCtl->needlock;
-
-    //LogDualWriteInfo(needlock);
-    
     /*no one is trying to add dual write logical */
-    if (0 == g_DualWriteCtl->entrynum && false == needlock)
+    if (0 == g_DualWriteCtl->entrynum && false == g_DualWriteCtl->needlock)
     {
         return false;
     }
@@ -4105,8 +4528,33 @@ bool NeedDualWrite(Oid relation, AttrNumber attr, Datum value)
         }
     }
     relation_close(rel, NoLock);
-  
+
+    return NeedDualWriteWithStrategy(relation, attr, value, partitionStrategy);
+}
+
+/*
+ * NeedDualWrite for callers which already know the partition strategy of
+ * the relation.
+ */
+static bool
+NeedDualWriteWithStrategy(Oid relation, AttrNumber attr, Datum value,
+                          int32 partitionStrategy)
+{
+    bool  found;
+    bool  needlock;
+    int32 gap;
+    DTag  tag;
+
+    needlock = g_DualWriteCtl->needlock;
+
+    //LogDualWriteInfo(needlock);
     
+    /*no one is trying to add dual write logical */
+    if (0 == g_DualWriteCtl->entrynum && false == needlock)
+    {
+        return false;
+    }
+
     gap             = get_timestamptz_gap(value, partitionStrategy);
     tag.relation     = relation;
     tag.attr         = attr;
@@ -4161,15 +4609,45 @@ bool InTempKeyValueList(Oid relation, char *value, Oid *hotGroup, Oid *coldGroup
 {
     ListCell *lc;
     KeyValuePair *p_KeyValuePair = NULL;
-    if (NIL != g_TempKeyValueList)
+
+    if (NIL == g_TempKeyValueList)
     {
-        foreach(lc, g_TempKeyValueList)
+        return false;
+    }
+
+    /* values too long for the hash key are compared the old way */
+    if (g_TempKeyValueHash && strlen(value) < NAMEDATALEN)
+    {
+        TempKeyValueKey  key;
+        TempKeyValueEnt *ent;
+
+        MemSet(&key, 0, sizeof(key));
+        key.table = relation;
+        strlcpy(NameStr(key.value), value, NAMEDATALEN);
+
+        ent = (TempKeyValueEnt *) hash_search(g_TempKeyValueHash, &key, HASH_FIND, NULL);
+        if (ent == NULL)
         {
-            p_KeyValuePair = (KeyValuePair*)lfirst(lc);
-            if (IsTempKeyValue(p_KeyValuePair, relation, value, hotGroup, coldGroup))
-            {
-                return true;
-            }
+            return false;
+        }
+
+        if (hotGroup)
+        {
+            *hotGroup = ent->hotGroup;
+        }
+        if (coldGroup)
+        {
+            *coldGroup = ent->coldGroup;
+        }
+        return true;
+    }
+
+    foreach(lc, g_TempKeyValueList)
+    {
+        p_KeyValuePair = (KeyValuePair*)lfirst(lc);
+        if (IsTempKeyValue(p_KeyValuePair, relation, value, hotGroup, coldGroup))
+        {
+            return true;
         }
     }
     
@@ -4376,6 +4854,11 @@ void SetTempKeyValueList(const char *str, void *extra)
         list_free_deep(g_TempKeyValueList);
         g_TempKeyValueList = NIL;
     }
+    if (g_TempKeyValueHash)
+    {
+        hash_destroy(g_TempKeyValueHash);
+        g_TempKeyValueHash = NULL;
+    }
     
     /*
      * str format: schemaA.tbl1,schemaB.tbl2 value hotgroupname coldgroupname
@@ -4421,6 +4904,8 @@ void SetTempKeyValueList(const char *str, void *extra)
             /*add to list*/
             g_TempKeyValueList = lappend(g_TempKeyValueList, (void*)p_KeyValuePair);
         }
+
+        BuildTempKeyValueHash();
     }
 
     /*free talNames itself*/
@@ -4569,12 +5054,26 @@ bool IsHotData(Datum secValue, RelationAccessType access, int32 interval,
 
     return gap < GetHotDataGap(interval);
 #endif
-    if (tm2timestamp(&g_ManualHotDataTime, 0, NULL, &hotDataTime) != 0)
-    {
-        ereport(ERROR,
-            (errcode(ERRCODE_DATETIME_VALUE_OUT_OF_RANGE),
-             errmsg("timestamp out of range")));
+    /* convert g_ManualHotDataTime only when the GUCs behind it changed */
+    if (!g_HotDataTimeValid ||
+        g_HotDataTimeKey.tm_year != g_ManualHotDataTime.tm_year ||
+        g_HotDataTimeKey.tm_mon != g_ManualHotDataTime.tm_mon ||
+        g_HotDataTimeKey.tm_mday != g_ManualHotDataTime.tm_mday ||
+        g_HotDataTimeKey.tm_hour != g_ManualHotDataTime.tm_hour ||
+        g_HotDataTimeKey.tm_min != g_ManualHotDataTime.tm_min ||
+        g_HotDataTimeKey.tm_sec != g_ManualHotDataTime.tm_sec)
+    {
+        if (tm2timestamp(&g_ManualHotDataTime, 0, NULL, &g_HotDataTime) != 0)
+        {
+            g_HotDataTimeValid = false;
+            ereport(ERROR,
+                (errcode(ERRCODE_DATETIME_VALUE_OUT_OF_RANGE),
+                 errmsg("timestamp out of range")));
+        }
+        g_HotDataTimeKey = g_ManualHotDataTime;
+        g_HotDataTimeValid = true;
     }
+    hotDataTime = g_HotDataTime;
 
 	if (enable_cold_hot_router_print)
 	{
@@ -4601,6 +5100,121 @@ bool IsHotData(Datum secValue, RelationAccessType access, int32 interval,
 }
 
 
+/*
+ * Build g_TempKeyValueHash from g_TempKeyValueList.  The first entry of a
+ * (table, value) pair wins, as with the list walk.
+ */
+static void
+BuildTempKeyValueHash(void)
+{
+    HASHCTL   ctl;
+    ListCell *lc;
+
+    MemSet(&ctl, 0, sizeof(ctl));
+    ctl.keysize = sizeof(TempKeyValueKey);
+    ctl.entrysize = sizeof(TempKeyValueEnt);
+    ctl.hcxt = TopMemoryContext;
+    g_TempKeyValueHash = hash_create("Temp key value hash",
+                                     Max(list_length(g_TempKeyValueList), 16),
+                                     &ctl,
+                                     HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+
+    foreach(lc, g_TempKeyValueList)
+    {
+        KeyValuePair    *p_KeyValuePair = (KeyValuePair*)lfirst(lc);
+        TempKeyValueKey  key;
+        TempKeyValueEnt *ent;
+        bool             found;
+
+        if (!OidIsValid(p_KeyValuePair->table))
+        {
+            continue;
+        }
+
+        MemSet(&key, 0, sizeof(key));
+        key.table = p_KeyValuePair->table;
+        strlcpy(NameStr(key.value), NameStr(p_KeyValuePair->value), NAMEDATALEN);
+
+        ent = (TempKeyValueEnt *) hash_search(g_TempKeyValueHash, &key, HASH_ENTER, &found);
+        if (!found)
+        {
+            ent->hotGroup  = p_KeyValuePair->hotGroup;
+            ent->coldGroup = p_KeyValuePair->coldGroup;
+        }
+    }
+}
+
+static void
+InvalidateColdHotRouterInfo(Datum arg, Oid relid)
+{
+    if (!OidIsValid(relid) ||
+        relid == g_ColdHotRouterInfo.relation ||
+        relid == g_ColdHotRouterInfo.routeRelation)
+    {
+        g_ColdHotRouterInfo.relation = InvalidOid;
+    }
+}
+
+/*
+ * Get the routing information of a cold-hot relation, from the single entry
+ * cache if possible.
+ */
+static ColdHotRouterInfo *
+GetColdHotRouterInfo(Oid relation, AttrNumber secAttr)
+{
+    ColdHotRouterInfo         *info = &g_ColdHotRouterInfo;
+    Relation                   rel;
+    Form_pg_partition_interval routerinfo;
+
+    if (info->relation == relation && info->secAttr == secAttr)
+    {
+        return info;
+    }
+
+    if (!g_ColdHotRouterCallbackRegistered)
+    {
+        CacheRegisterRelcacheCallback(InvalidateColdHotRouterInfo, (Datum) 0);
+        g_ColdHotRouterCallbackRegistered = true;
+    }
+
+    MemSet(info, 0, sizeof(ColdHotRouterInfo));
+
+    rel = relation_open(relation, NoLock);
+    info->routeRelation = RELATION_IS_CHILD(rel) ? RELATION_GET_PARENT(rel) : relation;
+    info->isInterval = (RELATION_IS_INTERVAL(rel) || RELATION_IS_CHILD(rel));
+    relation_close(rel, NoLock);
+
+    if (secAttr != InvalidAttrNumber)
+    {
+        rel        = relation_open(info->routeRelation, NoLock);
+        routerinfo = rel->rd_partitions_info;
+        if (routerinfo)
+        {
+            info->hasRouterInfo = true;
+            if (secAttr == routerinfo->partpartkey)
+            {
+                info->partitionStrategy = routerinfo->partinterval_type;
+
+                if (info->partitionStrategy == IntervalType_Month &&
+                    routerinfo->partinterval_int == COLD_HOT_INTERVAL_YEAR)
+                {
+                    info->partitionStrategy = IntervalType_Year;
+                }
+            }
+
+            info->interval_step = routerinfo->partinterval_int;
+            info->start_timestamp = routerinfo->partstartvalue_ts;
+        }
+        relation_close(rel, NoLock);
+    }
+
+    /* set the key last, an error above leaves the cache empty */
+    info->secAttr = secAttr;
+    info->relation = relation;
+
+    return info;
+}
+
 List* ShardMapRouter(Oid group, Oid coldgroup, Oid relation, Oid type, Datum dvalue, AttrNumber secAttr, Oid secType, 
                     bool isSecNull, Datum secValue, RelationAccessType accessType)
 {// #lizard forgives    
@@ -4624,21 +5238,28 @@ List* ShardMapRouter(Oid group, Oid coldgroup, Oid relation, Oid type, Datum dva
     int32         partitionStrategy          = 0;
     int32        interval_step            = 0;
     TimestampTz  start_timestamp          = 0;
-    Relation                 rel          = NULL;
-    Form_pg_partition_interval routerinfo = NULL;    
 	bool         router_log_print         = false;
+    ColdHotRouterInfo *info               = NULL;
 
-    rel = relation_open(relation, NoLock);
+    info = GetColdHotRouterInfo(relation, secAttr);
+    relation = info->routeRelation;
 
-    if (RELATION_IS_CHILD(rel))
-    {
-        relation = RELATION_GET_PARENT(rel);
-    }
+	router_log_print = (enable_cold_hot_router_print && accessType == RELATION_ACCESS_INSERT &&
+						info->isInterval);
 
-    relation_close(rel, NoLock);
+    /* get partition stragegy first */
+    if (!isSecNull && secAttr != InvalidAttrNumber)
+    {
+        partitionStrategy = info->partitionStrategy;
+        interval_step = info->interval_step;
+        start_timestamp = info->start_timestamp;
 
-	router_log_print = (enable_cold_hot_router_print && accessType == RELATION_ACCESS_INSERT &&
-						(RELATION_IS_INTERVAL(rel) || RELATION_IS_CHILD(rel)));
+        if (router_log_print)
+        {
+            elog(LOG, "%s routerinfo %d", info->hasRouterInfo ? "has" : "no",
+                 partitionStrategy);
+        }
+    }
 
     if (g_EnableKeyValue)
     {
@@ -4655,7 +5276,8 @@ List* ShardMapRouter(Oid group, Oid coldgroup, Oid relation, Oid type, Datum dva
         if (!isSecNull && PARTITION_KEY_IS_TIMESTAMP(secType) && secAttr != InvalidAttrNumber && 
             accessType != RELATION_ACCESS_READ && accessType != RELATION_ACCESS_READ_FQS)
         {
-            bdualwrite = NeedDualWrite(relation, secAttr, secValue);
+            bdualwrite = NeedDualWriteWithStrategy(relation, secAttr, secValue,
+                                                   partitionStrategy);
             if (bdualwrite)
             {
                 elog(LOG, "distribute key:%s timestamp:%s need dual write", value, timestamptz_to_str((TimestampTz) secValue));
@@ -4672,40 +5294,6 @@ List* ShardMapRouter(Oid group, Oid coldgroup, Oid relation, Oid type, Datum dva
 		elog(LOG, "Group %d coldgroup %d relation %d secAttr %d isSecNull %d dualwrite %d",
 		     group, coldgroup, relation, secAttr, isSecNull, bdualwrite);
 	}
-    
-    /* get partition stragegy first */
-    if (!isSecNull && secAttr != InvalidAttrNumber)
-    {
-        rel          = relation_open(relation, NoLock);
-        routerinfo     = rel->rd_partitions_info;
-        if (routerinfo)
-        {
-            if (secAttr == routerinfo->partpartkey)
-            {
-                partitionStrategy = routerinfo->partinterval_type;
-
-                if (partitionStrategy == IntervalType_Month &&
-					routerinfo->partinterval_int == COLD_HOT_INTERVAL_YEAR)
-                {
-                    partitionStrategy = IntervalType_Year;
-                }
-            }
-
-            interval_step = routerinfo->partinterval_int;
-            start_timestamp = routerinfo->partstartvalue_ts;
-
-			if (router_log_print)
-			{
-                elog(LOG, "has routerinfo %d", partitionStrategy);
-			}
-        }
-		else if (router_log_print)
-        {
-            elog(LOG, "no routerinfo %d", partitionStrategy);
-        }
-
-        relation_close(rel, NoLock);
-    }
 
     if (g_EnableKeyValue)
     {    
@@ -62,6 +62,7 @@
 #include "utils/memutils.h"
 #include "utils/elog.h"
 #include "commands/vacuum.h"
+#include "postmaster/netcalibrator.h"
 #endif
 int   NSQueues = 64;
 int   SQueueSize = 64;
@@ -104,6 +105,9 @@ bool in_data_pump = false;
 
 static bool execute_error = false;
 
+/* producer of the queue last read to EOF broadcast its tuples */
+static bool last_read_broadcast = false;
+
 volatile sig_atomic_t end_query_requested = false;
 
 
@@ -198,6 +202,8 @@ typedef struct SQueueHeader
     bool        producer_done;
     int         nConsumer_done;
     slock_t        lock;
+    bool        sq_broadcast;   /* producer sent all its tuples to every consumer */
+    bool        sq_redistributed;   /* producer chose not to broadcast */
 #endif
     int            sq_nconsumers;    /* Number of consumers */
     ConsState     sq_consumers[0];/* variable length array */
@@ -363,6 +369,10 @@ typedef struct
     size_t                nfast_send;  /* counter for tuple */
 
     size_t                sleep_count; /* counter sleep */
+
+    uint64              bytes_sent;  /* bytes written to the socket */
+    TimestampTz         first_send;  /* time of the first write */
+    TimestampTz         last_send;   /* time of the last write */
 }DataPumpNodeControl;
 
 typedef struct
@@ -585,6 +595,8 @@ typedef struct ParallelSendDestReceiver
 
 static bool DataPumpNodeCheck(void *sndctl, int32 nodeindex);
 static int    DataPumpRawSendData(DataPumpNodeControl *node, int32 sock, char *data, int32 len, int32 *reason);
+static void DataPumpCountSent(DataPumpNodeControl *node, int32 nbytes);
+static void DataPumpReportSent(SharedQueue squeue, DataPumpSenderControl *sender);
 static uint32 DataSize(DataPumpBuf *buf);
 static uint32 FreeSpace(DataPumpBuf *buf);
 static char  *GetData(DataPumpBuf *buf, uint32 *uiLen);
@@ -1096,6 +1108,10 @@ SharedQueueBind(const char *sqname, List *consNodes,
             /* Initialize the shared queue */
             sq->sq_pid = MyProcPid;
             sq->sq_nodeid = PGXC_PARENT_NODE_ID;
+#ifdef __OPENTENBASE__
+            sq->sq_broadcast = false;
+            sq->sq_redistributed = false;
+#endif
             OwnLatch(&sq->sq_sync->sqs_producer_latch);
 
             for (i = 0; i < MAX_NODES_NUMBER; i++)
@@ -1892,6 +1908,10 @@ SharedQueueRead(SharedQueue squeue, int consumerIdx,
                     squeue->sq_key,
                     cstate->cs_node, cstate->cs_pid, cstate->cs_status);
 
+#ifdef __OPENTENBASE__
+            /* producer may release the queue once we are done */
+            last_read_broadcast = squeue->sq_broadcast;
+#endif
             /* Inform producer the consumer have done the job */
             cstate->cs_status = CONSUMER_DONE;
             /* no need to receive notifications */
@@ -2475,6 +2495,49 @@ SharedQueueWaitOnProducerLatch(SharedQueue squeue, long timeout)
     return (rc & (WL_TIMEOUT|WL_POSTMASTER_DEATH));
 }
 
+#ifdef __OPENTENBASE__
+/*
+ * Mark that the producer sent all its tuples to every consumer, so that the
+ * consumers can tell the nodes they forward the tuples to. Must be called
+ * before the queue is finished.
+ */
+void
+SharedQueueSetBroadcast(SharedQueue squeue)
+{
+    squeue->sq_broadcast = true;
+}
+
+/*
+ * Mark that the producer chose not to send its tuples to every consumer, so
+ * that the consumers can tell the nodes they forward the tuples to early.
+ */
+void
+SharedQueueSetRedistributed(SharedQueue squeue)
+{
+    squeue->sq_redistributed = true;
+}
+
+/*
+ * Check if the producer of the queue chose not to send its tuples to every
+ * consumer.
+ */
+bool
+SharedQueueRedistributed(SharedQueue squeue)
+{
+    return squeue->sq_redistributed;
+}
+
+/*
+ * Check if the producer of the queue last read to EOF by this session sent
+ * all its tuples to every consumer.
+ */
+bool
+SharedQueueLastReadBroadcast(void)
+{
+    return last_read_broadcast;
+}
+#endif
+
 /*
  * Determine if producer can safely pause work.
  * The producer can pause if all consumers have enough data to read while
@@ -2918,6 +2981,7 @@ SEND_DATA:
                         SetLatch(&sqsync->sqs_consumer_sync[i].cs_latch);
                         LWLockRelease(sqsync->sqs_consumer_sync[i].cs_lwlock);
                     }
+                    DataPumpReportSent(squeue, sender);
                     DestoryDataPumpSenderControl(squeue->sender, squeue->sq_nodeid);
                     squeue->sender = NULL;
                     squeue->sender_destroy = true;
@@ -4007,6 +4071,9 @@ void InitDataPumpNodeControl(int32 nodeindex, DataPumpNodeControl *control)
     control->buffer      = BuildDataPumpBuf();
     control->ntuples_get = 0;
     control->ntuples_put = 0;
+    control->bytes_sent  = 0;
+    control->first_send  = 0;
+    control->last_send   = 0;
 }
 /*
  * Build data pump thread control.
@@ -4423,6 +4490,7 @@ static int DataPumpRawSendData(DataPumpNodeControl *node, int32 sock, char *data
                 pg_usleep(1000L);
                 node->sleep_count++;
                 *reason = errno;
+                DataPumpCountSent(node, offset);
                 return offset;
             }
             *reason = errno;
@@ -4431,9 +4499,79 @@ static int DataPumpRawSendData(DataPumpNodeControl *node, int32 sock, char *data
         offset += nbytes_write;
     }
     
+    DataPumpCountSent(node, offset);
     return offset;
 }
 
+/*
+ * Account bytes written to the socket of a node, for network calibration.
+ * Runs in the sender threads, so it must not use anything but the node.
+ */
+static void DataPumpCountSent(DataPumpNodeControl *node, int32 nbytes)
+{
+    TimestampTz now;
+
+    if (nbytes <= 0)
+        return;
+
+    now = GetCurrentTimestamp();
+    if (node->bytes_sent == 0)
+        node->first_send = now;
+    node->bytes_sent += nbytes;
+    node->last_send   = now;
+}
+
+/*
+ * Report the performance of the links data was sent over to the network
+ * calibration, once all data has been sent.
+ */
+static void DataPumpReportSent(SharedQueue squeue, DataPumpSenderControl *sender)
+{
+    Oid         self;
+    uint64      total_bytes = 0;
+    TimestampTz first_send  = 0;
+    TimestampTz last_send   = 0;
+    int         i;
+
+    if (!IS_PGXC_DATANODE)
+        return;
+
+    self = get_pgxc_nodeoid(PGXCNodeName);
+    if (!OidIsValid(self))
+        return;
+
+    for (i = 0; i < squeue->sq_nconsumers; i++)
+    {
+        DataPumpNodeControl *node = &sender->nodes[i];
+        Oid                  target;
+
+        if (node->bytes_sent == 0)
+            continue;
+
+        if (first_send == 0 || node->first_send < first_send)
+            first_send = node->first_send;
+        if (node->last_send > last_send)
+            last_send = node->last_send;
+        total_bytes += node->bytes_sent;
+
+        /* the parent of the query is not a datanode */
+        if (node->nodeindex < 0 || node->nodeindex == PGXC_PARENT_NODE_ID)
+            continue;
+
+        target = PGXCNodeGetNodeOid(node->nodeindex, PGXC_NODE_DATANODE);
+        if (!OidIsValid(target) || target == self)
+            continue;
+
+        NetworkCalibrationReportLink(self, target, (double) node->bytes_sent,
+                                     (node->last_send - node->first_send) / (double) USECS_PER_SEC,
+                                     node->sleep_count > 0);
+    }
+
+    if (total_bytes > 0)
+        NetworkCalibrationReportThroughput(self, (double) total_bytes,
+                                           (last_send - first_send) / (double) USECS_PER_SEC);
+}
+
 bool
 DataPumpTupleStoreDump(void *sndctl, int32 nodeindex, int32 nodeId,
                                  TupleTableSlot *tmpslot, 
@@ -43,6 +43,7 @@
 #include "executor/nodeAgg.h"
 #include "executor/nodeHashjoin.h"
 #include "pgxc/squeue.h"
+#include "postmaster/netcalibrator.h"
 #endif
 #ifdef __AUDIT_FGA__
 #include "audit/audit_fga.h"
@@ -146,6 +147,11 @@ static const struct
         "ApplyAuditFgaMain", ApplyAuditFgaMain
     }
 #endif
+#ifdef __OPENTENBASE__
+    ,{
+        "NetworkCalibratorMain", NetworkCalibratorMain
+    }
+#endif
 };
 
 /* Private functions. */
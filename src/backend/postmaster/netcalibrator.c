@@ -0,0 +1,936 @@
+/*-------------------------------------------------------------------------
+ *
+ * netcalibrator.c
+ *
+ * Measure network and datanode performance for the costing of data movement
+ * between nodes.
+ *
+ * cost_remote_subplan() charges network_byte_cost for every byte moved and
+ * remote_query_cost for starting a remote fragment, whatever the nodes
+ * involved.  This module keeps measurements that let it scale these costs
+ * by the actual performance of the links used:
+ *
+ * - Datanodes time how long the data pump takes to send each consumer its
+ *   data, giving the bandwidth of the link to that consumer, and the rate at
+ *   which they produce data overall.  A transfer during which the socket
+ *   never filled up only shows that the link is at least that fast.
+ *
+ * - On coordinators, the network calibrator background worker periodically
+ *   measures the round trip time of a query to each datanode and the
+ *   bandwidth of the link from it, and collects the measurements datanodes
+ *   made of their own links.
+ *
+ * Measurements are kept in shared memory, per pair of nodes.  Planning
+ * backends copy them into a local snapshot indexed by datanode, refreshed
+ * when they change.  Measurements not refreshed for
+ * NETCALIB_MAX_AGE_INTERVALS calibration intervals are ignored.
+ *
+ * Copyright (c) 2023 THL A29 Limited, a Tencent company.
+ *
+ * This source code file is licensed under the BSD 3-Clause License,
+ * you may obtain a copy of the License at http://opensource.org/license/bsd-3-clause/
+ *
+ * IDENTIFICATION
+ *	  src/backend/postmaster/netcalibrator.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "access/htup_details.h"
+#include "access/xact.h"
+#include "catalog/pg_type.h"
+#include "executor/executor.h"
+#include "funcapi.h"
+#include "libpq/pqsignal.h"
+#include "miscadmin.h"
+#include "nodes/makefuncs.h"
+#include "pgstat.h"
+#include "pgxc/execRemote.h"
+#include "pgxc/nodemgr.h"
+#include "pgxc/pgxc.h"
+#include "pgxc/pgxcnode.h"
+#include "port/atomics.h"
+#include "postmaster/bgworker.h"
+#include "postmaster/netcalibrator.h"
+#include "storage/ipc.h"
+#include "storage/latch.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "tcop/tcopprot.h"
+#include "utils/builtins.h"
+#include "utils/guc.h"
+#include "utils/lsyscache.h"
+#include "utils/memutils.h"
+#include "utils/snapmgr.h"
+
+/* GUC parameters */
+bool		enable_network_calibration = false;
+int			network_calibration_interval = 60;
+
+/*
+ * network_byte_cost and remote_query_cost are taken to be the costs on a
+ * 1 Gbit/s link with a 1 ms round trip; measured links are costed in
+ * proportion.
+ */
+#define NETCALIB_REFERENCE_BANDWIDTH	(125.0 * 1000 * 1000)
+#define NETCALIB_REFERENCE_LATENCY		0.001
+
+/* bounds of the cost factors, against wild measurements */
+#define NETCALIB_MIN_TRANSFER_FACTOR	0.05
+#define NETCALIB_MAX_TRANSFER_FACTOR	100.0
+#define NETCALIB_MIN_LATENCY_FACTOR		0.5
+#define NETCALIB_MAX_LATENCY_FACTOR		20.0
+
+/* size of the data fetched from a datanode to measure its link */
+#define NETCALIB_PROBE_BYTES			(1024 * 1024)
+
+/* smallest transfer taken as a bandwidth sample */
+#define NETCALIB_MIN_SAMPLE_BYTES		(256 * 1024)
+
+/* weight of a new sample in the smoothed measurements */
+#define NETCALIB_SMOOTHING				0.25
+
+/* measurements older than this many calibration intervals are ignored */
+#define NETCALIB_MAX_AGE_INTERVALS		10
+
+#define NETCALIB_QUERY_LEN				1024
+
+typedef struct NetCalibNode
+{
+	Oid			oid;			/* InvalidOid if the slot is free */
+	NameData	name;
+	double		latency;		/* round trip from this coordinator, seconds */
+	TimestampTz latency_time;
+	double		throughput;		/* bytes per second the node sends */
+	TimestampTz throughput_time;
+} NetCalibNode;
+
+typedef struct NetCalibLink
+{
+	double		bandwidth;		/* bytes per second, 0 if not measured */
+	TimestampTz time;
+} NetCalibLink;
+
+typedef struct NetCalibShmemStruct
+{
+	/* bumped whenever measurements change, protected by the lock otherwise */
+	pg_atomic_uint32 generation;
+	NetCalibNode nodes[NETCALIB_MAX_NODES];
+	/* indexed by the slots of the source and target nodes */
+	NetCalibLink links[NETCALIB_MAX_NODES][NETCALIB_MAX_NODES];
+} NetCalibShmemStruct;
+
+static NetCalibShmemStruct *NetCalibShmem = NULL;
+
+/*
+ * Backend-local copy of the measurements for planning, indexed by datanode.
+ * The bandwidth matrix has a column more than there are datanodes, for the
+ * links to this coordinator.
+ */
+static bool snapshot_valid = false;
+static uint32 snapshot_generation = 0;
+static TimestampTz snapshot_time = 0;
+static int	snapshot_ndatanodes = 0;
+static double *snapshot_bandwidth = NULL;
+static double *snapshot_latency = NULL;
+static double *snapshot_load = NULL;
+
+static volatile sig_atomic_t got_SIGHUP = false;
+
+static int	get_node_slot(Oid oid, const char *name);
+static int	find_node_slot(Oid oid);
+static double smooth(double current, double sample);
+static int	calibration_interval(void);
+static TimestampTz max_age_cutoff(TimestampTz now);
+static double link_cost_factor(int source, int target);
+static void refresh_snapshot(void);
+static void calibrate_datanodes(void);
+static List *query_datanode(Oid node, const char *query, int ncolumns,
+			   double *seconds);
+static void probe_datanode(Oid node, Oid self);
+static void collect_datanode_links(Oid node);
+static void netcalib_sighup(SIGNAL_ARGS);
+
+
+/*
+ * NetworkCalibrationShmemSize
+ *		Compute space needed for the measurements
+ */
+Size
+NetworkCalibrationShmemSize(void)
+{
+	return sizeof(NetCalibShmemStruct);
+}
+
+/*
+ * NetworkCalibrationShmemInit
+ *		Allocate and initialize the measurements
+ */
+void
+NetworkCalibrationShmemInit(void)
+{
+	bool		found;
+
+	NetCalibShmem = (NetCalibShmemStruct *)
+		ShmemInitStruct("Network Calibration", NetworkCalibrationShmemSize(),
+						&found);
+
+	if (!found)
+	{
+		memset(NetCalibShmem, 0, NetworkCalibrationShmemSize());
+		pg_atomic_init_u32(&NetCalibShmem->generation, 1);
+	}
+}
+
+/*
+ * Find the slot of a node, allocating one if needed.  When all slots are in
+ * use, the one measured least recently is reused.  Caller must hold
+ * NetworkCalibrationLock exclusively.
+ */
+static int
+get_node_slot(Oid oid, const char *name)
+{
+	int			slot = find_node_slot(oid);
+	TimestampTz oldest = 0;
+	int			i;
+
+	if (slot >= 0)
+		return slot;
+
+	slot = find_node_slot(InvalidOid);
+	if (slot < 0)
+	{
+		for (i = 0; i < NETCALIB_MAX_NODES; i++)
+		{
+			NetCalibNode *node = &NetCalibShmem->nodes[i];
+			TimestampTz last = Max(node->latency_time, node->throughput_time);
+			int			j;
+
+			for (j = 0; j < NETCALIB_MAX_NODES; j++)
+			{
+				last = Max(last, NetCalibShmem->links[i][j].time);
+				last = Max(last, NetCalibShmem->links[j][i].time);
+			}
+			if (slot < 0 || last < oldest)
+			{
+				slot = i;
+				oldest = last;
+			}
+		}
+	}
+
+	memset(&NetCalibShmem->nodes[slot], 0, sizeof(NetCalibNode));
+	for (i = 0; i < NETCALIB_MAX_NODES; i++)
+	{
+		memset(&NetCalibShmem->links[slot][i], 0, sizeof(NetCalibLink));
+		memset(&NetCalibShmem->links[i][slot], 0, sizeof(NetCalibLink));
+	}
+	NetCalibShmem->nodes[slot].oid = oid;
+	namestrcpy(&NetCalibShmem->nodes[slot].name, name);
+
+	return slot;
+}
+
+/* slot of a node, or -1; caller must hold NetworkCalibrationLock */
+static int
+find_node_slot(Oid oid)
+{
+	int			i;
+
+	for (i = 0; i < NETCALIB_MAX_NODES; i++)
+	{
+		if (NetCalibShmem->nodes[i].oid == oid)
+			return i;
+	}
+	return -1;
+}
+
+static double
+smooth(double current, double sample)
+{
+	if (current <= 0)
+		return sample;
+	return current + NETCALIB_SMOOTHING * (sample - current);
+}
+
+/*
+ * Seconds between calibrations.  Measurements of datanodes keep coming
+ * without the calibrator, so they still age.
+ */
+static int
+calibration_interval(void)
+{
+	return (network_calibration_interval > 0) ? network_calibration_interval : 60;
+}
+
+/* measurements taken before the returned time are out of date */
+static TimestampTz
+max_age_cutoff(TimestampTz now)
+{
+	return now - (TimestampTz) NETCALIB_MAX_AGE_INTERVALS *
+		calibration_interval() * USECS_PER_SEC;
+}
+
+/*
+ * NetworkCalibrationReportLink
+ *		Record that sending bytes from source to target took seconds
+ *
+ * If the sender never had to wait for the link, it may have been slowed down
+ * by the production of the data rather than by the link, so the bandwidth
+ * only serves as a lower bound.
+ */
+void
+NetworkCalibrationReportLink(Oid source, Oid target, double bytes,
+							 double seconds, bool saturated)
+{
+	char	   *source_name;
+	char	   *target_name;
+	double		sample;
+	int			s;
+	int			t;
+
+	if (bytes < NETCALIB_MIN_SAMPLE_BYTES || seconds <= 0 ||
+		source == target || NetCalibShmem == NULL)
+		return;
+
+	source_name = get_pgxc_nodename(source);
+	target_name = get_pgxc_nodename(target);
+	sample = bytes / seconds;
+
+	LWLockAcquire(NetworkCalibrationLock, LW_EXCLUSIVE);
+	s = get_node_slot(source, source_name);
+	t = get_node_slot(target, target_name);
+	if (s != t)
+	{
+		NetCalibLink *link = &NetCalibShmem->links[s][t];
+
+		if (saturated || link->bandwidth <= 0)
+			link->bandwidth = smooth(link->bandwidth, sample);
+		else
+			link->bandwidth = Max(link->bandwidth, sample);
+		link->time = GetCurrentTimestamp();
+	}
+	LWLockRelease(NetworkCalibrationLock);
+
+	pg_atomic_fetch_add_u32(&NetCalibShmem->generation, 1);
+}
+
+/*
+ * NetworkCalibrationReportThroughput
+ *		Record that node sent bytes to other nodes in seconds
+ */
+void
+NetworkCalibrationReportThroughput(Oid node, double bytes, double seconds)
+{
+	char	   *name;
+	int			slot;
+
+	if (bytes < NETCALIB_MIN_SAMPLE_BYTES || seconds <= 0 ||
+		NetCalibShmem == NULL)
+		return;
+
+	name = get_pgxc_nodename(node);
+
+	LWLockAcquire(NetworkCalibrationLock, LW_EXCLUSIVE);
+	slot = get_node_slot(node, name);
+	NetCalibShmem->nodes[slot].throughput =
+		smooth(NetCalibShmem->nodes[slot].throughput, bytes / seconds);
+	NetCalibShmem->nodes[slot].throughput_time = GetCurrentTimestamp();
+	LWLockRelease(NetworkCalibrationLock);
+
+	pg_atomic_fetch_add_u32(&NetCalibShmem->generation, 1);
+}
+
+/*
+ * Copy the current measurements into the local snapshot, unless it's up to
+ * date.
+ */
+static void
+refresh_snapshot(void)
+{
+	TimestampTz now = GetCurrentStatementStartTimestamp();
+	uint32		generation = pg_atomic_read_u32(&NetCalibShmem->generation);
+	int			ndatanodes = NumDataNodes;
+	int		   *slots;
+	Oid			self;
+	int			self_slot;
+	TimestampTz cutoff;
+	double	   *throughput;
+	double		median = 0;
+	int			nthroughput = 0;
+	int			i;
+	int			j;
+
+	if (snapshot_valid && snapshot_generation == generation &&
+		snapshot_ndatanodes == ndatanodes &&
+		now - snapshot_time < (TimestampTz) calibration_interval() * USECS_PER_SEC)
+		return;
+
+	if (snapshot_bandwidth != NULL)
+	{
+		pfree(snapshot_bandwidth);
+		pfree(snapshot_latency);
+		pfree(snapshot_load);
+		snapshot_bandwidth = NULL;
+	}
+	snapshot_valid = false;
+	if (ndatanodes <= 0)
+		return;
+
+	snapshot_bandwidth = MemoryContextAllocZero(TopMemoryContext,
+												sizeof(double) * ndatanodes * (ndatanodes + 1));
+	snapshot_latency = MemoryContextAllocZero(TopMemoryContext,
+											  sizeof(double) * ndatanodes);
+	snapshot_load = MemoryContextAlloc(TopMemoryContext,
+									   sizeof(double) * ndatanodes);
+	slots = palloc(sizeof(int) * (ndatanodes + 1));
+	throughput = palloc0(sizeof(double) * ndatanodes);
+	self = get_pgxc_nodeoid(PGXCNodeName);
+	cutoff = max_age_cutoff(now);
+
+	LWLockAcquire(NetworkCalibrationLock, LW_SHARED);
+
+	for (i = 0; i < ndatanodes; i++)
+		slots[i] = find_node_slot(PGXCNodeGetNodeOid(i, PGXC_NODE_DATANODE));
+	self_slot = find_node_slot(self);
+
+	for (i = 0; i < ndatanodes; i++)
+	{
+		NetCalibNode *node;
+
+		if (slots[i] < 0)
+			continue;
+
+		node = &NetCalibShmem->nodes[slots[i]];
+		if (node->latency_time >= cutoff)
+			snapshot_latency[i] = node->latency;
+		if (node->throughput_time >= cutoff)
+			throughput[i] = node->throughput;
+
+		for (j = 0; j <= ndatanodes; j++)
+		{
+			int			target = (j < ndatanodes) ? slots[j] : self_slot;
+			NetCalibLink *link;
+
+			if (target < 0)
+				continue;
+			link = &NetCalibShmem->links[slots[i]][target];
+			if (link->time >= cutoff)
+				snapshot_bandwidth[i * (ndatanodes + 1) + j] = link->bandwidth;
+		}
+	}
+
+	LWLockRelease(NetworkCalibrationLock);
+
+	/*
+	 * A datanode sending slower than the median is busier than the others,
+	 * and slows down all the transfers from it.
+	 */
+	for (i = 0; i < ndatanodes; i++)
+	{
+		if (throughput[i] > 0)
+			slots[nthroughput++] = i;
+	}
+	if (nthroughput > 0)
+	{
+		double	   *sorted = palloc(sizeof(double) * nthroughput);
+
+		for (i = 0; i < nthroughput; i++)
+			sorted[i] = throughput[slots[i]];
+		for (i = 1; i < nthroughput; i++)
+		{
+			double		value = sorted[i];
+
+			for (j = i; j > 0 && sorted[j - 1] > value; j--)
+				sorted[j] = sorted[j - 1];
+			sorted[j] = value;
+		}
+		median = sorted[nthroughput / 2];
+		pfree(sorted);
+	}
+	for (i = 0; i < ndatanodes; i++)
+	{
+		if (throughput[i] > 0 && throughput[i] < median)
+			snapshot_load[i] = median / throughput[i];
+		else
+			snapshot_load[i] = 1.0;
+	}
+
+	pfree(slots);
+	pfree(throughput);
+
+	snapshot_generation = generation;
+	snapshot_ndatanodes = ndatanodes;
+	snapshot_time = now;
+	snapshot_valid = true;
+}
+
+/*
+ * Relative cost of moving a byte from datanode source to target, target
+ * being the number of datanodes for this coordinator.
+ */
+static double
+link_cost_factor(int source, int target)
+{
+	double		bandwidth;
+	double		factor = 1.0;
+
+	bandwidth = snapshot_bandwidth[source * (snapshot_ndatanodes + 1) + target];
+	if (bandwidth > 0)
+		factor = NETCALIB_REFERENCE_BANDWIDTH / bandwidth;
+
+	return factor * snapshot_load[source];
+}
+
+/*
+ * NetworkCalibrationCostFactors
+ *		Factors to apply to network_byte_cost and remote_query_cost when
+ *		moving data from the datanodes in sources to those in targets
+ *
+ * A NULL targets means the data goes to this coordinator.  Data is assumed
+ * to be evenly spread over the links used.  Without measurements, both
+ * factors are 1.
+ */
+void
+NetworkCalibrationCostFactors(Bitmapset *sources, Bitmapset *targets,
+							  double *transfer_factor, double *latency_factor)
+{
+	double		total = 0;
+	int			nlinks = 0;
+	double		latency = 0;
+	int			ndatanodes;
+	int			s;
+
+	*transfer_factor = 1.0;
+	*latency_factor = 1.0;
+
+	if (!enable_network_calibration || !IS_PGXC_COORDINATOR ||
+		sources == NULL || NetCalibShmem == NULL)
+		return;
+
+	refresh_snapshot();
+	if (!snapshot_valid)
+		return;
+	ndatanodes = snapshot_ndatanodes;
+
+	s = -1;
+	while ((s = bms_next_member(sources, s)) >= 0)
+	{
+		int			t = -1;
+
+		if (s >= ndatanodes)
+			continue;
+
+		latency = Max(latency, snapshot_latency[s]);
+
+		if (targets == NULL)
+		{
+			total += link_cost_factor(s, ndatanodes);
+			nlinks++;
+			continue;
+		}
+
+		while ((t = bms_next_member(targets, t)) >= 0)
+		{
+			/* tuples staying on the node don't use the network */
+			if (t == s || t >= ndatanodes)
+				continue;
+
+			total += link_cost_factor(s, t);
+			nlinks++;
+		}
+	}
+
+	if (nlinks > 0)
+	{
+		*transfer_factor = total / nlinks;
+		*transfer_factor = Max(*transfer_factor, NETCALIB_MIN_TRANSFER_FACTOR);
+		*transfer_factor = Min(*transfer_factor, NETCALIB_MAX_TRANSFER_FACTOR);
+	}
+
+	if (latency > 0)
+	{
+		*latency_factor = latency / NETCALIB_REFERENCE_LATENCY;
+		*latency_factor = Max(*latency_factor, NETCALIB_MIN_LATENCY_FACTOR);
+		*latency_factor = Min(*latency_factor, NETCALIB_MAX_LATENCY_FACTOR);
+	}
+}
+
+/*
+ * NetworkCalibratorRegister
+ *		Register the network calibrator, on coordinators
+ */
+void
+NetworkCalibratorRegister(void)
+{
+	BackgroundWorker bgw;
+
+	if (!IS_PGXC_COORDINATOR)
+		return;
+
+	memset(&bgw, 0, sizeof(bgw));
+	bgw.bgw_flags = BGWORKER_SHMEM_ACCESS |
+		BGWORKER_BACKEND_DATABASE_CONNECTION;
+	bgw.bgw_start_time = BgWorkerStart_RecoveryFinished;
+	snprintf(bgw.bgw_library_name, BGW_MAXLEN, "postgres");
+	snprintf(bgw.bgw_function_name, BGW_MAXLEN, "NetworkCalibratorMain");
+	snprintf(bgw.bgw_name, BGW_MAXLEN, "network calibrator");
+	bgw.bgw_restart_time = 60;
+	bgw.bgw_notify_pid = 0;
+	bgw.bgw_main_arg = (Datum) 0;
+
+	RegisterBackgroundWorker(&bgw);
+}
+
+/* SIGHUP: set flag to re-read config file at next convenient time */
+static void
+netcalib_sighup(SIGNAL_ARGS)
+{
+	int			save_errno = errno;
+
+	got_SIGHUP = true;
+	SetLatch(MyLatch);
+
+	errno = save_errno;
+}
+
+/*
+ * NetworkCalibratorMain
+ *		Main loop of the network calibrator
+ *
+ * A datanode failing to answer makes the worker exit with an error; the
+ * postmaster restarts it after bgw_restart_time.
+ */
+void
+NetworkCalibratorMain(Datum main_arg)
+{
+	pqsignal(SIGHUP, netcalib_sighup);
+	pqsignal(SIGTERM, die);
+	BackgroundWorkerUnblockSignals();
+
+	BackgroundWorkerInitializeConnection("postgres", NULL);
+
+	ereport(DEBUG1,
+			(errmsg("network calibrator started")));
+
+	for (;;)
+	{
+		long		timeout = -1;
+		int			events = WL_LATCH_SET | WL_POSTMASTER_DEATH;
+		int			rc;
+
+		CHECK_FOR_INTERRUPTS();
+
+		if (got_SIGHUP)
+		{
+			got_SIGHUP = false;
+			ProcessConfigFile(PGC_SIGHUP);
+		}
+
+		if (network_calibration_interval > 0)
+		{
+			calibrate_datanodes();
+			timeout = network_calibration_interval * 1000L;
+			events |= WL_TIMEOUT;
+		}
+
+		rc = WaitLatch(MyLatch, events, timeout,
+					   WAIT_EVENT_NETWORK_CALIBRATOR_MAIN);
+		ResetLatch(MyLatch);
+
+		if (rc & WL_POSTMASTER_DEATH)
+			proc_exit(1);
+	}
+}
+
+/*
+ * Measure the links from all datanodes to this coordinator, and collect the
+ * measurements they made.
+ */
+static void
+calibrate_datanodes(void)
+{
+	Oid		   *dnoids = NULL;
+	int			ncoords;
+	int			ndatanodes;
+	Oid			self;
+	int			i;
+
+	StartTransactionCommand();
+	InitMultinodeExecutor(false);
+
+	PgxcNodeGetOids(NULL, &dnoids, &ncoords, &ndatanodes, false);
+	self = get_pgxc_nodeoid(PGXCNodeName);
+
+	for (i = 0; i < ndatanodes; i++)
+	{
+		CHECK_FOR_INTERRUPTS();
+
+		probe_datanode(dnoids[i], self);
+		collect_datanode_links(dnoids[i]);
+	}
+
+	CommitTransactionCommand();
+}
+
+/*
+ * Run query on a datanode and return its result rows, as arrays of
+ * ncolumns C strings (NULL for null values), along with the time it took.
+ */
+static List *
+query_datanode(Oid node, const char *query, int ncolumns, double *seconds)
+{
+	RemoteQuery *plan;
+	RemoteQueryState *pstate;
+	EState	   *estate;
+	MemoryContext oldcontext;
+	TupleTableSlot *result;
+	List	   *rows = NIL;
+	char		ntype = PGXC_NODE_DATANODE;
+	int			nodeid = PGXCNodeGetNodeId(node, &ntype);
+	instr_time	start;
+	instr_time	duration;
+	int			i;
+
+	if (nodeid < 0)
+		ereport(ERROR,
+				(errcode(ERRCODE_INTERNAL_ERROR),
+				 errmsg("Unknown node Oid: %u", node)));
+
+	plan = makeNode(RemoteQuery);
+	plan->combine_type = COMBINE_TYPE_NONE;
+	plan->exec_nodes = makeNode(ExecNodes);
+	plan->exec_type = EXEC_ON_DATANODES;
+	plan->exec_nodes->nodeList = list_make1_int(nodeid);
+	plan->sql_statement = (char *) query;
+	plan->force_autocommit = false;
+
+	/* columns are fetched as text */
+	for (i = 1; i <= ncolumns; i++)
+		plan->scan.plan.targetlist =
+			lappend(plan->scan.plan.targetlist,
+					makeTargetEntry((Expr *) makeVar(1, i, TEXTOID, -1, InvalidOid, 0),
+									i, NULL, false));
+
+	INSTR_TIME_SET_CURRENT(start);
+
+	/* the background worker has no snapshot of its own to run the query in */
+	PushActiveSnapshot(GetTransactionSnapshot());
+
+	estate = CreateExecutorState();
+	oldcontext = MemoryContextSwitchTo(estate->es_query_cxt);
+	estate->es_snapshot = GetActiveSnapshot();
+	pstate = ExecInitRemoteQuery(plan, estate, 0);
+	MemoryContextSwitchTo(oldcontext);
+
+	result = ExecRemoteQuery((PlanState *) pstate);
+	while (result != NULL && !TupIsNull(result))
+	{
+		char	  **row = palloc(sizeof(char *) * ncolumns);
+
+		slot_getallattrs(result);
+		for (i = 0; i < ncolumns; i++)
+			row[i] = result->tts_isnull[i] ? NULL :
+				TextDatumGetCString(result->tts_values[i]);
+		rows = lappend(rows, row);
+
+		result = ExecRemoteQuery((PlanState *) pstate);
+	}
+	ExecEndRemoteQuery(pstate);
+	FreeExecutorState(estate);
+
+	PopActiveSnapshot();
+
+	INSTR_TIME_SET_CURRENT(duration);
+	INSTR_TIME_SUBTRACT(duration, start);
+	*seconds = INSTR_TIME_GET_DOUBLE(duration);
+
+	return rows;
+}
+
+/*
+ * Measure the round trip time of a query to a datanode, and the bandwidth of
+ * its link to this coordinator.
+ */
+static void
+probe_datanode(Oid node, Oid self)
+{
+	char		query[NETCALIB_QUERY_LEN];
+	double		latency;
+	double		seconds;
+	int			slot;
+
+	(void) query_datanode(node, "SELECT NULL::text", 1, &latency);
+
+	snprintf(query, NETCALIB_QUERY_LEN,
+			 "SELECT pg_catalog.repeat('x', %d)", NETCALIB_PROBE_BYTES);
+	(void) query_datanode(node, query, 1, &seconds);
+
+	LWLockAcquire(NetworkCalibrationLock, LW_EXCLUSIVE);
+	slot = get_node_slot(node, get_pgxc_nodename(node));
+	NetCalibShmem->nodes[slot].latency =
+		smooth(NetCalibShmem->nodes[slot].latency, latency);
+	NetCalibShmem->nodes[slot].latency_time = GetCurrentTimestamp();
+	LWLockRelease(NetworkCalibrationLock);
+
+	/* the probe fills the link, take it as saturated */
+	if (seconds > latency)
+		NetworkCalibrationReportLink(node, self, NETCALIB_PROBE_BYTES,
+									 seconds - latency, true);
+	else
+		pg_atomic_fetch_add_u32(&NetCalibShmem->generation, 1);
+}
+
+/*
+ * Copy the measurements a datanode made of the links from it.
+ */
+static void
+collect_datanode_links(Oid node)
+{
+	char	   *name = get_pgxc_nodename(node);
+	List	   *rows;
+	ListCell   *lc;
+	double		seconds;
+	TimestampTz now = GetCurrentTimestamp();
+	TimestampTz cutoff = max_age_cutoff(now);
+	char		query[NETCALIB_QUERY_LEN];
+
+	snprintf(query, NETCALIB_QUERY_LEN,
+			 "SELECT target_node, bandwidth::text, throughput::text, "
+			 "pg_catalog.extract(epoch FROM pg_catalog.now() - last_update)::text "
+			 "FROM pg_catalog.pg_network_calibration() "
+			 "WHERE source_node = %s",
+			 quote_literal_cstr(name));
+	rows = query_datanode(node, query, 4, &seconds);
+
+	LWLockAcquire(NetworkCalibrationLock, LW_EXCLUSIVE);
+	foreach(lc, rows)
+	{
+		char	  **row = (char **) lfirst(lc);
+		Oid			target;
+		TimestampTz time;
+		int			s;
+		int			t;
+
+		if (row[0] == NULL || row[1] == NULL || row[3] == NULL)
+			continue;
+
+		time = now - (TimestampTz) (strtod(row[3], NULL) * USECS_PER_SEC);
+		target = get_pgxc_nodeoid(row[0]);
+		if (!OidIsValid(target) || target == node || time < cutoff)
+			continue;
+
+		s = get_node_slot(node, name);
+		t = get_node_slot(target, row[0]);
+		NetCalibShmem->links[s][t].bandwidth = strtod(row[1], NULL);
+		NetCalibShmem->links[s][t].time = time;
+
+		if (row[2] != NULL)
+		{
+			NetCalibShmem->nodes[s].throughput = strtod(row[2], NULL);
+			NetCalibShmem->nodes[s].throughput_time = time;
+		}
+	}
+	LWLockRelease(NetworkCalibrationLock);
+
+	pg_atomic_fetch_add_u32(&NetCalibShmem->generation, 1);
+}
+
+/*
+ * pg_network_calibration
+ *		Show the measured links
+ *
+ * On a datanode, these are the links from it; on a coordinator, the links
+ * it measured or collected.  The latency is the round trip time of a query
+ * from this coordinator to the source node, on the link to it.
+ */
+Datum
+pg_network_calibration(PG_FUNCTION_ARGS)
+{
+#define NETWORK_CALIBRATION_NCOLUMNS 6
+	ReturnSetInfo *rsinfo = (ReturnSetInfo *) fcinfo->resultinfo;
+	TupleDesc	tupdesc;
+	Tuplestorestate *tupstore;
+	MemoryContext per_query_ctx;
+	MemoryContext oldcontext;
+	NetCalibNode *nodes;
+	NetCalibLink *links;
+	Oid			self = get_pgxc_nodeoid(PGXCNodeName);
+	int			s;
+	int			t;
+
+	/* check to see if caller supports us returning a tuplestore */
+	if (rsinfo == NULL || !IsA(rsinfo, ReturnSetInfo))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("set-valued function called in context that cannot accept a set")));
+	if (!(rsinfo->allowedModes & SFRM_Materialize))
+		ereport(ERROR,
+				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				 errmsg("materialize mode required, but it is not " \
+						"allowed in this context")));
+
+	/* Build a tuple descriptor for our result type */
+	if (get_call_result_type(fcinfo, NULL, &tupdesc) != TYPEFUNC_COMPOSITE)
+		elog(ERROR, "return type must be a row type");
+
+	per_query_ctx = rsinfo->econtext->ecxt_per_query_memory;
+	oldcontext = MemoryContextSwitchTo(per_query_ctx);
+
+	tupstore = tuplestore_begin_heap(true, false, work_mem);
+	rsinfo->returnMode = SFRM_Materialize;
+	rsinfo->setResult = tupstore;
+	rsinfo->setDesc = tupdesc;
+
+	MemoryContextSwitchTo(oldcontext);
+
+	/* copy the measurements, not to hold the lock while building tuples */
+	nodes = palloc(sizeof(NetCalibNode) * NETCALIB_MAX_NODES);
+	links = palloc(sizeof(NetCalibLink) * NETCALIB_MAX_NODES * NETCALIB_MAX_NODES);
+	LWLockAcquire(NetworkCalibrationLock, LW_SHARED);
+	memcpy(nodes, NetCalibShmem->nodes, sizeof(NetCalibNode) * NETCALIB_MAX_NODES);
+	memcpy(links, NetCalibShmem->links,
+		   sizeof(NetCalibLink) * NETCALIB_MAX_NODES * NETCALIB_MAX_NODES);
+	LWLockRelease(NetworkCalibrationLock);
+
+	for (s = 0; s < NETCALIB_MAX_NODES; s++)
+	{
+		if (!OidIsValid(nodes[s].oid))
+			continue;
+
+		for (t = 0; t < NETCALIB_MAX_NODES; t++)
+		{
+			NetCalibLink *link = &links[s * NETCALIB_MAX_NODES + t];
+			Datum		values[NETWORK_CALIBRATION_NCOLUMNS];
+			bool		nulls[NETWORK_CALIBRATION_NCOLUMNS];
+
+			if (!OidIsValid(nodes[t].oid) || link->bandwidth <= 0)
+				continue;
+
+			MemSet(nulls, 0, sizeof(nulls));
+			values[0] = CStringGetTextDatum(NameStr(nodes[s].name));
+			values[1] = CStringGetTextDatum(NameStr(nodes[t].name));
+			values[2] = Float8GetDatum(link->bandwidth);
+			if (nodes[t].oid == self && nodes[s].latency > 0)
+				values[3] = Float8GetDatum(nodes[s].latency);
+			else
+				nulls[3] = true;
+			if (nodes[s].throughput > 0)
+				values[4] = Float8GetDatum(nodes[s].throughput);
+			else
+				nulls[4] = true;
+			values[5] = TimestampTzGetDatum(link->time);
+
+			tuplestore_putvalues(tupstore, tupdesc, values, nulls);
+		}
+	}
+
+	pfree(nodes);
+	pfree(links);
+
+	/* clean up and return the tuplestore */
+	tuplestore_donestoring(tupstore);
+
+	return (Datum) 0;
+}
@@ -3610,6 +3610,11 @@ pgstat_get_wait_activity(WaitEventActivity w)
         case WAIT_EVENT_AUDIT_FGA_MAIN:
             event_name = "AuditFgaMain";
             break;
+#endif
+#ifdef __OPENTENBASE__
+        case WAIT_EVENT_NETWORK_CALIBRATOR_MAIN:
+            event_name = "NetworkCalibratorMain";
+            break;
 #endif
         case WAIT_EVENT_CLUSTER_MONITOR_MAIN:
             event_name = "ClusterMonitorMain";
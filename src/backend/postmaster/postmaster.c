@@ -125,6 +125,7 @@
 #include "postmaster/bgworker_internals.h"
 #include "postmaster/clean2pc.h"
 #include "postmaster/fork_process.h"
+#include "postmaster/netcalibrator.h"
 #include "postmaster/pgarch.h"
 #include "postmaster/postmaster.h"
 #include "postmaster/syslogger.h"
@@ -1152,6 +1153,13 @@ PostmasterMain(int argc, char *argv[])
         */
     ApplyAuditFgaRegister();
 
+#ifdef __OPENTENBASE__
+    /*
+     * Register the network calibrator on coordinators
+     */
+    NetworkCalibratorRegister();
+#endif
+
     /*
      * process any libraries that should be preloaded at postmaster start
      */
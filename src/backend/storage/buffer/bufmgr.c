@@ -3307,6 +3307,84 @@ DropDatabaseBuffers(Oid dbid)
 }
 
 #ifdef _SHARDING_
+/*
+ * Dropping the buffers of a handful of extents is much cheaper by probing the
+ * buffer mapping table for each of their blocks than by sweeping all of
+ * shared_buffers. Past this many blocks the sweep wins again.
+ */
+#define BUF_DROP_FULL_SCAN_THRESHOLD    ((uint64) (NBuffers / 32))
+
+/*
+ * Invalidate the cached MAIN_FORKNUM blocks [blk_start, blk_end) of rnode by
+ * looking each of them up in the buffer mapping table. If sid is valid, only
+ * pages that belong to that shard are dropped.
+ *
+ * Same locking rules as the full-sweep variants: the caller must make sure
+ * nobody is loading pages of the range concurrently.
+ */
+static void
+DropRelfileNodeBlockRangeBuffers(RelFileNode rnode, BlockNumber blk_start,
+                                 BlockNumber blk_end, ShardID sid)
+{
+    BlockNumber blkno;
+
+    for (blkno = blk_start; blkno < blk_end; blkno++)
+    {
+        BufferTag    bufTag;
+        uint32        bufHash;
+        LWLock       *bufPartitionLock;
+        int            buf_id;
+        BufferDesc *bufHdr;
+        uint32        buf_state;
+
+        INIT_BUFFERTAG(bufTag, rnode, MAIN_FORKNUM, blkno);
+        bufHash = BufTableHashCode(&bufTag);
+        bufPartitionLock = BufMappingPartitionLock(bufHash);
+
+        LWLockAcquire(bufPartitionLock, LW_SHARED);
+        buf_id = BufTableLookup(&bufTag, bufHash);
+        LWLockRelease(bufPartitionLock);
+
+        if (buf_id < 0)
+            continue;
+
+        /* the tag may have changed meanwhile, recheck under the header lock */
+        bufHdr = GetBufferDescriptor(buf_id);
+        buf_state = LockBufHdr(bufHdr);
+        if (BUFFERTAGS_EQUAL(bufHdr->tag, bufTag) &&
+            (!ShardIDIsValid(sid) ||
+             PageGetShardId(BufHdrGetBlock(bufHdr)) == sid))
+            InvalidateBuffer(bufHdr);    /* releases spinlock */
+        else
+            UnlockBufHdr(bufHdr, buf_state);
+    }
+}
+
+/*
+ * Drop the buffers of shard sid that live in the given extents of rnode.
+ *
+ * Used when the caller knows which extents the shard occupied, e.g. after
+ * TruncateShard freed them: for a few extents we only probe their blocks,
+ * otherwise fall back to sweeping the buffer pool.
+ */
+void DropRelfileNodeShardExtentBuffers(RelFileNode rnode, ShardID sid,
+                                       ExtentID *eids, int neids)
+{
+    int            i;
+
+    if ((uint64) neids * PAGES_PER_EXTENTS >= BUF_DROP_FULL_SCAN_THRESHOLD)
+    {
+        DropRelfileNodeShardBuffers(rnode, sid);
+        return;
+    }
+
+    for (i = 0; i < neids; i++)
+        DropRelfileNodeBlockRangeBuffers(rnode,
+                                         eids[i] * PAGES_PER_EXTENTS,
+                                         (eids[i] + 1) * PAGES_PER_EXTENTS,
+                                         sid);
+}
+
 void DropRelfileNodeShardBuffers(RelFileNode rnode, ShardID sid)
 {
     int            i;
@@ -3353,6 +3431,16 @@ void DropRelfileNodeExtentBuffers(RelFileNode rnode, ExtentID eid)
 
     /* if it's a local relation, skip it. */
 
+    /* a single extent is normally far cheaper to probe than to sweep for */
+    if ((uint64) PAGES_PER_EXTENTS < BUF_DROP_FULL_SCAN_THRESHOLD)
+    {
+        DropRelfileNodeBlockRangeBuffers(rnode,
+                                         eid * PAGES_PER_EXTENTS,
+                                         (eid + 1) * PAGES_PER_EXTENTS,
+                                         InvalidShardID);
+        return;
+    }
+
     for (i = 0; i < NBuffers; i++)
     {
         BufferDesc *bufHdr = GetBufferDescriptor(i);
@@ -688,6 +688,31 @@ eob_get_free_extent_and_set_busy(Relation rel)
                          errdetail("reloid:%d, block number:%d",
                                    RelationGetRelid(rel), blk)));
         }
+
+        /*
+         * Look for a free bit under a share lock first, so that concurrent
+         * allocators don't serialize on exclusive locks of EOB pages that
+         * are already full. The page is checked again below.
+         */
+        LockBuffer(buf, BUFFER_LOCK_SHARE);
+        pg = (EOBPage)PageGetContents(BufferGetPage(buf));
+        if(pg->n_bits > 0)
+        {
+            if(pg->first_empty_extent >= 0)
+                next_free = EOB_FIRSTFREE_IS_FREE(pg) ?
+                                pg->first_empty_extent :
+                                EOB_NEXT_FREE(pg, pg->first_empty_extent);
+            else
+                next_free = EOB_FIRST_FREE(pg);
+
+            if(next_free < 0)
+            {
+                UnlockReleaseBuffer(buf);
+                continue;
+            }
+            next_free = -1;
+        }
+        LockBuffer(buf, BUFFER_LOCK_UNLOCK);
         
         LockBuffer(buf, BUFFER_LOCK_EXCLUSIVE);
 
@@ -1106,9 +1106,30 @@ fsm_search_from_extent(Relation rel, uint8 min_cat, ExtentID eid)
 static BlockNumber
 fsm_search_with_shard(Relation rel, uint8 min_cat, ShardID sid)
 {
-    ExtentID    eid;
+    ExtentID    eid = InvalidExtentID;
     int         slot = -1;
     FSMAddress    addr;
+    BlockNumber    hint;
+
+    /*
+     * Try the extent holding the shard's current target block first. It is
+     * the extent this backend has been filling and usually still has room,
+     * and checking it only needs its EME and FSM page, whereas
+     * GetExtentWithFreeSpace takes the shard lock and walks the alloc list.
+     * The hint lives in smgr, so it is reset by smgr invalidation like the
+     * target block itself.
+     */
+    hint = RelationGetTargetBlock_Shard(rel, sid);
+    if(hint != InvalidBlockNumber)
+    {
+        bool    occupied = false;
+        ShardID    e_sid = InvalidShardID;
+
+        eid = hint / PAGES_PER_EXTENTS;
+        ema_get_eme_extract(rel, eid, &occupied, &e_sid, NULL, NULL);
+        if(occupied && e_sid == sid)
+            slot = fsm_search_from_extent(rel, min_cat, eid);
+    }
 
     while(slot < 0)
     {
@@ -34,6 +34,7 @@
 #include "postmaster/autovacuum.h"
 #include "postmaster/clean2pc.h"
 #include "postmaster/clustermon.h"
+#include "postmaster/netcalibrator.h"
 #include "postmaster/bgworker_internals.h"
 #include "postmaster/bgwriter.h"
 #include "postmaster/postmaster.h"
@@ -189,6 +190,9 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
         size = add_size(size, WalSndShmemSize());
         size = add_size(size, WalRcvShmemSize());
 		size = add_size(size, Clean2pcShmemSize());
+#ifdef __OPENTENBASE__
+		size = add_size(size, NetworkCalibrationShmemSize());
+#endif
 #ifdef XCP
         if (IS_PGXC_DATANODE)
             size = add_size(size, SharedQueueShmemSize());
@@ -366,6 +370,9 @@ CreateSharedMemoryAndSemaphores(bool makePrivate, int port)
     ApplyLauncherShmemInit();
 
 	Clean2pcShmemInit();
+#ifdef __OPENTENBASE__
+	NetworkCalibrationShmemInit();
+#endif
 
 #ifdef XCP
     /*
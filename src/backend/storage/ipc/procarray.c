@@ -3364,6 +3364,66 @@ GetCurrentVirtualXIDs(TransactionId limitXmin, bool excludeXmin0,
     return vxids;
 }
 
+#ifdef __SUPPORT_DISTRIBUTED_TRANSACTION__
+/*
+ * GetVirtualXIDsBeforeTs -- returns an array of the VXIDs of this database
+ * that run with a global snapshot older than limitTs.
+ *
+ * This is the global timestamp counterpart of GetCurrentVirtualXIDs: a
+ * backend serving a distributed query decides visibility by its start
+ * timestamp, which it publishes as tmin, so its local xmin says little
+ * about how old its view of the data is. Processes without a global
+ * snapshot and those matching excludeVacuum are skipped, as is our own.
+ * The array is palloc'd and the number of entries is returned in *nvxids.
+ */
+VirtualTransactionId *
+GetVirtualXIDsBeforeTs(GlobalTimestamp limitTs, int excludeVacuum,
+                       int *nvxids)
+{
+    VirtualTransactionId *vxids;
+    ProcArrayStruct *arrayP = procArray;
+    int            count = 0;
+    int            index;
+
+    vxids = (VirtualTransactionId *)
+        palloc(sizeof(VirtualTransactionId) * arrayP->maxProcs);
+
+    LWLockAcquire(ProcArrayLock, LW_SHARED);
+
+    for (index = 0; index < arrayP->numProcs; index++)
+    {
+        int            pgprocno = arrayP->pgprocnos[index];
+        volatile PGPROC *proc = &allProcs[pgprocno];
+        volatile PGXACT *pgxact = &allPgXact[pgprocno];
+        GlobalTimestamp ptmin;
+
+        if (proc == MyProc)
+            continue;
+
+        if (excludeVacuum & pgxact->vacuumFlags)
+            continue;
+
+        if (proc->databaseId != MyDatabaseId)
+            continue;
+
+        ptmin = pg_atomic_read_u64(&pgxact->tmin);
+        if (GlobalTimestampIsValid(ptmin) && ptmin < limitTs)
+        {
+            VirtualTransactionId vxid;
+
+            GET_VXID_FROM_PGPROC(vxid, *proc);
+            if (VirtualTransactionIdIsValid(vxid))
+                vxids[count++] = vxid;
+        }
+    }
+
+    LWLockRelease(ProcArrayLock);
+
+    *nvxids = count;
+    return vxids;
+}
+#endif
+
 /*
  * GetConflictingVirtualXIDs -- returns an array of currently active VXIDs.
  *
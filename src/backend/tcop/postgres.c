@@ -3116,7 +3116,7 @@ exec_execute_message(const char *portal_name, long max_rows)
 		    desc != NULL &&
 		    desc->myindex == -1)
 		{
-			SendLocalInstr(desc->planstate);
+			SendLocalInstr(desc->planstate, desc->dest);
 		}
 #endif
         /* Send appropriate CommandComplete to client */
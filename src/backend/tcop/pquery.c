@@ -51,6 +51,7 @@
 #include "commands/vacuum.h"
 #include "postmaster/postmaster.h"
 #include "optimizer/planmain.h"
+#include "libpq/pqformat.h"
 #endif
 
 #ifdef __OPENTENBASE__
@@ -266,7 +267,7 @@ ProcessQuery(PlannedStmt *plan,
 #ifdef __OPENTENBASE__
 	if (instrument && queryDesc->planstate)
 	{
-		SendLocalInstr(queryDesc->planstate);
+		SendLocalInstr(queryDesc->planstate, queryDesc->dest);
 	}
 #endif
 
@@ -866,6 +867,13 @@ PortalStart(Portal portal, ParamListInfo params,
                     {
                         SetProducerNodeMap(dest, nodeMap);
                     }
+
+                    if (queryDesc->plannedstmt->skewValues)
+                        SetProducerSkewValues(dest,
+                                queryDesc->plannedstmt->skewPolicy,
+                                queryDesc->plannedstmt->skewValues,
+                                queryDesc->plannedstmt->skewEqOp,
+                                consMap, len);
 #endif
                     queryDesc->dest = dest;
                 }
@@ -971,6 +979,21 @@ PortalStart(Portal portal, ParamListInfo params,
                             queryDesc->sender
 #endif
                                 );
+#ifdef __OPENTENBASE__
+                        if (queryDesc->plannedstmt->skewValues)
+                            SetProducerSkewValues(dest,
+                                    queryDesc->plannedstmt->skewPolicy,
+                                    queryDesc->plannedstmt->skewValues,
+                                    queryDesc->plannedstmt->skewEqOp,
+                                    consMap, len);
+
+                        if (queryDesc->plannedstmt->adaptivePolicy == ADAPTIVE_POLICY_BUILD ||
+                            queryDesc->plannedstmt->adaptivePolicy == ADAPTIVE_POLICY_PROBE_LOCAL)
+                            SetProducerAdaptivePolicy(dest,
+                                    queryDesc->plannedstmt->adaptivePolicy,
+                                    queryDesc->plannedstmt->distributionNodes,
+                                    consMap, len);
+#endif
                         queryDesc->dest = dest;
 
                         addProducingPortal(portal);
@@ -1407,11 +1430,29 @@ PortalRun(Portal portal, long count, bool isTopLevel, bool run_once,
                 {
                     if (portal->queryDesc->squeue)
                     {
+#ifdef __OPENTENBASE__
+                        bool redistributed = false;
+
+#endif
                         /* Make sure the producer is advancing */
                         while (count == 0 || nprocessed < count)
                         {
                             if (!portal->queryDesc->estate->es_finished)
                                 AdvanceProducingPortal(portal, false);
+#ifdef __OPENTENBASE__
+                            /*
+                             * Tell the parent early the tuples are not
+                             * broadcast, it may start the probe side of the
+                             * join right away then
+                             */
+                            if (!redistributed &&
+                                dest->mydest == DestRemoteExecute &&
+                                ProducerReceiverRedistributed(portal->queryDesc->dest))
+                            {
+                                pq_putemptymessage('j');
+                                redistributed = true;
+                            }
+#endif
                             /* make read pointer active */
                             tuplestore_select_read_pointer(portal->holdStore, 1);
                             /* perform reads */
@@ -1443,6 +1484,14 @@ PortalRun(Portal portal, long count, bool isTopLevel, bool run_once,
 #ifdef __OPENTENBASE__
                         if (portal->atEnd)
                         {
+                            /*
+                             * Tell the parent all tuples were broadcast, it
+                             * may keep the probe side of the join local then
+                             */
+                            if (dest->mydest == DestRemoteExecute &&
+                                ProducerReceiverBroadcast(portal->queryDesc->dest))
+                                pq_putemptymessage('J');
+
                             removeProducingPortal(portal);
                         }
 #endif
@@ -1471,6 +1520,10 @@ PortalRun(Portal portal, long count, bool isTopLevel, bool run_once,
                     SharedQueue        squeue = queryDesc->squeue;
                     int             myindex = queryDesc->myindex;
                     TupleTableSlot *slot;
+#ifdef __OPENTENBASE__
+                    bool            broadcast = false;
+                    bool            redistributed = false;
+#endif
 
                     if (squeue == NULL)
                     {
@@ -1534,10 +1587,22 @@ PortalRun(Portal portal, long count, bool isTopLevel, bool run_once,
                             }
                             else
                             {
+#ifdef __OPENTENBASE__
+                                broadcast = done && SharedQueueLastReadBroadcast();
+#endif
                                 queryDesc->squeue = NULL;
                                 break;
                             }
                         }
+#ifdef __OPENTENBASE__
+                        /* forward the early redistribution report of the producer */
+                        if (!redistributed && dest->mydest == DestRemoteExecute &&
+                            SharedQueueRedistributed(squeue))
+                        {
+                            pq_putemptymessage('j');
+                            redistributed = true;
+                        }
+#endif
                         /*
                          * Send the tuple
                          */
@@ -1556,6 +1621,12 @@ PortalRun(Portal portal, long count, bool isTopLevel, bool run_once,
 
                     ExecDropSingleTupleTableSlot(slot);
 
+#ifdef __OPENTENBASE__
+                    /* forward the broadcast report of the producer */
+                    if (broadcast && dest->mydest == DestRemoteExecute)
+                        pq_putemptymessage('J');
+#endif
+
                     if (nprocessed > 0)
                         portal->atStart = false;        /* OK to go backward now */
                     if (count == 0 ||
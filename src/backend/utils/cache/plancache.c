@@ -2157,11 +2157,16 @@ SetRemoteSubplan(CachedPlanSource *plansource, const char *plan_string)
     stmt->distributionNodes = rstmt->distributionNodes;
     stmt->distributionRestrict = rstmt->distributionRestrict;
 #ifdef __OPENTENBASE__
+    stmt->skewPolicy = rstmt->skewPolicy;
+    stmt->skewValues = rstmt->skewValues;
+    stmt->skewEqOp = rstmt->skewEqOp;
+    stmt->adaptivePolicy = rstmt->adaptivePolicy;
     stmt->parallelModeNeeded = rstmt->parallelModeNeeded;
 
     stmt->haspart_tobe_modify = rstmt->haspart_tobe_modify;
     stmt->partrelindex = rstmt->partrelindex;
     stmt->partpruning = rstmt->partpruning;
+    stmt->jitFlags = rstmt->jitFlags;
 
     HeavyLockCheck(NULL, stmt->commandType, NULL, NULL);
 #endif
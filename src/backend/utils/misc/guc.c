@@ -89,6 +89,7 @@
 #include "postmaster/bgworker_internals.h"
 #include "postmaster/bgwriter.h"
 #include "postmaster/clean2pc.h"
+#include "postmaster/netcalibrator.h"
 #include "postmaster/postmaster.h"
 #include "postmaster/syslogger.h"
 #include "postmaster/walwriter.h"
@@ -151,6 +152,10 @@
 #ifdef __COLD_HOT__
 #include "utils/ruleutils.h"
 #include "executor/nodeAgg.h"
+#include "executor/nodeHashjoin.h"
+#include "executor/nodeSeqscan.h"
+#include "executor/producerReceiver.h"
+#include "jit/jit.h"
 #include "catalog/pg_partition_interval.h"
 #endif
 
@@ -185,6 +190,7 @@ extern char *default_tablespace;
 extern char *temp_tablespaces;
 extern bool ignore_checksum_failure;
 extern bool synchronize_seqscans;
+extern int    seqscan_prefetch_pages;
 extern bool enable_cold_hot_router_print;
 #ifdef _PUB_SUB_RELIABLE_
 static char * g_wal_stream_type_str;
@@ -1146,6 +1152,67 @@ static struct config_bool ConfigureNamesBool[] =
 		true,
 		NULL, NULL, NULL
 	},
+#ifdef __OPENTENBASE__
+	{
+		{"enable_hashjoin_bloom_filter", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables runtime Bloom filters on multi-batch hash joins."),
+			gettext_noop("Outer tuples whose join key cannot match any inner "
+						 "tuple are dropped instead of being spilled to a batch file.")
+		},
+		&enable_hashjoin_bloom_filter,
+		false,
+		NULL, NULL, NULL
+	},
+	{
+		{"enable_seqscan_batch_filter", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables page-at-a-time evaluation of simple sequential scan quals."),
+			gettext_noop("Quals comparing a column with a constant are applied "
+						 "by the heap access method to all tuples of a page at once.")
+		},
+		&enable_seqscan_batch_filter,
+		false,
+		NULL, NULL, NULL
+	},
+	{
+		{"enable_network_calibration", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables costing data movement with measured network performance."),
+			gettext_noop("Network and remote query costs are scaled by the bandwidth "
+						 "and latency measured for the links a plan sends data over.")
+		},
+		&enable_network_calibration,
+		false,
+		NULL, NULL, NULL
+	},
+	{
+		{"jit", PGC_USERSET, QUERY_TUNING_OTHER,
+			gettext_noop("Allow JIT compilation."),
+			NULL
+		},
+		&jit_enabled,
+		false,
+		NULL, NULL, NULL
+	},
+	{
+		{"jit_expressions", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Allow JIT compilation of expressions."),
+			NULL,
+			GUC_NOT_IN_SAMPLE
+		},
+		&jit_expressions,
+		true,
+		NULL, NULL, NULL
+	},
+	{
+		{"jit_tuple_deforming", PGC_USERSET, DEVELOPER_OPTIONS,
+			gettext_noop("Allow JIT compilation of tuple deforming."),
+			NULL,
+			GUC_NOT_IN_SAMPLE
+		},
+		&jit_tuple_deforming,
+		true,
+		NULL, NULL, NULL
+	},
+#endif
 #ifdef PGXC
     {
         {"enable_fast_query_shipping", PGC_USERSET, QUERY_TUNING_METHOD,
@@ -1217,6 +1284,24 @@ static struct config_bool ConfigureNamesBool[] =
 		false,
 		NULL, NULL, NULL
 	},
+	{
+		{"enable_partition_wise_agg", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables partition-wise aggregation."),
+			NULL
+		},
+		&enable_partition_wise_agg,
+		false,
+		NULL, NULL, NULL
+	},
+	{
+		{"enable_partition_wise_hashjoin", PGC_USERSET, QUERY_TUNING_METHOD,
+			gettext_noop("Enables partition-wise hash join of interval partitioned tables."),
+			NULL
+		},
+		&enable_partition_wise_hashjoin,
+		false,
+		NULL, NULL, NULL
+	},
 
     {
         {"geqo", PGC_USERSET, QUERY_TUNING_GEQO,
@@ -2277,6 +2362,17 @@ static struct config_bool ConfigureNamesBool[] =
         NULL, NULL, NULL
     },
 
+    {
+        {"transform_insert_to_copy_binary", PGC_USERSET, CUSTOM_OPTIONS,
+            gettext_noop("ship rows of insert into multi-values transformed to copy from in binary format."),
+            gettext_noop("The coordinator sends the evaluated values to datanodes instead of the original literals, "
+                         "so datanodes skip text input parsing. Only built-in column types are shipped in binary.")
+        },
+        &g_transform_insert_to_copy_binary,
+        true,
+        NULL, NULL, NULL
+    },
+
     {
         {"set_global_snapshot", PGC_USERSET, CUSTOM_OPTIONS,
             gettext_noop("always use global snapshot for query"),
@@ -2297,6 +2393,26 @@ static struct config_bool ConfigureNamesBool[] =
         NULL, NULL, NULL
     },
 
+    {
+        {"enable_skew_redistribution", PGC_USERSET, CUSTOM_OPTIONS,
+            gettext_noop("spread rows of hot join key values when redistributing both sides of a join."),
+            NULL
+        },
+        &enable_skew_redistribution,
+        false,
+        NULL, NULL, NULL
+    },
+
+    {
+        {"enable_adaptive_broadcast", PGC_USERSET, CUSTOM_OPTIONS,
+            gettext_noop("decide at runtime whether to broadcast the inner side of a hash join or to redistribute both sides."),
+            NULL
+        },
+        &enable_adaptive_broadcast,
+        false,
+        NULL, NULL, NULL
+    },
+
 	{
 		{"hybrid_hash_agg", PGC_USERSET, CUSTOM_OPTIONS,
 			gettext_noop("enable hybrid-hash agg."),
@@ -3631,6 +3747,18 @@ static struct config_int ConfigureNamesInt[] =
         check_wal_buffers, NULL, NULL
     },
 
+    {
+        {"wal_insert_locks", PGC_POSTMASTER, WAL_SETTINGS,
+            gettext_noop("Sets the number of locks used for concurrent WAL insertion."),
+            gettext_noop("More locks let more backends copy records into the WAL "
+                         "buffers at the same time, but make WAL flushes slightly "
+                         "more expensive.")
+        },
+        &num_xloginsert_locks,
+        8, 1, 128,
+        NULL, NULL, NULL
+    },
+
     {
         {"wal_writer_delay", PGC_SIGHUP, WAL_SETTINGS,
             gettext_noop("Time between WAL flushes performed in the WAL writer."),
@@ -3805,6 +3933,23 @@ static struct config_int ConfigureNamesInt[] =
         check_effective_io_concurrency, assign_effective_io_concurrency, NULL
     },
 
+    {
+        {"seqscan_prefetch_pages",
+            PGC_USERSET,
+            RESOURCES_ASYNCHRONOUS,
+            gettext_noop("Number of pages sequential scans and ANALYZE prefetch ahead of the page being read."),
+            gettext_noop("Zero disables prefetching, leaving read-ahead to the kernel."),
+            GUC_UNIT_BLOCKS
+        },
+        &seqscan_prefetch_pages,
+#ifdef USE_PREFETCH
+        0, 0, 4096,
+#else
+        0, 0, 0,
+#endif
+        NULL, NULL, NULL
+    },
+
     {
         {"backend_flush_after", PGC_USERSET, RESOURCES_ASYNCHRONOUS,
             gettext_noop("Number of pages after which previously performed writes are flushed to disk."),
@@ -3892,6 +4037,15 @@ static struct config_int ConfigureNamesInt[] =
 		300, 3, INT_MAX,
         NULL, NULL, NULL
     },
+    {
+        {"shard_statistic_select_sample", PGC_SIGHUP, STATS_COLLECTOR,
+            gettext_noop("Counts one of every N scanned tuples in shard statistic."),
+            gettext_noop("1 counts every tuple.")
+        },
+        &g_ShardInfoSelectSample,
+        1, 1, 10000,
+        NULL, NULL, NULL
+    },
 
     {
         {"interval_sample_threshold", PGC_USERSET, RESOURCES,
@@ -4240,6 +4394,16 @@ static struct config_int ConfigureNamesInt[] =
         NULL, NULL, NULL
     },
 
+    {
+        {"max_parallel_maintenance_workers", PGC_USERSET, RESOURCES_ASYNCHRONOUS,
+            gettext_noop("Sets the maximum number of parallel processes per maintenance operation."),
+            NULL
+        },
+        &max_parallel_maintenance_workers,
+        2, 0, MAX_PARALLEL_WORKER_LIMIT,
+        NULL, NULL, NULL
+    },
+
     {
         {"autovacuum_work_mem", PGC_SIGHUP, RESOURCES_MEM,
             gettext_noop("Sets the maximum memory to be used by each autovacuum worker process."),
@@ -4728,6 +4892,27 @@ static struct config_int ConfigureNamesInt[] =
         32, 0, INT_MAX,
         NULL, NULL, NULL
     },
+    {
+        {"network_calibration_interval", PGC_SIGHUP, CUSTOM_OPTIONS,
+            gettext_noop("Time between network calibration runs on coordinators."),
+            gettext_noop("Zero disables calibration."),
+            GUC_UNIT_S
+        },
+        &network_calibration_interval,
+        60, 0, INT_MAX / 1000,
+        NULL, NULL, NULL
+    },
+    {
+        {"adaptive_broadcast_threshold", PGC_USERSET, CUSTOM_OPTIONS,
+            gettext_noop("Output size below which a hash join build side is broadcast."),
+            gettext_noop("Producers of a join marked for adaptive broadcast buffer up to "
+                         "this much output before deciding to redistribute it."),
+            GUC_UNIT_KB
+        },
+        &adaptive_broadcast_threshold,
+        8192, 0, MAX_KILOBYTES,
+        NULL, NULL, NULL
+    },
 
     {
         {"replication_level", PGC_USERSET, CUSTOM_OPTIONS,
@@ -5050,6 +5235,35 @@ static struct config_real ConfigureNamesReal[] =
         DEFAULT_PARALLEL_SETUP_COST, 0, DBL_MAX,
         NULL, NULL, NULL
     },
+#ifdef __OPENTENBASE__
+    {
+        {"jit_above_cost", PGC_USERSET, QUERY_TUNING_COST,
+            gettext_noop("Perform JIT compilation if query is more expensive."),
+            gettext_noop("-1 disables JIT compilation.")
+        },
+        &jit_above_cost,
+        100000, -1, DBL_MAX,
+        NULL, NULL, NULL
+    },
+    {
+        {"jit_optimize_above_cost", PGC_USERSET, QUERY_TUNING_COST,
+            gettext_noop("Optimize JITed functions if query is more expensive."),
+            gettext_noop("-1 disables optimization.")
+        },
+        &jit_optimize_above_cost,
+        500000, -1, DBL_MAX,
+        NULL, NULL, NULL
+    },
+    {
+        {"jit_inline_above_cost", PGC_USERSET, QUERY_TUNING_COST,
+            gettext_noop("Perform JIT inlining if query is more expensive."),
+            gettext_noop("-1 disables inlining.")
+        },
+        &jit_inline_above_cost,
+        500000, -1, DBL_MAX,
+        NULL, NULL, NULL
+    },
+#endif
 
     {
         {"cursor_tuple_fraction", PGC_USERSET, QUERY_TUNING_OTHER,
@@ -5154,6 +5368,18 @@ static struct config_real ConfigureNamesReal[] =
         NULL, NULL, NULL
     },
 
+#ifdef __OPENTENBASE__
+    {
+        {"skew_redistribution_threshold", PGC_USERSET, CUSTOM_OPTIONS,
+            gettext_noop("minimal frequency of a join key value to be handled as hot by skew redistribution."),
+            NULL
+        },
+        &skew_redistribution_threshold,
+        0.1, 0.0, 1.0,
+        NULL, NULL, NULL
+    },
+#endif
+
     /* End-of-list marker */
     {
         {NULL, 0, 0, NULL, NULL}, NULL, 0.0, 0.0, 0.0, NULL, NULL, NULL
@@ -5369,6 +5595,19 @@ static struct config_string ConfigureNamesString[] =
         NULL, NULL, NULL
     },
 
+#ifdef __OPENTENBASE__
+    {
+        {"jit_provider", PGC_POSTMASTER, CLIENT_CONN_PRELOAD,
+            gettext_noop("JIT provider to use."),
+            NULL,
+            GUC_SUPERUSER_ONLY
+        },
+        &jit_provider,
+        "llvmjit",
+        NULL, NULL, NULL
+    },
+#endif
+
     {
         {"search_path", PGC_USERSET, CLIENT_CONN_STATEMENT,
             gettext_noop("Sets the schema search order for names that are not schema-qualified."),
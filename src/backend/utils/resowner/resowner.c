@@ -25,6 +25,7 @@
 #include "access/hash.h"
 #ifdef PGXC
 #include "commands/prepare.h"
+#include "jit/jit.h"
 #endif
 #include "storage/predicate.h"
 #include "storage/proc.h"
@@ -129,6 +130,7 @@ typedef struct ResourceOwnerData
     ResourceArray snapshotarr;    /* snapshot references */
     ResourceArray filearr;        /* open temporary files */
     ResourceArray dsmarr;        /* dynamic shmem segments */
+    ResourceArray jitarr;        /* JIT contexts */
     ResourceArray prepstmts;    /* prepared statements */
 
     /* We can remember up to MAX_RESOWNER_LOCKS references to local locks. */
@@ -517,6 +519,7 @@ ResourceOwnerCreate(ResourceOwner parent, const char *name)
     ResourceArrayInit(&(owner->snapshotarr), PointerGetDatum(NULL));
     ResourceArrayInit(&(owner->filearr), FileGetDatum(-1));
     ResourceArrayInit(&(owner->dsmarr), PointerGetDatum(NULL));
+    ResourceArrayInit(&(owner->jitarr), PointerGetDatum(NULL));
 
     return owner;
 }
@@ -636,6 +639,14 @@ ResourceOwnerReleaseInternal(ResourceOwner owner,
                 PrintDSMLeakWarning(res);
             dsm_detach(res);
         }
+
+        /* Ditto for JIT contexts */
+        while (ResourceArrayGetAny(&(owner->jitarr), &foundres))
+        {
+            JitContext *context = (JitContext *) DatumGetPointer(foundres);
+
+            jit_release_context(context);
+        }
     }
     else if (phase == RESOURCE_RELEASE_LOCKS)
     {
@@ -794,6 +805,7 @@ ResourceOwnerDelete(ResourceOwner owner)
     Assert(owner->snapshotarr.nitems == 0);
     Assert(owner->filearr.nitems == 0);
     Assert(owner->dsmarr.nitems == 0);
+    Assert(owner->jitarr.nitems == 0);
     Assert(owner->nlocks == 0 || owner->nlocks == MAX_RESOWNER_LOCKS + 1);
 
     /*
@@ -820,6 +832,7 @@ ResourceOwnerDelete(ResourceOwner owner)
     ResourceArrayFree(&(owner->snapshotarr));
     ResourceArrayFree(&(owner->filearr));
     ResourceArrayFree(&(owner->dsmarr));
+    ResourceArrayFree(&(owner->jitarr));
     ResourceArrayFree(&(owner->prepstmts));
 
     pfree(owner);
@@ -1411,6 +1424,41 @@ ResourceOwnerForgetDSM(ResourceOwner owner, dsm_segment *seg)
              dsm_segment_handle(seg), owner->name);
 }
 
+/*
+ * Make sure there is room for at least one more entry in a ResourceOwner's
+ * JIT context reference array.
+ *
+ * This is separate from actually inserting an entry because if we run out of
+ * memory, it's critical to do so *before* acquiring the resource.
+ */
+void
+ResourceOwnerEnlargeJIT(ResourceOwner owner)
+{
+    ResourceArrayEnlarge(&(owner->jitarr));
+}
+
+/*
+ * Remember that a JIT context is owned by a ResourceOwner
+ *
+ * Caller must have previously done ResourceOwnerEnlargeJIT()
+ */
+void
+ResourceOwnerRememberJIT(ResourceOwner owner, Datum handle)
+{
+    ResourceArrayAdd(&(owner->jitarr), handle);
+}
+
+/*
+ * Forget that a JIT context is owned by a ResourceOwner
+ */
+void
+ResourceOwnerForgetJIT(ResourceOwner owner, Datum handle)
+{
+    if (!ResourceArrayRemove(&(owner->jitarr), handle))
+        elog(ERROR, "JIT context %p is not owned by resource owner %s",
+             DatumGetPointer(handle), owner->name);
+}
+
 /*
  * Debugging subroutine
  */
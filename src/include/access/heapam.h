@@ -85,6 +85,8 @@ typedef struct HeapUpdateFailureData
  */
 
 /* in heap/heapam.c */
+extern int    seqscan_prefetch_pages;
+
 extern Relation relation_open(Oid relationId, LOCKMODE lockmode);
 extern Relation try_relation_open(Oid relationId, LOCKMODE lockmode);
 extern Relation relation_openrv(const RangeVar *relation, LOCKMODE lockmode);
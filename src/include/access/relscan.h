@@ -75,6 +75,7 @@ typedef struct HeapScanDescData
     BlockNumber rs_cblock;        /* current block # in scan, if any */
     Buffer        rs_cbuf;        /* current buffer in scan, if any */
     /* NB: if rs_cbuf is not InvalidBuffer, we hold a pin on that buffer */
+    BlockNumber rs_prefetch_next;    /* next block to prefetch, if any */
     ParallelHeapScanDesc rs_parallel;    /* parallel scan information */
 
 #ifdef __SUPPORT_DISTRIBUTED_TRANSACTION__
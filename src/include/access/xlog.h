@@ -107,6 +107,7 @@ extern int    min_wal_size_mb;
 extern int    max_wal_size_mb;
 extern int    wal_keep_segments;
 extern int    XLOGbuffers;
+extern int    num_xloginsert_locks;
 extern int    XLogArchiveTimeout;
 extern int    wal_retrieve_retry_interval;
 extern char *XLogArchiveCommand;
@@ -552,8 +552,10 @@ DATA(insert OID = 682 (  "@"       PGNSP PGUID l f f     0    21    21     0
 DESCR("absolute value");
 DATA(insert OID = 684 (  "+"       PGNSP PGUID b f f    20    20    20 684     0 int8pl - - ));
 DESCR("add");
+#define Int8PlusOperator    684
 DATA(insert OID = 685 (  "-"       PGNSP PGUID b f f    20    20    20     0     0 int8mi - - ));
 DESCR("subtract");
+#define Int8MinusOperator    685
 DATA(insert OID = 686 (  "*"       PGNSP PGUID b f f    20    20    20 686     0 int8mul - - ));
 DESCR("multiply");
 DATA(insert OID = 687 (  "/"       PGNSP PGUID b f f    20    20    20     0     0 int8div - - ));
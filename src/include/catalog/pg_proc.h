@@ -6782,6 +6782,10 @@ DATA(insert OID = 4619 (  vacuum_hidden_shards    PGNSP PGUID 12 1 0 0 0 f f f f
 DESCR("vacuum hidden shards");
 DATA(insert OID = 4620 (  opentenbase_shard_statistic PGNSP PGUID 12 1 0 0 0 f f f f t t v r 0 0 2249 "" "{25,25,23,20,20,20,20,20,20}" "{o,o,o,o,o,o,o,o,o}" "{group_name,node_name,shard_id,ntups_select,ntups_insert,ntups_update,ntups_delete,size,ntups}" _null_ _null_ opentenbase_shard_statistic _null_ _null_ _null_ ));
 DESCR("show statistic data of all shards");
+DATA(insert OID = 4631 (  opentenbase_shard_rebalance_plan PGNSP PGUID 12 1 100 0 0 f f f f t t v r 3 0 2249 "25 25 701" "{25,25,701,23,25,25,20}" "{i,i,i,o,o,o,o}" "{group_name,metric,max_imbalance,shard_id,from_node,to_node,load}" _null_ _null_ opentenbase_shard_rebalance_plan _null_ _null_ _null_ ));
+DESCR("plan shard moves that balance the load of the datanodes of a group");
+DATA(insert OID = 4632 (  pg_network_calibration PGNSP PGUID 12 1 1000 0 0 f f f f t t v r 0 0 2249 "" "{25,25,701,701,701,1184}" "{o,o,o,o,o,o}" "{source_node,target_node,bandwidth,latency,throughput,last_update}" _null_ _null_ pg_network_calibration _null_ _null_ _null_ ));
+DESCR("show measured network and datanode performance");
 
 DATA(insert OID = 4628 (  opentenbase_set_need_mvcc PGNSP PGUID 12 1 0 0 0 f f f f t f v r 1 0 16 "23" _null_ _null_ _null_ _null_ _null_ opentenbase_set_need_mvcc _null_ _null_ _null_ ));
 DESCR("set need_mvcc flag");
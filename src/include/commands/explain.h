@@ -89,6 +89,9 @@ extern void ExplainOnePlan(PlannedStmt *plannedstmt, IntoClause *into,
 
 extern void ExplainPrintPlan(ExplainState *es, QueryDesc *queryDesc);
 extern void ExplainPrintTriggers(ExplainState *es, QueryDesc *queryDesc);
+#ifdef __OPENTENBASE__
+extern void ExplainPrintJIT(ExplainState *es, QueryDesc *queryDesc);
+#endif
 
 extern void ExplainQueryText(ExplainState *es, QueryDesc *queryDesc);
 
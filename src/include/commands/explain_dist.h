@@ -41,6 +41,9 @@ typedef struct RemoteInstr
 	
 	/* for Hash */
 	HashInstrumentation hash_stat;
+	
+	/* for fragment root and RemoteSubplan */
+	FragmentInstrumentation fragment;
 } RemoteInstr;
 
 typedef struct AttachRemoteInstrContext
@@ -50,7 +53,7 @@ typedef struct AttachRemoteInstrContext
 	Bitmapset   *printed_nodes;     /* ids of plan nodes we've handled */
 } AttachRemoteInstrContext;
 
-extern void SendLocalInstr(PlanState *planstate);
+extern void SendLocalInstr(PlanState *planstate, DestReceiver *dest);
 extern void HandleRemoteInstr(char *msg_body, size_t len, int nodeid, ResponseCombiner *combiner);
 extern bool AttachRemoteInstr(PlanState *planstate, AttachRemoteInstrContext *ctx);
 extern void ExplainCommonRemoteInstr(PlanState *planstate, ExplainState *es);
@@ -23,9 +23,12 @@
 #include "catalog/pg_type.h"
 #include "executor/executor.h"
 #include "nodes/parsenodes.h"
+#include "port/atomics.h"
 #include "storage/buf.h"
+#include "storage/dsm.h"
 #include "storage/lock.h"
 #include "storage/relfilenode.h"
+#include "storage/shm_toc.h"
 #include "utils/relcache.h"
 #include "pgxc/planner.h"
 
@@ -265,6 +268,11 @@ extern void vacuum_set_xid_limits(Relation rel,
                       MultiXactId *mxactFullScanLimit);
 extern void vac_update_datfrozenxid(void);
 extern void vacuum_delay_point(void);
+#ifdef __OPENTENBASE__
+extern pg_atomic_uint32 *VacuumSharedCostBalance;
+extern pg_atomic_uint32 *VacuumActiveNWorkers;
+extern int	VacuumCostBalanceLocal;
+#endif
 #ifdef XCP
 extern void vacuum_rel_coordinator(Relation onerel, bool is_outer, VacuumParams *params, StatSyncOpt *syncOpt);
 TargetEntry *make_relation_tle(Oid reloid, const char *relname, const char *column);
@@ -273,12 +281,17 @@ TargetEntry *make_relation_tle(Oid reloid, const char *relname, const char *colu
 /* in commands/vacuumlazy.c */
 extern void lazy_vacuum_rel(Relation onerel, int options,
                 VacuumParams *params, BufferAccessStrategy bstrategy);
+#ifdef __OPENTENBASE__
+extern void parallel_vacuum_main(dsm_segment *seg, shm_toc *toc);
+#endif
 #ifdef _SHARDING_
 extern void truncate_extent_tuples(Relation onerel, 
                             BlockNumber     from_blk, 
                             BlockNumber to_blk, 
                             bool cleanpage, 
                             int *deleted_tuples);
+extern int64 truncate_extents_index_tuples(Relation onerel, ExtentID *eids,
+                            int neids);
 extern void reinit_extent_pages(Relation rel, ExtentID eid);
 extern void xlog_reinit_extent_pages(RelFileNode rnode, ExtentID eid);
 extern void ExecVacuumShard(VacuumShardStmt *stmt);
@@ -19,6 +19,9 @@
 
 #include "nodes/execnodes.h"
 #include "storage/buffile.h"
+#ifdef __OPENTENBASE__
+#include "lib/bloomfilter.h"
+#endif
 
 /* ----------------------------------------------------------------
  *                hash-join hash table structures
@@ -200,6 +203,21 @@ typedef struct HashJoinTableData
 
     /* used for dense allocation of tuples (into linked chunks) */
     HashMemoryChunk chunks;        /* one list for the whole batch */
+
+#ifdef __OPENTENBASE__
+    /*
+     * Runtime join filter.  Once the inner relation no longer fits in one
+     * batch, the hash values of all inner tuples are also added to a Bloom
+     * filter, so that outer tuples which cannot match are dropped before
+     * they are written to an outer batch file.  The parent join sets
+     * useBloomFilter if it is allowed to drop unmatched outer tuples.
+     */
+    bool        useBloomFilter;    /* may build a runtime join filter */
+    double        bloomPlanRows;    /* planner's estimate of inner tuples */
+    bloom_filter *bloomFilter;    /* NULL if not built (yet) */
+    double        bloomChecked;    /* # outer tuples tested */
+    double        bloomRemoved;    /* # outer tuples dropped by the filter */
+#endif
 }            HashJoinTableData;
 
 #endif                            /* HASHJOIN_H */
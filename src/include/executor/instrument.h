@@ -73,10 +73,24 @@ typedef struct WorkerInstrumentation
 } WorkerInstrumentation;
 
 #ifdef __OPENTENBASE__
+/*
+ * Wall-clock breakdown of a plan fragment's data exchange, collected under
+ * EXPLAIN ANALYZE. Times are in seconds, like Instrumentation.total.
+ */
+typedef struct FragmentInstrumentation
+{
+	bool    valid;              /* true if anything below was collected */
+	double  recv_time;          /* time waiting for tuples from other nodes */
+	double  send_time;          /* time handing tuples to consumers */
+	double  send_tuples;        /* tuples sent to other nodes */
+	double  spill_tuples;       /* tuples buffered locally, consumer was full */
+} FragmentInstrumentation;
+
 typedef struct RemoteInstrumentation
 {
 	int              nodeid;    /* which datanode the instrument comes from */
 	Instrumentation  instr;     /* the instrumentation */
+	FragmentInstrumentation fragment;   /* data exchange time of the node */
 } RemoteInstrumentation;
 
 typedef struct DatanodeInstrumentation
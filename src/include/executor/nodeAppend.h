@@ -20,4 +20,12 @@ extern AppendState *ExecInitAppend(Append *node, EState *estate, int eflags);
 extern void ExecEndAppend(AppendState *node);
 extern void ExecReScanAppend(AppendState *node);
 
+#ifdef __OPENTENBASE__
+extern List *ExecInitIntervalPruning(PlanState *parent, List *prunequals);
+extern bool ExecIntervalPruning(PlanState *parent, List *prunequals,
+                    List *pruneexprs, List *subplans, bool startup,
+                    MemoryContext cxt, Bitmapset **children);
+extern bool ExecIntervalPruneHasExecParams(List *prunequals);
+#endif
+
 #endif                            /* NODEAPPEND_H */
@@ -28,8 +28,9 @@ extern void ExecReScanHash(HashState *node);
 extern HashJoinTable ExecHashTableCreate(Hash *node, List *hashOperators,
 					bool keepNulls);
 #ifdef __OPENTENBASE__
+extern bool ExecHashBloomFilterRejects(HashJoinTable hashtable, uint32 hashvalue);
 extern HashJoinTable ExecShmHashTableCreate(Hash *node, List *hashOperators,
-					bool keepNulls);
+					bool keepNulls, int nworkers);
 extern Node *MultiExecShmHash(HashState *node);
 #endif
 
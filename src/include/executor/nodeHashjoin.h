@@ -30,6 +30,8 @@ extern void ExecReScanHashJoin(HashJoinState *node);
 extern void ExecHashJoinSaveTuple(MinimalTuple tuple, uint32 hashvalue,
                       BufFile **fileptr);
 #ifdef __OPENTENBASE__
+extern bool enable_hashjoin_bloom_filter;
+
 extern void ExecParallelHashJoinEstimate(HashJoinState *node, ParallelContext *pcxt);
 
 extern void ExecParallelHashJoinInitializeDSM(HashJoinState *node, ParallelContext *pcxt);
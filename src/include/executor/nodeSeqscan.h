@@ -20,6 +20,10 @@
 #include "access/parallel.h"
 #include "nodes/execnodes.h"
 
+#ifdef __OPENTENBASE__
+extern bool enable_seqscan_batch_filter;
+#endif
+
 extern SeqScanState *ExecInitSeqScan(SeqScan *node, EState *estate, int eflags);
 extern void ExecEndSeqScan(SeqScanState *node);
 extern void ExecReScanSeqScan(SeqScanState *node);
@@ -15,6 +15,7 @@
 #define PRODUCER_RECEIVER_H
 
 #include "tcop/dest.h"
+#include "executor/instrument.h"
 #include "pgxc/locator.h"
 #include "pgxc/squeue.h"
 
@@ -37,5 +38,17 @@ extern bool ProducerReceiverPushBuffers(DestReceiver *self);
 
 #ifdef __OPENTENBASE__
 extern void SetProducerNodeMap(DestReceiver *self, int16 *nodemap);
+extern void GetProducerFragmentInstr(DestReceiver *self,
+                                     FragmentInstrumentation *instr);
+extern void SetProducerSkewValues(DestReceiver *self, char skewPolicy,
+                                  List *skewValues, Oid skewEqOp,
+                                  int *consMap, int len);
+extern void SetProducerAdaptivePolicy(DestReceiver *self, char adaptivePolicy,
+                                      List *distributionNodes,
+                                      int *consMap, int len);
+extern bool ProducerReceiverBroadcast(DestReceiver *self);
+extern bool ProducerReceiverRedistributed(DestReceiver *self);
+
+extern int adaptive_broadcast_threshold;
 #endif
 #endif   /* PRODUCER_RECEIVER_H */
@@ -0,0 +1,92 @@
+/*-------------------------------------------------------------------------
+ *
+ * jit.h
+ *      Provider independent JIT infrastructure.
+ *
+ * Portions Copyright (c) 1996-2017, PostgreSQL Global Development Group
+ *
+ * This source code file contains modifications made by THL A29 Limited ("Tencent Modifications").
+ * All Tencent Modifications are Copyright (C) 2023 THL A29 Limited.
+ *
+ * src/include/jit/jit.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef JIT_H
+#define JIT_H
+
+#include "portability/instr_time.h"
+#include "utils/resowner.h"
+
+
+/* Flags determining what kind of JIT operations to perform */
+#define PGJIT_NONE     0
+#define PGJIT_PERFORM  (1 << 0)
+#define PGJIT_OPT3     (1 << 1)
+#define PGJIT_INLINE   (1 << 2)
+#define PGJIT_EXPR     (1 << 3)
+#define PGJIT_DEFORM   (1 << 4)
+
+
+typedef struct JitInstrumentation
+{
+    /* number of emitted functions */
+    size_t        created_functions;
+
+    /* accumulated time to generate code */
+    instr_time    generation_counter;
+
+    /* accumulated time for optimization */
+    instr_time    optimization_counter;
+
+    /* accumulated time for code emission */
+    instr_time    emission_counter;
+} JitInstrumentation;
+
+typedef struct JitContext
+{
+    /* see PGJIT_* above */
+    int            flags;
+
+    /* resowner responsible for cleanup */
+    ResourceOwner resowner;
+
+    JitInstrumentation instr;
+} JitContext;
+
+typedef struct JitProviderCallbacks JitProviderCallbacks;
+
+struct ExprState;
+
+extern void _PG_jit_provider_init(JitProviderCallbacks *cb);
+typedef void (*JitProviderInit) (JitProviderCallbacks *cb);
+typedef void (*JitProviderReleaseContextCB) (JitContext *context);
+typedef bool (*JitProviderCompileExprCB) (struct ExprState *state);
+
+struct JitProviderCallbacks
+{
+    JitProviderReleaseContextCB release_context;
+    JitProviderCompileExprCB compile_expr;
+};
+
+
+/* GUCs */
+extern bool jit_enabled;
+extern char *jit_provider;
+extern bool jit_expressions;
+extern bool jit_tuple_deforming;
+extern double jit_above_cost;
+extern double jit_inline_above_cost;
+extern double jit_optimize_above_cost;
+
+
+extern void jit_release_context(JitContext *context);
+
+/*
+ * Functions for JITing code by providers.  If the provider can't (or
+ * doesn't want to) JIT the given object, false is returned and the caller
+ * has to fall back to interpretation.
+ */
+extern bool jit_compile_expr(struct ExprState *state);
+
+#endif                            /* JIT_H */
@@ -0,0 +1,217 @@
+/*-------------------------------------------------------------------------
+ *
+ * llvmjit.h
+ *      LLVM JIT provider.
+ *
+ * Only the LLVM-C API is used, so the provider doesn't need a C++ compiler.
+ * Generated code refers to backend functions and data by embedding their
+ * addresses as constants, which avoids having to resolve symbols in the
+ * JITed code.
+ *
+ * Portions Copyright (c) 1996-2017, PostgreSQL Global Development Group
+ *
+ * This source code file contains modifications made by THL A29 Limited ("Tencent Modifications").
+ * All Tencent Modifications are Copyright (C) 2023 THL A29 Limited.
+ *
+ * src/include/jit/llvmjit.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef LLVMJIT_H
+#define LLVMJIT_H
+
+#include <llvm-c/Core.h>
+#include <llvm-c/LLJIT.h>
+
+#include "access/tupdesc.h"
+#include "jit/jit.h"
+#include "nodes/pg_list.h"
+
+
+typedef struct LLVMJitContext
+{
+    JitContext    base;
+
+    /* LLJIT instance the code of this context is emitted into */
+    LLVMOrcLLJITRef lljit;
+
+    /* tracks all code emitted for this context, so it can be released */
+    LLVMOrcResourceTrackerRef resource_tracker;
+
+    /* already emitted tuple deforming functions, list of LLVMJitDeform */
+    List       *deform_functions;
+} LLVMJitContext;
+
+/* a tuple deforming function for a (descriptor, natts) combination */
+typedef struct LLVMJitDeform
+{
+    TupleDesc    desc;
+    int            natts;
+    void       *func;
+} LLVMJitDeform;
+
+
+/* type and struct definitions */
+extern LLVMContextRef llvm_context;
+extern LLVMTypeRef TypeVoid;
+extern LLVMTypeRef TypeParamBool;
+extern LLVMTypeRef TypeStorageBool;
+extern LLVMTypeRef TypeInt8;
+extern LLVMTypeRef TypeInt16;
+extern LLVMTypeRef TypeInt32;
+extern LLVMTypeRef TypeInt64;
+extern LLVMTypeRef TypeSizeT;
+extern LLVMTypeRef TypeDatum;
+extern LLVMTypeRef TypePtr;
+
+
+extern LLVMJitContext *llvm_create_context(int jitFlags);
+extern LLVMModuleRef llvm_create_module(LLVMJitContext *context);
+extern char *llvm_expand_funcname(LLVMJitContext *context, const char *basename);
+extern void llvm_emit_module(LLVMJitContext *context, LLVMModuleRef module);
+extern void *llvm_get_function(LLVMJitContext *context, const char *funcname);
+
+extern bool llvm_compile_expr(struct ExprState *state);
+extern LLVMValueRef slot_compile_deform(LLVMJitContext *context,
+                    LLVMModuleRef mod, TupleDesc desc, int natts,
+                    const char *funcname);
+
+
+/*
+ * Emit a pointer constant.  All pointers are passed around as i8*, and only
+ * cast to a more specific type when dereferenced.
+ */
+static inline LLVMValueRef
+l_ptr_const(const void *ptr)
+{
+    LLVMValueRef c = LLVMConstInt(TypeSizeT, (uintptr_t) ptr, false);
+
+    return LLVMConstIntToPtr(c, TypePtr);
+}
+
+/* emit a pointer to a function with signature fntype */
+static inline LLVMValueRef
+l_func_const(LLVMTypeRef fntype, const void *fn)
+{
+    LLVMValueRef c = LLVMConstInt(TypeSizeT, (uintptr_t) fn, false);
+
+    return LLVMConstIntToPtr(c, LLVMPointerType(fntype, 0));
+}
+
+static inline LLVMValueRef
+l_int8_const(int8 i)
+{
+    return LLVMConstInt(TypeInt8, i, false);
+}
+
+static inline LLVMValueRef
+l_int16_const(int16 i)
+{
+    return LLVMConstInt(TypeInt16, i, false);
+}
+
+static inline LLVMValueRef
+l_int32_const(int32 i)
+{
+    return LLVMConstInt(TypeInt32, i, false);
+}
+
+static inline LLVMValueRef
+l_int64_const(int64 i)
+{
+    return LLVMConstInt(TypeInt64, i, false);
+}
+
+static inline LLVMValueRef
+l_sizet_const(size_t i)
+{
+    return LLVMConstInt(TypeSizeT, i, false);
+}
+
+/* i8* pointing offset bytes after base */
+static inline LLVMValueRef
+l_gep(LLVMBuilderRef b, LLVMValueRef base, LLVMValueRef offset)
+{
+    return LLVMBuildGEP2(b, TypeInt8, base, &offset, 1, "");
+}
+
+static inline LLVMValueRef
+l_gep_const(LLVMBuilderRef b, LLVMValueRef base, size_t offset)
+{
+    if (offset == 0)
+        return base;
+    return l_gep(b, base, l_sizet_const(offset));
+}
+
+/* load a value of the given type from an i8* */
+static inline LLVMValueRef
+l_load(LLVMBuilderRef b, LLVMTypeRef type, LLVMValueRef ptr, const char *name)
+{
+    LLVMValueRef typed = LLVMBuildBitCast(b, ptr, LLVMPointerType(type, 0), "");
+
+    return LLVMBuildLoad2(b, type, typed, name);
+}
+
+/* store a value through an i8* */
+static inline void
+l_store(LLVMBuilderRef b, LLVMValueRef value, LLVMValueRef ptr)
+{
+    LLVMTypeRef type = LLVMTypeOf(value);
+    LLVMValueRef typed = LLVMBuildBitCast(b, ptr, LLVMPointerType(type, 0), "");
+
+    LLVMBuildStore(b, value, typed);
+}
+
+/* load a struct member, given the struct's address and the member's offset */
+static inline LLVMValueRef
+l_load_field(LLVMBuilderRef b, LLVMTypeRef type, LLVMValueRef base,
+             size_t offset, const char *name)
+{
+    return l_load(b, type, l_gep_const(b, base, offset), name);
+}
+
+static inline void
+l_store_field(LLVMBuilderRef b, LLVMValueRef value, LLVMValueRef base,
+              size_t offset)
+{
+    l_store(b, value, l_gep_const(b, base, offset));
+}
+
+/* address of element idx of an array of elemsize sized elements */
+static inline LLVMValueRef
+l_array_elem(LLVMBuilderRef b, LLVMValueRef base, LLVMValueRef idx,
+             size_t elemsize)
+{
+    LLVMValueRef off;
+
+    off = LLVMBuildMul(b, LLVMBuildSExt(b, idx, TypeSizeT, ""),
+                       l_sizet_const(elemsize), "");
+    return l_gep(b, base, off);
+}
+
+/* call fn, a function with the given return and parameter types */
+static inline LLVMValueRef
+l_call(LLVMBuilderRef b, LLVMTypeRef rettype, const void *fn,
+       LLVMTypeRef *paramtypes, LLVMValueRef *args, int nargs)
+{
+    LLVMTypeRef fntype = LLVMFunctionType(rettype, paramtypes, nargs, false);
+
+    return LLVMBuildCall2(b, fntype, l_func_const(fntype, fn),
+                          args, nargs, "");
+}
+
+/* convert a bool stored as i8 into an i1 */
+static inline LLVMValueRef
+l_as_bool(LLVMBuilderRef b, LLVMValueRef v)
+{
+    return LLVMBuildICmp(b, LLVMIntNE, v, LLVMConstInt(LLVMTypeOf(v), 0, false), "");
+}
+
+/* create a basic block, appended to the function */
+static inline LLVMBasicBlockRef
+l_bb_append(LLVMValueRef fn, const char *name)
+{
+    return LLVMAppendBasicBlockInContext(llvm_context, fn, name);
+}
+
+#endif                            /* LLVMJIT_H */
@@ -102,6 +102,11 @@ typedef struct ExprState
 
     Datum       *innermost_domainval;
     bool       *innermost_domainnull;
+
+#ifdef __OPENTENBASE__
+    /* parent PlanState node, if any; needed to find the JIT context */
+    struct PlanState *parent;
+#endif
 } ExprState;
 
 
@@ -547,6 +552,16 @@ typedef struct EState
 #ifdef __AUDIT__
     int32        es_remote_subplan_num;    /* number of RemoteSubplan in es_plannedstmt */
 #endif
+
+#ifdef __OPENTENBASE__
+    /*
+     * JIT information. es_jit_flags indicates whether JIT should be
+     * performed and with which options.  es_jit is created on-demand when
+     * JITing is performed.
+     */
+    int            es_jit_flags;
+    struct JitContext *es_jit;
+#endif
 } EState;
 
 
@@ -1102,6 +1117,13 @@ typedef struct AppendState
     PlanState **appendplans;    /* array of PlanStates for my inputs */
     int            as_nplans;
     int            as_whichplan;
+#ifdef __OPENTENBASE__
+    int            as_nremoved;    /* subplans pruned at startup */
+    bool       *as_pruned;        /* subplans pruned by run-time params */
+    bool        as_prune_pending;    /* must recompute as_pruned? */
+    MemoryContext as_prunecxt;    /* workspace for run-time pruning */
+    List       *as_pruneexprs;    /* prepared param expressions of the quals */
+#endif
 } AppendState;
 
 /* ----------------
@@ -1125,6 +1147,13 @@ typedef struct MergeAppendState
     TupleTableSlot **ms_slots;    /* array of length ms_nplans */
     struct binaryheap *ms_heap; /* binary heap of slot indices */
     bool        ms_initialized; /* are subplans started? */
+#ifdef __OPENTENBASE__
+    int            ms_nremoved;    /* subplans pruned at startup */
+    bool       *ms_pruned;        /* subplans pruned by run-time params */
+    bool        ms_prune_pending;    /* must recompute ms_pruned? */
+    MemoryContext ms_prunecxt;    /* workspace for run-time pruning */
+    List       *ms_pruneexprs;    /* prepared param expressions of the quals */
+#endif
 } MergeAppendState;
 
 /* ----------------
@@ -1231,6 +1260,10 @@ typedef struct SeqScanState
 {
     ScanState    ss;                /* its first field is NodeTag */
     Size        pscan_len;        /* size of parallel heap scan descriptor */
+#ifdef __OPENTENBASE__
+    int            ss_NumScanKeys;    /* quals pushed down as heap scan keys */
+    ScanKey        ss_ScanKeys;
+#endif
 } SeqScanState;
 
 /* ----------------
@@ -1824,8 +1857,8 @@ typedef enum ParallelHashJoinStatus
     ParallelHashJoin_EmptyInter,            /* no tuples from inner */
     ParallelHashJoin_BuildShmHashTable,     /* build hashtable in share memory */
     ParallelHashJoin_BuildShmHashTableDone, /* build hashtable in share memory finished */
-    ParallelHashJoin_MergeShmHashTable,     /* merge shm-hashtable into local-hashtable */
-    ParallelHashJoin_MergeShmHashTableDone, /* merge shm-hashtable into local-hashtable finished */
+    ParallelHashJoin_MergeShmHashTable,     /* merge own slice of shm-hashtable buckets */
+    ParallelHashJoin_MergeShmHashTableDone, /* merge own slice of shm-hashtable buckets finished */
     ParallelHashJoin_ExecJoin,              /* do the hash-join */
     ParallelHashJoin_ShareOuterBufFile,     /* share outer buffiles */
     ParallelHashJoin_ShareOuterBufFileDone, /* share outer buffiles finished */
@@ -2237,6 +2270,10 @@ typedef struct HashInstrumentation
 	int			nbatch;			/* number of batches at end of execution */
 	int			nbatch_original;	/* planned number of batches */
 	size_t		space_peak;		/* speak memory usage in bytes */
+#ifdef __OPENTENBASE__
+	double		bloom_checked;	/* outer tuples tested by runtime filter */
+	double		bloom_removed;	/* outer tuples removed by runtime filter */
+#endif
 } HashInstrumentation;
 
 /* ----------------
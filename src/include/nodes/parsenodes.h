@@ -3299,10 +3299,11 @@ typedef enum VacuumOption
     VACOPT_NOWAIT = 1 << 5,        /* don't wait to get lock (autovacuum only) */
     VACOPT_SKIPTOAST = 1 << 6,    /* don't process the TOAST table, if any */
     VACOPT_DISABLE_PAGE_SKIPPING = 1 << 7,    /* don't skip any pages */
-    VACOPT_COORDINATOR = 1 << 8    /* don't trigger analyze on the datanodes, but
+    VACOPT_COORDINATOR = 1 << 8,    /* don't trigger analyze on the datanodes, but
                                   * just collect existing info and populate
                                   * coordinator side stats.
                                   */
+    VACOPT_PARALLEL = 1 << 9    /* vacuum indexes using parallel workers */
 } VacuumOption;
 
 typedef struct StatSyncOpt
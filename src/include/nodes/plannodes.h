@@ -109,6 +109,14 @@ typedef struct PlannedStmt
     AttrNumber  distributionKey;
     List       *distributionNodes;
     List       *distributionRestrict;
+#ifdef __OPENTENBASE__
+    /* Routing of rows with a hot distribution key value */
+    char        skewPolicy;
+    List       *skewValues;
+    Oid         skewEqOp;
+    /* Runtime choice between broadcast and redistribution */
+    char        adaptivePolicy;
+#endif
 #endif    
 
     Node       *utilityStmt;    /* non-null if this is utility stmt */
@@ -122,6 +130,7 @@ typedef struct PlannedStmt
     Index        partrelindex;
     Bitmapset    *partpruning;
     bool        need_snapshot;  /* need to set a snapshot when execute plan */
+    int            jitFlags;        /* which forms of JIT should be performed */
 #endif
 
 #ifdef __AUDIT__
@@ -302,6 +311,7 @@ typedef struct Append
     List       *appendplans;
 #ifdef __OPENTENBASE__
     bool       interval;
+    List       *partprunequals;    /* quals with Params to prune children by */
 #endif
 } Append;
 
@@ -324,6 +334,7 @@ typedef struct MergeAppend
     bool       *nullsFirst;        /* NULLS FIRST/LAST directions */
 #ifdef __OPENTENBASE__
     bool       interval;
+    List       *partprunequals;    /* quals with Params to prune children by */
 #endif
 } MergeAppend;
 
@@ -1437,6 +1437,12 @@ typedef struct RemoteSubPath
 {
     Path        path;
     Path       *subpath;
+#ifdef __OPENTENBASE__
+    char        skewPolicy;     /* how rows with hot key values are routed */
+    List       *skewValues;     /* hot key values, list of Const */
+    Oid         skewEqOp;       /* equality operator to match hot values */
+    char        adaptivePolicy; /* runtime broadcast or redistribution */
+#endif
 } RemoteSubPath;
 #endif
 
@@ -81,6 +81,8 @@ extern bool enable_hashjoin;
 extern bool enable_fast_query_shipping;
 extern bool enable_gathermerge;
 extern bool enable_partition_wise_join;
+extern bool enable_partition_wise_agg;
+extern bool enable_partition_wise_hashjoin;
 extern bool enable_nestloop_suppression;
 extern int	constraint_exclusion;
 
@@ -321,6 +321,9 @@ extern int replication_level;
 
 extern bool restrict_query;
 extern bool enable_subquery_shipping;
+extern bool enable_skew_redistribution;
+extern double skew_redistribution_threshold;
+extern bool enable_adaptive_broadcast;
 extern char *g_constrain_group;
 #endif
 
@@ -22,6 +22,7 @@
 
 #ifdef __OPENTENBASE__
 extern bool g_transform_insert_to_copy;
+extern bool g_transform_insert_to_copy_binary;
 #endif
 
 /* Hook for plugins to get control at end of parse analysis */
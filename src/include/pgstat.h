@@ -787,6 +787,9 @@ typedef enum
 	WAIT_EVENT_WAL_WRITER_MAIN,
 #ifdef __AUDIT_FGA__
     WAIT_EVENT_AUDIT_FGA_MAIN,
+#endif
+#ifdef __OPENTENBASE__
+	WAIT_EVENT_NETWORK_CALIBRATOR_MAIN,
 #endif
 	WAIT_EVENT_CLUSTER_MONITOR_MAIN
 } WaitEventActivity;
@@ -266,6 +266,21 @@ typedef struct RemoteSubplanState
     bool        finish_init;
     int32       eflags;                       /* estate flag. */
     ParallelWorkerStatus *parallel_status; /* Shared storage for parallel worker. */
+    instr_time  recv_time;              /* time spent waiting for remote tuples,
+                                         * collected under EXPLAIN ANALYZE */
+    char       *adaptive_local_subplanstr; /* probe side subplan keeping
+                                            * tuples on their nodes */
+    int         adaptive_producers;     /* number of producers bound */
+    int         adaptive_broadcasts;    /* producers which reported they
+                                         * broadcast their tuples */
+    char       *adaptive_hash_subplanstr;  /* probe side subplan redistributing
+                                            * tuples by hash */
+    bool        adaptive_redistributed; /* a build producer reported it
+                                         * redistributes its tuples */
+    struct RemoteSubplanState *adaptive_probe; /* probe side of the join of
+                                                * this build side */
+    bool        adaptive_prefetched;    /* probe side was started early */
+    TupleTableSlot *adaptive_first;     /* first tuple of the probe side */
 #endif
 } RemoteSubplanState;
 
@@ -312,10 +327,19 @@ typedef struct RemoteStmt
 
     List       *distributionRestrict;
 #ifdef __OPENTENBASE__
+    /* routing of rows with a hot distribution key value */
+    char        skewPolicy;
+    List       *skewValues;
+    Oid         skewEqOp;
+    /* runtime choice between broadcast and redistribution */
+    char        adaptivePolicy;
+
     /* used for interval partition */
     bool        haspart_tobe_modify;
     Index        partrelindex;
     Bitmapset    *partpruning;
+
+    int            jitFlags;        /* which forms of JIT should be performed */
 #endif
 
 #ifdef __AUDIT__
@@ -447,6 +471,9 @@ extern TupleDesc create_tuple_desc(char *msg_body, size_t len);
 
 extern void ExecFinishRemoteSubplan(RemoteSubplanState *node);
 extern void ExecShutdownRemoteSubplan(RemoteSubplanState *node);
+extern void ExecRemoteSubplanLinkAdaptive(PlanState *probe, PlanState *build);
+extern bool ExecRemoteSubplanProbePending(PlanState *probe);
+extern void ExecRemoteSubplanChooseProbe(PlanState *probe, PlanState *build);
 extern bool SetSnapshot(EState *state);
 
 extern void ExecRemoteUtility_ParallelDDLMode(RemoteQuery *node,
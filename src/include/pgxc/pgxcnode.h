@@ -208,6 +208,7 @@ extern int	ensure_in_buffer_capacity(size_t bytes_needed, PGXCNodeHandle * handl
 extern int	ensure_out_buffer_capacity(size_t bytes_needed, PGXCNodeHandle * handle);
 
 extern int	pgxc_node_send_query(PGXCNodeHandle * handle, const char *query);
+extern int	pgxc_node_queue_query(PGXCNodeHandle *handle, const char *query);
 extern int	pgxc_node_send_rollback(PGXCNodeHandle * handle, const char *query);
 extern int	pgxc_node_send_describe(PGXCNodeHandle * handle, bool is_statement,
 						const char *name);
@@ -234,6 +235,11 @@ extern int	pgxc_node_send_query_extended(PGXCNodeHandle *handle, const char *que
 							  int num_params, Oid *param_types,
 							  int paramlen, char *params,
 							  bool send_describe, int fetch_size);
+extern int	pgxc_node_queue_query_extended(PGXCNodeHandle *handle, const char *query,
+							  const char *statement, const char *portal,
+							  int num_params, Oid *param_types,
+							  int paramlen, char *params,
+							  bool send_describe, int fetch_size);
 extern int  pgxc_node_send_plan(PGXCNodeHandle * handle, const char *statement,
 					const char *query, const char *planstr,
 					short num_params, Oid *param_types, int instrument_options);
@@ -272,6 +278,7 @@ extern int	pgxc_node_is_data_enqueued(PGXCNodeHandle *conn);
 
 extern int	send_some(PGXCNodeHandle * handle, int len);
 extern int	pgxc_node_flush(PGXCNodeHandle *handle);
+extern int	pgxc_node_flush_all(PGXCNodeHandle **connections, int count);
 extern int	pgxc_node_flush_read(PGXCNodeHandle *handle);
 
 extern char get_message(PGXCNodeHandle *conn, int *len, char **msg);
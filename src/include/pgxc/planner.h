@@ -199,10 +199,40 @@ typedef struct
     bool        parallelWorkerSendTuple; 
 	/* params that generated by initplan */
 	Bitmapset  *initPlanParams;
+	/* routing of rows with a hot distribution key value, see SKEW_POLICY_xxx */
+	char        skewPolicy;
+	List       *skewValues;     /* hot key values, list of Const */
+	Oid         skewEqOp;       /* equality operator to match hot values */
+	/* runtime choice between broadcast and redistribution, ADAPTIVE_POLICY_xxx */
+	char        adaptivePolicy;
 #endif
 
 } RemoteSubplan;
 
+#ifdef __OPENTENBASE__
+/*
+ * Skew policies of a redistributing RemoteSubplan. Rows of the probe side
+ * of a join carrying a hot key value are spread round-robin over the
+ * consumers, and matching rows of the build side are sent to all of them.
+ */
+#define SKEW_POLICY_NONE        'n'
+#define SKEW_POLICY_SPREAD      's'
+#define SKEW_POLICY_BROADCAST   'b'
+
+/*
+ * Adaptive policies of the RemoteSubplans below a hash join whose build side
+ * may be broadcast instead of redistributed. Producers of the build side
+ * buffer their tuples and broadcast them if they stay small, otherwise they
+ * redistribute them by hash. The probe side is redistributed by hash, unless
+ * all build producers reported they broadcast; then the probe producers keep
+ * every tuple on their own node.
+ */
+#define ADAPTIVE_POLICY_NONE        'n'
+#define ADAPTIVE_POLICY_BUILD       'b'
+#define ADAPTIVE_POLICY_PROBE       'p'
+#define ADAPTIVE_POLICY_PROBE_LOCAL 'l'
+#endif
+
 /*
  * FQS_context
  * This context structure is used by the Fast Query Shipping walker, to gather
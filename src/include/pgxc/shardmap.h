@@ -56,6 +56,7 @@ extern bool         g_IsExtension;
 extern bool g_StatShardInfo;
 extern int  g_MaxSessionsPerPool;
 extern int  g_ShardInfoFlushInterval;
+extern int  g_ShardInfoSelectSample;
 
 #define SHARD_TABLE_BITMAP_SIZE \
     (BITMAPSET_SIZE(WORDNUM(SHARD_MAP_GROUP_NUM) + 1))
@@ -113,6 +114,7 @@ extern int32 EvaluateShardId(Oid type, bool isNull, Datum dvalue,
                            Oid secType, bool isSecNull, Datum secValue, Oid relid);
 
 extern int TruncateShard(Oid reloid, ShardID sid, int pausetime);
+extern int64 PurgeShardExtents(Oid reloid, Bitmapset *sids, int sleep_interval);
 
 /* shard barrier */
 extern void ShardBarrierShmemInit(void);
@@ -146,6 +148,10 @@ extern void ShardStatisticShmemInit(void);
 
 extern void UpdateShardStatistic(CmdType cmd, ShardID sid, int64 new_size, int64 old_size);
 
+extern void FlushLocalShardStatistic(void);
+
+extern void AtEOXact_ShardStatistic(void);
+
 extern void FlushShardStatistic(void);
 
 extern void RecoverShardStatistic(void);
@@ -154,6 +160,9 @@ extern void ResetShardStatistic(void);
 
 extern Datum opentenbase_shard_statistic(PG_FUNCTION_ARGS);
 
+/* in shard_rebalance.c */
+extern Datum opentenbase_shard_rebalance_plan(PG_FUNCTION_ARGS);
+
 #ifdef __COLD_HOT__
 extern Size DualWriteTableSize(void);
 extern void DualWriteCtlInit(void);
@@ -196,6 +196,14 @@ extern bool IsConsumerDisConnect(char *sqname, int nodeid);
 
 extern void RemoveDisConsumerHash(char *sqname);
 
+extern void SharedQueueSetBroadcast(SharedQueue squeue);
+
+extern bool SharedQueueLastReadBroadcast(void);
+
+extern void SharedQueueSetRedistributed(SharedQueue squeue);
+
+extern bool SharedQueueRedistributed(SharedQueue squeue);
+
 extern void RemoteSubplanSigusr2Handler(SIGNAL_ARGS);
 #ifdef __OPENTENBASE__
 enum MT_thr_detach 
@@ -0,0 +1,51 @@
+/*--------------------------------------------------------------------
+ * netcalibrator.h
+ *		Measured network and datanode performance for distributed costing.
+ *
+ * Every node keeps measurements of the links it sends data over in shared
+ * memory.  On coordinators, the network calibrator background worker
+ * periodically measures the latency and bandwidth of the links from each
+ * datanode to the coordinator, and collects the measurements datanodes made
+ * of the links between them, so that the planner can cost data movement
+ * with the actual performance of the cluster.
+ *
+ *
+ * Copyright (c) 2023 THL A29 Limited, a Tencent company.
+ *
+ * This source code file is licensed under the BSD 3-Clause License,
+ * you may obtain a copy of the License at http://opensource.org/license/bsd-3-clause/
+ *
+ * IDENTIFICATION
+ *		src/include/postmaster/netcalibrator.h
+ *--------------------------------------------------------------------
+ */
+#ifndef NETCALIBRATOR_H
+#define NETCALIBRATOR_H
+
+#include "nodes/bitmapset.h"
+#include "utils/timestamp.h"
+
+/* GUC parameters */
+extern bool enable_network_calibration;
+extern int	network_calibration_interval;
+
+/* nodes of the cluster measurements are kept for */
+#define NETCALIB_MAX_NODES		256
+
+extern Size NetworkCalibrationShmemSize(void);
+extern void NetworkCalibrationShmemInit(void);
+
+extern void NetworkCalibratorRegister(void);
+extern void NetworkCalibratorMain(Datum main_arg) pg_attribute_noreturn();
+
+extern void NetworkCalibrationReportLink(Oid source, Oid target,
+							 double bytes, double seconds, bool saturated);
+extern void NetworkCalibrationReportThroughput(Oid node, double bytes,
+								   double seconds);
+
+extern void NetworkCalibrationCostFactors(Bitmapset *sources,
+							  Bitmapset *targets,
+							  double *transfer_factor,
+							  double *latency_factor);
+
+#endif							/* NETCALIBRATOR_H */
@@ -215,6 +215,8 @@ extern void DropDatabaseBuffers(Oid dbid);
 #ifdef _SHARDING_
 extern void DropRelfileNodeShardBuffers(RelFileNode rnode, ShardID sid);
 extern void DropRelfileNodeExtentBuffers(RelFileNode rnode, ExtentID eid);
+extern void DropRelfileNodeShardExtentBuffers(RelFileNode rnode, ShardID sid,
+                                              ExtentID *eids, int neids);
 #endif
 #define RelationGetNumberOfBlocks(reln) \
     RelationGetNumberOfBlocksInFork(reln, MAIN_FORKNUM)
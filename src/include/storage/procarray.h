@@ -149,6 +149,10 @@ extern VirtualTransactionId *GetCurrentVirtualXIDs(TransactionId limitXmin,
 					  bool excludeXmin0, bool allDbs, int excludeVacuum,
 					  int *nvxids);
 extern VirtualTransactionId *GetConflictingVirtualXIDs(TransactionId limitXmin, Oid dbOid);
+#ifdef __SUPPORT_DISTRIBUTED_TRANSACTION__
+extern VirtualTransactionId *GetVirtualXIDsBeforeTs(GlobalTimestamp limitTs,
+					   int excludeVacuum, int *nvxids);
+#endif
 extern pid_t CancelVirtualTransaction(VirtualTransactionId vxid, ProcSignalReason sigmode);
 
 extern bool MinimumActiveBackends(int min);
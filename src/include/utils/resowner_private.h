@@ -92,6 +92,13 @@ extern void ResourceOwnerRememberDSM(ResourceOwner owner,
 extern void ResourceOwnerForgetDSM(ResourceOwner owner,
                        dsm_segment *);
 
+/* support for JIT context management */
+extern void ResourceOwnerEnlargeJIT(ResourceOwner owner);
+extern void ResourceOwnerRememberJIT(ResourceOwner owner,
+                         Datum handle);
+extern void ResourceOwnerForgetJIT(ResourceOwner owner,
+                       Datum handle);
+
 #ifdef XCP
 /* support for prepared statement management */
 extern void ResourceOwnerEnlargePreparedStmts(ResourceOwner owner);
@@ -0,0 +1,46 @@
+--
+-- Choosing between broadcast and redistribution of hash join inputs at
+-- runtime (enable_adaptive_broadcast)
+--
+show enable_adaptive_broadcast;
+create table ab_o(a int, b int);
+create table ab_i(a int, b int);
+create table ab_s(a int, b int);
+insert into ab_o select i, i % 50 from generate_series(1, 2000) i;
+insert into ab_i select i, i from generate_series(1, 50) i;
+-- most rows of ab_s are on the node of a = 1
+insert into ab_s select 1, i % 50 + 1 from generate_series(1, 200) i;
+insert into ab_s select i, i from generate_series(2, 10) i;
+analyze ab_o;
+analyze ab_i;
+analyze ab_s;
+set enable_adaptive_broadcast = on;
+-- every build producer broadcasts, the probe side stays local
+select count(*), sum(ab_i.b) from ab_o join ab_i on ab_o.b = ab_i.b;
+select count(*), count(ab_i.a) from ab_o left join ab_i on ab_o.b = ab_i.b;
+select count(*), sum(ab_s.b) from ab_o join ab_s on ab_o.b = ab_s.b;
+-- every build producer redistributes, the probe side starts early
+set adaptive_broadcast_threshold = 0;
+select count(*), sum(ab_i.b) from ab_o join ab_i on ab_o.b = ab_i.b;
+select count(*), count(ab_i.a) from ab_o left join ab_i on ab_o.b = ab_i.b;
+select count(*), sum(ab_s.b) from ab_o join ab_s on ab_o.b = ab_s.b;
+-- some build producers broadcast, the others redistribute
+set adaptive_broadcast_threshold = 1;
+select count(*), sum(ab_s.b) from ab_o join ab_s on ab_o.b = ab_s.b;
+select count(*) from ab_o where ab_o.b in (select b from ab_s);
+select count(*) from ab_o where not exists (select 1 from ab_s where ab_s.b = ab_o.b);
+-- rescans
+select x.n, (select count(*) from ab_o join ab_s on ab_o.b = ab_s.b where ab_o.a <= x.n)
+  from (values (100), (1000)) x(n) order by 1;
+-- rescans of a probe side that was started early, each of which has to
+-- replace the redistributing subplan with a broadcast one
+set adaptive_broadcast_threshold = 0;
+select x.n, (select count(*) from ab_o join ab_s on ab_o.b = ab_s.b where ab_o.a <= x.n)
+  from (values (100), (1000), (2000)) x(n) order by 1;
+select x.n, (select count(*) from ab_o join ab_i on ab_o.b = ab_i.b where ab_i.a <= x.n)
+  from (values (10), (50)) x(n) order by 1;
+reset adaptive_broadcast_threshold;
+reset enable_adaptive_broadcast;
+drop table ab_o;
+drop table ab_i;
+drop table ab_s;
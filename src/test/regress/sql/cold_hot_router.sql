@@ -0,0 +1,31 @@
+--
+-- Routing state of shard tables and the temp_key_value white list, which
+-- are cached per backend
+--
+create table chr_t(a int, d timestamp without time zone, b int)
+partition by range(d) begin(timestamp without time zone '2020-01-01') step(interval '1 month') partitions(12)
+distribute by shard(a);
+insert into chr_t select i, timestamp without time zone '2020-01-01' + (i % 365) * interval '1 day', i from generate_series(1, 3650) i;
+select count(*), sum(b) from chr_t;
+select count(*) from chr_t partition for(timestamp without time zone '2020-02-15');
+-- the white list must name existing groups
+set temp_key_value = 'public.chr_t 1 default_group no_such_group';
+set temp_key_value = 'public.chr_t 1 no_such_group default_group';
+set temp_key_value = 'public.chr_t 1 default_group default_group';
+insert into chr_t values (1, timestamp without time zone '2020-03-01', 0);
+select count(*) from chr_t where a = 1;
+-- setting the list again replaces the previous one
+set temp_key_value = 'public.chr_t 2 default_group default_group';
+insert into chr_t values (2, timestamp without time zone '2020-03-01', 0);
+reset temp_key_value;
+insert into chr_t values (3, timestamp without time zone '2020-03-01', 0);
+select a, count(*) from chr_t where a in (1, 2, 3) group by a order by a;
+-- a new relation with the same name is routed by its own state
+drop table chr_t;
+create table chr_t(a int, d timestamp without time zone, b int)
+partition by range(d) begin(timestamp without time zone '2021-01-01') step(interval '1 month') partitions(2)
+distribute by shard(a);
+insert into chr_t values (1, timestamp without time zone '2021-01-15', 1), (2, timestamp without time zone '2021-02-15', 2);
+insert into chr_t values (3, timestamp without time zone '2020-02-15', 3);
+select a, b from chr_t order by a;
+drop table chr_t;
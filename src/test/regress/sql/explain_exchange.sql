@@ -0,0 +1,45 @@
+--
+-- Data exchange time of plan fragments in distributed EXPLAIN ANALYZE
+--
+create table xe_a(a int, b int);
+create table xe_b(a int, b int);
+insert into xe_a select i, i % 100 from generate_series(1, 1000) i;
+insert into xe_b select i, i % 100 from generate_series(1, 1000) i;
+analyze xe_a;
+analyze xe_b;
+
+-- count the lines of an EXPLAIN output reporting data exchange
+create function xe_exchange_lines(query text) returns int
+language plpgsql as
+$$
+declare
+    line text;
+    n int := 0;
+begin
+    for line in execute query loop
+        if line like '%exchange recv time%' then
+            n := n + 1;
+        end if;
+    end loop;
+    return n;
+end;
+$$;
+
+-- joining on non-distribution columns redistributes both sides
+select xe_exchange_lines('explain (analyze, costs off, summary off)
+    select count(*) from xe_a join xe_b on xe_a.b = xe_b.b') > 0 as reported;
+select xe_exchange_lines('explain (analyze, verbose, costs off, summary off)
+    select count(*) from xe_a join xe_b on xe_a.b = xe_b.b') > 0 as reported;
+
+-- nothing is measured or shown without timing
+select xe_exchange_lines('explain (analyze, costs off, summary off, timing off)
+    select count(*) from xe_a join xe_b on xe_a.b = xe_b.b') as lines;
+select xe_exchange_lines('explain (analyze, verbose, costs off, summary off, timing off)
+    select count(*) from xe_a join xe_b on xe_a.b = xe_b.b') as lines;
+
+-- the query itself is not affected
+select count(*) from xe_a join xe_b on xe_a.b = xe_b.b;
+
+drop function xe_exchange_lines(text);
+drop table xe_a;
+drop table xe_b;
@@ -0,0 +1,16 @@
+--
+-- Extent allocation when inserts go to many shards of an extent table:
+-- the shard's current extent is tried before the shard's alloc list
+--
+create table ea_t(a int, b text) distribute by shard(a);
+-- rows of many shards interleaved, each shard filling several pages
+insert into ea_t select i % 64, repeat('x', 500) from generate_series(1, 20000) i;
+select count(*), count(distinct a) from ea_t;
+select a, count(*) from ea_t where a in (0, 1, 63) group by a order by a;
+-- free most of the space and fill it again, reusing existing extents
+delete from ea_t where a % 2 = 0;
+vacuum ea_t;
+insert into ea_t select i % 64, repeat('y', 500) from generate_series(1, 20000) i where i % 2 = 0;
+select count(*), count(distinct a) from ea_t;
+select count(*) from ea_t where b like 'y%';
+drop table ea_t;
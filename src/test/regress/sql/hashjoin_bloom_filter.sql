@@ -0,0 +1,53 @@
+--
+-- Runtime Bloom filter on the outer side of multi-batch hash joins
+-- (enable_hashjoin_bloom_filter)
+--
+create table hbf_o(a int, b int);
+create table hbf_i(a int, b int);
+insert into hbf_o select i, i % 100 from generate_series(1, 100000) i;
+-- only every fifth outer key has a match
+insert into hbf_i select i * 5, i from generate_series(1, 20000) i;
+analyze hbf_o;
+analyze hbf_i;
+
+create function hbf_explain_has(query text, pattern text) returns boolean
+language plpgsql as
+$$
+declare
+    line text;
+begin
+    for line in execute 'explain (analyze, costs off, timing off, summary off) ' || query loop
+        if line like '%' || pattern || '%' then
+            return true;
+        end if;
+    end loop;
+    return false;
+end;
+$$;
+
+set enable_mergejoin = off;
+set enable_nestloop = off;
+set work_mem = '64kB';
+show enable_hashjoin_bloom_filter;
+set enable_hashjoin_bloom_filter = on;
+select count(*), sum(o.b), sum(i.b) from hbf_o o join hbf_i i on o.a = i.a;
+select hbf_explain_has('select count(*) from hbf_o o join hbf_i i on o.a = i.a', 'Bloom Filter');
+-- outer joins keep every outer row
+select count(*), count(i.a) from hbf_o o left join hbf_i i on o.a = i.a;
+select count(*) from hbf_o o where not exists (select 1 from hbf_i i where i.a = o.a);
+select count(*) from hbf_o o where exists (select 1 from hbf_i i where i.a = o.a);
+-- the same results without the filter
+reset enable_hashjoin_bloom_filter;
+select count(*), sum(o.b), sum(i.b) from hbf_o o join hbf_i i on o.a = i.a;
+select hbf_explain_has('select count(*) from hbf_o o join hbf_i i on o.a = i.a', 'Bloom Filter');
+select count(*), count(i.a) from hbf_o o left join hbf_i i on o.a = i.a;
+-- a single batch needs no filter
+set enable_hashjoin_bloom_filter = on;
+reset work_mem;
+select hbf_explain_has('select count(*) from hbf_o o join hbf_i i on o.a = i.a', 'Bloom Filter');
+reset enable_hashjoin_bloom_filter;
+reset enable_mergejoin;
+reset enable_nestloop;
+drop function hbf_explain_has(text, text);
+drop table hbf_o;
+drop table hbf_i;
@@ -0,0 +1,35 @@
+--
+-- Multi-values INSERT transformed to COPY, with the evaluated rows shipped
+-- to datanodes in binary format (transform_insert_to_copy_binary)
+--
+set transform_insert_to_copy to on;
+create domain icb_posint as int check (value > 0) default 7;
+create type icb_pair as (a int, b text);
+
+-- defaults of domain and composite types keep the text format
+create table icb_t(id int, v numeric(10,2), n int8 default 42,
+                   d icb_posint, p icb_pair default row(1, 'x')::icb_pair,
+                   t text default 'def');
+set transform_insert_to_copy_binary to on;
+insert into icb_t(id, v) values (1, 1.5), (2, 2.25), (3, null);
+insert into icb_t(id, v, d, p) values (4, 4, 4, row(4, 'four')), (5, 5.5, 5, null);
+set transform_insert_to_copy_binary to off;
+insert into icb_t(id, v) values (6, 6), (7, 7.75);
+select id, v, n, d::int as d, p, t from icb_t order by id;
+
+-- built-in types only, defaults are computed on the coordinator as well
+create table icb_s(id int, v text, n int8 default 42, f float8 default 0.5,
+                   ts timestamp default '2020-01-02 03:04:05');
+set transform_insert_to_copy_binary to on;
+insert into icb_s(id, v) values (1, 'a'), (2, null), (3, 'c');
+insert into icb_s(id, v, n, f) values (4, 'd', -1, 1.25), (5, '', null, null);
+set transform_insert_to_copy_binary to off;
+insert into icb_s(id, v, n, f) values (6, 'f', 6, 6.5), (7, 'g', 7, null);
+select id, v, n, f, ts = '2020-01-02 03:04:05' as ts_default from icb_s order by id;
+
+reset transform_insert_to_copy_binary;
+reset transform_insert_to_copy;
+drop table icb_t;
+drop table icb_s;
+drop type icb_pair;
+drop domain icb_posint;
@@ -0,0 +1,70 @@
+--
+-- Pruning children of interval partitioned tables with param values at
+-- run time
+--
+create table rp_t(id int, c2 timestamp, v int)
+partition by range(c2) begin(timestamp without time zone '2020-01-01') step(interval '1 month') partitions(12)
+distribute by shard(id);
+create table rp_o(k int, d timestamp, tz timestamptz) distribute by replication;
+insert into rp_t select i, timestamp '2020-01-01' + (i - 1) * interval '1 day', i
+  from generate_series(1, 366) i;
+insert into rp_o values (1, '2020-03-15', '2020-03-15'), (2, '2020-07-04', '2020-07-04'),
+  (3, '2021-05-01', '2021-05-01');
+create index rp_t_c2 on rp_t(c2);
+analyze rp_t;
+analyze rp_o;
+create function rp_explain_has(query text, pattern text) returns boolean
+language plpgsql as
+$$
+declare
+    line text;
+begin
+    for line in execute 'explain (analyze, costs off, timing off, summary off) ' || query loop
+        if line like '%' || pattern || '%' then
+            return true;
+        end if;
+    end loop;
+    return false;
+end;
+$$;
+-- parameterized nestloops rescan the children with new param values
+set enable_hashjoin = off;
+set enable_mergejoin = off;
+select o.k, t.id, t.v from rp_o o join rp_t t on t.c2 = o.d order by 1;
+select o.k, t.id, t.v from rp_o o join rp_t t on t.c2 = o.tz order by 1;
+select o.k, count(*) from rp_o o join rp_t t on t.c2 < o.tz group by o.k order by 1;
+select o.k, count(*) from rp_o o join rp_t t on o.tz <= t.c2 group by o.k order by 1;
+select o.k, (select count(*) from rp_t t where t.c2 >= o.d) from rp_o o order by 1;
+-- EXPLAIN ANALYZE counts the children skipped on the rescans
+set enable_fast_query_shipping = off;
+select rp_explain_has('select o.k, t.id from rp_o o join rp_t t on t.c2 = o.d', 'Subplans Pruned');
+reset enable_fast_query_shipping;
+reset enable_hashjoin;
+reset enable_mergejoin;
+-- initplan outputs
+select count(*) from rp_t where c2 < (select max(tz) from rp_o where k < 3);
+select count(*) from rp_t where c2 >= (select min(d) from rp_o);
+prepare rp_p(timestamp) as
+  select count(*) from rp_t where c2 >= $1 and c2 < $1 + interval '1 month';
+execute rp_p('2020-02-01');
+execute rp_p('2020-12-15');
+deallocate rp_p;
+-- a generic plan prunes with the param values at executor startup; charge
+-- more for planning the custom plans so that the generic one is chosen
+set enable_fast_query_shipping = off;
+set cpu_operator_cost = 1;
+prepare rp_g(timestamp) as
+  select count(*) from rp_t where c2 >= $1 and c2 < $1 + interval '1 month';
+execute rp_g('2020-01-01');
+execute rp_g('2020-03-01');
+execute rp_g('2020-04-01');
+execute rp_g('2020-05-01');
+execute rp_g('2020-06-01');
+select rp_explain_has('execute rp_g(''2020-02-01'')', 'Subplans Removed');
+execute rp_g('2020-02-01');
+deallocate rp_g;
+reset cpu_operator_cost;
+reset enable_fast_query_shipping;
+drop function rp_explain_has(text, text);
+drop table rp_t;
+drop table rp_o;
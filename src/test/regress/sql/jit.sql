@@ -0,0 +1,49 @@
+--
+-- JIT contexts are owned by the current resource owner, so they are
+-- released on commit, abort and subtransaction abort alike.  Results
+-- must be identical whether or not a JIT provider is available.
+--
+create table jit_t(a int, b int);
+insert into jit_t select i, i % 10 from generate_series(1, 1000) i;
+set jit = on;
+set jit_above_cost = 0;
+set jit_optimize_above_cost = 0;
+set jit_inline_above_cost = 0;
+select count(*), sum(a) from jit_t where b = 3;
+-- released at commit
+begin;
+select sum(a) from jit_t where a > 500;
+commit;
+-- released at top-level abort
+select sum(a / (b - b)) from jit_t;
+select sum(a) from jit_t where a > 500;
+-- released at subtransaction abort
+begin;
+savepoint s1;
+select sum(a / (b - b)) from jit_t;
+rollback to savepoint s1;
+select sum(b) from jit_t;
+commit;
+create function jit_sub() returns int language plpgsql as $$
+declare
+    r int;
+begin
+    begin
+        select sum(a / b) into r from jit_t;
+    exception when division_by_zero then
+        r := -1;
+    end;
+    return r;
+end $$;
+select jit_sub() from generate_series(1, 3);
+select count(*), sum(a) from jit_t where b = 3;
+-- same results without JIT
+set jit = off;
+select count(*), sum(a) from jit_t where b = 3;
+select jit_sub();
+reset jit;
+reset jit_above_cost;
+reset jit_optimize_above_cost;
+reset jit_inline_above_cost;
+drop function jit_sub();
+drop table jit_t;
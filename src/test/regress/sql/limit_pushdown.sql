@@ -0,0 +1,27 @@
+--
+-- LIMIT and OFFSET pushed down to datanodes
+--
+create table lp_t(a int, b int);
+insert into lp_t select i, i % 10 from generate_series(1, 1000) i;
+analyze lp_t;
+select a from lp_t order by a limit 3;
+select a from lp_t order by a desc limit 2 offset 1;
+select count(*) from (select a from lp_t order by a limit 500 offset 100) s;
+-- LIMIT ALL with an OFFSET must not be pushed down as a row limit
+select a from lp_t order by a limit null offset 997;
+select a from lp_t order by a limit all offset 998;
+-- parameters are pushed down as well
+prepare lp_p(int8, int8) as select a from lp_t order by a limit $1 offset $2;
+execute lp_p(3, 0);
+execute lp_p(3, 995);
+execute lp_p(null, 997);
+-- the bound pushed down must not overflow
+execute lp_p(9223372036854775807, 998);
+execute lp_p(0, 0);
+prepare lp_q(int8) as select a, b from lp_t where b = 3 order by a limit $1;
+execute lp_q(2);
+deallocate lp_p;
+deallocate lp_q;
+-- not pushed down, the result is the same
+select a from lp_t order by a limit (select 2);
+drop table lp_t;
@@ -0,0 +1,23 @@
+--
+-- Costing data movement with measured network performance
+-- (enable_network_calibration)
+--
+show enable_network_calibration;
+-- whatever the calibrator measured so far is well-formed
+select count(*) = 0 or (min(bandwidth) > 0 and min(coalesce(latency, 1)) > 0) as ok
+  from pg_network_calibration();
+create table nc_a(a int, b int);
+create table nc_b(a int, b int);
+insert into nc_a select i, i % 100 from generate_series(1, 1000) i;
+insert into nc_b select i, i from generate_series(1, 100) i;
+analyze nc_a;
+analyze nc_b;
+-- the join needs data moved between nodes
+select count(*), sum(nc_b.b) from nc_a join nc_b on nc_a.b = nc_b.a;
+set enable_network_calibration = on;
+select count(*), sum(nc_b.b) from nc_a join nc_b on nc_a.b = nc_b.a;
+select count(*) from nc_a left join nc_b on nc_a.a = nc_b.b where nc_b.a is null;
+reset enable_network_calibration;
+select count(*) from nc_a left join nc_b on nc_a.a = nc_b.b where nc_b.a is null;
+drop table nc_a;
+drop table nc_b;
@@ -0,0 +1,29 @@
+--
+-- Statements fanned out to several datanodes inside and outside of
+-- transaction blocks; BEGIN is sent to all nodes of a batch at once
+--
+create table nbb_t(a int, b int);
+insert into nbb_t select i, i % 10 from generate_series(1, 1000) i;
+
+-- autocommit fan-out
+update nbb_t set b = b + 1 where a <= 500;
+select count(*), sum(b) from nbb_t;
+
+-- reads and writes in one transaction block reuse the begun connections
+begin;
+select count(*) from nbb_t;
+insert into nbb_t select i, 0 from generate_series(1001, 2000) i;
+update nbb_t set b = b + 1 where a > 1500;
+select count(*), sum(b) from nbb_t;
+rollback;
+select count(*), sum(b) from nbb_t;
+
+-- committed transaction touching every node twice
+begin;
+update nbb_t set b = 0 where a % 2 = 0;
+delete from nbb_t where a > 900;
+select count(*), sum(b) from nbb_t;
+commit;
+select count(*), sum(b) from nbb_t;
+
+drop table nbb_t;
@@ -0,0 +1,34 @@
+--
+-- Parallel-aware hash joins on datanodes, whose per-worker hash tables are
+-- merged cooperatively
+--
+create table phm_outer(a int, b int);
+create table phm_inner(a int, b int);
+insert into phm_outer select i, i % 1000 from generate_series(1, 50000) i;
+insert into phm_inner select i, i % 100 from generate_series(1, 20000) i;
+analyze phm_outer;
+analyze phm_inner;
+
+-- serial plan gives the reference results
+set max_parallel_workers_per_gather = 0;
+select count(*), sum(o.a), sum(i.a) from phm_outer o join phm_inner i on o.b = i.a;
+select count(*) from phm_outer o join phm_inner i on o.a = i.b;
+
+-- force parallel hash joins, in one and in several batches
+set parallel_setup_cost = 0;
+set parallel_tuple_cost = 0;
+set min_parallel_table_scan_size = 0;
+set max_parallel_workers_per_gather = 2;
+select count(*), sum(o.a), sum(i.a) from phm_outer o join phm_inner i on o.b = i.a;
+select count(*) from phm_outer o join phm_inner i on o.a = i.b;
+set work_mem = '64kB';
+select count(*), sum(o.a), sum(i.a) from phm_outer o join phm_inner i on o.b = i.a;
+select count(*) from phm_outer o join phm_inner i on o.a = i.b;
+
+reset work_mem;
+reset max_parallel_workers_per_gather;
+reset min_parallel_table_scan_size;
+reset parallel_tuple_cost;
+reset parallel_setup_cost;
+drop table phm_outer;
+drop table phm_inner;
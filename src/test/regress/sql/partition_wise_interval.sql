@@ -0,0 +1,53 @@
+--
+-- Partition-wise aggregation and hash join of interval partitioned tables
+-- (enable_partition_wise_agg, enable_partition_wise_hashjoin)
+--
+show enable_partition_wise_agg;
+show enable_partition_wise_hashjoin;
+create table pw_a(id int, k int, v int)
+partition by range(k) begin(1) step(100) partitions(4)
+distribute by shard(id);
+create table pw_b(id int, k int)
+partition by range(k) begin(1) step(100) partitions(4)
+distribute by shard(id);
+insert into pw_a select i, (i - 1) % 400 + 1, i from generate_series(1, 800) i;
+insert into pw_b select i, 2 * i from generate_series(1, 200) i;
+analyze pw_a;
+analyze pw_b;
+set enable_partition_wise_agg = on;
+select count(*), sum(c), max(c) from (select k, count(*) c from pw_a group by k) s;
+select k, count(*), sum(v) from pw_a where k in (1, 100, 101, 400) group by k order by k;
+select count(*) from pw_a
+  where v > (select avg(c) from (select k, count(*) c from pw_a group by k) s);
+set enable_partition_wise_hashjoin = on;
+select count(*), sum(a.v) from pw_a a join pw_b b on a.k = b.k;
+select count(*) from pw_a a where a.k in (select k from pw_b);
+-- the joins of the children project the join's target list
+select a.k, a.v, b.id * 2 as y from pw_a a join pw_b b on a.k = b.k
+  where a.k <= 4 order by 1, 2;
+select a.k, count(*) from pw_a a join pw_b b on a.k = b.k
+  group by a.k order by 2 desc, 1 limit 3;
+select b.k, (select count(*) from pw_a a where a.k = b.k) from pw_b b
+  where b.k <= 6 order by 1;
+-- outer joins are left alone
+select count(*), count(b.id) from pw_a a left join pw_b b on a.k = b.k;
+-- plan shapes, with aggregation and joins done on the datanodes
+set enable_fast_query_shipping = off;
+set enable_sort = off;
+set enable_mergejoin = off;
+set enable_nestloop = off;
+explain (costs off) select id, k, count(*) from pw_a group by id, k;
+-- grouping not on the partition key is left alone
+explain (costs off) select id, count(*) from pw_a group by id;
+explain (costs off) select a.v, b.id from pw_a a join pw_b b on a.id = b.id and a.k = b.k;
+-- outer joins are left alone
+explain (costs off) select a.v, b.id from pw_a a left join pw_b b on a.id = b.id and a.k = b.k;
+reset enable_nestloop;
+reset enable_mergejoin;
+reset enable_sort;
+reset enable_fast_query_shipping;
+reset enable_partition_wise_hashjoin;
+reset enable_partition_wise_agg;
+select count(*), sum(a.v) from pw_a a join pw_b b on a.k = b.k;
+drop table pw_a;
+drop table pw_b;
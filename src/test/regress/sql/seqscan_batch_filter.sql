@@ -0,0 +1,39 @@
+--
+-- Simple seqscan quals evaluated a page at a time as heap scan keys
+-- (enable_seqscan_batch_filter)
+--
+create table sbf_t(i2 int2, i4 int4, i8 int8, f4 float4, f8 float8,
+                   d date, ts timestamp, t text);
+insert into sbf_t
+  select i % 100, i, i * 1000000000::int8, i / 4.0, i / 8.0,
+         date '2020-01-01' + i % 366, timestamp '2020-01-01' + i * interval '1 hour',
+         'v' || (i % 10)
+  from generate_series(1, 10000) i;
+insert into sbf_t values (null, null, null, null, null, null, null, null);
+set enable_indexscan = off;
+set enable_bitmapscan = off;
+show enable_seqscan_batch_filter;
+set enable_seqscan_batch_filter = on;
+select count(*) from sbf_t where i2 = 7;
+select count(*) from sbf_t where i4 > 9990;
+select count(*) from sbf_t where i8 >= 5000000000000;
+-- cross-type comparisons
+select count(*) from sbf_t where i2 < 10::int8;
+select count(*) from sbf_t where i8 < 3000000001;
+select count(*) from sbf_t where f4 > 2400.5;
+select count(*) from sbf_t where f8 <= 1.0;
+select count(*) from sbf_t where d = date '2020-02-01';
+select count(*) from sbf_t where ts < timestamp '2020-01-02';
+-- operators without an inline kernel go through the function call
+select count(*) from sbf_t where t = 'v3';
+-- several keys and a qual that stays a filter
+select count(*) from sbf_t where i4 > 100 and i4 <= 200 and i2 <> 50 and i4 % 2 = 0;
+select count(*) from sbf_t where i4 is null;
+-- the same results evaluating the quals per tuple
+reset enable_seqscan_batch_filter;
+select count(*) from sbf_t where i2 = 7;
+select count(*) from sbf_t where f4 > 2400.5;
+select count(*) from sbf_t where i4 > 100 and i4 <= 200 and i2 <> 50 and i4 % 2 = 0;
+reset enable_indexscan;
+reset enable_bitmapscan;
+drop table sbf_t;
@@ -0,0 +1,27 @@
+--
+-- seqscan_prefetch_pages: heap scans and ANALYZE prefetch ahead of the
+-- block being read; results do not depend on it
+--
+show seqscan_prefetch_pages;
+create table spf_t(a int, b text) distribute by shard(a);
+insert into spf_t select i, repeat('x', 200) from generate_series(1, 20000) i;
+select count(*), sum(a) from spf_t;
+set seqscan_prefetch_pages = 32;
+select count(*), sum(a) from spf_t;
+-- a window longer than the table stops at its end
+set seqscan_prefetch_pages = 4096;
+select count(*), sum(a) from spf_t where a % 3 = 0;
+analyze spf_t;
+select reltuples > 0 from pg_class where relname = 'spf_t';
+-- parallel scans prefetch within their own block range
+set parallel_setup_cost = 0;
+set parallel_tuple_cost = 0;
+set min_parallel_table_scan_size = 0;
+set max_parallel_workers_per_gather = 2;
+select count(*), sum(a) from spf_t;
+reset max_parallel_workers_per_gather;
+reset min_parallel_table_scan_size;
+reset parallel_tuple_cost;
+reset parallel_setup_cost;
+reset seqscan_prefetch_pages;
+drop table spf_t;
@@ -0,0 +1,20 @@
+--
+-- Rows are routed through a backend-local copy of the shard map
+--
+create table smr_t(a int, b int);
+insert into smr_t select i, i from generate_series(1, 2000) i;
+-- single-row routing by key finds each row on the node it went to
+prepare smr_get(int) as select b from smr_t where a = $1;
+execute smr_get(1);
+execute smr_get(1999);
+select count(*) from generate_series(1, 200) k where (select count(*) from smr_t where a = k) = 1;
+-- every row lives on exactly one datanode
+execute direct on (datanode_1) 'select count(*) as smr_n1 from smr_t' \gset
+execute direct on (datanode_2) 'select count(*) as smr_n2 from smr_t' \gset
+select :smr_n1 + :smr_n2 as total, :smr_n1 > 0 and :smr_n2 > 0 as both_used;
+-- a fresh backend builds its own copy and routes the same way
+\c
+update smr_t set b = -b where a % 7 = 0;
+select count(*), sum(b) from smr_t;
+select b from smr_t where a = 7;
+drop table smr_t;
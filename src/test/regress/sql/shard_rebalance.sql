@@ -0,0 +1,34 @@
+--
+-- opentenbase_shard_rebalance_plan plans shardgroup moves from the shard
+-- statistics the datanodes of a group report
+--
+create table srb_t(a int, b text) distribute by shard(a) to group default_group;
+insert into srb_t select i, repeat('r', 100) from generate_series(1, 20000) i;
+-- a generous allowance needs no move
+select count(*) from opentenbase_shard_rebalance_plan('default_group', 'size', 1000000);
+-- every planned move goes between two different nodes of the group
+select coalesce(bool_and(from_node <> to_node), true) as distinct_nodes,
+       coalesce(bool_and(from_node in (select node_name::text from pgxc_node where node_type = 'D')), true) as from_member,
+       coalesce(bool_and(load >= 0), true) as load_ok
+  from opentenbase_shard_rebalance_plan('default_group', 'write', 0);
+-- pile writes onto the datanode that has the most already, so that the
+-- group is clearly out of balance
+execute direct on (datanode_1) 'select coalesce(sum(ntups_insert + ntups_update + ntups_delete), 0) as srb_w1 from opentenbase_shard_statistic() where group_name = ''default_group''' \gset
+execute direct on (datanode_2) 'select coalesce(sum(ntups_insert + ntups_update + ntups_delete), 0) as srb_w2 from opentenbase_shard_statistic() where group_name = ''default_group''' \gset
+select case when :srb_w1 >= :srb_w2 then 'datanode_1' else 'datanode_2' end as srb_heavy \gset
+update srb_t set b = b where xc_node_id = (select node_id from pgxc_node where node_name = :'srb_heavy');
+update srb_t set b = b where xc_node_id = (select node_id from pgxc_node where node_name = :'srb_heavy');
+execute direct on (datanode_1) 'select coalesce(sum(ntups_insert + ntups_update + ntups_delete), 0) as srb_w1 from opentenbase_shard_statistic() where group_name = ''default_group''' \gset
+execute direct on (datanode_2) 'select coalesce(sum(ntups_insert + ntups_update + ntups_delete), 0) as srb_w2 from opentenbase_shard_statistic() where group_name = ''default_group''' \gset
+-- the plan is not empty, and carrying it out lowers the highest node load
+select count(*) > 0 as planned,
+       greatest(:srb_w1 - coalesce(sum(load) filter (where from_node = 'datanode_1'), 0)
+                        + coalesce(sum(load) filter (where to_node = 'datanode_1'), 0),
+                :srb_w2 - coalesce(sum(load) filter (where from_node = 'datanode_2'), 0)
+                        + coalesce(sum(load) filter (where to_node = 'datanode_2'), 0))
+         < greatest(:srb_w1, :srb_w2) as reduces_imbalance
+  from opentenbase_shard_rebalance_plan('default_group', 'write', 0);
+select * from opentenbase_shard_rebalance_plan('default_group', 'bogus', 0.1);
+select * from opentenbase_shard_rebalance_plan('default_group', 'size', -1);
+select * from opentenbase_shard_rebalance_plan('no_such_group', 'size', 0.1);
+drop table srb_t;
@@ -0,0 +1,22 @@
+--
+-- Shard statistics are counted per backend and merged into shared memory at
+-- transaction end
+--
+create table sst_t(a int, b text) distribute by shard(a);
+execute direct on (datanode_1) 'select sum(ntups_insert) as sst_i1, sum(ntups_delete) as sst_d1 from opentenbase_shard_statistic()' \gset
+execute direct on (datanode_2) 'select sum(ntups_insert) as sst_i2, sum(ntups_delete) as sst_d2 from opentenbase_shard_statistic()' \gset
+-- the same shards are touched again and again inside one transaction
+begin;
+insert into sst_t select i, 'x' from generate_series(1, 3000) i;
+delete from sst_t where a <= 1000;
+insert into sst_t select i, 'y' from generate_series(1, 1000) i;
+delete from sst_t where a <= 500;
+commit;
+-- more updates than the flush threshold in one statement
+insert into sst_t select i, 'z' from generate_series(3001, 15000) i;
+execute direct on (datanode_1) 'select sum(ntups_insert) as sst_i1b, sum(ntups_delete) as sst_d1b from opentenbase_shard_statistic()' \gset
+execute direct on (datanode_2) 'select sum(ntups_insert) as sst_i2b, sum(ntups_delete) as sst_d2b from opentenbase_shard_statistic()' \gset
+select (:sst_i1b + :sst_i2b) - (:sst_i1 + :sst_i2) >= 16000 as inserts_counted,
+       (:sst_d1b + :sst_d2b) - (:sst_d1 + :sst_d2) >= 1500 as deletes_counted;
+select count(*) from sst_t;
+drop table sst_t;
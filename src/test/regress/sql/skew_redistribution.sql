@@ -0,0 +1,55 @@
+--
+-- Spreading hot join keys when both join sides are redistributed
+-- (enable_skew_redistribution)
+--
+create table skew_o(a int, b int);
+create table skew_i(a int, b int);
+-- value 1 makes up 60% of the outer join key
+insert into skew_o select i, case when i % 5 < 3 then 1 else i % 50 end
+  from generate_series(1, 5000) i;
+insert into skew_i select i, i % 50 from generate_series(1, 5000) i;
+analyze skew_o;
+analyze skew_i;
+
+create function skew_plan_has(query text, pattern text) returns boolean
+language plpgsql as
+$$
+declare
+    line text;
+begin
+    for line in execute 'explain (costs off) ' || query loop
+        if line like '%' || pattern || '%' then
+            return true;
+        end if;
+    end loop;
+    return false;
+end;
+$$;
+
+show enable_skew_redistribution;
+select skew_plan_has('select count(*) from skew_o o join skew_i i on o.b = i.b',
+                     'Skew Handling') as skewed;
+select count(*), sum(o.a), sum(i.a) from skew_o o join skew_i i on o.b = i.b;
+select count(*) from skew_o o left join skew_i i on o.b = i.b;
+select count(*) from skew_o o where exists (select 1 from skew_i i where i.b = o.b);
+select count(*) from skew_o o where not exists (select 1 from skew_i i where i.b = o.b + 1);
+
+set enable_skew_redistribution to on;
+select skew_plan_has('select count(*) from skew_o o join skew_i i on o.b = i.b',
+                     'Skew Handling') as skewed;
+select count(*), sum(o.a), sum(i.a) from skew_o o join skew_i i on o.b = i.b;
+select count(*) from skew_o o left join skew_i i on o.b = i.b;
+select count(*) from skew_o o where exists (select 1 from skew_i i where i.b = o.b);
+select count(*) from skew_o o where not exists (select 1 from skew_i i where i.b = o.b + 1);
+
+-- no value is hot enough
+set skew_redistribution_threshold = 0.9;
+select skew_plan_has('select count(*) from skew_o o join skew_i i on o.b = i.b',
+                     'Skew Handling') as skewed;
+select count(*), sum(o.a), sum(i.a) from skew_o o join skew_i i on o.b = i.b;
+
+reset skew_redistribution_threshold;
+reset enable_skew_redistribution;
+drop function skew_plan_has(text, text);
+drop table skew_o;
+drop table skew_i;
@@ -0,0 +1,27 @@
+--
+-- vacuum_hidden_shards on an extent table: rows of a shard that lives on
+-- another node are purged extent by extent
+--
+create table vhs_t(a int, b text) distribute by shard(a);
+create index vhs_t_a on vhs_t(a);
+insert into vhs_t select i, repeat('x', 100) from generate_series(1, 200) i;
+execute direct on (datanode_2) 'select a as vhs_key, shardid as vhs_sid from vhs_t order by a limit 1' \gset
+-- leave rows of a datanode_2 shard behind on datanode_1, as a shard move would
+\set vhs_ins 'insert into vhs_t select ' :vhs_key ', repeat(''y'', 100) from generate_series(1, 2000)'
+execute direct on (datanode_1) :'vhs_ins';
+\set vhs_purge 'select vacuum_hidden_shards(''' :vhs_sid '#vhs_t#0'')'
+execute direct on (datanode_1) :'vhs_purge';
+-- nothing is left to purge
+execute direct on (datanode_1) :'vhs_purge';
+-- neither the heap nor the index of datanode_1 still has the rows
+\set vhs_cnt 'select count(*) from vhs_t where a = ' :vhs_key
+set enable_indexscan = off;
+set enable_bitmapscan = off;
+execute direct on (datanode_1) :'vhs_cnt';
+reset enable_indexscan;
+reset enable_bitmapscan;
+set enable_seqscan = off;
+execute direct on (datanode_1) :'vhs_cnt';
+reset enable_seqscan;
+select count(*) from vhs_t;
+drop table vhs_t;
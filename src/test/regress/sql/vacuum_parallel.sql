@@ -0,0 +1,47 @@
+--
+-- VACUUM (PARALLEL) hands the index bulk-delete passes to parallel workers
+--
+create table vp_t(a int, b int, c text) distribute by shard(a);
+create index vp_t_b on vp_t(b);
+create index vp_t_c on vp_t(c);
+create index vp_t_bc on vp_t(b, c);
+insert into vp_t select i, i % 100, 'v' || (i % 1000) from generate_series(1, 30000) i;
+delete from vp_t where a % 3 = 0;
+vacuum (parallel) vp_t;
+set enable_seqscan = off;
+set enable_bitmapscan = off;
+select count(*) from vp_t where b = 7;
+select count(*) from vp_t where c = 'v7';
+reset enable_bitmapscan;
+reset enable_seqscan;
+-- several bulk-delete rounds with a small maintenance_work_mem
+delete from vp_t where a % 3 = 1;
+set maintenance_work_mem = '1MB';
+vacuum (parallel) vp_t;
+reset maintenance_work_mem;
+set enable_seqscan = off;
+set enable_bitmapscan = off;
+select count(*) from vp_t where b = 7;
+reset enable_bitmapscan;
+reset enable_seqscan;
+-- without maintenance workers the leader does all indexes
+set max_parallel_maintenance_workers = 0;
+delete from vp_t where b = 8;
+vacuum (parallel) vp_t;
+select count(*) from vp_t;
+reset max_parallel_maintenance_workers;
+-- the leader and the workers share one cost-based delay balance
+delete from vp_t where b = 9;
+set vacuum_cost_delay = 1;
+set vacuum_cost_limit = 200;
+vacuum (parallel) vp_t;
+reset vacuum_cost_limit;
+reset vacuum_cost_delay;
+set enable_seqscan = off;
+set enable_bitmapscan = off;
+select count(*) from vp_t where b = 9;
+reset enable_bitmapscan;
+reset enable_seqscan;
+select count(*) from vp_t;
+vacuum (parallel, full) vp_t;
+drop table vp_t;
@@ -0,0 +1,22 @@
+--
+-- VACUUM ... SHARDING drops the rows and the storage of one shard on a
+-- datanode; the extents it frees are collected across its transactions
+--
+create table vsh_t(a int, b text) distribute by shard(a);
+create index vsh_t_a on vsh_t(a);
+insert into vsh_t select 1, repeat('x', 200) from generate_series(1, 3000);
+insert into vsh_t select i, repeat('y', 200) from generate_series(2, 101) i;
+select shardid as vsh_sid from vsh_t where a = 1 limit 1 \gset
+select count(*) from vsh_t where shardid = :vsh_sid;
+\set vsh_cmd 'vacuum vsh_t sharding(' :vsh_sid ')'
+execute direct on (datanode_1) :'vsh_cmd';
+execute direct on (datanode_2) :'vsh_cmd';
+select count(*) from vsh_t where shardid = :vsh_sid;
+set enable_seqscan = off;
+select count(*) from vsh_t where a = 1;
+reset enable_seqscan;
+-- the shard is empty now, a second run has nothing to free
+execute direct on (datanode_1) :'vsh_cmd';
+execute direct on (datanode_2) :'vsh_cmd';
+select count(*) from vsh_t where shardid = :vsh_sid;
+drop table vsh_t;
@@ -0,0 +1,13 @@
+--
+-- wal_insert_locks sets the number of WAL insertion locks at server start
+--
+show wal_insert_locks;
+select context, min_val, max_val from pg_settings where name = 'wal_insert_locks';
+set wal_insert_locks = 4;
+-- WAL-heavy work goes through all of the insertion locks
+create table wil_t(a int, b text) distribute by shard(a);
+insert into wil_t select i, repeat('w', 100) from generate_series(1, 10000) i;
+update wil_t set b = repeat('v', 100) where a % 2 = 0;
+select count(*), count(*) filter (where b like 'v%') from wil_t;
+checkpoint;
+drop table wil_t;